@@ -7,6 +7,7 @@ class Inputs;
 class Window;
 class Renderer;
 struct MaterialUBO;
+class AssetRegistry;
 
 class Application{
 private:
@@ -15,6 +16,7 @@ private:
     std::unique_ptr<Window> m_window;
     std::unique_ptr<Renderer> m_renderer;
     std::shared_ptr<class Material> m_material;
+    std::unique_ptr<AssetRegistry> m_assetRegistry; // 纹理 / 网格按路径去重共享
 
 private:
     // 窗口大小改变回调
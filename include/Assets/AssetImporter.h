@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Core/Context.h"
+#include "Assets/Mesh.h"
+#include "Assets/Texture.h"
+
+// 一次批量导入的耗时统计（CPU 阶段为各工作线程耗时之和）
+struct ImportStats {
+    size_t meshCount = 0;
+    size_t textureCount = 0;
+    size_t meshCacheHits = 0;       // 直接映射 .vmesh 缓存的网格数
+    size_t textureCacheHits = 0;    // 直接映射 .vtex 缓存的纹理数
+    uint32_t workerCount = 0;
+    uint64_t sourceBytes = 0;       // 读取的源文件字节数
+    uint64_t uploadedBytes = 0;     // 写入 staging 的字节数
+    double wallMs = 0.0;            // importAll 的墙钟时间
+    double ioMs = 0.0;              // 文件读取（缓存命中时为映射）
+    double parseMs = 0.0;           // OBJ 解析 + 顶点去重
+    double optimizeMs = 0.0;        // 缓存 / 过度绘制 / 顶点读取重排（+ Compact 格式的量化）
+    double cacheWriteMs = 0.0;      // 写 .vmesh / .vtex 缓存
+    double decodeMs = 0.0;          // 图像解码 + 翻转
+    double encodeMs = 0.0;          // CPU mip 生成 + 块压缩编码
+    double gpuCreateMs = 0.0;       // 主线程创建 Vulkan 资源并录制上传
+    double uploadWaitMs = 0.0;      // 等待传输队列完成
+};
+
+// 批量资源导入：文件读取、OBJ 解析、图像解码与块压缩编码在 JobSystem 的工作线程上并行执行，
+// 主线程按完成顺序创建 Vulkan 资源并把拷贝录制进 UploadEngine 的同一批次，
+// importAll 返回时所有数据已经在显存中（mip 生成在下一帧的图形命令缓冲开头完成）
+class AssetImporter {
+private:
+    struct MeshRequest {
+        std::string path;
+        MeshImportSettings settings;
+        std::shared_ptr<Mesh> result;
+    };
+    struct TextureRequest {
+        std::string path;
+        TextureImportSettings settings;
+        std::array<std::string, 3> channels;    // 打包纹理的 R / G / B 源图（普通纹理全为空）
+        std::unique_ptr<Texture> result;
+    };
+
+    Context* m_context;
+    std::vector<MeshRequest> m_meshes;
+    std::vector<TextureRequest> m_textures;
+    ImportStats m_stats;
+
+public:
+    explicit AssetImporter(Context* context);
+
+    // 禁止拷贝和移动
+    AssetImporter(const AssetImporter&) = delete;
+    AssetImporter& operator=(const AssetImporter&) = delete;
+    AssetImporter(AssetImporter&&) = delete;
+    AssetImporter& operator=(AssetImporter&&) = delete;
+
+    // 登记导入请求，返回的索引在 importAll 之后用于取结果
+    size_t addMesh(const std::string& path, const MeshImportSettings& settings = {});
+    size_t addTexture(const std::string& path, const TextureImportSettings& settings = {});
+    // 通道打包：各源图（灰度）的 R 通道依次写入结果的 R / G / B，空路径的通道为 1.0（例如 遮蔽 / 粗糙度 / 金属度）
+    size_t addPackedTexture(const std::array<std::string, 3>& channels, const TextureImportSettings& settings);
+
+    // 执行所有登记的导入，阻塞到上传完成；任意一个失败时抛出异常
+    const ImportStats& importAll();
+
+    std::shared_ptr<Mesh> getMesh(size_t index) const { return m_meshes.at(index).result; }
+    std::unique_ptr<Texture> takeTexture(size_t index) { return std::move(m_textures.at(index).result); }
+    const ImportStats& getStats() const { return m_stats; }
+};
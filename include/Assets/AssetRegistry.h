@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "Core/Context.h"
+#include "Assets/Mesh.h"
+#include "Assets/Texture.h"
+#include "Assets/AssetImporter.h"
+
+class CommandManager;
+
+// 资源句柄：引用计数由 shared_ptr 维护，注册表自身持有一份
+using TextureHandle = std::shared_ptr<Texture>;
+using MeshHandle = std::shared_ptr<Mesh>;
+
+struct AssetRegistryStats {
+    size_t textureCount = 0;
+    size_t meshCount = 0;
+    uint64_t hits = 0;              // 命中已加载资源的请求
+    uint64_t misses = 0;            // 需要解码 + 上传的请求
+    uint64_t evictions = 0;
+    VkDeviceSize residentBytes = 0; // 注册表中资源占用的显存
+};
+
+// 资源注册表：以 “规范化路径 + 导入设置” 为键，每个资源只解码、上传一次，
+// 多个 Material / Renderable 共享同一个句柄；显存紧张时按 LRU 驱逐没有外部引用的资源
+class AssetRegistry {
+public:
+    struct TextureRequest {
+        std::string path;
+        TextureImportSettings settings;
+        std::array<std::string, 3> channels{};  // 非空时为通道打包请求（见 AssetImporter::addPackedTexture），path 不使用
+    };
+
+private:
+    template<typename T>
+    struct Entry {
+        std::shared_ptr<T> asset;
+        VkDeviceSize size = 0;
+        uint64_t lastUsed = 0;      // 最近一次被请求时的 m_tick
+    };
+
+    Context* m_context;
+    std::unordered_map<std::string, Entry<Texture>> m_textures;
+    std::unordered_map<std::string, Entry<Mesh>> m_meshes;
+    uint64_t m_tick = 0;
+    float m_pressureThreshold = 0.9f;   // 设备本地堆用量超过预算的该比例时开始驱逐
+    AssetRegistryStats m_stats;
+    ImportStats m_lastImport;           // 最近一次未命中触发的批量导入
+
+    VkDeviceSize bytesOverBudget() const;
+
+public:
+    // 注册表的键（实现在 AssetRegistryKeys.cpp，不依赖设备，test/asset_registry_test.cpp 单独链接）：
+    // 路径经 weakly_canonical 规范化（失败时按词法规范化），再拼接影响导入结果的设置；useCache 不参与
+    static std::string normalizePath(const std::string& path);
+    static std::string makeTextureKey(const std::string& normalizedPath, const TextureImportSettings& settings);
+    static std::string makeMeshKey(const std::string& normalizedPath, const MeshImportSettings& settings);
+
+    explicit AssetRegistry(Context* context);
+    ~AssetRegistry() = default;
+
+    // 禁止拷贝和移动
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
+    AssetRegistry(AssetRegistry&&) = delete;
+    AssetRegistry& operator=(AssetRegistry&&) = delete;
+
+    TextureHandle loadTexture(const std::string& path, const TextureImportSettings& settings = {});
+    // 批量请求：去重后只把未加载的纹理交给 AssetImporter 并行导入，结果与请求一一对应
+    std::vector<TextureHandle> loadTextures(const std::vector<TextureRequest>& requests);
+    MeshHandle loadMesh(const std::string& path, const MeshImportSettings& settings = {});
+
+    // 每帧调用：显存超过预算阈值时驱逐未被引用的资源，返回驱逐数量
+    size_t update(CommandManager* commands);
+    // 按 LRU 驱逐未被引用的资源直到释放 bytesToFree 字节；销毁推迟到在途帧完成之后
+    size_t evictUnreferenced(CommandManager* commands, VkDeviceSize bytesToFree = VK_WHOLE_SIZE);
+
+    Context* getContext() const { return m_context; }
+    void setPressureThreshold(float threshold) { m_pressureThreshold = threshold; }
+    bool isUnderMemoryPressure() const { return this->bytesOverBudget() > 0; }
+    const AssetRegistryStats& getStats() const { return m_stats; }
+    const ImportStats& getLastImportStats() const { return m_lastImport; }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+class JobSystem;
+
+// 块压缩格式：每 4x4 像素编码成一个 8 或 16 字节的块，GPU 采样时直接解码
+enum class BlockFormat : uint32_t {
+    BC1,        // RGB，4 bpp（不透明颜色）
+    BC3,        // RGBA，8 bpp（BC1 颜色 + BC4 alpha）
+    BC4,        // 单通道 R，4 bpp（粗糙度 / 金属度等遮罩）
+    BC5,        // 双通道 RG，8 bpp（切线空间法线的 xy，z 在着色器中重建）
+    BC7,        // RGBA，8 bpp（颜色，质量最高）
+    Count
+};
+
+// 导入时的 CPU 块压缩编码（只访问 CPU 数据，可在工作线程上调用）：
+//  - BC1 / BC3 的颜色端点取主成分轴上的投影极值，再按当前索引做最小二乘修正
+//  - BC4 / BC5 每个通道取块内的最小 / 最大值，八插值模式
+//  - BC7 只用 mode 6（单子集、RGBA 7777 + p 位端点、4 位索引），同样做主成分 + 最小二乘
+namespace BlockCompressor {
+    constexpr uint32_t kBlockDim = 4;
+
+    // 一个块的字节数：BC1 / BC4 为 8，其余为 16
+    uint32_t getBlockBytes(BlockFormat format);
+    // width x height 的一级图像编码后的字节数（宽高向上取整到 4 的倍数）
+    size_t getEncodedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+    // rgba: 紧密排列的 RGBA8 像素；output 至少 getEncodedSize 字节，块按行排列。
+    // 宽高不是 4 的倍数时边缘块重复最后一行 / 列的像素。
+    // jobs 非空时按块行分给工作线程（可以在工作线程的任务内嵌套调用）
+    void encode(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* output,
+                JobSystem* jobs = nullptr);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Core/Context.h"
+#include "Assets/Mesh.h"
+#include "Assets/Material.h"
+
+class Scene;
+class Renderable;
+class DescriptorManager;
+
+struct GltfImportSettings {
+    bool importTextures = true;     // false 时只导入材质因子，纹理用 1x1 默认值
+    bool compressTextures = true;   // 按用途编码为块压缩格式，结果缓存在 glTF 文件旁的 .vcache/ 目录
+};
+
+// 一次 glTF 导入的统计（CPU 阶段为墙钟时间）
+struct GltfImportStats {
+    size_t primitiveCount = 0;
+    size_t zeroCopyPrimitives = 0;  // 顶点布局与 Vertex 一致，直接从映射内存拷贝进 staging
+    size_t skippedPrimitives = 0;   // 非三角形图元
+    size_t materialCount = 0;
+    size_t textureCount = 0;
+    size_t textureCacheHits = 0;    // 直接映射 .vtex 缓存的纹理数
+    size_t instanceCount = 0;
+    uint64_t fileBytes = 0;
+    uint64_t uploadedBytes = 0;
+    double wallMs = 0.0;
+    double mapMs = 0.0;             // 映射文件 + 解析 JSON
+    double prepareMs = 0.0;         // 交织顶点 / 转换与校验索引
+    double decodeMs = 0.0;          // 等待图像解码与块压缩编码（与准备阶段重叠）
+    double gpuCreateMs = 0.0;
+    double uploadWaitMs = 0.0;
+};
+
+// 节点层次展开后的一个实例：世界矩阵 + 图元
+struct GltfInstance {
+    uint32_t mesh = 0;              // GltfAsset::meshes 的下标
+    glm::mat4 transform{1.0f};
+};
+
+// 导入结果：每个三角形图元一个 Mesh（各自引用一个材质），节点展开为实例
+struct GltfAsset {
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    std::vector<uint32_t> meshMaterials;                // 与 meshes 一一对应，materials 的下标
+    std::vector<std::shared_ptr<Material>> materials;   // 最后一个是没有指定材质的图元使用的默认材质
+    std::vector<GltfInstance> instances;
+    GltfImportStats stats;
+};
+
+// glTF 2.0 导入（.glb 或 .gltf + 外部 .bin）：文件内存映射，JSON 解析后
+//   1. 位置 / 法线 / UV 在同一个 bufferView 中按 Vertex 布局交织时，顶点直接从映射内存拷贝进 staging；
+//      否则在工作线程上分块交织。16 / 32 位索引同样直接拷贝（只扫描一遍校验范围）
+//   2. 嵌入的图像在工作线程上解码，与顶点准备重叠；metallicRoughness 拆成两张单通道贴图（着色器读 .r）
+//   3. 场景节点层次（matrix 或 TRS）展开为实例
+// 只支持三角形图元；稀疏访问器、data: URI、KHR_mesh_quantization 等扩展会抛出 std::runtime_error
+namespace GltfImporter {
+    // 必须在主线程调用，返回时所有数据已经在显存中
+    GltfAsset load(Context* context, const std::string& path, const GltfImportSettings& settings = {});
+
+    // 为每个实例创建 Renderable 并加入场景，对象下标从 firstObjectIndex 开始（每个实例占用一个描述符集）；
+    // 超出 objectCapacity 的实例会被跳过。返回创建的 Renderable
+    std::vector<std::shared_ptr<Renderable>> instantiate(const GltfAsset& asset, Scene& scene,
+                                                         DescriptorManager* descriptors,
+                                                         uint32_t firstObjectIndex, uint32_t objectCapacity);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Assets/Texture.h"
+
+// 解析后的 KTX2 纹理：无超压缩时各级数据直接指向文件字节（调用方在上传前保持文件映射存活），
+// 有超压缩时逐级解压到 decompressed
+struct Ktx2Image {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    vk::Format format = vk::Format::eUndefined;
+    uint32_t supercompression = 0;          // KTX2 supercompressionScheme
+    const uint8_t* source = nullptr;        // 文件字节
+    std::vector<TextureLevel> levels;       // 相对 getView().data 的区间，mip 0 在前
+    std::vector<uint8_t> decompressed;
+
+    TextureView getView() const {
+        return TextureView{width, height, format, decompressed.empty() ? source : decompressed.data(),
+                           levels.data(), static_cast<uint32_t>(levels.size())};
+    }
+};
+
+// KTX2（Khronos Texture 2.0）读取：vkFormat 就是 Vulkan 格式，mip 链在打包时已经生成，
+// 全部级别一次拷贝进 staging，不在运行时解码图像或 blit。
+//  - 只支持 2D 纹理（没有数组层与立方体面）
+//  - 超压缩：无、ZLIB（stb_image 的 zlib 解码器）、Zstandard（构建时找到 libzstd 才可用）；
+//    BasisLZ / UASTC 等需要转码的格式（vkFormat 为 UNDEFINED）不支持
+//  - 数据按文件中的方向上传，不做翻转：给 OBJ 模型用的贴图需以左下角为原点打包（toktx --lower_left_maps_to_s0t0）
+//  - levelCount 为 0（要求运行时生成 mip）时只上传 mip 0
+//  - 各级数据长度必须等于该级尺寸按格式块大小算出的字节数，levelCount 不能超过完整 mip 链的级数
+namespace Ktx2 {
+    bool isKtx2(const uint8_t* bytes, size_t size);
+
+    // 只访问 CPU 数据，可在工作线程上调用；不支持的文件或损坏的数据抛出 std::runtime_error
+    Ktx2Image parse(const uint8_t* bytes, size_t size, const std::string& name);
+}
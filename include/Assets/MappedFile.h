@@ -0,0 +1,37 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// 只读内存映射文件：缓存与大文件解析直接读取页缓存，不经过 ifstream 拷贝。
+// 映射在析构时解除；可移动，便于从工作线程把映射交回主线程
+class MappedFile {
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    void close();
+
+public:
+    MappedFile() = default;
+    // 打开失败时抛出 std::runtime_error；空文件得到 size 为 0 的有效对象
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const uint8_t* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+    std::span<const uint8_t> getBytes() const { return {m_data, m_size}; }
+};
@@ -9,11 +9,13 @@
 #include "Assets/Texture.h"
 #include "Core/Descriptor.h"
 
+// 与 pbr.frag 的 MaterialBuffer 对应（std140）：因子与 ORM 贴图的对应通道相乘
 struct alignas(16) MaterialUBO {
     glm::vec3 albedo{1.0f, 1.0f, 1.0f};
     float metallic{0.0f};
     float roughness{0.5f};
     float ao{1.0f};
+    float normalScale{1.0f};        // 法线贴图 xy 的缩放（glTF normalTexture.scale），0 时等于几何法线
     static vk::DescriptorSetLayoutBinding GetBinding(size_t idx) {
         return vk::DescriptorSetLayoutBinding{}
             .setBinding(static_cast<uint32_t>(idx))
@@ -22,23 +24,39 @@ struct alignas(16) MaterialUBO {
             .setStageFlags(vk::ShaderStageFlagBits::eFragment);
     }
 };
+class AssetRegistry;
+
+// 材质引用的纹理（来自 AssetRegistry，多个材质可以共享同一张纹理）：
+// 法线为两通道（xy，z 在着色器中重建），遮蔽 / 粗糙度 / 金属度打包在一张线性纹理的 R / G / B
+struct MaterialTextures {
+    std::shared_ptr<Texture> albedo;
+    std::shared_ptr<Texture> normal;
+    std::shared_ptr<Texture> orm;
+};
+
 class Material {
 private:
     Context* m_context;
     PipelineType m_pipelineType;
     MaterialUBO m_uboData;
-    std::unique_ptr<Texture> m_albedoMap;
-    std::unique_ptr<Texture> m_normalMap;
-    std::unique_ptr<Texture> m_metallicMap;
-    std::unique_ptr<Texture> m_roughnessMap;
+    std::shared_ptr<Texture> m_albedoMap;
+    std::shared_ptr<Texture> m_normalMap;
+    std::shared_ptr<Texture> m_ormMap;
 public:
-    Material(Context* context,
+    // 纹理通过注册表加载：相同路径 + 设置的纹理只解码、上传一次；
+    // 遮蔽 / 粗糙度 / 金属度三张灰度图在导入时打包成一张 ORM 纹理（缺少的通道取 1.0）
+    Material(AssetRegistry& registry,
              PipelineType pipelineType,
              const MaterialUBO& uboData,
              const std::string& albedoPath = "",
              const std::string& normalPath = "",
              const std::string& metallicPath = "",
-             const std::string& roughnessPath = "");
+             const std::string& roughnessPath = "",
+             const std::string& occlusionPath = "");
+    Material(Context* context,
+             PipelineType pipelineType,
+             const MaterialUBO& uboData,
+             MaterialTextures textures);
 
     ~Material() = default;
     Material(const Material&) = delete;
@@ -56,16 +74,15 @@ public:
     // Textures
     Texture* getAlbedoMap() const { return m_albedoMap.get(); }
     Texture* getNormalMap() const { return m_normalMap.get(); }
-    Texture* getMetallicMap() const { return m_metallicMap.get(); }
-    Texture* getRoughnessMap() const { return m_roughnessMap.get(); }
+    Texture* getOrmMap() const { return m_ormMap.get(); }
 
     bool hasAlbedoMap() const { return m_albedoMap != nullptr; }
     bool hasNormalMap() const { return m_normalMap != nullptr; }
-    bool hasMetallicMap() const { return m_metallicMap != nullptr; }
-    bool hasRoughnessMap() const { return m_roughnessMap != nullptr; }
+    bool hasOrmMap() const { return m_ormMap != nullptr; }
 
-    // Bind all textures to descriptor set
+    // Bind all textures to descriptor set（copy 为 kAllCopies 时写入该实例的所有副本）
     void bindToDescriptorSet(DescriptorManager* descriptorManager,
                            uint32_t layoutIdx,
-                           uint32_t setInstance);
+                           uint32_t setInstance,
+                           uint32_t copy = DescriptorManager::kAllCopies);
 };
\ No newline at end of file
@@ -3,9 +3,17 @@
 #include <vector>
 #include <memory>
 #include <array>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <vulkan/vulkan.hpp>
 #include "Core/Context.h"
+#include "Assets/MeshOptimizer.h"
+#include "Assets/MeshletBuilder.h"
 
 struct Vertex {
     glm::vec3 pos;
@@ -36,39 +44,161 @@ struct Vertex {
     }
 };
 
-// 读取obj文件为顶点和索引（保存到显存上）
+// 去重按原始字节比较与求哈希，不能有填充字节
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex must stay tightly packed");
+
+// 紧凑顶点（16 字节）：位置按网格包围盒量化为 unorm16，法线八面体编码为 2x snorm16，UV 为 half
+struct CompactVertex {
+    uint16_t position[4];       // xyz + 保留分量（留给切线符号等）
+    int16_t normal[2];          // 八面体编码，着色器中解码
+    uint16_t texCoord[2];       // half float
+    static vk::VertexInputBindingDescription getBindingDescription() {
+        return vk::VertexInputBindingDescription{
+            0,                          // binding
+            sizeof(CompactVertex),      // stride
+            vk::VertexInputRate::eVertex
+        };
+    }
+    static std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions() {
+        return std::array{
+            vk::VertexInputAttributeDescription{
+                0, 0, vk::Format::eR16G16B16A16Unorm, offsetof(CompactVertex, position)
+            },
+            vk::VertexInputAttributeDescription{
+                1, 0, vk::Format::eR16G16Snorm, offsetof(CompactVertex, normal)
+            },
+            vk::VertexInputAttributeDescription{
+                2, 0, vk::Format::eR16G16Sfloat, offsetof(CompactVertex, texCoord)
+            }
+        };
+    }
+};
+static_assert(sizeof(CompactVertex) == 16, "CompactVertex must stay 16 bytes");
+
+enum class VertexFormat : uint8_t {
+    Standard,                   // Vertex，32 字节
+    Compact                     // CompactVertex，16 字节
+};
+
+struct MeshImportSettings {
+    VertexFormat vertexFormat = VertexFormat::Standard;
+    bool optimize = true;       // 顶点缓存 / 过度绘制 / 顶点读取重排（只改变顺序，不改变外观）
+    bool useCache = true;       // 读写 .vmesh 二进制缓存（不影响导入结果）
+    bool meshlets = true;       // 划分网格簇（三角形在子网格内重排），供 GPU 簇剔除使用
+    bool lods = true;           // 生成 LOD 链（QEM 简化，各级共享顶点缓冲，只追加索引）
+    bool operator==(const MeshImportSettings& other) const = default;
+};
+
+// 量化参数与误差（Compact 格式导入时统计）
+struct QuantizationInfo {
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsExtent{1.0f};
+    float maxPositionError = 0.0f;          // 模型空间距离
+    float maxNormalErrorDegrees = 0.0f;
+    float maxTexCoordError = 0.0f;
+};
+
+// 子网格：索引缓冲中的一段（OBJ 的一个 shape）
+struct Submesh {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// LOD 链中的一级：索引缓冲中的一段（0 级是原网格），所有级别引用同一份顶点
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t firstMeshlet = 0;      // 该级别的簇在 meshlets 中的区间（没有簇时为 0）
+    uint32_t meshletCount = 0;
+    float error = 0.0f;             // 相对 0 级的几何误差（QEM 估计的模型空间距离，逐级累加）
+};
+
+// CPU 侧的网格数据（解析结果，可以在工作线程上生成）
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;     // 覆盖全部索引，优化只在子网格内部重排
+    // Compact 格式的顶点，由 Mesh::compress 填充（同样可以在工作线程上执行）
+    std::vector<CompactVertex> compactVertices;
+    QuantizationInfo quantization;
+    // Mesh::optimize 前后的顶点缓存统计
+    bool optimized = false;
+    VertexCacheStats cacheBefore;
+    VertexCacheStats cacheAfter;
+    // Mesh::buildLods 生成的 LOD 链：indices 依次是 0 级（submeshes 覆盖的部分）与各级简化结果；
+    // 为空表示没有生成过，只有一项表示网格太小或无法继续简化
+    std::vector<MeshLod> lods;
+    // Mesh::buildMeshlets 划分的簇（firstIndex 相对 indices，按 LOD 级别依次排列）
+    std::vector<Meshlet> meshlets;
+};
+
+// 已是 GPU 布局的网格数据视图（例如映射的 .vmesh），直接拷贝进 staging，不做任何转换
+struct MeshView {
+    VertexFormat vertexFormat = VertexFormat::Standard;
+    const void* vertices = nullptr;
+    uint32_t vertexCount = 0;
+    uint32_t vertexStride = 0;
+    const void* indices = nullptr;
+    uint32_t indexCount = 0;
+    vk::IndexType indexType = vk::IndexType::eUint32;
+    const Submesh* submeshes = nullptr;
+    uint32_t submeshCount = 0;
+    const Meshlet* meshlets = nullptr;
+    uint32_t meshletCount = 0;
+    const MeshLod* lods = nullptr;      // 为空时整个索引区间是唯一的级别
+    uint32_t lodCount = 0;
+    glm::vec4 boundingSphere{0.0f};     // xyz 中心，w 半径（模型空间），LOD 选择使用
+    float uvDensity = 0.0f;             // 见 Mesh::computeUvDensity，纹理流式加载使用
+    QuantizationInfo quantization;
+};
+
+// 读取obj文件为顶点和索引（子分配在 GeometryArena 的共享缓冲上）
 class Mesh {
 private:
     Context* m_context;
-    uint32_t m_indexCount;
-    vk::Buffer m_indexBuffer;
-    vk::Buffer m_vertexBuffer;
-    VmaAllocation m_indexAllocation;
-    VmaAllocation m_vertexAllocation;
-
-    void createVertexBuffer(const std::vector<Vertex>& vertices);
-    void createIndexBuffer(const std::vector<uint32_t>& indices);
-    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& allocation);
-    void copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, VkDeviceSize size);
-    vk::CommandBuffer beginSingleTimeCommands();
-    void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
+    std::string m_name;
+    uint32_t m_indexCount;              // 0 级的索引数（索引区间中其后是更粗的级别）
+    GeometryArena::Handle m_geometry;   // 竞技场中的区间句柄（整理后偏移会变化，绘制时按句柄查询）
+    VertexFormat m_vertexFormat = VertexFormat::Standard;
+    QuantizationInfo m_quantization;
+    std::vector<Submesh> m_submeshes;
+    // 网格簇：CPU 副本 + 只读存储缓冲（剔除 / task 着色器读取），没有簇时为空
+    std::vector<Meshlet> m_meshlets;
+    vk::Buffer m_meshletBuffer;
+    VmaAllocation m_meshletAllocation = VK_NULL_HANDLE;
+    VkDeviceSize m_meshletBufferSize = 0;   // 支持网格着色器时包含簇的局部顶点 / 三角形数据
+    // LOD 链（至少一项），各级在竞技场索引区间内的偏移与簇区间
+    std::vector<MeshLod> m_lods;
+    glm::vec4 m_boundingSphere{0.0f};
+    float m_uvDensity = 0.0f;           // 每个模型空间单位对应的 UV 长度（0 级）
+
+    // 顶点数允许时以 16 位索引上传
+    void createGeometry(const void* vertices, uint32_t vertexCount, uint32_t vertexStride, const std::vector<uint32_t>& indices);
+    void createGeometry(const MeshView& view);
+    // indices 的元素类型由 indexType 决定；设备支持网格着色器时据此生成簇的局部数据
+    void createMeshletBuffer(const void* indices, vk::IndexType indexType, uint32_t vertexCount);
+    void releaseGeometry();
+    // 没有 LOD 链时以整个 0 级作为唯一一级；m_indexCount 取 0 级的索引数
+    void initLods(const MeshLod* lods, uint32_t lodCount, uint32_t indexCount);
 
 public:
     // Default constructor
     Mesh(Context* context)
         : m_context(context)
         , m_indexCount(0)
-        , m_vertexBuffer(nullptr)
-        , m_indexBuffer(nullptr)
-        , m_vertexAllocation(VK_NULL_HANDLE)
-        , m_indexAllocation(VK_NULL_HANDLE) {}
+        , m_geometry(GeometryArena::kInvalidHandle) {}
 
     // Load from OBJ file
-    Mesh(Context* context, const std::string& objPath);
-    Mesh(Context* context, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
-        : m_context(context), m_indexCount(static_cast<uint32_t>(indices.size())) {
-        this->createVertexBuffer(vertices);
-        this->createIndexBuffer(indices);
+    Mesh(Context* context, const std::string& objPath, const MeshImportSettings& settings = {});
+    // 由已解析的数据创建（只做区间分配与上传，必须在主线程调用）
+    Mesh(Context* context, const MeshData& data, const std::string& name, const MeshImportSettings& settings = {});
+    // 由 GPU 布局的视图创建（数据直接拷贝进 staging，必须在主线程调用）
+    Mesh(Context* context, const MeshView& view, const std::string& name);
+    Mesh(Context* context, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::string& name = "<inline mesh>")
+        : m_context(context), m_name(name), m_indexCount(static_cast<uint32_t>(indices.size())), m_geometry(GeometryArena::kInvalidHandle)
+        , m_submeshes{Submesh{0, static_cast<uint32_t>(indices.size())}} {
+        this->initLods(nullptr, 0, m_indexCount);
+        this->createGeometry(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(Vertex), indices);
     }
 
     ~Mesh();
@@ -78,7 +208,64 @@ public:
     Mesh& operator=(Mesh&& other) noexcept;
 
     // Getters
-    vk::Buffer getVertexBuffer() const { return m_vertexBuffer; }
-    vk::Buffer getIndexBuffer() const { return m_indexBuffer; }
+    // 顶点 / 索引缓冲由所有 Mesh 共享，每帧通过 GeometryArena::bind 绑定一次
+    vk::Buffer getVertexBuffer() const { return m_context->getGeometryArena()->getVertexBuffer(); }
+    vk::Buffer getIndexBuffer() const { return m_context->getGeometryArena()->getIndexBuffer(); }
+    // 0 级的索引数；当前帧实际绘制的级别见 getLod
     uint32_t getIndexCount() const { return m_indexCount; }
+    const GeometryRange& getRange() const { return m_context->getGeometryArena()->getRange(m_geometry); }
+    VkDeviceSize getMemorySize() const;
+    const std::string& getName() const { return m_name; }
+    const std::vector<Submesh>& getSubmeshes() const { return m_submeshes; }
+    VertexFormat getVertexFormat() const { return m_vertexFormat; }
+    const std::vector<Meshlet>& getMeshlets() const { return m_meshlets; }
+    vk::Buffer getMeshletBuffer() const { return m_meshletBuffer; }
+    // 缓冲中是否带有网格着色器需要的局部数据（Meshlet::dataOffset 有效）
+    bool hasMeshletLocalData() const { return m_meshletBufferSize > m_meshlets.size() * sizeof(Meshlet); }
+    const QuantizationInfo& getQuantization() const { return m_quantization; }
+    const std::vector<MeshLod>& getLods() const { return m_lods; }
+    const MeshLod& getLod(uint32_t level) const { return m_lods[std::min<size_t>(level, m_lods.size() - 1)]; }
+    const glm::vec4& getBoundingSphere() const { return m_boundingSphere; }
+    float getUvDensity() const { return m_uvDensity; }
+    // 按投影误差选择级别：pixelsPerUnit 为网格处一个模型空间单位投影到屏幕上的像素数。
+    // 选误差不超过 maxPixelError 的最粗一级；比当前更粗的级别要求误差低于 maxPixelError * (1 - hysteresis)，
+    // 误差在阈值附近波动时不会来回切换
+    uint32_t selectLod(float pixelsPerUnit, uint32_t currentLevel, float maxPixelError, float hysteresis) const;
+    // 量化位置 [0,1]^3 -> 模型空间，合并进模型矩阵后着色器不需要单独反量化
+    glm::mat4 getDequantizeMatrix() const {
+        if (m_vertexFormat != VertexFormat::Compact) return glm::mat4(1.0f);
+        return glm::scale(glm::translate(glm::mat4(1.0f), m_quantization.boundsMin), m_quantization.boundsExtent);
+    }
+
+    // UV 密度：按三角形面积加权的 sqrt(UV 面积 / 模型空间面积)，即一个模型空间单位对应的 UV 长度。
+    // 纹理流式加载用它把屏幕上的投影尺寸换算成需要的 mip 级；index(i) 返回第 i 个索引
+    template<typename IndexFn>
+    static float computeUvDensity(const Vertex* vertices, size_t indexCount, IndexFn index) {
+        double uvArea = 0.0;
+        double area = 0.0;
+        for (size_t i = 0; i + 2 < indexCount; i += 3) {
+            const Vertex& a = vertices[index(i)];
+            const Vertex& b = vertices[index(i + 1)];
+            const Vertex& c = vertices[index(i + 2)];
+            area += glm::length(glm::cross(b.pos - a.pos, c.pos - a.pos));
+            const glm::vec2 u = b.texCoord - a.texCoord;
+            const glm::vec2 v = c.texCoord - a.texCoord;
+            uvArea += std::abs(u.x * v.y - u.y * v.x);
+        }
+        return area > 0.0 ? static_cast<float>(std::sqrt(uvArea / area)) : 0.0f;
+    }
+
+    // OBJ 解析只访问 CPU 数据，可在任意线程调用；传入 jobs 时文本分块并行解析、大网格的顶点去重分区并行
+    static MeshData parseObj(std::string_view text, const std::string& name, JobSystem* jobs = nullptr);
+    static MeshData loadObj(const std::string& objPath);
+    // 生成 Compact 顶点并统计量化误差（只访问 CPU 数据，可在任意线程调用）
+    static void compress(MeshData& data);
+    // 重排索引与顶点并统计 ACMR / ATVR（只访问 CPU 数据，可在任意线程调用）
+    static void optimize(MeshData& data);
+    // 逐级简化 0 级生成 LOD 链，各级索引追加在 indices 之后（不改变顶点，可在任意线程调用）
+    static void buildLods(MeshData& data);
+    // 在子网格与各级 LOD 内划分网格簇并重排三角形（不改变顶点，可在任意线程调用）
+    static void buildMeshlets(MeshData& data);
+    // 按导入设置依次执行 optimize、buildLods、buildMeshlets 与 compress，已处理过的步骤会跳过
+    static void process(MeshData& data, const MeshImportSettings& settings);
 };
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <numeric>
+#include <cstddef>
+#include <cstdint>
+
+// 每个顶点相邻的三角形列表（CSR 布局）。
+// MeshOptimizer / MeshletBuilder / MeshSimplifier 内部共用，不属于对外接口
+struct MeshAdjacency {
+    std::vector<uint32_t> offsets;      // 顶点 v 的三角形位于 triangles[offsets[v], offsets[v + 1])
+    std::vector<uint32_t> triangles;
+
+    // 重建时复用已有容量（MeshSimplifier 每一轮都会重建）
+    void build(const std::vector<uint32_t>& indices, size_t vertexCount) {
+        offsets.assign(vertexCount + 1, 0);
+        for (uint32_t index : indices) {
+            offsets[index + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        triangles.resize(indices.size());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+};
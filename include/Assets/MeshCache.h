@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <cstdint>
+#include <filesystem>
+#include "Assets/Mesh.h"
+#include "Assets/MappedFile.h"
+
+// .vmesh 文件头（小端，所有数据块 16 字节对齐）：
+//   MeshCacheHeader | Submesh[submeshCount] | 顶点数据（GPU 布局） | 索引数据（16 / 32 位，含各级 LOD）
+//   | Meshlet[meshletCount] | MeshLod[lodCount]
+struct MeshCacheHeader {
+    static constexpr uint32_t kMagic = 0x48534D56;      // "VMSH"
+    static constexpr uint32_t kVersion = 4;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t vertexFormat = 0;          // VertexFormat
+    uint32_t flags = 0;                 // kFlagOptimized | kFlagMeshlets | kFlagLods
+    uint32_t vertexCount = 0;
+    uint32_t vertexStride = 0;
+    uint32_t indexCount = 0;
+    uint32_t indexSize = 0;             // 2 或 4
+    uint32_t submeshCount = 0;
+    uint32_t meshletCount = 0;
+    uint32_t lodCount = 0;
+    float uvDensity = 0.0f;             // Mesh::computeUvDensity（0 级）
+    // 源文件签名：大小与修改时间不一致时缓存作废
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    float boundsMin[3] = {};
+    float boundsMax[3] = {};
+    QuantizationInfo quantization;
+    VertexCacheStats cacheBefore;
+    VertexCacheStats cacheAfter;
+    uint64_t submeshOffset = 0;
+    uint64_t vertexOffset = 0;
+    uint64_t indexOffset = 0;
+    uint64_t meshletOffset = 0;
+    uint64_t lodOffset = 0;
+    uint64_t fileSize = 0;
+
+    static constexpr uint32_t kFlagOptimized = 1u << 0;
+    static constexpr uint32_t kFlagMeshlets = 1u << 1;
+    static constexpr uint32_t kFlagLods = 1u << 2;
+};
+
+// 映射的缓存文件 + 指向映射内存的视图（视图在 file 存活期间有效）
+struct CachedMesh {
+    MappedFile file;
+    MeshView view;
+    const MeshCacheHeader* header = nullptr;
+};
+
+// 二进制网格缓存：首次导入后把处理好的 GPU 布局数据写进源文件旁的 .vcache/ 目录，
+// 之后的导入直接映射文件并从映射内存拷贝进 staging，跳过解析、去重、优化与量化
+namespace MeshCache {
+    // <源文件目录>/.vcache/<文件名>.<std|compact>.<opt|raw>[.mlt][.lod].vmesh
+    std::filesystem::path getCachePath(const std::string& sourcePath, const MeshImportSettings& settings);
+
+    // 缓存存在且与源文件签名、导入设置、版本都匹配时映射并返回；否则返回空
+    std::optional<CachedMesh> open(const std::string& sourcePath, const MeshImportSettings& settings);
+
+    // 把已处理的网格写入缓存（先写临时文件再重命名，并发导入不会读到半个文件），返回写入的字节数。
+    // data 必须已按 settings 处理（Mesh::process）
+    uint64_t write(const std::string& sourcePath, const MeshData& data, const MeshImportSettings& settings);
+}
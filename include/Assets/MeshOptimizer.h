@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 顶点后变换缓存统计（FIFO 缓存模拟）
+struct VertexCacheStats {
+    float acmr = 0.0f;      // average cache miss ratio：每个三角形的未命中数（最优 ~0.5，最差 3）
+    float atvr = 0.0f;      // average transformed vertex ratio：未命中数 / 被引用的顶点数（最优 1）
+};
+
+// 导入时的网格优化（只访问 CPU 数据，可在工作线程上调用）：
+//  1. optimizeVertexCache —— Tipsify 顶点缓存重排
+//  2. optimizeOverdraw    —— 按缓存边界切分簇，簇按朝外程度排序（由外向内绘制，减少过度绘制）
+//  3. optimizeVertexFetch —— 按索引首次引用顺序重排顶点，提高顶点读取的局部性
+namespace MeshOptimizer {
+    inline constexpr uint32_t kDefaultCacheSize = 16;
+
+    VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                        uint32_t cacheSize = kDefaultCacheSize);
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount,
+                             uint32_t cacheSize = kDefaultCacheSize);
+
+    // positions: 每个顶点的 xyz 起始地址为 positions + i * positionStride 字节。
+    // threshold: 允许簇内 ACMR 相对整体变差的比例，越大切得越碎、排序越自由
+    void optimizeOverdraw(std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+                          size_t vertexCount, float threshold = 1.05f, uint32_t cacheSize = kDefaultCacheSize);
+
+    // 重写 indices，返回 remap[旧顶点] = 新顶点（未被引用的顶点为 UINT32_MAX），以及新的顶点数
+    std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, size_t& newVertexCount);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 导入时的网格简化（只访问 CPU 数据，可在工作线程上调用）：
+// 二次误差度量（QEM）驱动的半边折叠，顶点只折叠到已有的顶点上，简化结果直接引用原顶点缓冲，
+// 同一网格的各级 LOD 只多出索引。
+//  - 开放边界、非流形边以及三个以上属性分支交汇处的顶点锁定（模型轮廓与子网格接缝不开裂）
+//  - 属性接缝（位置相同、法线或 UV 不同的顶点）上的顶点只能沿接缝折叠，各分支一起移动
+//  - 会使相邻三角形翻面的折叠被拒绝
+namespace MeshSimplifier {
+    // 原地简化 indices，直到索引数不超过 targetIndexCount，或剩下的折叠误差都超过 targetError（模型空间距离）。
+    // positions: 每个顶点的 xyz 起始地址为 positions + i * positionStride 字节。
+    // 返回本次简化的误差（执行过的折叠中最大的面积加权 RMS 距离，模型空间）
+    float simplify(std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+                   size_t vertexCount, size_t targetIndexCount, float targetError);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// 网格簇（meshlet）：索引缓冲中连续的一段三角形 + 剔除用的包围球与法线锥。
+// 布局与 shaders/meshlet_cull.comp 中的 std430 结构一致（64 字节）
+struct Meshlet {
+    float center[3] = {};           // 模型空间包围球
+    float radius = 0.0f;
+    float coneApex[3] = {};         // 法线锥顶点（模型空间）
+    float coneCutoff = 1.0f;        // dot(normalize(apex - camera), axis) >= cutoff 时整簇背向相机；1 表示不可剔除
+    float coneAxis[3] = {};
+    uint32_t firstIndex = 0;        // 相对网格索引区间的起点
+    uint32_t triangleCount = 0;
+    uint32_t vertexCount = 0;       // 簇内不同顶点数
+    uint32_t dataOffset = 0;        // 网格着色器的局部数据在 meshlet 缓冲中的位置（32 位字），上传时由 buildLocalData 填写
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(Meshlet) == 64, "Meshlet must match the std430 layout in meshlet_cull.comp");
+
+// 导入时的簇划分（只访问 CPU 数据，可在工作线程上调用）：
+// 在各索引区间内按邻接关系贪心生长，新增顶点最少者优先、法线偏离簇平均法线的作为惩罚，
+// 三角形重排后每个簇都是连续的索引区间，传统索引绘制与间接绘制可以共用同一份索引缓冲
+namespace MeshletBuilder {
+    inline constexpr uint32_t kMaxVertices = 64;
+    inline constexpr uint32_t kMaxTriangles = 124;
+
+    // ranges: {firstIndex, indexCount}，簇不会跨越区间；indices 在各区间内被重排。
+    // positions: 每个顶点的 xyz 起始地址为 positions + i * positionStride 字节。
+    // coneWeight: 法线偏离的惩罚权重，越大簇的法线锥越窄（背面剔除率越高），但顶点复用变差
+    std::vector<Meshlet> build(std::vector<uint32_t>& indices, const std::vector<std::pair<uint32_t, uint32_t>>& ranges,
+                               const float* positions, size_t positionStride, size_t vertexCount,
+                               float coneWeight = 0.5f);
+
+    // 网格着色器用的局部数据，紧接在 meshlet 数组之后上传到同一个缓冲：
+    // 每个簇先是 vertexCount 个顶点索引（相对网格的顶点区间，按首次出现的顺序），
+    // 再是 triangleCount 个局部三角形（3 个 8 位局部索引打包在一个 32 位字里）。
+    // wordBase 为数据区在缓冲中的起点（32 位字），写入各簇的 dataOffset
+    std::vector<uint32_t> buildLocalData(std::vector<Meshlet>& meshlets, const uint32_t* indices, size_t vertexCount, uint32_t wordBase);
+    std::vector<uint32_t> buildLocalData(std::vector<Meshlet>& meshlets, const uint16_t* indices, size_t vertexCount, uint32_t wordBase);
+
+    // 由簇的三角形计算包围球与法线锥（firstIndex / triangleCount 已填写）
+    void computeBounds(Meshlet& meshlet, const std::vector<uint32_t>& indices,
+                       const float* positions, size_t positionStride);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+class JobSystem;
+
+// 角点引用的属性下标（0 起始，已解析相对下标），-1 表示缺省
+struct ObjIndex {
+    int32_t position = -1;
+    int32_t texCoord = -1;
+    int32_t normal = -1;
+};
+
+// o / g 分隔出的一组面（角点区间，已三角化）
+struct ObjShape {
+    uint32_t firstCorner = 0;
+    uint32_t cornerCount = 0;
+};
+
+// 解析结果保持 OBJ 的索引形式，去重由调用方完成
+struct ObjData {
+    std::vector<float> positions;       // xyz
+    std::vector<float> normals;         // xyz
+    std::vector<float> texCoords;       // uv
+    std::vector<ObjIndex> corners;      // 每 3 个为一个三角形（多边形按扇形三角化）
+    std::vector<ObjShape> shapes;       // 只包含有面的组
+};
+
+// 多线程 OBJ 解析：文本按行边界切块，第一遍并行统计每块的 v / vt / vn 个数，
+// 前缀和得到每块的全局下标起点后第二遍并行解析（std::from_chars，无字符串分配），
+// 负数相对下标在块内即可解析。只支持几何相关的语句（v / vt / vn / f / o / g），材质语句忽略
+namespace ObjParser {
+    // text 通常是映射的文件内容；jobs 为空或文本较小时单线程解析。格式错误时抛出 std::runtime_error
+    ObjData parse(std::string_view text, const std::string& name, JobSystem* jobs = nullptr);
+}
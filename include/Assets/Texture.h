@@ -1,39 +1,143 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <functional>
 #include <stdexcept>
 #include <iostream>
 #include <vulkan/vulkan.hpp>
 #include "Core/Context.h"
+#include "Assets/BlockCompressor.h"
+#include "Assets/MappedFile.h"
+
+class JobSystem;
+class CommandManager;
+
+// CPU 侧解码后的 RGBA8 像素（已按 Vulkan 约定翻转，可以在工作线程上生成）
+struct ImageData {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+// 贴图用途：决定块压缩格式与 mip 生成方式
+enum class TextureUsage : uint32_t {
+    Color,      // 反照率等颜色贴图：BC7（设备不支持时不透明用 BC1、带 alpha 用 BC3）
+    Normal,     // 切线空间法线：BC5（未压缩时 R8G8）只保存 xy，z 在着色器中重建
+    Mask,       // 单通道数据（取 R 通道）：BC4（未压缩时 R8）
+    Orm         // 打包的 遮蔽 / 粗糙度 / 金属度（R / G / B，线性）：BC7（设备不支持时 BC1）
+};
+
+// 导入设置：与路径一起组成资源注册表的键，同一张图以不同设置导入会得到不同的 Texture
+struct TextureImportSettings {
+    bool srgb = true;               // 颜色数据用 SRGB 格式，数据贴图（法线/粗糙度等）可以用 UNORM
+    bool generateMips = true;
+    TextureUsage usage = TextureUsage::Color;
+    bool compress = true;           // 在 CPU 上编码为块压缩格式（设备不支持所需格式时回退到 RGBA8）
+    bool useCache = true;           // 编码结果缓存在源文件旁的 .vcache/ 目录
+    bool operator==(const TextureImportSettings& other) const = default;
+};
+
+// 一个 mip 级在数据中的区间
+struct TextureLevel {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+// 指向已编码纹理数据的视图（EncodedTexture、映射的缓存文件或 KTX2），levels[0] 是 mip 0，各级区间相对 data
+struct TextureView {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    vk::Format format = vk::Format::eUndefined;
+    const uint8_t* data = nullptr;
+    const TextureLevel* levels = nullptr;
+    uint32_t levelCount = 0;
+};
+
+// 流式纹理保留的 CPU 侧数据：预先生成好的完整 mip 链（映射的 .vtex / KTX2 文件只占地址空间与页缓存），
+// 改变常驻级别时从这里重新上传。view 指向 file 或 data，levels 拷贝到自身，移动后仍然有效
+struct TextureStreamSource {
+    MappedFile file;
+    std::vector<uint8_t> data;          // 不来自映射文件的数据（未写缓存的编码结果、解压后的 KTX2）
+    std::vector<TextureLevel> levels;
+    TextureView view;
+
+    TextureStreamSource(MappedFile mappedFile, std::vector<uint8_t> ownedData, const TextureView& source)
+        : file(std::move(mappedFile))
+        , data(std::move(ownedData))
+        , levels(source.levels, source.levels + source.levelCount)
+        , view(source) {
+        view.levels = levels.data();
+    }
+};
+
+// CPU 上编码好的块压缩纹理（含完整 mip 链，可以在工作线程上生成）
+struct EncodedTexture {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    vk::Format format = vk::Format::eUndefined;
+    std::vector<TextureLevel> levels;
+    std::vector<uint8_t> data;
+
+    TextureView getView() const {
+        return TextureView{width, height, format, data.data(), levels.data(), static_cast<uint32_t>(levels.size())};
+    }
+};
+
+// 设备对块压缩格式的支持：主线程查询一次，按值交给工作线程选择编码格式
+struct TextureFormatSupport {
+    uint32_t blockFormats = 0;      // 1 << BlockFormat：SRGB / UNORM 变体都能采样、线性过滤并作为拷贝目标
+
+    bool supports(BlockFormat format) const { return (blockFormats >> static_cast<uint32_t>(format) & 1u) != 0; }
+};
 
 class Texture {
 private:
     Context* m_context;
+    std::string m_name;                 // 用于显存追踪（VMA allocation name）
     uint32_t m_mipLevels;
     uint32_t m_width;
     uint32_t m_height;
+    vk::Format m_format;
 
     vk::Image m_image;
     vk::ImageView m_imageView;
-    vk::Sampler m_sampler;
+    vk::Sampler m_sampler;              // 共享采样器，归 SamplerCache 所有
     VmaAllocation m_allocation;
 
+    // 流式加载：图像只包含 [m_residentMip, m_mipLevels) 这些级别，m_width / m_height 仍是 mip 0 的尺寸
+    std::optional<TextureStreamSource> m_stream;
+    uint32_t m_residentMip = 0;
+
     void createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
                      vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-                     VmaMemoryUsage memoryUsage);
+                     VmaMemoryUsage memoryUsage, vk::ImageCreateFlags flags = {});
     void createImageView(vk::Format format, vk::ImageAspectFlags aspectFlags);
     void createSampler();
-    void transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout,
-                              vk::ImageLayout newLayout, uint32_t mipLevels);
-    void copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
-    void generateMipmaps(vk::Image image, vk::Format format, int32_t texWidth,
-                         int32_t texHeight, uint32_t mipLevels);
-    vk::CommandBuffer beginSingleTimeCommands();
-    void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
+    // 由未压缩像素创建（格式见 getPixelFormat），需要时由 MipGenerator 或图形队列 blit 生成 mip；
+    // writePixels 把紧密排列的 mip 0 写进映射的 staging 内存
+    void createFromPixels(uint32_t width, uint32_t height, const TextureImportSettings& settings,
+                          const std::function<void(uint8_t* mapped)>& writePixels);
+    // 由预先生成好的 mip 级创建，[m_residentMip, 末级] 一次拷贝
+    void createFromLevels(const TextureView& view);
+    void createResidentLevels(const TextureView& view);
+    static void destroyImage(Context* context, vk::Image image, vk::ImageView view, VmaAllocation allocation);
 
 public:
     ~Texture();
-    Texture(Context* context, const std::string& filepath);
+    // .ktx2 文件直接上传其中的 mip 链（忽略 settings），其他格式解码后按 settings 上传
+    Texture(Context* context, const std::string& filepath, const TextureImportSettings& settings = {});
+    // 由已解码的像素创建（只做 GPU 分配与上传，必须在主线程调用）
+    Texture(Context* context, const ImageData& image, const std::string& name, const TextureImportSettings& settings = {});
+    // 由预先生成好全部 mip 级的数据创建（块压缩编码结果、缓存映射或 KTX2），逐级拷贝，不再 blit
+    Texture(Context* context, const TextureView& view, const std::string& name);
+    // 流式纹理：接管源数据，先只上传 TextureStreamer 选择的低分辨率级别，之后由 TextureStreamer 升降
+    Texture(Context* context, TextureStreamSource source, const std::string& name);
+    // 预先生成好 mip 链的数据：TextureStreamer 启用且不止一级时创建流式纹理，否则全部上传后释放源数据
+    static std::unique_ptr<Texture> createFromSource(Context* context, TextureStreamSource source, const std::string& name);
 
     // Disable copying
     Texture(const Texture&) = delete;
@@ -44,6 +148,38 @@ public:
     vk::Sampler getSampler() const { return m_sampler; }
     vk::Image getImage() const { return m_image; }
     uint32_t getMipLevels() const { return m_mipLevels; }
+    vk::Format getFormat() const { return m_format; }
+    VkDeviceSize getMemorySize() const;
+    const std::string& getName() const { return m_name; }
+    uint32_t getWidth() const { return m_width; }
+    uint32_t getHeight() const { return m_height; }
+
+    // --- 流式加载（只在主线程调用） ---
+    bool isStreamed() const { return m_stream.has_value(); }
+    // 当前常驻的最高一级（0 为完整分辨率）
+    uint32_t getResidentMip() const { return m_residentMip; }
+    // 从 firstMip 到末级的数据量（流式纹理按源数据估算显存，用于预算）
+    VkDeviceSize getLevelBytes(uint32_t firstMip) const;
+    // 改为只常驻 [mip, 末级]：新建图像并从源数据上传，立即替换图像与视图。
+    // 旧图像可能仍被在途帧与描述符集引用，返回其销毁函数，由调用方在重写描述符后交给 CommandManager::deferDestroy。
+    // 失败时保留原来的级别并抛出；已录制进上传批次的新图像经 commands 延迟到本帧完成后销毁
+    std::function<void()> setResidentMip(uint32_t mip, CommandManager* commands);
+
+    // 解码只访问 CPU 数据，可在任意线程调用。flipY：按 OBJ 的 UV 约定（原点在左下角）上下翻转，
+    // glTF 的 UV 原点在左上角，不需要翻转
+    static ImageData decode(const uint8_t* bytes, size_t size, const std::string& name, bool flipY = true);
+    static ImageData loadImage(const std::string& filepath);
+
+    // 按用途选择块压缩格式，在 CPU 上生成 mip 链（sRGB 颜色在线性空间滤波，法线滤波后重新归一化）并逐级编码。
+    // 只访问 CPU 数据，可在工作线程上调用，块编码按块行分给 jobs。
+    // 压缩关闭或设备不支持所需格式时返回空，调用方走未压缩的 RGBA8 路径
+    static std::optional<EncodedTexture> encode(const ImageData& image, const TextureImportSettings& settings,
+                                                const TextureFormatSupport& support, JobSystem* jobs = nullptr);
+    // 查询设备可用的块压缩格式（需要 textureCompressionBC 特性）
+    static TextureFormatSupport queryFormatSupport(Context* context);
+    static vk::Format getBlockFormat(BlockFormat format, bool srgb);
+    // 未压缩路径的格式：法线 R8G8，单通道 R8，其余 RGBA8（sRGB 按设置）
+    static vk::Format getPixelFormat(const TextureImportSettings& settings);
 };
 
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include "Assets/Texture.h"
+#include "Assets/MappedFile.h"
+
+// .vtex 文件头（小端，数据块 16 字节对齐）：
+//   TextureCacheHeader | TextureLevel[levelCount] | 各 mip 级的块数据（TextureLevel::offset 相对 dataOffset）
+struct TextureCacheHeader {
+    static constexpr uint32_t kMagic = 0x58455456;      // "VTEX"
+    static constexpr uint32_t kVersion = 2;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t format = 0;                // VkFormat
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    uint32_t settings = 0;              // 影响编码结果的导入设置（用途 | sRGB | mip）
+    uint32_t formatSupport = 0;         // 编码时设备支持的块压缩格式（TextureFormatSupport::blockFormats）
+    uint64_t sourceHash = 0;            // 源图像文件内容的哈希：内容不一致时缓存作废
+    uint64_t levelOffset = 0;
+    uint64_t dataOffset = 0;
+    uint64_t fileSize = 0;
+};
+
+// 映射的缓存文件 + 指向映射内存的视图（视图在 file 存活期间有效）
+struct CachedTexture {
+    MappedFile file;
+    TextureView view;
+};
+
+// 块压缩纹理缓存：首次导入时把编码好的全部 mip 级写进源文件旁的 .vcache/ 目录，
+// 以源文件内容哈希 + 导入设置为键；之后的导入映射文件并从映射内存拷贝进 staging，跳过解码、mip 生成与编码
+namespace TextureCache {
+    // <源文件目录>/.vcache/<文件名>.<color|normal|mask|orm>.<srgb|unorm>.<mips|nomips>.vtex
+    std::filesystem::path getCachePath(const std::string& sourcePath, const TextureImportSettings& settings);
+
+    // 源文件内容的 64 位哈希（xxHash64）
+    uint64_t hashBytes(const uint8_t* data, size_t size);
+
+    // 缓存存在且与源文件哈希、导入设置、设备支持的格式、版本都匹配时映射并返回；否则返回空
+    std::optional<CachedTexture> open(const std::string& sourcePath, const TextureImportSettings& settings,
+                                      uint64_t sourceHash, const TextureFormatSupport& support);
+
+    // 把编码结果写入缓存（先写临时文件再重命名），返回写入的字节数
+    uint64_t write(const std::string& sourcePath, const TextureImportSettings& settings,
+                   uint64_t sourceHash, const TextureFormatSupport& support, const EncodedTexture& texture);
+}
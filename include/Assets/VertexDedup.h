@@ -0,0 +1,197 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Core/JobSystem.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// 顶点去重：按位比较的顶点键 + wyhash 风格的 64 位哈希 + 开放寻址（线性探测）哈希表。
+// 大网格按哈希的高位分区，每个分区在各自的线程上独立建表，结果与单线程一致且确定
+namespace VertexDedup {
+    // 64x64 -> 128 位乘法后高低位异或（wyhash 的 mum 混合）
+    inline uint64_t mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        const __uint128_t r = static_cast<__uint128_t>(a) * b;
+        return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER)
+        uint64_t high;
+        const uint64_t low = _umul128(a, b, &high);
+        return low ^ high;
+#else
+        const uint64_t aLow = a & 0xffffffffull, aHigh = a >> 32;
+        const uint64_t bLow = b & 0xffffffffull, bHigh = b >> 32;
+        const uint64_t ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+        const uint64_t middle = (ll >> 32) + (lh & 0xffffffffull) + (hl & 0xffffffffull);
+        const uint64_t low = (middle << 32) | (ll & 0xffffffffull);
+        const uint64_t high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+        return low ^ high;
+#endif
+    }
+
+    // 对顶点的原始字节求哈希（-0.0 与 0.0 视为不同的键）
+    template<typename V>
+    uint64_t hash(const V& vertex) {
+        static_assert(std::is_trivially_copyable_v<V>, "vertex key must be trivially copyable");
+        constexpr uint64_t kSeed0 = 0xa0761d6478bd642full;
+        constexpr uint64_t kSeed1 = 0xe7037ed1a0b428dbull;
+        constexpr uint64_t kSeed2 = 0x8ebc6af09c88c6e3ull;
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+        uint64_t state = kSeed0 ^ sizeof(V);
+        size_t offset = 0;
+        for (; offset + 16 <= sizeof(V); offset += 16) {
+            uint64_t a, b;
+            std::memcpy(&a, bytes + offset, 8);
+            std::memcpy(&b, bytes + offset + 8, 8);
+            state = mix(a ^ kSeed1, b ^ state);
+        }
+        if (offset < sizeof(V)) {
+            uint64_t tail[2] = {0, 0};
+            std::memcpy(tail, bytes + offset, sizeof(V) - offset);
+            state = mix(tail[0] ^ kSeed1, tail[1] ^ state);
+        }
+        return mix(state ^ kSeed2, kSeed1);
+    }
+
+    template<typename V>
+    bool equal(const V& a, const V& b) {
+        return std::memcmp(&a, &b, sizeof(V)) == 0;
+    }
+
+    // 开放寻址表：槽位保存 (哈希高 32 位标签, 顶点编号)，标签不同时跳过字节比较
+    template<typename V>
+    class Table {
+    private:
+        struct Slot {
+            uint32_t tag;
+            uint32_t id;
+        };
+        static constexpr uint32_t kEmpty = UINT32_MAX;
+
+        std::vector<Slot> m_slots;
+        std::vector<V> m_vertices;
+        size_t m_mask = 0;
+
+    public:
+        // expected 为插入次数的上界，容量取其两倍以上的 2 的幂，负载因子不超过 0.5
+        explicit Table(size_t expected) {
+            const size_t capacity = std::bit_ceil(std::max<size_t>(expected * 2, 16));
+            m_slots.assign(capacity, Slot{0, kEmpty});
+            m_mask = capacity - 1;
+        }
+
+        // 返回已有顶点的编号，或插入后返回新编号（按首次出现顺序递增）
+        uint32_t findOrInsert(const V& vertex, uint64_t hashValue) {
+            const uint32_t tag = static_cast<uint32_t>(hashValue >> 32);
+            for (size_t i = static_cast<size_t>(hashValue) & m_mask; ; i = (i + 1) & m_mask) {
+                Slot& slot = m_slots[i];
+                if (slot.id == kEmpty) {
+                    slot.tag = tag;
+                    slot.id = static_cast<uint32_t>(m_vertices.size());
+                    m_vertices.push_back(vertex);
+                    return slot.id;
+                }
+                if (slot.tag == tag && equal(m_vertices[slot.id], vertex)) {
+                    return slot.id;
+                }
+            }
+        }
+
+        std::vector<V>& vertices() { return m_vertices; }
+    };
+
+    template<typename V>
+    struct Result {
+        std::vector<V> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    // 对 cornerCount 个角点去重，fetch(i) 返回第 i 个角点的顶点（必须线程安全）。
+    // jobs 为空或网格较小时单线程执行
+    template<typename V, typename Fetch>
+    Result<V> deduplicate(size_t cornerCount, const Fetch& fetch, JobSystem* jobs = nullptr) {
+        constexpr size_t kChunkSize = 1 << 16;
+        constexpr size_t kParallelThreshold = 1 << 18;
+
+        Result<V> result;
+        result.indices.resize(cornerCount);
+        if (cornerCount == 0) {
+            return result;
+        }
+
+        // 单线程：一张表，一次查找
+        if (jobs == nullptr || jobs->getThreadCount() == 0 || cornerCount < kParallelThreshold) {
+            Table<V> table(cornerCount);
+            for (size_t i = 0; i < cornerCount; i++) {
+                const V vertex = fetch(i);
+                result.indices[i] = table.findOrInsert(vertex, hash(vertex));
+            }
+            result.vertices = std::move(table.vertices());
+            return result;
+        }
+
+        // 分区数取线程数的若干倍（最多 256，分区号存成 uint8），按哈希最高位分区（表内探测用低位，两者不相关）
+        const uint32_t partitions = std::min(std::bit_ceil(jobs->getThreadCount() * 4u), 256u);
+        const uint32_t partitionBits = static_cast<uint32_t>(std::bit_width(partitions - 1));
+        const size_t partitionCount = size_t{1} << partitionBits;
+        const uint32_t partitionShift = 64 - partitionBits;
+        const size_t chunkCount = (cornerCount + kChunkSize - 1) / kChunkSize;
+
+        // 1. 按块并行求哈希，记录每个角点所属分区，每块内按分区收集角点编号（保持原顺序）
+        std::vector<uint8_t> partitionOf(cornerCount);
+        std::vector<std::vector<std::vector<uint32_t>>> buckets(chunkCount, std::vector<std::vector<uint32_t>>(partitionCount));
+        jobs->parallelFor(chunkCount, [&](size_t chunk) {
+            const size_t begin = chunk * kChunkSize;
+            const size_t end = std::min(cornerCount, begin + kChunkSize);
+            for (size_t i = begin; i < end; i++) {
+                const size_t partition = static_cast<size_t>(hash(fetch(i)) >> partitionShift);
+                partitionOf[i] = static_cast<uint8_t>(partition);
+                buckets[chunk][partition].push_back(static_cast<uint32_t>(i));
+            }
+        });
+
+        // 2. 每个分区独立建表，角点暂存分区内编号
+        std::vector<std::vector<V>> partitionVertices(partitionCount);
+        jobs->parallelFor(partitionCount, [&](size_t partition) {
+            size_t expected = 0;
+            for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+                expected += buckets[chunk][partition].size();
+            }
+            Table<V> table(expected);
+            for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+                for (uint32_t corner : buckets[chunk][partition]) {
+                    const V vertex = fetch(corner);
+                    result.indices[corner] = table.findOrInsert(vertex, hash(vertex));
+                }
+                std::vector<uint32_t>().swap(buckets[chunk][partition]);
+            }
+            partitionVertices[partition] = std::move(table.vertices());
+        });
+
+        // 3. 分区按顺序拼接，分区内编号加上分区起点
+        std::vector<uint32_t> base(partitionCount + 1, 0);
+        for (size_t partition = 0; partition < partitionCount; partition++) {
+            base[partition + 1] = base[partition] + static_cast<uint32_t>(partitionVertices[partition].size());
+        }
+        result.vertices.resize(base[partitionCount]);
+        jobs->parallelFor(partitionCount, [&](size_t partition) {
+            std::copy(partitionVertices[partition].begin(), partitionVertices[partition].end(),
+                      result.vertices.begin() + base[partition]);
+        });
+        jobs->parallelFor(chunkCount, [&](size_t chunk) {
+            const size_t begin = chunk * kChunkSize;
+            const size_t end = std::min(cornerCount, begin + kChunkSize);
+            for (size_t i = begin; i < end; i++) {
+                result.indices[i] += base[partitionOf[i]];
+            }
+        });
+        return result;
+    }
+}
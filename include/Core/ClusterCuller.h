@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.hpp>
+#include "Core/Context.h"
+#include "Core/RenderGraph.h"
+
+class Scene;
+class Renderable;
+
+struct ClusterCullSettings {
+    bool frustum = true;        // 包围球对视锥
+    // 法线锥背面剔除：只在背面本来就会被光栅化剔除时与原画面一致，而主管线与网格着色器管线
+    // 都是 cullMode = eNone（双面绘制，开放网格的背面可见），所以默认关闭，在 ImGui 中手动开启
+    bool cone = false;
+};
+
+// 簇剔除统计（可见数来自 GPU 计数回读，晚 framesInFlight 帧）
+struct ClusterCullStats {
+    uint32_t meshes = 0;                // 走簇剔除路径的 Renderable 数
+    uint32_t meshletsTested = 0;
+    uint32_t meshletsVisible = 0;
+    uint64_t trianglesTested = 0;
+    bool drawIndirectCount = false;     // false 时不可见的簇以 instanceCount = 0 占位
+};
+
+// GPU 簇剔除：每帧在主通道之前加一个计算 pass，逐个带 meshlet 的 Renderable 派发
+// meshlet_cull.comp，可见的簇写成间接绘制命令；主通道对这些 Renderable 用一次
+// vkCmdDrawIndexedIndirectCount（不支持时为 vkCmdDrawIndexedIndirect）代替 drawIndexed。
+// 没有 meshlet 的网格、着色器缺失或设备不支持 multiDrawIndirect 时主通道保持原来的绘制方式
+class ClusterCuller {
+private:
+    // 本帧某个 Renderable 在命令缓冲中的区间
+    struct DrawSlot {
+        uint32_t commandOffset = 0;
+        uint32_t countIndex = 0;
+        uint32_t maxDraws = 0;
+    };
+
+    // 每个 frame in flight 一份：该槽位上一次的提交在 beginFrame 返回时已经完成，可以直接重用或重建
+    struct FrameResources {
+        vk::Buffer commands;
+        VmaAllocation commandsAllocation = VK_NULL_HANDLE;
+        uint32_t commandCapacity = 0;
+        vk::Buffer counts;                          // 主机可见，回读统计
+        VmaAllocation countsAllocation = VK_NULL_HANDLE;
+        uint32_t* countsMapped = nullptr;
+        uint32_t countCapacity = 0;
+        vk::Buffer planes;                          // CullFrame UBO
+        VmaAllocation planesAllocation = VK_NULL_HANDLE;
+        void* planesMapped = nullptr;
+        vk::DescriptorPool pool;
+        uint32_t poolCapacity = 0;
+        // 上一次使用该槽位时的记录，用于回读
+        uint32_t countsUsed = 0;
+        uint32_t meshletsTested = 0;
+    };
+
+    Context* m_context;
+    vk::DescriptorSetLayout m_setLayout;
+    vk::PipelineLayout m_pipelineLayout;
+    vk::Pipeline m_pipeline;
+    uint32_t m_maxDrawIndirectCount = 1;
+    std::vector<FrameResources> m_frames;
+
+    bool m_enabled = true;
+    ClusterCullSettings m_settings;
+    ClusterCullStats m_stats;
+
+    // 本帧的声明结果（addPass 写入，主通道读取）
+    std::unordered_map<uint32_t, DrawSlot> m_slots;     // objectIndex -> 区间
+    RGHandle m_commandsHandle = RG_INVALID_HANDLE;
+    RGHandle m_countsHandle = RG_INVALID_HANDLE;
+
+    void createPipeline(const std::string& shaderPath);
+    void ensureCapacity(FrameResources& frame, uint32_t commandCount, uint32_t countCount, uint32_t setCount);
+    void destroyBuffers(FrameResources& frame);
+    void readBack(FrameResources& frame);
+
+public:
+    ClusterCuller(Context* context, uint32_t framesInFlight, const std::string& shaderPath = "shaders/meshlet_cull.comp.spv");
+    ~ClusterCuller();
+
+    // 禁止拷贝和移动
+    ClusterCuller(const ClusterCuller&) = delete;
+    ClusterCuller& operator=(const ClusterCuller&) = delete;
+    ClusterCuller(ClusterCuller&&) = delete;
+    ClusterCuller& operator=(ClusterCuller&&) = delete;
+
+    bool isSupported() const { return m_pipeline && m_context->getFeatures().multiDrawIndirect; }
+    bool isEnabled() const { return m_enabled && this->isSupported(); }
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    ClusterCullSettings& getSettings() { return m_settings; }
+    const ClusterCullStats& getStats() const { return m_stats; }
+
+    // 在主通道之前声明剔除 pass（必须在 CommandManager::beginFrame 之后调用）
+    void addPass(RenderGraph& graph, const Scene& scene, uint32_t frameIndex,
+                 const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+    // 本帧不做簇剔除（例如几何体走网格着色器路径）：清除上一帧的声明，上一轮的计数照常回读
+    void skipFrame(uint32_t frameIndex);
+    // 主通道的 setup 中调用：声明对间接命令与计数的读取
+    void declareReads(RenderGraphBuilder& builder) const;
+    // 录制该 Renderable 的间接绘制；返回 false 时调用方按原方式 drawIndexed
+    bool draw(vk::CommandBuffer commandBuffer, const RenderGraph& graph, const Renderable& renderable) const;
+};
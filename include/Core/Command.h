@@ -3,6 +3,7 @@
 #include <vector>
 #include <stdexcept>
 #include <string>
+#include <functional>
 #include <vulkan/vulkan.hpp>
 
 #include <unordered_map>
@@ -11,9 +12,27 @@
 class CommandManager {
 private:
     struct FrameData {
-        vk::Fence inFlightFence;               // GPU 完成信号
         vk::CommandPool commandPool;           // 每帧独立命令池（避免重置开销）
         vk::CommandBuffer primaryBuffer;        // 主命令缓冲（每帧一个）
+        uint64_t timelineValue = 0;            // 该帧上次提交时 signal 的时间线值
+    };
+
+    // 异步计算：计算队列族上的每帧命令池，与图形帧槽位一一对应
+    struct ComputeFrameData {
+        vk::CommandPool commandPool;
+        vk::CommandBuffer commandBuffer;
+        uint64_t timelineValue = 0;            // 该槽位上次计算提交 signal 的值
+    };
+
+    struct PendingWait {
+        vk::Semaphore semaphore;
+        uint64_t value;
+        vk::PipelineStageFlags2 stage;
+    };
+
+    struct DeferredDeletion {
+        uint64_t value;                        // GPU 完成到该值后才能执行
+        std::function<void()> deleter;
     };
 
     Context* m_context;
@@ -21,13 +40,32 @@ private:
     uint32_t m_currentFrameIndex = 0;
     uint32_t m_currentImageIndex = 0;
 
-    // CPU–GPU 同步：防止 CPU 提交过多帧，导致 GPU 积压。
-    std::vector<FrameData> m_perFrameData; 
+    // CPU–GPU 同步：图形队列的时间线信号量，每次提交 signal 一个单调递增的值。
+    // 帧资源复用、延迟删除、上传完成、异步计算都等待具体的时间线值
+    vk::Semaphore m_timeline;
+    uint64_t m_submittedValue = 0;             // 最近一次提交 signal 的值
+    double m_cpuWaitMs = 0.0;                  // 本帧 beginFrame 中 CPU 阻塞等待 GPU 的时间
+
+    // 异步计算（计算队列族与图形队列族不同时才可用）
+    bool m_asyncComputeAvailable = false;
+    vk::Semaphore m_computeTimeline;
+    uint64_t m_computeSubmittedValue = 0;
+    std::vector<ComputeFrameData> m_computeFrameData;
+
+    std::vector<FrameData> m_perFrameData;
+    std::vector<PendingWait> m_pendingWaits;   // 下一次提交需要额外等待的信号量
+    std::vector<DeferredDeletion> m_deferredDeletions;
     // GPU 内部同步：通知图形队列 “swapchain image 已准备好，可以渲染了
     std::vector<vk::Semaphore> m_imageAvailableSemaphores;
     // GPU 内部同步：通知 present 队列 “渲染已完成，可以显示了”。
     std::vector<vk::Semaphore> m_renderFinishedSemaphores;
 
+    void createSwapchainSemaphores(uint32_t swapchainImageCount);
+    void destroySwapchainSemaphores();
+    void collectDeferredDeletions(uint64_t completedValue);
+    vk::Semaphore createTimelineSemaphore() const;
+    void createComputeResources();
+
 public:
     explicit CommandManager(Context* context, uint32_t framesInFlight, uint32_t swapchainImageCount);
     ~CommandManager();
@@ -44,4 +82,34 @@ public:
     void endFrame(vk::CommandBuffer commandBuffer, const vk::SwapchainKHR& swapchain);
     vk::CommandBuffer getCurrentCommandBuffer() const;
     uint32_t getCurrentFrameIndex() const;
+
+    // swapchain 重建后调用（设备需空闲）：按新的图像数量重建二值信号量，时间线保持不变
+    void onSwapchainRecreated(uint32_t swapchainImageCount);
+
+    // --- 时间线 ---
+    // GPU 已完成的时间线值（不阻塞，可每帧轮询）
+    uint64_t gpuCompletedValue() const;
+    // 阻塞等待 GPU 完成到 value，超时返回 false
+    bool waitForValue(uint64_t value, uint64_t timeoutNs = UINT64_MAX) const;
+    // 当前正在录制的帧提交后会 signal 的值（beginFrame 与 endFrame 之间有效）
+    uint64_t getCurrentFrameValue() const { return m_submittedValue + 1; }
+    uint64_t getSubmittedValue() const { return m_submittedValue; }
+    vk::Semaphore getTimelineSemaphore() const { return m_timeline; }
+
+    // 让下一次图形提交在 stage 阶段等待 semaphore 达到 value（上传、异步计算等）
+    void addWaitSemaphore(vk::Semaphore semaphore, uint64_t value, vk::PipelineStageFlags2 stage);
+    // 当前帧完成后再执行 deleter（销毁仍可能被在途帧使用的资源）
+    void deferDestroy(std::function<void()> deleter);
+
+    double getCpuWaitMs() const { return m_cpuWaitMs; }
+
+    // --- 异步计算 ---
+    bool isAsyncComputeAvailable() const { return m_asyncComputeAvailable; }
+    // 取得当前帧槽位的计算命令缓冲并开始录制
+    vk::CommandBuffer beginComputeCommands();
+    // 结束录制并提交到计算队列；下一次图形提交会在 graphicsWaitStage 等待本次计算完成。
+    // waitForGraphics: 计算 pass 与上一帧图形共享资源时，先等待上一帧的图形提交
+    uint64_t submitCompute(vk::CommandBuffer commandBuffer, vk::PipelineStageFlags2 graphicsWaitStage, bool waitForGraphics);
+    uint64_t computeCompletedValue() const;
+    vk::Semaphore getComputeTimelineSemaphore() const { return m_computeTimeline; }
 };
@@ -6,6 +6,13 @@
 #include <optional>
 #include <unordered_set>
 #include "Core/Window.h"
+#include "Core/MemoryTracker.h"
+#include "Core/UploadEngine.h"
+#include "Core/JobSystem.h"
+#include "Core/GeometryArena.h"
+#include "Core/SamplerCache.h"
+#include "Core/TextureStreamer.h"
+#include "Core/MipGenerator.h"
 #include "3rd/vk_mem_alloc.h"  // 只包含头文件，不定义实现
 
 struct GLFWwindow; // 前向声明
@@ -19,6 +26,15 @@ struct QueueFamilyIndices {
         return graphicsFamily.has_value() && presentFamily.has_value();
     }
 };
+// 设备上实际启用的可选特性
+struct DeviceFeatureSupport {
+    bool synchronization2 = false;      // vkCmdPipelineBarrier2 / vkQueueSubmit2 (1.3)
+    bool timelineSemaphore = false;     // 时间线信号量 (1.2)
+    bool multiDrawIndirect = false;     // 间接绘制 drawCount > 1（GPU 簇剔除）
+    bool drawIndirectCount = false;     // vkCmdDrawIndexedIndirectCount (1.2)，绘制数由 GPU 写入
+    bool meshShader = false;            // VK_EXT_mesh_shader 的 task + mesh 着色器（网格簇的另一条几何路径）
+    bool textureCompressionBC = false;  // BC1-BC7 块压缩纹理（不支持时纹理回退到 RGBA8）
+};
 class Context {
 private:
     bool m_enableValidationLayers = true;
@@ -37,11 +53,21 @@ private:
     vk::CommandPool m_graphicsCommandPool;
 
     VmaAllocator m_vmaAllocator;            
+    std::unique_ptr<MemoryTracker> m_memoryTracker; // 按名字/分类追踪 VMA 分配
+    bool m_memoryBudgetSupported = false;   // 是否启用了 VK_EXT_memory_budget
+    DeviceFeatureSupport m_features;        // 创建设备时启用的 1.2 / 1.3 特性
+    std::unique_ptr<UploadEngine> m_uploadEngine;   // 传输队列上的批量异步上传
+    std::unique_ptr<JobSystem> m_jobSystem;         // 资源导入等 CPU 任务的工作线程池
+    std::unique_ptr<GeometryArena> m_geometryArena; // 所有网格共享的顶点 / 索引缓冲
+    std::unique_ptr<SamplerCache> m_samplerCache;   // 按创建参数共享的采样器
+    std::unique_ptr<TextureStreamer> m_textureStreamer; // 流式纹理的常驻级别与显存预算
+    std::unique_ptr<MipGenerator> m_mipGenerator;   // 计算着色器单次派发生成 mip（异步计算队列）
 
     QueueFamilyIndices m_queuefamily;       // 选择的队列族索引
 
     VkDebugUtilsMessengerEXT m_debugMessenger;
     PFN_vkDestroyDebugUtilsMessengerEXT pfnDestroyDebugUtilsMessengerEXT = nullptr;
+    PFN_vkCmdDrawMeshTasksEXT pfnCmdDrawMeshTasksEXT = nullptr;    // 扩展函数，启用 meshShader 时加载
 
     const std::vector<const char*> m_validationLayers = {"VK_LAYER_KHRONOS_validation"};
     const std::vector<const char*> m_deviceExtensions = {"VK_KHR_swapchain"};               // 必要的扩展
@@ -53,9 +79,20 @@ private:
     void createVmaAllocator();
     void createCommandPool();
     bool checkValidationLayerSupport();
+    bool checkDeviceExtensionSupport(const char* extensionName) const;
 public:
     ~Context(){
-        // 1. 销毁 VMA 分配器
+        // 0. 先停止工作线程；上传引擎依赖临时命令池、VMA 与追踪器，随后销毁（会等待在途的上传完成）
+        //    几何体缓冲可能被未提交的上传批次引用，在上传引擎之后销毁；mip 生成器等待在途的生成，先于采样器缓存销毁
+        m_jobSystem.reset();
+        m_uploadEngine.reset();
+        m_mipGenerator.reset();
+        m_geometryArena.reset();
+        m_samplerCache.reset();
+        m_textureStreamer.reset();
+
+        // 1. 销毁 VMA 分配器（追踪器先于分配器销毁）
+        m_memoryTracker.reset();
         if (m_vmaAllocator != VK_NULL_HANDLE) {
             vmaDestroyAllocator(m_vmaAllocator);
             m_vmaAllocator = VK_NULL_HANDLE;
@@ -110,6 +147,19 @@ public:
     vk::SurfaceKHR getSurface() const { return m_surface;}
     vk::PhysicalDevice getPhysicalDevice() const { return m_phyDevice; }
     const VmaAllocator& getVmaAllocator() const { return m_vmaAllocator; }
+    MemoryTracker* getMemoryTracker() const { return m_memoryTracker.get(); }
+    bool isMemoryBudgetSupported() const { return m_memoryBudgetSupported; }
+    const DeviceFeatureSupport& getFeatures() const { return m_features; }
+    UploadEngine* getUploadEngine() const { return m_uploadEngine.get(); }
+    JobSystem* getJobSystem() const { return m_jobSystem.get(); }
+    GeometryArena* getGeometryArena() const { return m_geometryArena.get(); }
+    SamplerCache* getSamplerCache() const { return m_samplerCache.get(); }
+    TextureStreamer* getTextureStreamer() const { return m_textureStreamer.get(); }
+    MipGenerator* getMipGenerator() const { return m_mipGenerator.get(); }
+    // vkCmdDrawMeshTasksEXT（只在 getFeatures().meshShader 时可用）
+    void drawMeshTasks(vk::CommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) const {
+        pfnCmdDrawMeshTasksEXT(static_cast<VkCommandBuffer>(commandBuffer), groupCountX, groupCountY, groupCountZ);
+    }
 
     vk::Queue getComputeQueue() const { return m_computeQueue;}
     vk::Queue getPresentQueue() const { return m_presentQueue;}
@@ -122,5 +172,7 @@ public:
     uint32_t getPresentQueueFamily() const { return m_queuefamily.presentFamily.value();}
     uint32_t getGraphicsQueueFamily() const { return m_queuefamily.graphicsFamily.value();}
     uint32_t getComputeQueueFamily() const { return m_queuefamily.computeFamily.value();}
+    bool hasComputeQueue() const { return m_queuefamily.computeFamily.has_value(); }
     uint32_t getTransferQueueFamily() const { return m_queuefamily.transferFamily.value();}
+    bool hasTransferQueue() const { return m_queuefamily.transferFamily.has_value(); }
 };
\ No newline at end of file
@@ -26,14 +26,16 @@ template<>
 struct DescriptorTraits<CameraUBO> {
     static constexpr bool IsValid = true;
     static constexpr vk::DescriptorType Type = vk::DescriptorType::eUniformBuffer;
-    static constexpr vk::ShaderStageFlags Stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+    // 网格着色器路径中 task（视锥）与 mesh（变换）阶段也读取；设备不支持时创建布局时去掉
+    static constexpr vk::ShaderStageFlags Stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment
+                                                 | vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT;
 };
 
 template<>
 struct DescriptorTraits<TransformUBO> {
     static constexpr bool IsValid = true;
     static constexpr vk::DescriptorType Type = vk::DescriptorType::eUniformBuffer;
-    static constexpr vk::ShaderStageFlags Stages = vk::ShaderStageFlagBits::eVertex;
+    static constexpr vk::ShaderStageFlags Stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eMeshEXT;
 };
 
 template<>
@@ -72,8 +74,14 @@ private:
     vk::DescriptorPool m_descriptorPool;
     std::unordered_map<uint32_t, vk::DescriptorSetLayout> m_layouts;
     std::unordered_map<uint32_t, std::vector<vk::DescriptorSet>> m_sets;
+    std::unordered_map<uint32_t, uint32_t> m_copies;       // 每个实例的副本数，未设置时为 1
+
+    uint32_t getCopies(uint32_t setIndex) const;
+    vk::DescriptorSet& setAt(uint32_t setIndex, uint32_t instance, uint32_t copy);
 
 public:
+    static constexpr uint32_t kAllCopies = UINT32_MAX;
+
     explicit DescriptorManager(Context* context);
     ~DescriptorManager();
 
@@ -86,24 +94,28 @@ public:
     template<typename... Types>
     void createLayout(uint32_t setIndex, uint32_t bindStart = 0);
 
+    // 在 createPool 之前调用：该 set 的每个实例分配 copies 份（每个 frame in flight 一份），
+    // 这样某一帧只重写自己的副本，不必等待仍在使用其他副本的帧
+    void setCopiesPerInstance(uint32_t setIndex, uint32_t copies);
     void createPool(const std::unordered_map<uint32_t, uint32_t>& setCapacity);
     void allocateAllSets(const std::unordered_map<uint32_t, uint32_t>& setCapacity);
     vk::DescriptorSetLayout getLayout(uint32_t setIndex) const;
-    vk::DescriptorSet getSet(uint32_t setIndex, uint32_t instanceIndex) const;
+    vk::DescriptorSet getSet(uint32_t setIndex, uint32_t instanceIndex, uint32_t copy = 0) const;
 
     void bindBufferToSet(uint32_t layoutIdx,
                         uint32_t setInstance,
                         uint32_t binding,
                         vk::Buffer buffer,
-                        vk::DeviceSize size);
+                        vk::DeviceSize size);       // 写入该实例的所有副本
 
     void bindImageToSet(uint32_t layoutIdx,
                        uint32_t setInstance,
                        uint32_t binding,
                        vk::ImageView imageView,
-                       vk::Sampler sampler);
+                       vk::Sampler sampler,
+                       uint32_t copy = kAllCopies);
 
-    vk::DescriptorSet getDescriptorSet(uint32_t setIndex, uint32_t index) const;
+    vk::DescriptorSet getDescriptorSet(uint32_t setIndex, uint32_t index, uint32_t copy = 0) const;
 
     std::vector<vk::DescriptorSetLayout> getAllDescriptorSetLayouts() const;
 };
\ No newline at end of file
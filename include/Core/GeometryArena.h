@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+#include "3rd/vk_mem_alloc.h"
+
+class Context;          // 前向声明（Context 持有 GeometryArena）
+class CommandManager;
+
+// 网格在共享缓冲中的区间（单位为顶点 / 索引个数，可直接传给 drawIndexed）
+struct GeometryRange {
+    int32_t vertexOffset = 0;           // 以该网格自身的顶点步长计
+    uint32_t vertexCount = 0;
+    uint32_t vertexStride = 0;
+    uint32_t firstIndex = 0;            // 以该网格自身的索引类型计（索引缓冲总是从 0 偏移绑定）
+    uint32_t indexCount = 0;
+    vk::IndexType indexType = vk::IndexType::eUint32;
+};
+
+struct GeometryArenaStats {
+    uint32_t meshCount = 0;
+    uint64_t vertexBytesCapacity = 0;
+    uint64_t vertexBytesUsed = 0;
+    uint64_t indexBytesCapacity = 0;
+    uint64_t indexBytesUsed = 0;
+    uint32_t meshes16BitIndices = 0;    // 使用 16 位索引的网格数
+    float fragmentation = 0.0f;         // 1 - 最大空闲区间 / 空闲总量（顶点与索引取较大者）
+    uint64_t relocations = 0;           // 扩容 + 碎片整理的次数
+};
+
+// 几何体竞技场：所有网格的顶点 / 索引子分配在两块设备本地的大缓冲里，
+// 区间由 VMA virtual block（TLSF）管理，每帧只需绑定一次顶点缓冲与索引缓冲。
+// 顶点块以 kVertexUnit 字节为单位，按顶点步长对齐，不同顶点格式的网格可以共存在同一缓冲里；
+// 索引块以 kIndexUnit（2 字节）为单位，16 / 32 位索引的网格共存，绘制时索引类型变化才重新绑定索引缓冲。
+// 空间不足时扩容、碎片超过阈值时整理：两者都把存活区间紧凑地拷贝到新缓冲，
+// 拷贝录制进 UploadEngine 的批次，旧缓冲在使用它的帧完成后销毁。
+// 缓冲以 CONCURRENT 共享模式创建，传输队列写入时不需要所有权转移
+class GeometryArena {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = UINT32_MAX;
+
+private:
+    struct Slot {
+        VmaVirtualAllocation vertexAllocation = VK_NULL_HANDLE;
+        VmaVirtualAllocation indexAllocation = VK_NULL_HANDLE;
+        GeometryRange range;
+        bool live = false;
+    };
+
+    struct Storage {
+        vk::Buffer vertexBuffer;
+        vk::Buffer indexBuffer;
+        VmaAllocation vertexAllocation = VK_NULL_HANDLE;
+        VmaAllocation indexAllocation = VK_NULL_HANDLE;
+        VmaVirtualBlock vertexBlock = VK_NULL_HANDLE;
+        VmaVirtualBlock indexBlock = VK_NULL_HANDLE;
+        uint32_t vertexCapacity = 0;
+        uint32_t indexCapacity = 0;
+    };
+
+    Context* m_context;
+    Storage m_storage;
+    std::vector<Slot> m_slots;
+    std::vector<Handle> m_freeSlots;
+    std::vector<Storage> m_retired;          // 已被替换、等待在途帧完成后销毁
+    float m_defragThreshold = 0.5f;
+    bool m_fragmentationDirty = false;       // 释放过区间后才需要重新统计碎片
+    uint64_t m_relocations = 0;
+
+    Storage createStorage(uint32_t vertexCapacity, uint32_t indexCapacity) const;
+    void destroyStorage(Storage& storage) const;
+    bool tryAllocate(Storage& storage, uint32_t vertexCount, uint32_t vertexStride,
+                     uint32_t indexCount, vk::IndexType indexType, Slot& slot) const;
+    // 把所有存活区间按原顺序紧凑拷贝到新容量的缓冲
+    void relocate(uint32_t vertexCapacity, uint32_t indexCapacity);
+    float calculateFragmentation() const;
+
+public:
+    static constexpr uint32_t kVertexUnit = 16;                      // 顶点步长必须是它的 2 的幂倍
+    static constexpr uint32_t kDefaultVertexCapacity = 2u << 20;     // 单位个数（32 MB）
+    static constexpr uint32_t kIndexUnit = 2;                        // 16 位索引占 1 个单位，32 位索引占 2 个
+    static constexpr uint32_t kDefaultIndexCapacity = 6u << 20;      // 单位个数（12 MB）
+
+    explicit GeometryArena(Context* context,
+                           uint32_t vertexCapacity = kDefaultVertexCapacity,
+                           uint32_t indexCapacity = kDefaultIndexCapacity);
+    ~GeometryArena();
+
+    // 禁止拷贝和移动
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+    GeometryArena(GeometryArena&&) = delete;
+    GeometryArena& operator=(GeometryArena&&) = delete;
+
+    // 分配区间并把数据录制进上传引擎的当前批次（必须在主线程调用）
+    // indices 的元素类型由 indexType 决定（uint16_t / uint32_t）
+    Handle allocate(const void* vertices, uint32_t vertexCount, uint32_t vertexStride,
+                    const void* indices, uint32_t indexCount, vk::IndexType indexType = vk::IndexType::eUint32);
+    // 释放区间：调用方保证没有在途帧仍在读取（Mesh 由 deferDestroy 延迟析构）
+    void free(Handle handle);
+
+    // 每帧在录制上传收尾之前调用：碎片超过阈值时整理，并把被替换的旧缓冲交给时间线延迟销毁
+    void update(CommandManager* commands);
+    // 在命令缓冲上一次性绑定顶点与索引缓冲
+    void bind(vk::CommandBuffer commandBuffer, vk::IndexType indexType = vk::IndexType::eUint32) const;
+    // 只切换索引类型（同一缓冲按另一种类型重新绑定）
+    void bindIndices(vk::CommandBuffer commandBuffer, vk::IndexType indexType) const;
+
+    // 整理会移动区间，绘制时需按句柄重新查询
+    const GeometryRange& getRange(Handle handle) const { return m_slots.at(handle).range; }
+    vk::Buffer getVertexBuffer() const { return m_storage.vertexBuffer; }
+    vk::Buffer getIndexBuffer() const { return m_storage.indexBuffer; }
+    void setDefragThreshold(float threshold) { m_defragThreshold = threshold; }
+    GeometryArenaStats getStats() const;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+// 固定大小的工作线程池：用于文件读取、OBJ 解析、图像解码等纯 CPU 任务。
+// 任务内不要录制 Vulkan 命令（UploadEngine 只在主线程使用）
+class JobSystem {
+private:
+    std::vector<std::jthread> m_workers;
+    std::deque<std::function<void()>> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+
+    void workerLoop(std::stop_token stopToken);
+    void enqueue(std::function<void()> job);
+
+public:
+    // threadCount = 0 时使用 hardware_concurrency - 1（主线程负责提交与上传）
+    explicit JobSystem(uint32_t threadCount = 0);
+    ~JobSystem();
+
+    // 禁止拷贝和移动
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    // 提交任务，异常通过 future 传回调用线程
+    template<typename F>
+    auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+        std::future<Result> future = task->get_future();
+        this->enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    // 把 [0, count) 分给工作线程与调用线程并行执行，阻塞到全部完成，第一个异常在调用线程重新抛出。
+    // 调用线程自己也领取任务，只等待已经开始执行的部分，因此可以在任务内部嵌套调用而不会死锁
+    void parallelFor(size_t count, std::function<void(size_t)> body);
+
+    uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "3rd/vk_mem_alloc.h"
+
+// 显存分配的分类，用于统计各类资源的占用
+enum class MemoryCategory : uint8_t {
+    Mesh,
+    Texture,
+    UniformBuffer,
+    RenderTarget,
+    Staging,
+    Other,
+    Count
+};
+
+const char* toString(MemoryCategory category);
+
+// 一条被追踪的 VMA 分配
+struct TrackedAllocation {
+    std::string name;
+    MemoryCategory category = MemoryCategory::Other;
+    VkDeviceSize size = 0;
+    uint32_t memoryType = 0;
+};
+
+// 单个内存堆的使用量与预算（来自 VK_EXT_memory_budget）
+struct HeapBudget {
+    uint32_t heapIndex = 0;
+    bool deviceLocal = false;
+    VkDeviceSize heapSize = 0;
+    VkDeviceSize usage = 0;             // 系统报告的当前进程用量
+    VkDeviceSize budget = 0;            // 系统报告的可用预算
+    VkDeviceSize blockBytes = 0;        // VMA 从驱动申请的 VkDeviceMemory 总量
+    VkDeviceSize allocationBytes = 0;   // VMA 子分配实际使用的字节数
+};
+
+using CategoryTotals = std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)>;
+
+// 追踪每个 Mesh / Texture / Renderer 资源的 VMA 分配，
+// 提供堆预算、分类统计、Top-N 大分配以及 vmaBuildStatsString 的 JSON 导出
+class MemoryTracker {
+private:
+    VmaAllocator m_allocator;
+    mutable std::mutex m_mutex;
+    std::unordered_map<VmaAllocation, TrackedAllocation> m_allocations;
+
+    // ImGui 面板状态
+    int m_topCount = 10;
+    std::string m_lastDumpPath;
+
+public:
+    explicit MemoryTracker(VmaAllocator allocator);
+    ~MemoryTracker() = default;
+
+    // 禁止拷贝和移动
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+    MemoryTracker(MemoryTracker&&) = delete;
+    MemoryTracker& operator=(MemoryTracker&&) = delete;
+
+    // 给分配打上名字和分类（同时写入 VMA 的 allocation name，JSON 导出中可见）
+    void track(VmaAllocation allocation, const std::string& name, MemoryCategory category);
+    // 销毁分配前调用
+    void untrack(VmaAllocation allocation);
+
+    std::vector<HeapBudget> getHeapBudgets() const;
+    CategoryTotals getCategoryTotals() const;
+    std::vector<TrackedAllocation> getLargestAllocations(size_t count) const;
+    size_t getTrackedCount() const;
+
+    // vmaBuildStatsString 输出（JSON 格式）
+    std::string buildStatsJson(bool detailed = true) const;
+    void dumpStatsJson(const std::string& path) const;
+
+    // 实时显存面板（在 ImGui::NewFrame 与 ImGui::Render 之间调用）
+    void drawImGuiPanel();
+};
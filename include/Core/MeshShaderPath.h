@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.hpp>
+#include "Core/Context.h"
+#include "Core/ClusterCuller.h"
+
+class Scene;
+class Renderable;
+
+struct MeshShaderStats {
+    uint32_t meshes = 0;                // 走网格着色器路径的 Renderable 数
+    uint32_t meshletsSubmitted = 0;     // task 着色器测试的簇数
+    uint64_t trianglesSubmitted = 0;
+};
+
+// 网格着色器几何路径（VK_EXT_mesh_shader）：带 meshlet 局部数据的网格不经过顶点输入与索引缓冲，
+// meshlet.task 逐簇剔除（与 ClusterCuller 相同的包围球 / 法线锥测试），meshlet.mesh 从竞技场的顶点缓冲
+// 读取并解码顶点、输出簇的三角形，片段着色器与主管线共用 pbr.frag。
+// 设备不支持、着色器缺失或网格没有局部数据时，主通道回退到顶点输入路径（drawIndexed / 间接绘制）
+class MeshShaderPath {
+private:
+    // 与 meshlet.task / meshlet.mesh 的 push constant 块一致
+    struct MeshParams {
+        glm::mat4 model;
+        glm::vec4 cameraPosition;       // xyz: 模型空间相机位置，w: 模型矩阵最大轴缩放
+        uint32_t meshletCount = 0;      // 所选 LOD 级别的簇数
+        uint32_t vertexBase = 0;        // 网格第一个顶点在顶点缓冲绑定中的位置（32 位字）
+        uint32_t flags = 0;
+        uint32_t firstMeshlet = 0;      // 所选 LOD 级别的第一个簇
+    };
+
+    struct DrawData {
+        vk::DescriptorSet set;          // set 2：meshlet / 局部数据 / 顶点缓冲
+        MeshParams params;
+    };
+
+    // 每个 frame in flight 一份描述符池：beginFrame 返回时该槽位上一次的提交已完成，可以直接重置
+    struct FrameResources {
+        vk::DescriptorPool pool;
+        uint32_t poolCapacity = 0;
+    };
+
+    Context* m_context;
+    vk::DescriptorSetLayout m_setLayout;
+    vk::PipelineLayout m_pipelineLayout;
+    vk::Pipeline m_pipeline;
+    std::vector<FrameResources> m_frames;
+    vk::DeviceSize m_storageAlignment = 1;      // minStorageBufferOffsetAlignment
+    vk::DeviceSize m_maxStorageRange = 0;       // maxStorageBufferRange
+
+    bool m_enabled = true;
+    MeshShaderStats m_stats;
+    std::unordered_map<uint32_t, DrawData> m_draws;     // objectIndex -> 本帧的绘制参数
+
+    void createPipeline(const std::vector<vk::DescriptorSetLayout>& sceneLayouts, vk::RenderPass renderPass,
+                        const std::string& taskPath, const std::string& meshPath, const std::string& fragmentPath);
+
+public:
+    // sceneLayouts: 主管线的 set 0 / set 1 布局（网格着色器路径的 set 2 追加在其后）
+    MeshShaderPath(Context* context, uint32_t framesInFlight,
+                   const std::vector<vk::DescriptorSetLayout>& sceneLayouts, vk::RenderPass renderPass,
+                   const std::string& taskPath = "shaders/meshlet.task.spv",
+                   const std::string& meshPath = "shaders/meshlet.mesh.spv",
+                   const std::string& fragmentPath = "shaders/pbr.frag.spv");
+    ~MeshShaderPath();
+
+    // 禁止拷贝和移动
+    MeshShaderPath(const MeshShaderPath&) = delete;
+    MeshShaderPath& operator=(const MeshShaderPath&) = delete;
+    MeshShaderPath(MeshShaderPath&&) = delete;
+    MeshShaderPath& operator=(MeshShaderPath&&) = delete;
+
+    bool isSupported() const { return m_pipeline && m_context->getFeatures().meshShader; }
+    bool isEnabled() const { return m_enabled && this->isSupported(); }
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    const MeshShaderStats& getStats() const { return m_stats; }
+
+    // 每帧在主通道之前调用（CommandManager::beginFrame 之后，GeometryArena::update 之后）：
+    // 为带局部数据的 Renderable 写 set 2 并准备 push constant（按 Renderable 当前的 LOD 级别取簇区间）；
+    // 剔除开关与簇剔除共用
+    void prepare(const Scene& scene, uint32_t frameIndex, const glm::vec3& cameraPosition, const ClusterCullSettings& settings);
+    // 在主通道中录制该 Renderable；返回 false 时调用方按顶点输入路径绘制
+    bool draw(vk::CommandBuffer commandBuffer, vk::DescriptorSet frameSet, vk::DescriptorSet objectSet, const Renderable& renderable) const;
+};
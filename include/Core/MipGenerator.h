@@ -0,0 +1,125 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+#include "3rd/vk_mem_alloc.h"
+
+class Context; // 前向声明（Context 持有 MipGenerator）
+
+// 一张需要生成 mip 的图像：mip 0 已写入，全部级别处于 General 布局
+// （由上传侧转换，或随 srcQueueFamily 的所有权转移一起转换）
+struct MipJob {
+    vk::Image image;
+    vk::Format format = vk::Format::eUndefined;
+    vk::Extent2D extent{};
+    uint32_t mipLevels = 1;
+    vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    vk::PipelineStageFlags2 dstStage = vk::PipelineStageFlagBits2::eFragmentShader;   // 首次使用的阶段
+    uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED;     // 不同于生成队列族时先 acquire
+};
+
+struct MipGeneratorStats {
+    uint64_t images = 0;
+    uint64_t levels = 0;
+    uint64_t submissions = 0;
+};
+
+// 4K 纹理上 blit 链与单次派发的 GPU 耗时对比（图形队列上的时间戳）
+struct MipBenchmarkResult {
+    uint32_t size = 0;
+    uint32_t mipLevels = 0;
+    uint32_t iterations = 0;
+    double blitMs = 0.0;            // 每次的平均值
+    double computeMs = 0.0;
+    uint32_t blitCommands = 0;      // 每次录制的 blit + 屏障数
+    uint32_t computeCommands = 0;   // 每次录制的派发 + 屏障数
+};
+
+// 计算着色器 mip 生成（shaders/spd_downsample.comp，参考 AMD FidelityFX SPD）：一次派发生成整条 mip 链，
+// 代替逐级 blit + 两个屏障；sRGB 图像在线性空间平均后编码回 sRGB，不依赖格式的线性 blit 支持。
+//  - 有独立计算队列族时在异步计算队列上提交（等待上传时间线，完成后把图像 release 给图形队列族），
+//    否则提交到图形队列；图形帧等待 getTimelineSemaphore() 上的值
+//  - 只支持 RGBA8（UNORM / SRGB）且边长不超过 kMaxSize 的图像（单次派发最多 12 级），其余仍由 UploadEngine blit
+//  - 图像需以 getImageUsage / getImageCreateFlags 创建：sRGB 图像通过 UNORM 存储视图写入
+//  - 目前唯一的调用方是 UploadEngine：运行时由 CPU 像素创建的纹理（未压缩导入、glTF 内嵌图片、
+//    运行时生成的 ImageData）上传 mip 0 后在这里生成其余级别。块压缩 / KTX2 / .vtex 自带 mip 链不经过这里；
+//    渲染器没有需要 mip 的 GPU 渲染结果（渲染目标只有 1 级），这类图像要接入时写完 mip 0 后转换到 General 直接调用 submit
+// 只在主线程调用
+class MipGenerator {
+private:
+    // 一次提交占用的资源，生成时间线完成后释放
+    struct Submission {
+        uint64_t value = 0;
+        vk::CommandBuffer commandBuffer;
+        vk::DescriptorPool pool;
+        std::vector<vk::ImageView> views;
+    };
+
+    Context* m_context;
+    vk::Queue m_queue;
+    uint32_t m_queueFamily = 0;
+    bool m_async = false;                       // 在独立的计算队列族上生成
+    bool m_available = false;
+    bool m_srgbStorage = false;                 // sRGB 图像可以带 STORAGE 用途创建（EXTENDED_USAGE）
+
+    vk::DescriptorSetLayout m_setLayout;
+    vk::PipelineLayout m_pipelineLayout;
+    vk::Pipeline m_pipeline;
+    vk::Sampler m_sampler;                      // 最近点采样器，归 SamplerCache 所有（texelFetch 不使用过滤）
+    vk::CommandPool m_commandPool;
+
+    // 每次派发一个原子计数，提交开头清零
+    vk::Buffer m_counterBuffer;
+    VmaAllocation m_counterAllocation = VK_NULL_HANDLE;
+
+    vk::Semaphore m_timeline;
+    uint64_t m_submittedValue = 0;
+    std::deque<Submission> m_inFlight;
+    MipGeneratorStats m_stats;
+    MipBenchmarkResult m_benchmark;
+
+    void createPipeline(const std::string& shaderPath);
+    void retireSubmissions(uint64_t completedValue);
+    vk::DescriptorPool createDescriptorPool(uint32_t jobCount) const;
+    void resetCounters(vk::CommandBuffer commandBuffer) const;
+    // 创建视图与描述符集并录制一次派发（前后屏障由调用方负责）
+    void recordDispatch(vk::CommandBuffer commandBuffer, const MipJob& job, vk::DescriptorPool pool,
+                        uint32_t counterIndex, std::vector<vk::ImageView>& views) const;
+
+public:
+    static constexpr uint32_t kMaxSize = 4096;          // 第 6 级不超过 64x64，最后一个工作组可以一次处理完
+    static constexpr uint32_t kMaxJobsPerBatch = 256;   // 计数缓冲的大小，超过时清零后复用
+
+    explicit MipGenerator(Context* context, const std::string& shaderPath = "shaders/spd_downsample.comp.spv");
+    ~MipGenerator();
+
+    // 禁止拷贝和移动
+    MipGenerator(const MipGenerator&) = delete;
+    MipGenerator& operator=(const MipGenerator&) = delete;
+    MipGenerator(MipGenerator&&) = delete;
+    MipGenerator& operator=(MipGenerator&&) = delete;
+
+    bool isAvailable() const { return m_available; }
+    bool supports(vk::Format format, uint32_t width, uint32_t height, uint32_t mipLevels) const;
+    static vk::ImageUsageFlags getImageUsage() { return vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled; }
+    static vk::ImageCreateFlags getImageCreateFlags(vk::Format format);
+
+    // 生成所在的队列族（异步时为计算队列族）；上传侧把图像 release 到这里
+    uint32_t getQueueFamily() const { return m_queueFamily; }
+    bool usesAsyncCompute() const { return m_async; }
+
+    // 提交一批生成：等待 waitSemaphore 达到 waitValue（上传时间线），返回本次 signal 的生成时间线值。
+    // 结束时全部级别转换到 finalLayout；在计算队列族上生成时同时 release 给图形队列族，
+    // 图形侧需要以相同布局 acquire（见 UploadEngine::recordGraphicsWork）
+    uint64_t submit(const std::vector<MipJob>& jobs, vk::Semaphore waitSemaphore, uint64_t waitValue);
+    vk::Semaphore getTimelineSemaphore() const { return m_timeline; }
+    uint64_t completedValue() const;
+
+    // 在图形队列上分别用 blit 链与单次派发为 size x size 的 sRGB RGBA8 图像生成 mip，比较 GPU 耗时（阻塞，调试用）
+    MipBenchmarkResult benchmark(uint32_t size = kMaxSize, uint32_t iterations = 8);
+    const MipBenchmarkResult& getLastBenchmark() const { return m_benchmark; }
+    const MipGeneratorStats& getStats() const { return m_stats; }
+};
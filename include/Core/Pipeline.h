@@ -5,6 +5,7 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <array>
 
 #include "Assets/Mesh.h"
 #include "Core/Context.h"
@@ -21,10 +22,12 @@ enum class PipelineType {
 class PipelineManager {
 private:
     Context* m_context;
-    std::unordered_map<PipelineType, vk::Pipeline> m_pipelines;
+    // 每种管线按顶点格式各有一个变体，共享同一个 pipeline layout
+    std::unordered_map<PipelineType, std::array<vk::Pipeline, 2>> m_pipelines;
     std::unordered_map<PipelineType, vk::PipelineLayout> m_pipelinelayout;
-    vk::ShaderModule createShaderModule(const std::string& filepath);
 public:
+    // 读取 .spv 创建着色器模块（计算管线等不经过 PipelineManager 的调用方也使用）
+    static vk::ShaderModule createShaderModule(Context* context, const std::string& filepath);
     explicit PipelineManager(Context* context);
     ~PipelineManager();
 
@@ -41,8 +44,9 @@ public:
         vk::Extent2D swapchainExtent,
         vk::Format swapchainFormat,
         vk::RenderPass renderPass,
-        std::vector<vk::DescriptorSetLayout> setLayouts);
+        std::vector<vk::DescriptorSetLayout> setLayouts,
+        VertexFormat vertexFormat = VertexFormat::Standard);
 
     vk::PipelineLayout getPipelineLayout(PipelineType type);
-    vk::Pipeline getPipeline(PipelineType type);
+    vk::Pipeline getPipeline(PipelineType type, VertexFormat vertexFormat = VertexFormat::Standard);
 };
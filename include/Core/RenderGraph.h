@@ -0,0 +1,217 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <vulkan/vulkan.hpp>
+#include "Core/Context.h"
+#include "Core/RenderTargetPool.h"
+
+// 帧图（Frame Graph）：pass 声明读写的资源，编译时裁剪无用 pass、排序、
+// 生成最少的 vkCmdPipelineBarrier2 屏障与布局转换，并为 transient 资源分配（可别名的）内存。
+// 拓扑不变时复用上一帧的编译结果。
+
+using RGHandle = uint32_t;
+constexpr RGHandle RG_INVALID_HANDLE = UINT32_MAX;
+
+// pass 提交到的队列
+enum class RGQueue {
+    Graphics,
+    AsyncCompute    // 异步计算队列（不可用或被关闭时回退到图形队列）
+};
+
+enum class RGResourceType {
+    Image,
+    Buffer
+};
+
+// pass 对资源的访问方式，决定 stage / access / layout
+enum class RGAccess {
+    ColorAttachmentWrite,
+    DepthAttachmentWrite,
+    DepthAttachmentRead,
+    SampledRead,            // 片段着色器采样
+    ComputeSampledRead,     // 计算着色器采样
+    StorageImageRead,
+    StorageImageWrite,
+    StorageBufferRead,
+    StorageBufferWrite,
+    VertexBufferRead,
+    IndexBufferRead,
+    IndirectBufferRead,
+    UniformBufferRead,
+    TransferSrc,
+    TransferDst
+};
+
+// 资源在某一时刻的同步状态
+struct RGState {
+    vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eNone;
+    vk::AccessFlags2 access = vk::AccessFlagBits2::eNone;
+    vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+};
+
+class RenderGraph;
+
+// 在 setup 回调中声明 pass 的资源读写
+class RenderGraphBuilder {
+private:
+    RenderGraph& m_graph;
+    uint32_t m_passIndex;
+public:
+    RenderGraphBuilder(RenderGraph& graph, uint32_t passIndex) : m_graph(graph), m_passIndex(passIndex) {}
+
+    // endLayout: pass 内部（例如 VkRenderPass 的 finalLayout）改变布局时，声明离开 pass 时的布局
+    RGHandle read(RGHandle resource, RGAccess access);
+    RGHandle write(RGHandle resource, RGAccess access, std::optional<vk::ImageLayout> endLayout = std::nullopt);
+    // 即使没有被任何输出引用也不会被裁剪（例如回读、调试输出）
+    void setSideEffect();
+    // 请求在异步计算队列上执行。依赖本帧图形 pass 输出的计算 pass 会回退到图形队列
+    void setAsyncCompute();
+};
+
+using RGExecuteFn = std::function<void(vk::CommandBuffer, const RenderGraph&)>;
+
+class RenderGraph {
+    friend class RenderGraphBuilder;
+private:
+    struct Resource {
+        std::string name;
+        RGResourceType type = RGResourceType::Image;
+        bool imported = false;
+        bool output = false;                        // 导入资源被帧外部使用（如 present），保证写它的 pass 不被裁剪
+
+        // Image
+        RenderTargetDesc desc;
+        vk::Image image;
+        vk::ImageView view;
+        vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+        std::optional<vk::ImageLayout> finalLayout; // 帧末需要转换到的布局
+
+        // Buffer
+        vk::Buffer buffer;
+        vk::DeviceSize size = 0;
+
+        RGState initialState;
+
+        // 编译结果
+        uint32_t firstUse = UINT32_MAX;
+        uint32_t lastUse = 0;
+        RenderTarget* target = nullptr;
+    };
+
+    struct AccessRecord {
+        RGHandle resource;
+        RGAccess access;
+        bool write;
+        std::optional<vk::ImageLayout> endLayout;
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<AccessRecord> accesses;
+        RGExecuteFn execute;
+        bool sideEffect = false;
+        bool culled = false;
+        RGQueue queue = RGQueue::Graphics;      // 请求的队列
+    };
+
+    struct Barrier {
+        RGHandle resource;
+        RGState src;
+        RGState dst;
+        uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED;  // 队列族所有权转移时有效
+        uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+    };
+
+    struct CompiledPass {
+        uint32_t passIndex;
+        RGQueue queue;                  // 实际执行的队列
+        std::vector<Barrier> barriers;  // 执行该 pass 前需要的屏障
+    };
+
+    Context* m_context;
+    RenderTargetPool* m_pool;
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+
+    // 编译缓存
+    size_t m_compiledHash = 0;
+    bool m_compiled = false;
+    std::vector<CompiledPass> m_schedule;
+    std::vector<Barrier> m_finalBarriers;
+    std::vector<Barrier> m_computeReleaseBarriers;          // 计算队列末尾的所有权释放屏障
+
+    // 异步计算
+    bool m_asyncComputeEnabled = false;
+    vk::PipelineStageFlags2 m_graphicsWaitStage{};          // 图形提交等待计算时间线的阶段
+    bool m_computeWaitsForGraphics = false;                 // 计算 pass 使用了与上一帧图形共享的 transient 资源
+    std::vector<std::pair<uint32_t, uint32_t>> m_edges;   // pass 依赖边（用于 GraphViz）
+    std::vector<bool> m_culledPasses;
+    std::vector<std::pair<uint32_t, uint32_t>> m_lifetimes;  // 每个资源的 [firstUse, lastUse]
+    std::vector<RenderTarget*> m_transientTargets;        // 按资源句柄索引，导入资源或未使用的资源为空
+
+    size_t computeTopologyHash() const;
+    void cullPasses();
+    std::vector<uint32_t> sortPasses();
+    std::vector<RGQueue> assignQueues(const std::vector<uint32_t>& order) const;
+    void computeLifetimes(const std::vector<uint32_t>& order);
+    void allocateTransients();
+    void buildBarriers(const std::vector<uint32_t>& order, const std::vector<RGQueue>& queues);
+    void restoreCompiledState();
+    void bindTransients();
+    void recordBarriers(vk::CommandBuffer cmd, const std::vector<Barrier>& barriers) const;
+
+public:
+    RenderGraph(Context* context, RenderTargetPool* pool);
+    ~RenderGraph();
+
+    // 禁止拷贝和移动
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+    RenderGraph(RenderGraph&&) = delete;
+    RenderGraph& operator=(RenderGraph&&) = delete;
+
+    // 每帧开始时清空声明（编译缓存保留）
+    void reset();
+    // 释放编译缓存与 transient 资源（例如 swapchain 重建后，调用前需保证设备空闲）
+    void invalidate();
+
+    // 带 finalLayout 的导入图像视为帧输出（例如 swapchain），写它的 pass 不会被裁剪
+    RGHandle importImage(const std::string& name, vk::Image image, vk::ImageView view, const RenderTargetDesc& desc,
+                         const RGState& initialState, std::optional<vk::ImageLayout> finalLayout = std::nullopt);
+    RGHandle importBuffer(const std::string& name, vk::Buffer buffer, vk::DeviceSize size, const RGState& initialState = {});
+    RGHandle createImage(const std::string& name, const RenderTargetDesc& desc);
+
+    void addPass(const std::string& name,
+                 const std::function<void(RenderGraphBuilder&)>& setup,
+                 RGExecuteFn execute);
+
+    void compile();
+    // computeCmd 只在 hasAsyncComputeWork() 时需要；计算命令必须先于图形命令提交
+    void execute(vk::CommandBuffer cmd, vk::CommandBuffer computeCmd = nullptr);
+
+    // 需要计算队列与图形队列属于不同队列族，否则所有 pass 都在图形队列执行
+    void setAsyncComputeEnabled(bool enabled) { m_asyncComputeEnabled = enabled; }
+    bool isAsyncComputeEnabled() const { return m_asyncComputeEnabled; }
+    bool hasAsyncComputeWork() const;
+    vk::PipelineStageFlags2 getGraphicsWaitStage() const { return m_graphicsWaitStage; }
+    bool computeWaitsForGraphics() const { return m_computeWaitsForGraphics; }
+
+    // 调试：导出 GraphViz (.dot) 文件
+    void exportGraphviz(const std::string& path) const;
+
+    vk::Image getImage(RGHandle handle) const { return m_resources[handle].image; }
+    vk::ImageView getImageView(RGHandle handle) const { return m_resources[handle].view; }
+    vk::Buffer getBuffer(RGHandle handle) const { return m_resources[handle].buffer; }
+    const RenderTargetDesc& getImageDesc(RGHandle handle) const { return m_resources[handle].desc; }
+
+    size_t getPassCount() const { return m_passes.size(); }
+    size_t getCulledPassCount() const;
+    size_t getBarrierCount() const;
+    size_t getAsyncComputePassCount() const;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+#include "Core/Context.h"
+
+// 渲染目标描述：(format, extent, usage, samples) 相同的请求可以复用同一张图像
+struct RenderTargetDesc {
+    vk::Format format = vk::Format::eUndefined;
+    vk::Extent2D extent{};
+    vk::ImageUsageFlags usage{};
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+
+    bool operator==(const RenderTargetDesc& other) const {
+        return format == other.format && extent == other.extent &&
+               usage == other.usage && samples == other.samples;
+    }
+    // 从不 store 的附件（如只在本帧使用的深度）带 eTransientAttachment，可放入惰性分配内存
+    bool isTransient() const { return static_cast<bool>(usage & vk::ImageUsageFlagBits::eTransientAttachment); }
+};
+
+struct RenderTarget {
+    vk::Image image;
+    vk::ImageView view;
+    RenderTargetDesc desc;
+    std::string name;
+    VmaAllocation allocation = VK_NULL_HANDLE;  // 独立分配时有效；别名目标的内存归属于 alias slot
+    bool lazilyAllocated = false;
+    bool inUse = false;
+    uint64_t lastUsedFrame = 0;
+};
+
+// 别名请求：生命周期 [firstPass, lastPass] 不重叠的目标可以共享同一块内存
+struct AliasRequest {
+    RenderTargetDesc desc;
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+    std::string name;
+};
+
+// 渲染目标池：按描述符分发图像并跨帧回收，
+// 对生命周期不重叠的 pass 做内存别名，对不需要 store 的附件使用 LAZILY_ALLOCATED 内存
+class RenderTargetPool {
+private:
+    struct AliasSlot {
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        vk::MemoryRequirements requirements;
+        uint32_t lastPass = 0;   // 当前占用者最后使用的 pass
+    };
+
+    Context* m_context;
+    bool m_lazyMemorySupported = false;
+    uint64_t m_frame = 0;
+
+    std::vector<std::unique_ptr<RenderTarget>> m_targets;        // 独立分配的池化目标
+    std::vector<std::unique_ptr<RenderTarget>> m_aliasedTargets; // 共享 slot 内存的目标
+    std::vector<AliasSlot> m_aliasSlots;
+    std::vector<RenderTarget*> m_aliasPooledTargets;             // 别名请求中走独立分配的惰性目标
+
+    static constexpr uint64_t kMaxIdleFrames = 8;  // 空闲超过该帧数的目标会被销毁
+
+    vk::Image createImage(const RenderTargetDesc& desc) const;
+    vk::ImageView createImageView(vk::Image image, const RenderTargetDesc& desc) const;
+    std::unique_ptr<RenderTarget> createTarget(const RenderTargetDesc& desc, const std::string& name);
+    void destroyTarget(RenderTarget& target);
+
+public:
+    explicit RenderTargetPool(Context* context);
+    ~RenderTargetPool();
+
+    // 禁止拷贝和移动
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+    RenderTargetPool(RenderTargetPool&&) = delete;
+    RenderTargetPool& operator=(RenderTargetPool&&) = delete;
+
+    // 每帧调用一次：推进帧号并销毁长时间未使用的目标
+    void beginFrame();
+
+    // 取得一个匹配描述的目标（优先复用空闲目标），用完后 release 归还
+    RenderTarget* acquire(const RenderTargetDesc& desc, const std::string& name);
+    void release(RenderTarget* target);
+
+    // 按生命周期做区间着色，为一组目标分配别名内存；返回顺序与 requests 一致
+    std::vector<RenderTarget*> createAliasedTargets(const std::vector<AliasRequest>& requests);
+    void releaseAliasedTargets();
+
+    // 销毁所有空闲目标（例如 swapchain 重建后，调用前需保证设备空闲）
+    void trim();
+
+    bool isLazyMemorySupported() const { return m_lazyMemorySupported; }
+    size_t getTargetCount() const { return m_targets.size() + m_aliasedTargets.size(); }
+    size_t getAliasSlotCount() const { return m_aliasSlots.size(); }
+};
@@ -2,8 +2,11 @@
 
 #include <memory>
 #include <vector>
+#include <array>
 #include <optional>
+#include <unordered_set>
 #include <cstdint>
+#include <string>
 #include <glm/glm.hpp>
 #include "Scene/Camera.h"
 #include "Core/RenderPass.h"
@@ -14,14 +17,69 @@
 #include "Core/Descriptor.h"
 #include "Core/Command.h"
 #include "Core/ImGuiManager.h"
+#include "Core/RenderTargetPool.h"
+#include "Core/RenderGraph.h"
+#include "Core/ClusterCuller.h"
+#include "Core/MeshShaderPath.h"
 #include <vulkan/vulkan.hpp>
 
 
+// 每帧传给 RenderFeature 的帧图上下文
+struct FrameGraphContext {
+    RenderGraph& graph;
+    const Scene& scene;
+    uint32_t frameIndex;        // frame in flight 索引
+    uint32_t imageIndex;        // swapchain image 索引
+    vk::Extent2D extent;
+    RGHandle backbuffer;        // 当前 swapchain image（导入资源）
+    RGHandle depth;             // 主通道深度（transient）
+};
+
+// 可插拔的渲染特性（阴影、后处理、预处理 pass 等）：
+// 在主 pass 之前或之后向帧图追加 pass，不需要修改 Renderer::render
+class RenderFeature {
+public:
+    enum class Stage {
+        BeforeMain,
+        AfterMain
+    };
+    virtual ~RenderFeature() = default;
+    virtual Stage getStage() const { return Stage::BeforeMain; }
+    virtual void setup(FrameGraphContext& frame) = 0;
+};
+
+// 主通道几何绘制的 GPU 耗时（时间戳回读，晚 framesInFlight 帧），用于比较两条几何路径的三角形吞吐
+struct GeometryPassStats {
+    bool meshShaders = false;       // 该帧是否走网格着色器路径
+    double gpuMs = 0.0;             // 0 表示设备不支持时间戳
+    uint64_t triangles = 0;         // 提交的三角形数（剔除之前）
+};
+
+// 逐 Renderable 的 LOD 选择（CPU，每帧在剔除之前）：取投影误差不超过 maxPixelError 的最粗一级，
+// 结果同时用于顶点输入绘制、GPU 簇剔除（间接绘制）与网格着色器路径
+struct LodSettings {
+    bool enabled = true;
+    float maxPixelError = 1.0f;     // 允许的屏幕空间误差（像素）
+    float hysteresis = 0.25f;       // 切换到更粗的级别时误差还要再低这个比例，避免在阈值附近来回切换
+    int forcedLevel = -1;           // >= 0 时所有网格固定使用该级别（超出时取最粗一级），调试用
+};
+
+struct LodStats {
+    uint32_t meshesWithLods = 0;    // 有 1 级以上 LOD 的 Renderable
+    uint32_t meshesReduced = 0;     // 本帧没有使用 0 级的 Renderable
+    uint32_t switches = 0;          // 本帧级别发生变化的 Renderable
+    uint64_t trianglesFull = 0;     // 全部按 0 级绘制时的三角形数
+    uint64_t trianglesSelected = 0;
+};
+
 template<typename T>
 concept ValidUBO = std::is_trivially_copyable_v<T> && requires { sizeof(T) > 0; };
 
 class Renderer {
 public:
+    // 每个 Renderable 占用一个 set 1 描述符集与一组对象 UBO（objectIndex 必须小于该值）
+    static constexpr uint32_t MAX_OBJECTS = 64;
+
     void markFramebufferResized() { m_framebufferResized = true; }
     // --- 构造与析构 ---
     explicit Renderer(std::unique_ptr<Window>& window);
@@ -45,8 +103,24 @@ public:
     DescriptorManager* getDescriptorManager() {
         return m_descriptorManager.get();
     }
+    RenderTargetPool* getRenderTargetPool() { return m_renderTargetPool.get(); }
+    RenderGraph* getRenderGraph() { return m_renderGraph.get(); }
+    CommandManager* getCommandManager() { return m_commandManager.get(); }
+    ClusterCuller* getClusterCuller() { return m_clusterCuller.get(); }
+    MeshShaderPath* getMeshShaderPath() { return m_meshShaderPath.get(); }
+    const GeometryPassStats& getGeometryStats() const { return m_geometryStats; }
+    LodSettings& getLodSettings() { return m_lodSettings; }
+    const LodStats& getLodStats() const { return m_lodStats; }
+
+    void addRenderFeature(std::unique_ptr<RenderFeature> feature) { m_features.push_back(std::move(feature)); }
+    // 开关异步计算（用于测量与图形重叠的收益）；没有独立计算队列族时始终关闭
+    void setAsyncComputeEnabled(bool enabled);
+    bool isAsyncComputeEnabled() const;
+    // 下一帧编译后把帧图导出为 GraphViz 文件
+    void requestRenderGraphDump(const std::string& path) { m_pendingGraphDump = path; }
 private:
     bool m_framebufferResized = false;
+    uint32_t m_frameNumber = 0;                    // 累计帧号（驱动 VMA 预算刷新）
     static constexpr int MAX_FRAMES_IN_FLIGHT = 2; // 提交的最大帧数
     // --- 核心组件 ---
     std::unique_ptr<Context> m_context;
@@ -56,12 +130,31 @@ private:
     std::unique_ptr<CommandManager> m_commandManager;
     std::unique_ptr<DescriptorManager> m_descriptorManager; // 负责创建和管理布局、池、集
     std::unique_ptr<ImGuiManager> m_imguiManager;
+    std::unique_ptr<RenderTargetPool> m_renderTargetPool;   // 深度等渲染目标按描述池化复用
+    std::unique_ptr<RenderGraph> m_renderGraph;             // 每帧声明 pass，编译结果按拓扑缓存
+    std::unique_ptr<ClusterCuller> m_clusterCuller;         // 带 meshlet 的网格在主通道前做 GPU 簇剔除
+    std::unique_ptr<MeshShaderPath> m_meshShaderPath;       // 支持时带 meshlet 的网格改走 task / mesh 着色器
+    std::vector<std::unique_ptr<RenderFeature>> m_features;
+    std::string m_pendingGraphDump;
+
+    // --- 几何绘制计时 ---
+    struct GeometryTiming {
+        bool written = false;
+        bool meshShaders = false;
+        uint64_t triangles = 0;
+    };
+    vk::QueryPool m_timestampPool;          // 每个 frame in flight 两个时间戳（几何绘制的起止）
+    double m_timestampPeriod = 0.0;         // 纳秒 / tick
+    std::array<GeometryTiming, MAX_FRAMES_IN_FLIGHT> m_geometryTimings{};
+    GeometryPassStats m_geometryStats;
+
+    // --- LOD ---
+    LodSettings m_lodSettings;
+    LodStats m_lodStats;
 
     // --- 帧相关资源 ---
-    vk::Image m_depthImage = nullptr; 
-    vk::ImageView m_depthImageView = nullptr;
-    vk::DeviceMemory m_depthImageMemory = nullptr; 
     std::vector<vk::Framebuffer> m_swapchainFramebuffers;
+    vk::ImageView m_framebufferDepthView;   // 帧缓冲创建时使用的深度视图（来自帧图的 transient 深度）
 
     struct FrameUBOs {
         std::vector<vk::Buffer> camera;
@@ -72,16 +165,23 @@ private:
         std::vector<vk::Buffer> material;
     } m_objectUBOs;
     std::vector<VmaAllocation> m_frameAllocations; // 所有帧级 allocation
+    // 纹理替换后还未重写的物体级描述符集副本（按 frame in flight，元素为对象下标）
+    std::array<std::unordered_set<uint32_t>, MAX_FRAMES_IN_FLIGHT> m_staleObjectSets;
     std::vector<VmaAllocation> m_objectAllocations;
 
+    void createPipelines();
     void createFrameUBOs();
     void createObjectUBOs(size_t);
-    void createFramebuffers();
-    void createDepthResources();
+    void createFramebuffers(vk::ImageView depthView);
+    vk::Framebuffer getFramebuffer(uint32_t imageIndex, vk::ImageView depthView);
+    void addMainPass(FrameGraphContext& frame);
+    void createTimestampPool();
+    void readGeometryTimestamps(uint32_t frame);
+    void selectLods(const Scene& scene);
+    void requestTextureMips(const Scene& scene);
 
     void cleanupUBOs();
     void cleanupFramebuffers();
-    void cleanupDepthResources();
     
     void updateFrameUBO(uint32_t frame, const CameraUBO& cam);
     void updateObjectUBO(size_t objIdx, const TransformUBO& trans, const LightUBO& light, const MaterialUBO& mat);
@@ -90,7 +190,7 @@ private:
 
     // 通用创建函数
     template<ValidUBO T>
-    void createUniformBuffer(vk::Buffer& buffer, VmaAllocation& alloc) {
+    void createUniformBuffer(vk::Buffer& buffer, VmaAllocation& alloc, const std::string& name) {
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.size = sizeof(T);
@@ -103,5 +203,6 @@ private:
         VkBuffer buf;
         vmaCreateBuffer(m_context->getVmaAllocator(), &bufferInfo, &allocInfo, &buf, &alloc, nullptr);
         buffer = buf;
+        m_context->getMemoryTracker()->track(alloc, name, MemoryCategory::UniformBuffer);
     }
 };
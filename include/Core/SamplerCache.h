@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vulkan/vulkan.hpp>
+
+class Context; // 前向声明（Context 持有 SamplerCache）
+
+// 采样器缓存：以完整的 vk::SamplerCreateInfo 为键，相同参数的纹理共享同一个 vk::Sampler。
+// 设备对同时存在的采样器数量有上限（maxSamplerAllocationCount，常见为 4000），每张纹理一个采样器时
+// 纹理数量一多就会超限；共享后采样器数量只与参数组合数有关。
+// 采样器在 Context 销毁时统一释放，纹理只持有句柄，不负责销毁。只在主线程调用
+class SamplerCache {
+public:
+    // 缓存键的哈希与相等比较：覆盖 pNext 以外的所有字段，浮点字段按位比较（0.0 与 -0.0 视为不同）。
+    // 不依赖设备，test/sampler_cache_test.cpp 直接用它们检查键的划分
+    struct CreateInfoHash {
+        size_t operator()(const vk::SamplerCreateInfo& info) const;
+    };
+    struct CreateInfoEqual {
+        bool operator()(const vk::SamplerCreateInfo& a, const vk::SamplerCreateInfo& b) const;
+    };
+
+private:
+    Context* m_context;
+    std::unordered_map<vk::SamplerCreateInfo, vk::Sampler, CreateInfoHash, CreateInfoEqual> m_samplers;
+    uint32_t m_maxSamplers = 0;         // 设备上限 maxSamplerAllocationCount
+    uint64_t m_requests = 0;
+
+public:
+    explicit SamplerCache(Context* context);
+    ~SamplerCache();
+
+    // 禁止拷贝和移动
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+    SamplerCache(SamplerCache&&) = delete;
+    SamplerCache& operator=(SamplerCache&&) = delete;
+
+    // 返回参数相同的已有采样器，没有时创建。不支持 pNext 扩展链（会抛出 std::runtime_error）
+    vk::Sampler getSampler(const vk::SamplerCreateInfo& info);
+
+    // 纹理默认的三线性 + 最大各向异性、重复寻址采样器。
+    // maxLod 不限制（VK_LOD_CLAMP_NONE），由图像视图的 mip 数决定，不同 mip 数的纹理可以共享
+    vk::SamplerCreateInfo getDefaultCreateInfo() const;
+
+    size_t getSamplerCount() const { return m_samplers.size(); }
+    uint64_t getRequestCount() const { return m_requests; }
+};
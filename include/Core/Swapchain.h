@@ -25,6 +25,7 @@ public:
     vk::Extent2D getExtent() const;
     vk::Format getImageFormat() const;
     const vk::SwapchainKHR& getSwapchain() const;
+    const vk::Image& getImage(size_t index) const;
     const vk::ImageView& getImageView(size_t index) const;
     const std::vector<vk::ImageView>& getImageViews()const;
 private:
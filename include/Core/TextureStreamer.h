@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vulkan/vulkan.hpp>
+
+class Context;          // 前向声明（Context 持有 TextureStreamer）
+class Texture;
+class CommandManager;
+struct TextureView;
+
+struct TextureStreamerSettings {
+    bool enabled = true;                                // 关闭后新导入的纹理全部常驻，已有的流式纹理保持当前级别
+    VkDeviceSize budgetBytes = 256ull * 1024 * 1024;    // 流式纹理可占用的显存
+    uint32_t qualityCap = 0;                            // 全局质量：最高只加载到该级（0 为原始分辨率，1 为一半 ...）
+    uint32_t initialSize = 128;                         // 导入时只加载边长不超过该值的低分辨率级别
+    float mipBias = 0.0f;                               // 加到按纹素密度算出的级别上，正值降低清晰度
+    VkDeviceSize maxUploadBytesPerFrame = 32ull * 1024 * 1024;  // 每帧升级上传的数据量上限（至少升级一张）
+};
+
+struct TextureStreamerStats {
+    uint32_t textureCount = 0;          // 流式纹理数
+    uint32_t visibleCount = 0;          // 上一帧有请求的纹理
+    uint32_t pendingCount = 0;          // 常驻级别低于请求、本帧没有升级的纹理（预算或上传量不足）
+    VkDeviceSize residentBytes = 0;     // 常驻级别的数据量
+    VkDeviceSize requestedBytes = 0;    // 全部按请求级别常驻时的数据量
+    VkDeviceSize frameUploadBytes = 0;  // 本帧升降级上传的数据量
+    uint64_t upgrades = 0;
+    uint64_t downgrades = 0;
+    uint64_t uploadedBytes = 0;
+};
+
+// 纹理流式加载：带预生成 mip 链的纹理（.vtex 缓存、KTX2、编码结果）导入时只上传低分辨率级别，
+// 之后按渲染器反馈的屏幕空间纹素密度升级，显存超过预算时按 LRU 降级。
+//  - 反馈：Renderer 在剔除阶段对可见物体按投影尺寸与网格的 UV 密度算出每张材质纹理需要的最高一级（requestTexture）
+//  - 升级：下一帧开头按请求新建只含所需级别的图像，从 CPU 侧的源数据上传后替换（没有稀疏驻留，整张图像重建）
+//  - 降级：预算不足时先把上一帧不可见的纹理按 LRU 退回初始级别，仍超出时再逐级降低可见纹理
+// 被替换的图像仍可能被描述符集引用：update 返回 true 时调用方需重写引用这些纹理的描述符集，旧图像在本帧完成后销毁。
+// 只在主线程调用
+class TextureStreamer {
+private:
+    struct Entry {
+        Texture* texture = nullptr;
+        uint32_t requestedMip = UINT32_MAX;     // 上一帧请求的最高一级（UINT32_MAX 表示没有请求）
+        uint64_t lastUsed = 0;                  // 最近一次有请求的帧
+    };
+
+    Context* m_context;
+    TextureStreamerSettings m_settings;
+    TextureStreamerStats m_stats;
+    std::unordered_map<Texture*, Entry> m_entries;
+    std::unordered_set<const Texture*> m_swapped;   // 本帧替换过图像的纹理
+    uint64_t m_frame = 1;
+
+    uint32_t getBaselineMip(const Texture& texture) const;
+    void setResidentMip(Entry& entry, uint32_t mip, CommandManager* commands);
+
+public:
+    explicit TextureStreamer(Context* context);
+    ~TextureStreamer() = default;
+
+    // 禁止拷贝和移动
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+    TextureStreamer(TextureStreamer&&) = delete;
+    TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+    // 启用且有多于一级的 mip 时，导入按流式纹理创建
+    bool canStream(const TextureView& view) const;
+    // 新建流式纹理时常驻的最高一级：边长不超过 initialSize 的第一级，且不高于质量上限
+    uint32_t getInitialMip(const TextureView& view) const;
+    void registerTexture(Texture* texture);
+    void unregisterTexture(Texture* texture);
+
+    // 使用反馈：uvPerPixel 为纹理所在表面上一个屏幕像素覆盖的 UV 长度（UV 密度 / 每模型单位的像素数）。
+    // 非流式纹理与空指针直接忽略
+    void requestTexture(Texture* texture, float uvPerPixel);
+    // 每帧开头（录制上传的图形收尾之前）调用：按上一帧的请求升降常驻级别。
+    // 有纹理替换了图像时返回 true，用 wasSwapped 找出需要重写的描述符集
+    bool update(CommandManager* commands);
+    bool wasSwapped(const Texture* texture) const { return texture && m_swapped.contains(texture); }
+
+    TextureStreamerSettings& getSettings() { return m_settings; }
+    const TextureStreamerStats& getStats() const { return m_stats; }
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <vulkan/vulkan.hpp>
+#include "3rd/vk_mem_alloc.h"
+#include "Core/MipGenerator.h"
+
+class Context; // 前向声明（Context 持有 UploadEngine）
+
+// 图像上传描述：默认只上传 mip 0，其余 mip 由图形队列 blit 生成（storageMips 且 MipGenerator 支持时改用计算派发）；
+// levelOffsets 非空时数据里已经包含各 mip 级（块压缩格式只能这样），逐级拷贝，不做 blit
+struct ImageUploadDesc {
+    vk::Image image;
+    vk::Format format = vk::Format::eUndefined;
+    vk::Extent3D extent{};
+    uint32_t mipLevels = 1;
+    bool generateMips = false;
+    bool storageMips = false;                   // 图像以 MipGenerator::getImageUsage / getImageCreateFlags 创建
+    std::vector<vk::DeviceSize> levelOffsets;   // 各 mip 级在 data 中的字节偏移（需为块大小的倍数）
+    vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    vk::PipelineStageFlags2 dstStage = vk::PipelineStageFlagBits2::eFragmentShader;  // 首次使用的阶段
+
+    bool needsMipGeneration() const { return generateMips && mipLevels > 1 && levelOffsets.empty(); }
+};
+
+// 异步上传引擎：
+//  - 持久映射的 staging 环形缓冲，按传输时间线值回收，不再为每次上传创建/销毁 staging buffer
+//  - 拷贝命令按批录制，一次提交到传输队列（没有独立传输队列族时退化为图形队列），不再 waitIdle
+//  - 传输队列族与图形队列族不同时做 queue family ownership transfer：
+//    传输侧 release，图形侧在下一帧命令缓冲开头 acquire（同时生成 mipmap，blit 需要图形队列）
+//  - 可以用计算着色器生成 mip 的图像交给 MipGenerator：传输侧 release 给生成所在的队列族，
+//    图形帧额外等待生成时间线（getMipWaitValue），异步计算时在帧开头 acquire
+class UploadEngine {
+private:
+    struct StagingAllocation {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+        void* mapped = nullptr;
+    };
+
+    struct DedicatedStaging {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+    };
+
+    // 已提交、等待传输时间线完成的批次
+    struct Batch {
+        uint64_t value = 0;                        // 该批次 signal 的传输时间线值
+        vk::CommandBuffer commandBuffer;
+        vk::DeviceSize ringBytes = 0;              // 占用的环形缓冲字节（含对齐与回绕填充）
+        std::vector<DedicatedStaging> dedicated;   // 超过环形缓冲容量的上传使用的独立 staging
+    };
+
+    // 需要在图形队列上完成的收尾工作（acquire + mip 生成 + 最终布局）
+    struct GraphicsBufferOp {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        vk::PipelineStageFlags2 dstStage;
+        vk::AccessFlags2 dstAccess;
+    };
+    struct GraphicsImageOp {
+        ImageUploadDesc desc;
+        vk::ImageLayout releasedLayout;            // release/acquire 屏障里的 newLayout
+    };
+
+    Context* m_context;
+    vk::Queue m_queue;
+    uint32_t m_queueFamily = 0;
+    bool m_ownershipTransfer = false;              // 传输与图形队列族不同
+
+    // 环形缓冲：空闲区从 m_head 开始（可回绕）连续 capacity - m_used 字节
+    vk::Buffer m_ringBuffer;
+    VmaAllocation m_ringAllocation = VK_NULL_HANDLE;
+    uint8_t* m_ringMapped = nullptr;
+    vk::DeviceSize m_ringCapacity = 0;
+    vk::DeviceSize m_head = 0;
+    vk::DeviceSize m_used = 0;
+
+    vk::Semaphore m_timeline;
+    uint64_t m_submittedValue = 0;
+    uint64_t m_graphicsWaitedValue = 0;            // 图形队列已经等待过的值
+
+    // 正在录制的批次
+    vk::CommandBuffer m_recording;
+    Batch m_current;
+    std::deque<Batch> m_inFlight;
+
+    std::vector<GraphicsBufferOp> m_graphicsBufferOps;
+    std::vector<GraphicsImageOp> m_graphicsImageOps;
+    std::vector<MipJob> m_mipJobs;                 // 下一次 recordGraphicsWork 交给 MipGenerator 的图像
+    uint64_t m_mipWaitValue = 0;                   // 最近一次 recordGraphicsWork 提交的生成时间线值
+    vk::PipelineStageFlags2 m_pendingWaitStage{};  // 挂起上传的首次使用阶段（累积）
+    vk::PipelineStageFlags2 m_graphicsWaitStage{};  // 最近一次 recordGraphicsWork 的等待阶段
+
+    // 统计
+    uint64_t m_batchCount = 0;
+    uint64_t m_uploadCount = 0;
+    vk::DeviceSize m_uploadedBytes = 0;
+
+    void createRingBuffer(vk::DeviceSize capacity);
+    vk::CommandBuffer getRecordingCommandBuffer();
+    StagingAllocation allocateStaging(vk::DeviceSize size, vk::DeviceSize alignment);
+    bool tryAllocateRing(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset);
+    void retireBatches(uint64_t completedValue);
+    void waitForOldestBatch();
+    // 拷贝后把图像转换到 General（需要时 release 给 MipGenerator 的队列族），记下生成任务
+    void recordMipJob(vk::CommandBuffer commandBuffer, const ImageUploadDesc& desc);
+
+public:
+    static constexpr vk::DeviceSize kDefaultRingSize = 64ull * 1024 * 1024;
+
+    explicit UploadEngine(Context* context, vk::DeviceSize ringSize = kDefaultRingSize);
+    ~UploadEngine();
+
+    // 禁止拷贝和移动
+    UploadEngine(const UploadEngine&) = delete;
+    UploadEngine& operator=(const UploadEngine&) = delete;
+    UploadEngine(UploadEngine&&) = delete;
+    UploadEngine& operator=(UploadEngine&&) = delete;
+
+    // 录制一次缓冲区上传，返回完成时的传输时间线值（在 flush 之前不会提交）。
+    // concurrent: dst 以 VK_SHARING_MODE_CONCURRENT 创建，不做所有权转移
+    uint64_t uploadBuffer(vk::Buffer dst, const void* data, vk::DeviceSize size, vk::DeviceSize dstOffset,
+                          vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess, bool concurrent = false);
+    // 录制缓冲区之间的拷贝（src / dst 需为 CONCURRENT 或归属上传队列族），排在本批次之前的写入之后
+    uint64_t copyBuffer(vk::Buffer src, vk::Buffer dst, const std::vector<vk::BufferCopy>& regions,
+                        vk::PipelineStageFlags2 dstStage);
+    // 录制一次图像上传（data 为紧密排列的 mip 0 像素，或 levelOffsets 描述的全部 mip 级）
+    uint64_t uploadImage(const ImageUploadDesc& desc, const void* data, vk::DeviceSize size);
+    // 同上，但由 write 直接向映射的 staging 内存写入 size 字节（例如解码结果按行翻转写入），调用方不需要中间缓冲
+    uint64_t uploadImage(const ImageUploadDesc& desc, vk::DeviceSize size, const std::function<void(uint8_t* mapped)>& write);
+
+    // 把当前批次提交到传输队列，返回 signal 的值（没有待提交内容时返回最近一次的值）
+    uint64_t flush();
+    // 在图形命令缓冲开头调用：提交挂起的批次，录制 acquire 屏障与 mip 生成。
+    // 返回图形提交需要等待的传输时间线值，0 表示不需要等待
+    uint64_t recordGraphicsWork(vk::CommandBuffer commandBuffer);
+    // 图形提交等待传输时间线的阶段（覆盖 acquire 屏障与首次使用阶段）
+    vk::PipelineStageFlags2 getGraphicsWaitStage() const { return m_graphicsWaitStage; }
+    // 最近一次 recordGraphicsWork 提交了计算 mip 生成时，图形提交还需要在同一阶段等待
+    // MipGenerator 时间线达到该值；0 表示没有
+    uint64_t getMipWaitValue() const { return m_mipWaitValue; }
+    // 在图形队列上逐级 blit 生成 mip（全部级别处于 TransferDst，结束时为 desc.finalLayout）
+    static void recordMipmaps(vk::CommandBuffer commandBuffer, const ImageUploadDesc& desc);
+
+    uint64_t completedValue() const;
+    bool isComplete(uint64_t value) const { return value <= this->completedValue(); }
+    // 阻塞直到所有已录制的上传在传输队列上完成（图形侧收尾仍在下一帧）
+    void waitIdle();
+
+    vk::Semaphore getTimelineSemaphore() const { return m_timeline; }
+    bool usesOwnershipTransfer() const { return m_ownershipTransfer; }
+    uint32_t getQueueFamily() const { return m_queueFamily; }
+    vk::DeviceSize getRingCapacity() const { return m_ringCapacity; }
+    vk::DeviceSize getRingUsed() const { return m_used; }
+    uint64_t getBatchCount() const { return m_batchCount; }
+    uint64_t getUploadCount() const { return m_uploadCount; }
+    vk::DeviceSize getUploadedBytes() const { return m_uploadedBytes; }
+};
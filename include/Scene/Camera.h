@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cmath>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Scene/UniformBuffer.h"
@@ -59,6 +60,15 @@ public:
         m_height = height;
     }
 
+    float getNearPlane() const {
+        return m_near;
+    }
+
+    // 距离 1 处一个单位长度投影到屏幕上的像素数（垂直方向），LOD 选择用它把几何误差换算成像素
+    float getProjectionScale() const {
+        return static_cast<float>(m_height) / (2.0f * std::tan(glm::radians(m_fov) * 0.5f));
+    }
+
     void moveForward(float deltaTime) {
         float velocity = m_movementSpeed * deltaTime;
         m_position += m_front * velocity;
@@ -110,4 +120,19 @@ public:
     CameraUBO getUBO() const {
         return CameraUBO(getViewMatrix(),getProjectionMatrix(),m_position);
     }
+
+    // 视锥平面（Gribb-Hartmann），法线指向内侧并归一化。
+    // 近平面按 [-w, w] 深度提取：对 [0, w] 深度的投影同样成立，只是更保守
+    static void extractFrustumPlanes(const glm::mat4& m, glm::vec4 planes[6]) {
+        auto row = [&](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+        planes[0] = row(3) + row(0);    // left
+        planes[1] = row(3) - row(0);    // right
+        planes[2] = row(3) + row(1);    // bottom
+        planes[3] = row(3) - row(1);    // top
+        planes[4] = row(3) + row(2);    // near
+        planes[5] = row(3) - row(2);    // far
+        for (int i = 0; i < 6; i++) {
+            planes[i] /= glm::length(glm::vec3(planes[i]));
+        }
+    }
 };
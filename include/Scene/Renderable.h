@@ -13,6 +13,7 @@ private:
     TransformUBO m_transform;
     std::shared_ptr<Mesh> m_mesh;
     std::shared_ptr<Material> m_material;
+    uint32_t m_lod = 0;                 // 上一帧选择的 LOD 级别（带滞回的选择需要）
 
 public:
     Renderable(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, uint32_t objectIndex)
@@ -39,4 +40,6 @@ public:
     Material& getMaterial() const { return *m_material; }
     uint32_t getObjectIndex() const { return m_objectIndex; }
     const TransformUBO& getTransform() const { return m_transform; }
+    uint32_t getLod() const { return m_lod; }
+    void setLod(uint32_t lod) { m_lod = lod; }
 };
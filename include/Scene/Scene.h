@@ -15,7 +15,7 @@ class Scene {
 private:
     std::unique_ptr<Camera> m_camera;
     std::vector<std::shared_ptr<Renderable>> m_renderables;
-    std::vector<glm::vec3> m_initialPositions;  // 存储每个物体的初始位置
+    std::vector<glm::mat4> m_initialTransforms; // 存储每个物体的初始变换（导入场景的节点带旋转 / 缩放）
     LightUBO m_mainLight{
         .position = glm::vec3(2.0f, 2.0f, 2.0f),
         .intensity = 1.0f,
@@ -54,10 +54,8 @@ public:
 
     void addRenderable(std::shared_ptr<Renderable> object) {
         m_renderables.push_back(object);
-        // 自动提取初始位置（从变换矩阵的最后一列）
-        auto transform = object->getTransform();
-        glm::vec3 position = glm::vec3(transform.model[3]);  // 提取位移分量
-        m_initialPositions.push_back(position);
+        // 记录初始变换，自动旋转时保留其中的旋转与缩放
+        m_initialTransforms.push_back(object->getTransform().model);
     }
 
     CameraUBO getCameraData() const {
@@ -78,13 +76,16 @@ public:
         m_autoRotationAngle += rotationSpeed * deltaTime;
         // 遍历所有物体，保持各自的初始位置，只添加旋转
         for (size_t i = 0; i < m_renderables.size(); ++i) {
+            // 初始变换去掉位移部分（保留旋转 / 缩放）
+            glm::mat4 local = m_initialTransforms[i];
+            local[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
             glm::mat4 modelMatrix = glm::mat4(1.0f);
             // 1. 先移动到初始位置
-            modelMatrix = glm::translate(modelMatrix, m_initialPositions[i]);
+            modelMatrix = glm::translate(modelMatrix, glm::vec3(m_initialTransforms[i][3]));
             // 2. 在该位置旋转
             modelMatrix = glm::rotate(modelMatrix, glm::radians(m_autoRotationAngle), glm::vec3(0.0f, 1.0f, 0.0f));
-            // 3. 应用缩放（默认为1.0）
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(1.0f));
+            // 3. 应用初始的旋转与缩放
+            modelMatrix = modelMatrix * local;
             // 更新物体的变换
             m_renderables[i]->updateTransform(modelMatrix);
         }
@@ -26,13 +26,13 @@ layout(set = 1, binding = 2) uniform MaterialBuffer {
     float metallic;
     float roughness;
     float ao;
+    float normalScale;
 } material;
 
-// 纹理采样器 - Set 1, Bindings 3-6
+// 纹理采样器 - Set 1, Bindings 3-5
 layout(set = 1, binding = 3) uniform sampler2D albedoMap;
-layout(set = 1, binding = 4) uniform sampler2D normalMap;
-layout(set = 1, binding = 5) uniform sampler2D metallicMap;
-layout(set = 1, binding = 6) uniform sampler2D roughnessMap;
+layout(set = 1, binding = 4) uniform sampler2D normalMap;   // 两通道（BC5 / R8G8）：只有 xy
+layout(set = 1, binding = 5) uniform sampler2D ormMap;      // R = 遮蔽，G = 粗糙度，B = 金属度（线性）
 
 // 输出颜色
 layout(location = 0) out vec4 outColor;
@@ -86,15 +86,37 @@ vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness) {
     return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
+// 顶点没有切线：由屏幕空间导数构造切线空间（Schüler, "Followup: Normal Mapping Without Precomputed Tangents"）。
+// 乘以行列式的符号，结果与屏幕 y 轴方向无关；B 指向 v 增大的方向
+mat3 cotangentFrame(vec3 N, vec3 p, vec2 uv) {
+    vec3 dp1 = dFdx(p);
+    vec3 dp2 = dFdy(p);
+    vec2 duv1 = dFdx(uv);
+    vec2 duv2 = dFdy(uv);
+
+    vec3 dp2perp = cross(dp2, N);
+    vec3 dp1perp = cross(N, dp1);
+    vec3 T = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 B = dp2perp * duv1.y + dp1perp * duv2.y;
+
+    float orientation = dot(dp1, dp2perp) < 0.0 ? -1.0 : 1.0;
+    float invmax = inversesqrt(max(max(dot(T, T), dot(B, B)), 1e-20));
+    return mat3(T * (invmax * orientation), B * (invmax * orientation), N);
+}
+
 void main() {
-    // 1. 准备材质参数（纹理 * UBO 参数，滑动条可实时调节）
+    // 1. 准备材质参数（纹理 * UBO 参数，滑动条可实时调节）：三次纹理读取
     vec3 albedo = texture(albedoMap, fragTexCoord).rgb * material.albedo;
-    float metallic = texture(metallicMap, fragTexCoord).r * material.metallic;
-    float roughness = texture(roughnessMap, fragTexCoord).r * material.roughness;
-    float ao = material.ao;
+    vec3 orm = texture(ormMap, fragTexCoord).rgb;
+    float ao = orm.r * material.ao;
+    float roughness = orm.g * material.roughness;
+    float metallic = orm.b * material.metallic;
 
-    // 2. 归一化输入向量
+    // 2. 归一化输入向量；法线贴图只存 xy，z = sqrt(1 - x² - y²)
     vec3 N = normalize(fragNormal);
+    vec2 normalXY = texture(normalMap, fragTexCoord).rg * 2.0 - 1.0;
+    vec3 tangentNormal = vec3(normalXY * material.normalScale, sqrt(max(1.0 - dot(normalXY, normalXY), 1e-6)));
+    N = normalize(cotangentFrame(N, fragPos, fragTexCoord) * normalize(tangentNormal));
     vec3 V = normalize(camera.cameraPos - fragPos);
     vec3 L = normalize(light.position - fragPos);
     vec3 H = normalize(V + L);
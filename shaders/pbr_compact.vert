@@ -0,0 +1,51 @@
+#version 450
+
+// Compact 顶点格式（16 字节）：位置为包围盒内的 unorm16，反量化已并入 transform.model；
+// 法线为八面体编码的 2x snorm16；UV 为 half float（格式转换由顶点输入完成）
+
+// Uniform 缓冲区 - Set 0: Camera
+layout(set = 0, binding = 0) uniform CameraBuffer {
+    mat4 view;
+    mat4 projection;
+    vec3 cameraPos;
+} camera;
+
+// Set 1, Binding 0: Object Transform
+layout(set = 1, binding = 0) uniform ObjectBuffer {
+    mat4 model;
+    mat4 normalMatrix;
+} transform;
+
+// 输入属性
+layout(location = 0) in vec3 inPosition;    // [0,1]^3
+layout(location = 1) in vec2 inNormalOct;   // [-1,1]^2
+layout(location = 2) in vec2 inTexCoord;
+
+// 输出到片段着色器
+layout(location = 0) out vec3 fragPos;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+
+// 与 Mesh.cpp 中的 octDecode 一致
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    // 计算世界空间位置
+    vec4 worldPos = transform.model * vec4(inPosition, 1.0);
+    fragPos = worldPos.xyz;
+
+    // 传递法线（世界空间，使用法线矩阵正确变换）
+    fragNormal = mat3(transform.normalMatrix) * octDecode(inNormalOct);
+
+    // 传递纹理坐标
+    fragTexCoord = inTexCoord;
+
+    // 输出裁剪空间位置
+    gl_Position = camera.projection * camera.view * worldPos;
+}
@@ -1,6 +1,8 @@
 #include <chrono>
+#include <print>
 #include <thread>
 #include <iostream>
+#include <filesystem>
 
 #include "Application.h"
 #include "Core/Window.h"
@@ -11,6 +13,8 @@
 #include "Scene/Renderable.h"
 #include "Assets/Mesh.h"
 #include "Assets/Material.h"
+#include "Assets/AssetRegistry.h"
+#include "Assets/GltfImporter.h"
 #include "Core/Pipeline.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -41,6 +45,173 @@ Application::Application(){
         ImGui::SliderFloat("Metallic", &data.metallic, 0.0f, 1.0f);
         ImGui::SliderFloat("Roughness", &data.roughness, 0.0f, 1.0f);
         ImGui::SliderFloat("AO", &data.ao, 0.0f, 1.0f);
+        ImGui::SliderFloat("Normal scale", &data.normalScale, 0.0f, 2.0f);
+        ImGui::End();
+
+        m_renderer->getContext()->getMemoryTracker()->drawImGuiPanel();
+
+        auto* commands = m_renderer->getCommandManager();
+        ImGui::Begin("Frame");
+        ImGui::Text("CPU wait for GPU: %.3f ms", commands->getCpuWaitMs());
+        ImGui::Text("Timeline: submitted %llu, completed %llu",
+                    static_cast<unsigned long long>(commands->getSubmittedValue()),
+                    static_cast<unsigned long long>(commands->gpuCompletedValue()));
+        bool asyncCompute = m_renderer->isAsyncComputeEnabled();
+        ImGui::BeginDisabled(!commands->isAsyncComputeAvailable());
+        if (ImGui::Checkbox("Async compute", &asyncCompute)) {
+            m_renderer->setAsyncComputeEnabled(asyncCompute);
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        ImGui::Text("(%zu pass(es) on compute queue)", m_renderer->getRenderGraph()->getAsyncComputePassCount());
+        auto* uploads = m_renderer->getContext()->getUploadEngine();
+        ImGui::Text("Uploads: %llu in %llu batch(es), %.2f MB%s",
+                    static_cast<unsigned long long>(uploads->getUploadCount()),
+                    static_cast<unsigned long long>(uploads->getBatchCount()),
+                    uploads->getUploadedBytes() / (1024.0 * 1024.0),
+                    uploads->usesOwnershipTransfer() ? " (transfer queue)" : "");
+        ImGui::Text("Staging ring: %.2f / %.2f MB",
+                    uploads->getRingUsed() / (1024.0 * 1024.0),
+                    uploads->getRingCapacity() / (1024.0 * 1024.0));
+        const GeometryArenaStats geometry = m_renderer->getContext()->getGeometryArena()->getStats();
+        ImGui::Text("Geometry arena: %u mesh(es) (%u with 16-bit indices)", geometry.meshCount, geometry.meshes16BitIndices);
+        ImGui::Text("  vertex %.2f / %.2f MB, index %.2f / %.2f MB",
+                    geometry.vertexBytesUsed / (1024.0 * 1024.0),
+                    geometry.vertexBytesCapacity / (1024.0 * 1024.0),
+                    geometry.indexBytesUsed / (1024.0 * 1024.0),
+                    geometry.indexBytesCapacity / (1024.0 * 1024.0));
+        ImGui::Text("Fragmentation: %.1f%%  Relocations: %llu",
+                    geometry.fragmentation * 100.0f, static_cast<unsigned long long>(geometry.relocations));
+        const SamplerCache* samplers = m_renderer->getContext()->getSamplerCache();
+        ImGui::Text("Samplers: %zu shared by %llu request(s)",
+                    samplers->getSamplerCount(), static_cast<unsigned long long>(samplers->getRequestCount()));
+
+        ImGui::Separator();
+        auto* culler = m_renderer->getClusterCuller();
+        bool clusterCulling = culler->isEnabled();
+        ImGui::BeginDisabled(!culler->isSupported());
+        if (ImGui::Checkbox("Cluster culling", &clusterCulling)) {
+            culler->setEnabled(clusterCulling);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Frustum", &culler->getSettings().frustum);
+        ImGui::SameLine();
+        ImGui::Checkbox("Cone", &culler->getSettings().cone);
+        ImGui::EndDisabled();
+        const ClusterCullStats& cull = culler->getStats();
+        ImGui::Text("Meshlets: %u / %u visible (%.1f%%) in %u mesh(es), %llu triangle(s) tested%s",
+                    cull.meshletsVisible, cull.meshletsTested,
+                    cull.meshletsTested > 0 ? 100.0 * cull.meshletsVisible / cull.meshletsTested : 0.0,
+                    cull.meshes, static_cast<unsigned long long>(cull.trianglesTested),
+                    cull.drawIndirectCount ? "" : " (no drawIndirectCount)");
+        auto* meshShaders = m_renderer->getMeshShaderPath();
+        bool meshShaderPath = meshShaders->isEnabled();
+        ImGui::BeginDisabled(!meshShaders->isSupported());
+        if (ImGui::Checkbox("Mesh shaders", &meshShaderPath)) {
+            meshShaders->setEnabled(meshShaderPath);
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        const MeshShaderStats& meshStats = meshShaders->getStats();
+        ImGui::Text("(%u mesh(es), %u meshlet(s) to task shaders)", meshStats.meshes, meshStats.meshletsSubmitted);
+        const GeometryPassStats& geometryPass = m_renderer->getGeometryStats();
+        ImGui::Text("Geometry: %s, %.3f ms GPU, %llu triangle(s), %.1f Mtri/s",
+                    geometryPass.meshShaders ? "mesh shaders" : "vertex input",
+                    geometryPass.gpuMs, static_cast<unsigned long long>(geometryPass.triangles),
+                    geometryPass.gpuMs > 0.0 ? geometryPass.triangles / geometryPass.gpuMs * 1e-3 : 0.0);
+
+        ImGui::Separator();
+        LodSettings& lodSettings = m_renderer->getLodSettings();
+        ImGui::Checkbox("LOD", &lodSettings.enabled);
+        ImGui::SameLine();
+        ImGui::SliderFloat("Max error (px)", &lodSettings.maxPixelError, 0.25f, 16.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Hysteresis", &lodSettings.hysteresis, 0.0f, 0.9f);
+        ImGui::SliderInt("Forced level", &lodSettings.forcedLevel, -1, 5);
+        const LodStats& lods = m_renderer->getLodStats();
+        ImGui::Text("LOD: %u / %u mesh(es) reduced, %u switch(es), %llu / %llu triangle(s) (%.1f%%)",
+                    lods.meshesReduced, lods.meshesWithLods, lods.switches,
+                    static_cast<unsigned long long>(lods.trianglesSelected),
+                    static_cast<unsigned long long>(lods.trianglesFull),
+                    lods.trianglesFull > 0 ? 100.0 * lods.trianglesSelected / lods.trianglesFull : 0.0);
+        ImGui::End();
+
+        const ImportStats& import = m_assetRegistry->getLastImportStats();
+        const AssetRegistryStats& registry = m_assetRegistry->getStats();
+        ImGui::Begin("Asset Import");
+        ImGui::Text("Last import: %zu mesh(es) (%zu cached), %zu texture(s), %u worker(s)",
+                    import.meshCount, import.meshCacheHits, import.textureCount, import.workerCount);
+        ImGui::Text("Wall clock: %.2f ms", import.wallMs);
+        ImGui::Text("I/O: %.2f ms  Parse: %.2f ms  Optimize: %.2f ms  Cache write: %.2f ms  Decode: %.2f ms (CPU sum)",
+                    import.ioMs, import.parseMs, import.optimizeMs, import.cacheWriteMs, import.decodeMs);
+        ImGui::Text("GPU create: %.2f ms  Upload wait: %.2f ms", import.gpuCreateMs, import.uploadWaitMs);
+        ImGui::Text("Source: %.2f MB  Uploaded: %.2f MB",
+                    import.sourceBytes / (1024.0 * 1024.0), import.uploadedBytes / (1024.0 * 1024.0));
+        ImGui::Separator();
+        ImGui::Text("Registry: %zu texture(s), %zu mesh(es), %.2f MB resident",
+                    registry.textureCount, registry.meshCount, registry.residentBytes / (1024.0 * 1024.0));
+        ImGui::Text("Hits: %llu  Misses: %llu  Evictions: %llu",
+                    static_cast<unsigned long long>(registry.hits),
+                    static_cast<unsigned long long>(registry.misses),
+                    static_cast<unsigned long long>(registry.evictions));
+        ImGui::End();
+
+        TextureStreamer* streamer = m_renderer->getContext()->getTextureStreamer();
+        TextureStreamerSettings& streaming = streamer->getSettings();
+        ImGui::Begin("Texture Streaming");
+        ImGui::Checkbox("Enabled", &streaming.enabled);
+        int budgetMb = static_cast<int>(streaming.budgetBytes / (1024 * 1024));
+        if (ImGui::SliderInt("Budget (MB)", &budgetMb, 16, 4096, "%d", ImGuiSliderFlags_Logarithmic)) {
+            streaming.budgetBytes = static_cast<VkDeviceSize>(budgetMb) * 1024 * 1024;
+        }
+        int qualityCap = static_cast<int>(streaming.qualityCap);
+        if (ImGui::SliderInt("Quality cap (mip)", &qualityCap, 0, 4)) {
+            streaming.qualityCap = static_cast<uint32_t>(qualityCap);
+        }
+        ImGui::SliderFloat("Mip bias", &streaming.mipBias, -2.0f, 4.0f);
+        const TextureStreamerStats& streamStats = streamer->getStats();
+        ImGui::Text("Textures: %u streamed, %u visible, %u pending",
+                    streamStats.textureCount, streamStats.visibleCount, streamStats.pendingCount);
+        ImGui::Text("Resident: %.2f MB  Requested: %.2f MB",
+                    streamStats.residentBytes / (1024.0 * 1024.0), streamStats.requestedBytes / (1024.0 * 1024.0));
+        ImGui::Text("Upgrades: %llu  Downgrades: %llu  Uploaded: %.2f MB (%.2f MB this frame)",
+                    static_cast<unsigned long long>(streamStats.upgrades),
+                    static_cast<unsigned long long>(streamStats.downgrades),
+                    streamStats.uploadedBytes / (1024.0 * 1024.0), streamStats.frameUploadBytes / (1024.0 * 1024.0));
+        ImGui::End();
+
+        MipGenerator* mips = m_renderer->getContext()->getMipGenerator();
+        const MipGeneratorStats& mipStats = mips->getStats();
+        ImGui::Begin("Mip Generation");
+        ImGui::Text("Compute: %s%s", mips->isAvailable() ? "single-pass" : "unavailable (blit)",
+                    mips->usesAsyncCompute() ? ", async compute queue" : "");
+        ImGui::Text("Images: %llu  Levels: %llu  Submissions: %llu",
+                    static_cast<unsigned long long>(mipStats.images),
+                    static_cast<unsigned long long>(mipStats.levels),
+                    static_cast<unsigned long long>(mipStats.submissions));
+        ImGui::BeginDisabled(!mips->isAvailable());
+        if (ImGui::Button("Benchmark 4K (blit vs compute)")) {
+            try {
+                mips->benchmark();
+            } catch (const std::exception& e) {
+                std::println("Warning: mip benchmark failed: {}", e.what());
+            }
+        }
+        ImGui::EndDisabled();
+        const MipBenchmarkResult& bench = mips->getLastBenchmark();
+        if (bench.iterations > 0) {
+            ImGui::Text("%ux%u, %u levels: blit %.3f ms (%u commands), compute %.3f ms (%u commands)",
+                        bench.size, bench.size, bench.mipLevels, bench.blitMs, bench.blitCommands,
+                        bench.computeMs, bench.computeCommands);
+        }
+        ImGui::End();
+
+        auto* graph = m_renderer->getRenderGraph();
+        ImGui::Begin("Render Graph");
+        ImGui::Text("Passes: %zu (culled %zu)", graph->getPassCount(), graph->getCulledPassCount());
+        ImGui::Text("Barriers: %zu", graph->getBarrierCount());
+        if (ImGui::Button("Dump GraphViz")) {
+            m_renderer->requestRenderGraphDump("render_graph.dot");
+        }
         ImGui::End();
     });
 }
@@ -55,6 +226,7 @@ Application::~Application() {
     }
     m_scene.reset();
     m_material.reset();
+    m_assetRegistry.reset();
     m_renderer.reset();
     m_inputs.reset();
     m_window.reset();
@@ -93,9 +265,10 @@ void Application::initializeScene(){
     m_scene->getCamera().setPosition({0.0f, 0.0f, 3.0f});  // 在z=3位置，看向z=-3的立方体
     // 获取 Context 指针
     Context* context = m_renderer->getContext();
+    m_assetRegistry = std::make_unique<AssetRegistry>(context);
 
-    // 1. 创建 Mesh（从 assets 文件夹加载魔方模型）
-    auto mesh = std::make_shared<Mesh>(context, "assets/Cube.obj");
+    // 1. 通过注册表加载 Mesh（从 assets 文件夹加载魔方模型，同一路径只导入一次）
+    auto mesh = m_assetRegistry->loadMesh("assets/Cube.obj");
 
     // 2. 准备材质数据（基础 PBR 参数）
     MaterialUBO materialData{
@@ -105,15 +278,16 @@ void Application::initializeScene(){
         .ao = 1.0f                          // 完整环境光遮蔽
     };
 
-    // 3. 创建 Material（带完整 PBR 纹理）
+    // 3. 创建 Material（带完整 PBR 纹理并行解码；遮蔽 / 粗糙度 / 金属度打包成一张 ORM 纹理）
     m_material = std::make_shared<Material>(
-        context,
+        *m_assetRegistry,
         PipelineType::Main,
         materialData,
         "assets/Cube_Diffuse.jpg",          // Albedo 纹理
-        "assets/Cube_Normal.jpg",           // 法线贴图
+        "assets/Cube_Normal.jpg",           // 法线贴图（两通道）
         "assets/Cube_Glossyness.jpg",       // Metallic 贴图（glossiness 反转）
-        "assets/Cube_Roughness.jpg"         // Roughness 纹理
+        "assets/Cube_Roughness.jpg",        // Roughness 纹理
+        "assets/Cube_Ambient_Occlution.jpg" // 环境光遮蔽
     );
 
     // 4. 绑定纹理到描述符集
@@ -143,6 +317,13 @@ void Application::initializeScene(){
     // 7. 添加到场景
     m_scene->addRenderable(renderable1);
     m_scene->addRenderable(renderable2);
+
+    // 8. 存在 glTF 场景时一并导入（网格、材质、节点层次），对象下标接在两个立方体之后
+    const std::string gltfPath = "assets/Scene.glb";
+    if (std::filesystem::exists(gltfPath)) {
+        GltfAsset gltf = GltfImporter::load(context, gltfPath);
+        GltfImporter::instantiate(gltf, *m_scene, m_renderer->getDescriptorManager(), 2, Renderer::MAX_OBJECTS);
+    }
 }
 
 
@@ -180,6 +361,8 @@ void Application::run(){
         this->updateSceneFromInput(deltaTime);
         this->m_scene->updateAutoRotation(deltaTime, 30.0f);  // 每秒旋转30度
         this->m_renderer->render(this->m_scene);
+        // 显存紧张时驱逐没有外部引用的资源
+        this->m_assetRegistry->update(this->m_renderer->getCommandManager());
         //=========================================
     }
 }
@@ -0,0 +1,318 @@
+#include "Assets/AssetImporter.h"
+#include "Core/JobSystem.h"
+#include "Assets/MeshCache.h"
+#include "Assets/TextureCache.h"
+#include "Assets/MappedFile.h"
+#include "Assets/Ktx2.h"
+#include <print>
+#include <chrono>
+#include <future>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 工作线程的产出：CPU 数据 + 各阶段耗时
+    struct MeshJobResult {
+        MeshData data;
+        std::optional<CachedMesh> cached;       // 命中 .vmesh 缓存时只有映射，没有 data
+        uint64_t bytes = 0;
+        double ioMs = 0.0;
+        double parseMs = 0.0;
+        double optimizeMs = 0.0;
+        double cacheWriteMs = 0.0;
+    };
+    struct TextureJobResult {
+        MappedFile file;                        // 源文件映射（未超压缩的 KTX2 直接从映射内存拷贝进 staging）
+        std::optional<Ktx2Image> ktx;           // KTX2：预先生成的 mip 链，跳过解码与编码
+        ImageData image;                        // 不压缩时上传的像素（RGBA8，按用途取前几个通道）
+        std::optional<EncodedTexture> encoded;  // 块压缩结果（压缩关闭或设备不支持所需格式时为空）
+        std::optional<CachedTexture> cached;    // 命中 .vtex 缓存时只有映射
+        uint64_t bytes = 0;
+        double ioMs = 0.0;
+        double decodeMs = 0.0;
+        double encodeMs = 0.0;
+        double cacheWriteMs = 0.0;
+    };
+
+    // 块压缩编码并写缓存（写缓存失败，例如只读目录，不影响本次导入）
+    void encodeTexture(TextureJobResult& result, const std::string& cachePath, const TextureImportSettings& settings,
+                       uint64_t sourceHash, const TextureFormatSupport& formatSupport, JobSystem* jobs) {
+        auto start = Clock::now();
+        result.encoded = Texture::encode(result.image, settings, formatSupport, jobs);
+        result.encodeMs = elapsedMs(start);
+
+        if (result.encoded && settings.compress && settings.useCache) {
+            start = Clock::now();
+            try {
+                TextureCache::write(cachePath, settings, sourceHash, formatSupport, *result.encoded);
+            } catch (const std::exception& e) {
+                std::println("Warning: {}", e.what());
+            }
+            result.cacheWriteMs = elapsedMs(start);
+        }
+    }
+
+    TextureJobResult importTexture(const std::string& path, const TextureImportSettings& settings,
+                                   const TextureFormatSupport& formatSupport, JobSystem* jobs) {
+        TextureJobResult result;
+        auto start = Clock::now();
+        result.file = MappedFile(path);
+        const uint8_t* source = result.file.getData();
+        const size_t size = result.file.getSize();
+        result.bytes = size;
+
+        // KTX2 已带有目标格式与完整 mip 链：只解析（及解压超压缩数据），不解码、不编码、不写缓存
+        if (Ktx2::isKtx2(source, size)) {
+            result.ioMs = elapsedMs(start);
+            start = Clock::now();
+            result.ktx = Ktx2::parse(source, size, path);
+            result.decodeMs = elapsedMs(start);
+            return result;
+        }
+
+        // 缓存以源文件内容哈希为键：哈希远比解码 + 编码便宜
+        uint64_t sourceHash = 0;
+        if (settings.compress && settings.useCache) {
+            sourceHash = TextureCache::hashBytes(source, size);
+            result.cached = TextureCache::open(path, settings, sourceHash, formatSupport);
+        }
+        result.ioMs = elapsedMs(start);
+        if (result.cached) {
+            return result;
+        }
+
+        start = Clock::now();
+        result.image = Texture::decode(source, size, path);
+        result.decodeMs = elapsedMs(start);
+
+        encodeTexture(result, path, settings, sourceHash, formatSupport, jobs);
+        return result;
+    }
+
+    // 各源图的 R 通道依次打包进 R / G / B（空路径的通道填 255），缓存以各源文件哈希的组合为键
+    TextureJobResult importPackedTexture(const std::string& label, const std::array<std::string, 3>& channels,
+                                         const TextureImportSettings& settings, const TextureFormatSupport& formatSupport,
+                                         JobSystem* jobs) {
+        TextureJobResult result;
+        auto start = Clock::now();
+        std::array<MappedFile, 3> files;
+        std::array<uint64_t, 3> hashes{};
+        const bool useCache = settings.compress && settings.useCache;
+        for (size_t c = 0; c < channels.size(); c++) {
+            if (channels[c].empty()) continue;
+            files[c] = MappedFile(channels[c]);
+            result.bytes += files[c].getSize();
+            if (useCache) hashes[c] = TextureCache::hashBytes(files[c].getData(), files[c].getSize());
+        }
+        uint64_t sourceHash = 0;
+        if (useCache) {
+            sourceHash = TextureCache::hashBytes(reinterpret_cast<const uint8_t*>(hashes.data()), sizeof(hashes));
+            result.cached = TextureCache::open(label, settings, sourceHash, formatSupport);
+        }
+        result.ioMs = elapsedMs(start);
+        if (result.cached) {
+            return result;
+        }
+
+        start = Clock::now();
+        for (size_t c = 0; c < channels.size(); c++) {
+            if (channels[c].empty()) continue;
+            const ImageData source = Texture::decode(files[c].getData(), files[c].getSize(), channels[c]);
+            if (result.image.pixels.empty()) {
+                result.image.width = source.width;
+                result.image.height = source.height;
+                result.image.pixels.assign(source.pixels.size(), 255);
+            } else if (source.width != result.image.width || source.height != result.image.height) {
+                throw std::runtime_error("Packed texture sources differ in size: " + channels[c]);
+            }
+            for (size_t i = c; i < source.pixels.size(); i += 4) {
+                result.image.pixels[i] = source.pixels[i - c];
+            }
+            files[c] = MappedFile();
+        }
+        result.decodeMs = elapsedMs(start);
+
+        encodeTexture(result, label, settings, sourceHash, formatSupport, jobs);
+        return result;
+    }
+}
+
+AssetImporter::AssetImporter(Context* context)
+    : m_context(context) {
+}
+
+size_t AssetImporter::addMesh(const std::string& path, const MeshImportSettings& settings) {
+    m_meshes.push_back(MeshRequest{path, settings, nullptr});
+    return m_meshes.size() - 1;
+}
+
+size_t AssetImporter::addTexture(const std::string& path, const TextureImportSettings& settings) {
+    m_textures.push_back(TextureRequest{path, settings, {}, nullptr});
+    return m_textures.size() - 1;
+}
+
+size_t AssetImporter::addPackedTexture(const std::array<std::string, 3>& channels, const TextureImportSettings& settings) {
+    // 纹理名与缓存文件名取自第一张源图所在目录：<目录>/<R 源文件名>+<G 源文件名>+<B 源文件名>
+    const auto source = std::find_if(channels.begin(), channels.end(), [](const std::string& channel) { return !channel.empty(); });
+    if (source == channels.end()) {
+        throw std::runtime_error("Packed texture has no source images");
+    }
+    std::string name;
+    for (size_t c = 0; c < channels.size(); c++) {
+        name += (c > 0 ? "+" : "") + (channels[c].empty() ? std::string("-") : std::filesystem::path(channels[c]).filename().string());
+    }
+    const std::filesystem::path label = std::filesystem::path(*source).parent_path() / name;
+    m_textures.push_back(TextureRequest{label.generic_string(), settings, channels, nullptr});
+    return m_textures.size() - 1;
+}
+
+const ImportStats& AssetImporter::importAll() {
+    auto wallStart = Clock::now();
+    JobSystem* jobs = m_context->getJobSystem();
+    UploadEngine* uploads = m_context->getUploadEngine();
+    const uint64_t uploadedBefore = uploads->getUploadedBytes();
+
+    m_stats = ImportStats{};
+    m_stats.meshCount = m_meshes.size();
+    m_stats.textureCount = m_textures.size();
+    m_stats.workerCount = jobs->getThreadCount();
+
+    // 1. CPU 阶段全部派发到工作线程
+    std::vector<std::future<MeshJobResult>> meshJobs;
+    meshJobs.reserve(m_meshes.size());
+    for (const auto& request : m_meshes) {
+        meshJobs.push_back(jobs->submit([jobs, path = request.path, settings = request.settings]() {
+            MeshJobResult result;
+            auto start = Clock::now();
+            if (settings.useCache) {
+                result.cached = MeshCache::open(path, settings);
+                if (result.cached) {
+                    result.ioMs = elapsedMs(start);
+                    result.bytes = result.cached->file.getSize();
+                    return result;
+                }
+            }
+            // OBJ 直接在映射内存上解析，不拷贝整个文件
+            MappedFile file(path);
+            result.ioMs = elapsedMs(start);
+            result.bytes = file.getSize();
+
+            start = Clock::now();
+            result.data = Mesh::parseObj(std::string_view(reinterpret_cast<const char*>(file.getData()), file.getSize()), path, jobs);
+            result.parseMs = elapsedMs(start);
+
+            start = Clock::now();
+            Mesh::process(result.data, settings);
+            result.optimizeMs = elapsedMs(start);
+
+            // 写缓存失败（只读目录等）不影响本次导入
+            if (settings.useCache) {
+                start = Clock::now();
+                try {
+                    MeshCache::write(path, result.data, settings);
+                } catch (const std::exception& e) {
+                    std::println("Warning: {}", e.what());
+                }
+                result.cacheWriteMs = elapsedMs(start);
+            }
+            return result;
+        }));
+    }
+    // 压缩格式的设备支持只在主线程查询一次
+    const TextureFormatSupport formatSupport = Texture::queryFormatSupport(m_context);
+    std::vector<std::future<TextureJobResult>> textureJobs;
+    textureJobs.reserve(m_textures.size());
+    for (const auto& request : m_textures) {
+        const bool packed = std::any_of(request.channels.begin(), request.channels.end(),
+                                        [](const std::string& channel) { return !channel.empty(); });
+        // 与网格任务相同按值捕获：任务不引用 m_textures，导入器提前析构时也不会访问它
+        textureJobs.push_back(jobs->submit([jobs, formatSupport, packed, path = request.path, channels = request.channels,
+                                            settings = request.settings]() {
+            return packed
+                ? importPackedTexture(path, channels, settings, formatSupport, jobs)
+                : importTexture(path, settings, formatSupport, jobs);
+        }));
+    }
+
+    // 2. 主线程按提交顺序取结果并创建 GPU 资源，与剩余的解码重叠；
+    //    拷贝都录制进上传引擎的当前批次，不逐个提交。
+    //    任一结果抛出（文件缺失、KTX2 无效等）时先等待所有已派发的任务结束再向上传播
+    try {
+        for (size_t i = 0; i < meshJobs.size(); i++) {
+            MeshJobResult result = meshJobs[i].get();
+            m_stats.sourceBytes += result.bytes;
+            m_stats.ioMs += result.ioMs;
+            m_stats.parseMs += result.parseMs;
+            m_stats.optimizeMs += result.optimizeMs;
+            m_stats.cacheWriteMs += result.cacheWriteMs;
+
+            // 缓存命中时从映射内存直接拷贝进 staging；拷贝在 uploadBuffer 内同步完成，之后即可解除映射
+            auto start = Clock::now();
+            if (result.cached) {
+                m_stats.meshCacheHits++;
+                m_meshes[i].result = std::make_shared<Mesh>(m_context, result.cached->view, m_meshes[i].path);
+            } else {
+                m_meshes[i].result = std::make_shared<Mesh>(m_context, result.data, m_meshes[i].path, m_meshes[i].settings);
+            }
+            m_stats.gpuCreateMs += elapsedMs(start);
+        }
+        for (size_t i = 0; i < textureJobs.size(); i++) {
+            TextureJobResult result = textureJobs[i].get();
+            m_stats.sourceBytes += result.bytes;
+            m_stats.ioMs += result.ioMs;
+            m_stats.decodeMs += result.decodeMs;
+            m_stats.encodeMs += result.encodeMs;
+            m_stats.cacheWriteMs += result.cacheWriteMs;
+
+            auto start = Clock::now();
+            // 预先生成好 mip 链的纹理把源数据交给 Texture（流式纹理之后从中上传更高的级别）；
+            // 视图在移动之前取出，移动不改变映射地址与 vector 的缓冲
+            if (result.ktx) {
+                const TextureView view = result.ktx->getView();
+                m_textures[i].result = Texture::createFromSource(m_context,
+                    TextureStreamSource(std::move(result.file), std::move(result.ktx->decompressed), view), m_textures[i].path);
+            } else if (result.cached) {
+                m_stats.textureCacheHits++;
+                const TextureView view = result.cached->view;
+                m_textures[i].result = Texture::createFromSource(m_context,
+                    TextureStreamSource(std::move(result.cached->file), {}, view), m_textures[i].path);
+            } else if (result.encoded) {
+                const TextureView view = result.encoded->getView();
+                m_textures[i].result = Texture::createFromSource(m_context,
+                    TextureStreamSource(MappedFile(), std::move(result.encoded->data), view), m_textures[i].path);
+            } else {
+                m_textures[i].result = std::make_unique<Texture>(m_context, result.image, m_textures[i].path, m_textures[i].settings);
+            }
+            m_stats.gpuCreateMs += elapsedMs(start);
+        }
+    } catch (...) {
+        for (auto& job : meshJobs) {
+            if (job.valid()) job.wait();
+        }
+        for (auto& job : textureJobs) {
+            if (job.valid()) job.wait();
+        }
+        throw;
+    }
+
+    // 3. 一次提交并等待传输完成
+    auto waitStart = Clock::now();
+    uploads->waitIdle();
+    m_stats.uploadWaitMs = elapsedMs(waitStart);
+    m_stats.uploadedBytes = uploads->getUploadedBytes() - uploadedBefore;
+    m_stats.wallMs = elapsedMs(wallStart);
+
+    std::println("Imported {} mesh(es) ({} from cache), {} texture(s) ({} from cache) in {:.2f} ms on {} worker(s)",
+                 m_stats.meshCount, m_stats.meshCacheHits, m_stats.textureCount, m_stats.textureCacheHits, m_stats.wallMs, m_stats.workerCount);
+    std::println("  io {:.2f} ms | parse {:.2f} ms | optimize {:.2f} ms | decode {:.2f} ms | encode {:.2f} ms (CPU sum) | gpu create {:.2f} ms | upload wait {:.2f} ms | {:.2f} MB uploaded",
+                 m_stats.ioMs, m_stats.parseMs, m_stats.optimizeMs, m_stats.decodeMs, m_stats.encodeMs, m_stats.gpuCreateMs, m_stats.uploadWaitMs,
+                 m_stats.uploadedBytes / (1024.0 * 1024.0));
+    return m_stats;
+}
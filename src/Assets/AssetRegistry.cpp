@@ -0,0 +1,171 @@
+#include "Assets/AssetRegistry.h"
+#include "Core/Command.h"
+#include <print>
+#include <algorithm>
+
+AssetRegistry::AssetRegistry(Context* context)
+    : m_context(context) {
+}
+
+TextureHandle AssetRegistry::loadTexture(const std::string& path, const TextureImportSettings& settings) {
+    return this->loadTextures({TextureRequest{path, settings}}).front();
+}
+
+std::vector<TextureHandle> AssetRegistry::loadTextures(const std::vector<TextureRequest>& requests) {
+    std::vector<TextureHandle> handles(requests.size());
+    std::vector<std::string> keys(requests.size());
+
+    // 1. 命中的直接返回；同一批次内重复的键只导入一次
+    AssetImporter importer(m_context);
+    std::unordered_map<std::string, size_t> pending;     // key -> importer 索引
+    std::vector<std::string> pendingKeys;
+    for (size_t i = 0; i < requests.size(); i++) {
+        // 打包请求以各通道的规范化路径组成键
+        const bool packed = std::any_of(requests[i].channels.begin(), requests[i].channels.end(),
+                                        [](const std::string& channel) { return !channel.empty(); });
+        std::array<std::string, 3> channels;
+        std::string normalized;
+        if (packed) {
+            for (size_t c = 0; c < channels.size(); c++) {
+                channels[c] = requests[i].channels[c].empty() ? std::string() : normalizePath(requests[i].channels[c]);
+                normalized += (c > 0 ? "+" : "") + (channels[c].empty() ? std::string("-") : channels[c]);
+            }
+        } else {
+            normalized = normalizePath(requests[i].path);
+        }
+        keys[i] = makeTextureKey(normalized, requests[i].settings);
+        m_tick++;
+        if (auto it = m_textures.find(keys[i]); it != m_textures.end()) {
+            it->second.lastUsed = m_tick;
+            handles[i] = it->second.asset;
+            m_stats.hits++;
+        } else if (!pending.contains(keys[i])) {
+            pending[keys[i]] = packed ? importer.addPackedTexture(channels, requests[i].settings)
+                                      : importer.addTexture(normalized, requests[i].settings);
+            pendingKeys.push_back(keys[i]);
+            m_stats.misses++;
+        } else {
+            m_stats.hits++;
+        }
+    }
+    if (pending.empty()) {
+        return handles;
+    }
+
+    // 2. 未加载的并行导入并登记
+    m_lastImport = importer.importAll();
+    for (const auto& key : pendingKeys) {
+        Entry<Texture> entry;
+        entry.asset = TextureHandle(importer.takeTexture(pending[key]));
+        entry.size = entry.asset->getMemorySize();
+        entry.lastUsed = m_tick;
+        m_stats.residentBytes += entry.size;
+        m_textures.emplace(key, std::move(entry));
+    }
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (!handles[i]) {
+            handles[i] = m_textures.at(keys[i]).asset;
+        }
+    }
+    m_stats.textureCount = m_textures.size();
+    return handles;
+}
+
+MeshHandle AssetRegistry::loadMesh(const std::string& path, const MeshImportSettings& settings) {
+    const std::string normalized = normalizePath(path);
+    const std::string key = makeMeshKey(normalized, settings);
+    m_tick++;
+    if (auto it = m_meshes.find(key); it != m_meshes.end()) {
+        it->second.lastUsed = m_tick;
+        m_stats.hits++;
+        return it->second.asset;
+    }
+    m_stats.misses++;
+
+    AssetImporter importer(m_context);
+    const size_t index = importer.addMesh(normalized, settings);
+    m_lastImport = importer.importAll();
+
+    Entry<Mesh> entry;
+    entry.asset = importer.getMesh(index);
+    entry.size = entry.asset->getMemorySize();
+    entry.lastUsed = m_tick;
+    m_stats.residentBytes += entry.size;
+    MeshHandle handle = entry.asset;
+    m_meshes.emplace(key, std::move(entry));
+    m_stats.meshCount = m_meshes.size();
+    return handle;
+}
+
+VkDeviceSize AssetRegistry::bytesOverBudget() const {
+    VkDeviceSize over = 0;
+    for (const auto& heap : m_context->getMemoryTracker()->getHeapBudgets()) {
+        if (!heap.deviceLocal || heap.budget == 0) continue;
+        const auto limit = static_cast<VkDeviceSize>(static_cast<double>(heap.budget) * m_pressureThreshold);
+        if (heap.usage > limit) {
+            over = std::max(over, heap.usage - limit);
+        }
+    }
+    return over;
+}
+
+size_t AssetRegistry::update(CommandManager* commands) {
+    // 流式纹理的常驻级别随使用变化，按当前分配刷新大小（驱逐按这个大小估算释放量）
+    for (auto& [key, entry] : m_textures) {
+        if (!entry.asset->isStreamed()) continue;
+        m_stats.residentBytes -= std::min(m_stats.residentBytes, entry.size);
+        entry.size = entry.asset->getMemorySize();
+        m_stats.residentBytes += entry.size;
+    }
+
+    const VkDeviceSize over = this->bytesOverBudget();
+    if (over == 0) {
+        return 0;
+    }
+    return this->evictUnreferenced(commands, over);
+}
+
+size_t AssetRegistry::evictUnreferenced(CommandManager* commands, VkDeviceSize bytesToFree) {
+    // 只有注册表自己持有（use_count == 1）的资源可以驱逐
+    struct Candidate {
+        uint64_t lastUsed;
+        VkDeviceSize size;
+        bool isTexture;
+        std::string key;
+    };
+    std::vector<Candidate> candidates;
+    for (const auto& [key, entry] : m_textures) {
+        if (entry.asset.use_count() == 1) candidates.push_back({entry.lastUsed, entry.size, true, key});
+    }
+    for (const auto& [key, entry] : m_meshes) {
+        if (entry.asset.use_count() == 1) candidates.push_back({entry.lastUsed, entry.size, false, key});
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.lastUsed < b.lastUsed; });
+
+    VkDeviceSize freed = 0;
+    size_t evicted = 0;
+    for (const auto& candidate : candidates) {
+        if (freed >= bytesToFree) break;
+        // 上一帧可能仍在读取该资源，交给时间线延迟销毁
+        if (candidate.isTexture) {
+            auto it = m_textures.find(candidate.key);
+            commands->deferDestroy([asset = std::move(it->second.asset)]() mutable { asset.reset(); });
+            m_textures.erase(it);
+        } else {
+            auto it = m_meshes.find(candidate.key);
+            commands->deferDestroy([asset = std::move(it->second.asset)]() mutable { asset.reset(); });
+            m_meshes.erase(it);
+        }
+        freed += candidate.size;
+        evicted++;
+    }
+    if (evicted > 0) {
+        m_stats.evictions += evicted;
+        m_stats.residentBytes -= std::min(m_stats.residentBytes, freed);
+        m_stats.textureCount = m_textures.size();
+        m_stats.meshCount = m_meshes.size();
+        std::println("AssetRegistry: evicted {} asset(s), {:.2f} MB", evicted, freed / (1024.0 * 1024.0));
+    }
+    return evicted;
+}
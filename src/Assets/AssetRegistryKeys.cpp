@@ -0,0 +1,23 @@
+#include "Assets/AssetRegistry.h"
+#include <filesystem>
+
+std::string AssetRegistry::normalizePath(const std::string& path) {
+    // "assets/./a.jpg"、"assets/../assets/a.jpg" 与绝对路径都归一到同一个键
+    std::error_code ec;
+    std::filesystem::path normalized = std::filesystem::weakly_canonical(path, ec);
+    if (ec) {
+        normalized = std::filesystem::path(path).lexically_normal();
+    }
+    return normalized.generic_string();
+}
+
+std::string AssetRegistry::makeTextureKey(const std::string& normalizedPath, const TextureImportSettings& settings) {
+    static constexpr const char* kUsageNames[] = {"|color", "|normal", "|mask", "|orm"};
+    return normalizedPath + (settings.srgb ? "|srgb" : "|unorm") + (settings.generateMips ? "|mips" : "|nomips")
+         + kUsageNames[static_cast<uint32_t>(settings.usage)] + (settings.compress ? "|bc" : "|raw");
+}
+
+std::string AssetRegistry::makeMeshKey(const std::string& normalizedPath, const MeshImportSettings& settings) {
+    return normalizedPath + (settings.vertexFormat == VertexFormat::Compact ? "|compact" : "|standard")
+         + (settings.optimize ? "|opt" : "|raw") + (settings.meshlets ? "|mlt" : "") + (settings.lods ? "|lod" : "");
+}
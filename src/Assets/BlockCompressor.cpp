@@ -0,0 +1,458 @@
+#include "Assets/BlockCompressor.h"
+#include "Core/JobSystem.h"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    constexpr uint32_t kTexels = 16;
+    // 块数少于该值的 mip 级不值得分发到工作线程
+    constexpr size_t kParallelMinBlocks = 256;
+
+    // 一个 4x4 块的 RGBA 像素
+    using Block = std::array<std::array<uint8_t, 4>, kTexels>;
+
+    void fetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block& block) {
+        for (uint32_t y = 0; y < 4; y++) {
+            const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; x++) {
+                const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                std::memcpy(block[y * 4 + x].data(), rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+            }
+        }
+    }
+
+    // 按位从低到高写入（BC7 的位流是小端的），输出需预先清零
+    class BitWriter {
+    private:
+        uint8_t* m_out;
+        uint32_t m_bit = 0;
+
+    public:
+        explicit BitWriter(uint8_t* out) : m_out(out) {}
+
+        void write(uint32_t value, uint32_t count) {
+            for (uint32_t i = 0; i < count; i++, m_bit++) {
+                if (value >> i & 1u) {
+                    m_out[m_bit >> 3] |= static_cast<uint8_t>(1u << (m_bit & 7));
+                }
+            }
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // 端点拟合（BC1 与 BC7 共用）
+    // ---------------------------------------------------------------------
+    // 主成分轴：协方差矩阵的幂迭代；点全部重合时 axis 为零向量
+    void computePrincipalAxis(const float points[kTexels][4], uint32_t channels, float mean[4], float axis[4]) {
+        for (uint32_t c = 0; c < 4; c++) {
+            mean[c] = 0.0f;
+            axis[c] = 0.0f;
+        }
+        for (uint32_t i = 0; i < kTexels; i++) {
+            for (uint32_t c = 0; c < channels; c++) mean[c] += points[i][c];
+        }
+        for (uint32_t c = 0; c < channels; c++) mean[c] /= kTexels;
+
+        double covariance[4][4] = {};
+        for (uint32_t i = 0; i < kTexels; i++) {
+            for (uint32_t a = 0; a < channels; a++) {
+                const double da = points[i][a] - mean[a];
+                for (uint32_t b = 0; b < channels; b++) {
+                    covariance[a][b] += da * (points[i][b] - mean[b]);
+                }
+            }
+        }
+        // 初始向量取方差最大的那一行，避免与主轴正交
+        uint32_t largest = 0;
+        for (uint32_t c = 1; c < channels; c++) {
+            if (covariance[c][c] > covariance[largest][largest]) largest = c;
+        }
+        if (covariance[largest][largest] < 1e-6) {
+            return;
+        }
+        double vector[4] = {};
+        for (uint32_t c = 0; c < channels; c++) vector[c] = covariance[largest][c];
+        for (int iteration = 0; iteration < 8; iteration++) {
+            double next[4] = {};
+            double length = 0.0;
+            for (uint32_t a = 0; a < channels; a++) {
+                for (uint32_t b = 0; b < channels; b++) next[a] += covariance[a][b] * vector[b];
+                length += next[a] * next[a];
+            }
+            length = std::sqrt(length);
+            if (length < 1e-12) break;
+            for (uint32_t c = 0; c < channels; c++) vector[c] = next[c] / length;
+        }
+        double length = 0.0;
+        for (uint32_t c = 0; c < channels; c++) length += vector[c] * vector[c];
+        length = std::sqrt(length);
+        if (length < 1e-12) {
+            return;
+        }
+        for (uint32_t c = 0; c < channels; c++) axis[c] = static_cast<float>(vector[c] / length);
+    }
+
+    // 点在主轴上投影的极值，两端向内收缩 range * inset
+    void computeAxisEndpoints(const float points[kTexels][4], uint32_t channels, float inset, float e0[4], float e1[4]) {
+        float mean[4];
+        float axis[4];
+        computePrincipalAxis(points, channels, mean, axis);
+        float low = 0.0f;
+        float high = 0.0f;
+        for (uint32_t i = 0; i < kTexels; i++) {
+            float projection = 0.0f;
+            for (uint32_t c = 0; c < channels; c++) projection += (points[i][c] - mean[c]) * axis[c];
+            low = std::min(low, projection);
+            high = std::max(high, projection);
+        }
+        const float shrink = (high - low) * inset;
+        low += shrink;
+        high -= shrink;
+        for (uint32_t c = 0; c < 4; c++) {
+            e0[c] = std::clamp(mean[c] + axis[c] * low, 0.0f, 255.0f);
+            e1[c] = std::clamp(mean[c] + axis[c] * high, 0.0f, 255.0f);
+        }
+    }
+
+    // 固定各像素的插值位置 t（0 取 e0，1 取 e1），求平方误差最小的两个端点；方程退化时返回 false
+    bool fitEndpoints(const float points[kTexels][4], const float t[kTexels], uint32_t channels, float e0[4], float e1[4]) {
+        double a = 0.0, b = 0.0, c = 0.0;
+        double x[4] = {};
+        double y[4] = {};
+        for (uint32_t i = 0; i < kTexels; i++) {
+            const double u = 1.0 - t[i];
+            const double v = t[i];
+            a += u * u;
+            b += u * v;
+            c += v * v;
+            for (uint32_t ch = 0; ch < channels; ch++) {
+                x[ch] += u * points[i][ch];
+                y[ch] += v * points[i][ch];
+            }
+        }
+        const double determinant = a * c - b * b;
+        if (std::abs(determinant) < 1e-8) {
+            return false;
+        }
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            e0[ch] = static_cast<float>(std::clamp((c * x[ch] - b * y[ch]) / determinant, 0.0, 255.0));
+            e1[ch] = static_cast<float>(std::clamp((a * y[ch] - b * x[ch]) / determinant, 0.0, 255.0));
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // BC1 颜色块（BC3 的颜色部分相同）
+    // ---------------------------------------------------------------------
+    struct ColorBlock {
+        uint16_t c0 = 0;
+        uint16_t c1 = 0;
+        uint32_t indices = 0;
+        uint32_t error = std::numeric_limits<uint32_t>::max();
+    };
+
+    uint16_t packColor565(const float color[4]) {
+        const int r = std::clamp(static_cast<int>(std::lround(color[0] * 31.0f / 255.0f)), 0, 31);
+        const int g = std::clamp(static_cast<int>(std::lround(color[1] * 63.0f / 255.0f)), 0, 63);
+        const int b = std::clamp(static_cast<int>(std::lround(color[2] * 31.0f / 255.0f)), 0, 31);
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    void unpackColor565(uint16_t color, int out[3]) {
+        const int r = color >> 11 & 31;
+        const int g = color >> 5 & 63;
+        const int b = color & 31;
+        out[0] = r << 3 | r >> 2;
+        out[1] = g << 2 | g >> 4;
+        out[2] = b << 3 | b >> 2;
+    }
+
+    // 四色模式（c0 > c1）：索引 0 / 1 为端点，2 / 3 为 1/3、2/3 处的插值
+    ColorBlock evaluateColorBlock(const Block& block, uint16_t c0, uint16_t c1) {
+        int palette[4][3];
+        unpackColor565(c0, palette[0]);
+        unpackColor565(c1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        ColorBlock result{c0, c1, 0, 0};
+        for (uint32_t i = 0; i < kTexels; i++) {
+            uint32_t bestIndex = 0;
+            uint32_t bestError = std::numeric_limits<uint32_t>::max();
+            for (uint32_t p = 0; p < 4; p++) {
+                uint32_t error = 0;
+                for (int c = 0; c < 3; c++) {
+                    const int d = palette[p][c] - block[i][c];
+                    error += static_cast<uint32_t>(d * d);
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            result.indices |= bestIndex << (2 * i);
+            result.error += bestError;
+        }
+        return result;
+    }
+
+    ColorBlock quantizeColorEndpoints(const Block& block, const float e0[4], const float e1[4]) {
+        uint16_t c0 = packColor565(e0);
+        uint16_t c1 = packColor565(e1);
+        // 四色模式要求 c0 > c1；两端量化到同一个值时拉开一个最低位
+        if (c0 < c1) {
+            std::swap(c0, c1);
+        } else if (c0 == c1) {
+            if (c1 > 0) c1--;
+            else c0++;
+        }
+        return evaluateColorBlock(block, c0, c1);
+    }
+
+    void encodeColorBlock(const Block& block, uint8_t* out) {
+        float points[kTexels][4];
+        for (uint32_t i = 0; i < kTexels; i++) {
+            for (int c = 0; c < 3; c++) points[i][c] = block[i][c];
+            points[i][3] = 0.0f;
+        }
+        // 端点向内收缩 1/16：极值像素误差略增，更多中间像素落在插值点上
+        float e0[4];
+        float e1[4];
+        computeAxisEndpoints(points, 3, 1.0f / 16.0f, e0, e1);
+        ColorBlock best = quantizeColorEndpoints(block, e0, e1);
+
+        static constexpr float kIndexPosition[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        for (int iteration = 0; iteration < 2 && best.error > 0; iteration++) {
+            float t[kTexels];
+            for (uint32_t i = 0; i < kTexels; i++) t[i] = kIndexPosition[best.indices >> (2 * i) & 3u];
+            if (!fitEndpoints(points, t, 3, e0, e1)) break;
+            const ColorBlock candidate = quantizeColorEndpoints(block, e0, e1);
+            if (candidate.error >= best.error) break;
+            best = candidate;
+        }
+
+        out[0] = static_cast<uint8_t>(best.c0 & 0xFF);
+        out[1] = static_cast<uint8_t>(best.c0 >> 8);
+        out[2] = static_cast<uint8_t>(best.c1 & 0xFF);
+        out[3] = static_cast<uint8_t>(best.c1 >> 8);
+        for (int b = 0; b < 4; b++) out[4 + b] = static_cast<uint8_t>(best.indices >> (8 * b));
+    }
+
+    // ---------------------------------------------------------------------
+    // BC4 单通道块（BC3 的 alpha、BC5 的两个通道相同）
+    // ---------------------------------------------------------------------
+    // 八插值模式（e0 > e1）：索引 0 / 1 为端点，2..7 在两端之间等分
+    void encodeChannelBlock(const Block& block, uint32_t channel, uint8_t* out) {
+        int low = 255;
+        int high = 0;
+        for (uint32_t i = 0; i < kTexels; i++) {
+            low = std::min<int>(low, block[i][channel]);
+            high = std::max<int>(high, block[i][channel]);
+        }
+        out[0] = static_cast<uint8_t>(high);
+        out[1] = static_cast<uint8_t>(low);
+        std::memset(out + 2, 0, 6);
+        if (high == low) {
+            return;     // 全部取索引 0
+        }
+        int palette[8] = {high, low};
+        for (int i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * high + (i - 1) * low + 3) / 7;
+        }
+        uint64_t bits = 0;
+        for (uint32_t i = 0; i < kTexels; i++) {
+            const int value = block[i][channel];
+            uint64_t bestIndex = 0;
+            int bestError = std::numeric_limits<int>::max();
+            for (int p = 0; p < 8; p++) {
+                const int error = std::abs(palette[p] - value);
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = static_cast<uint64_t>(p);
+                }
+            }
+            bits |= bestIndex << (3 * i);
+        }
+        for (int b = 0; b < 6; b++) out[2 + b] = static_cast<uint8_t>(bits >> (8 * b));
+    }
+
+    // ---------------------------------------------------------------------
+    // BC7 mode 6
+    // ---------------------------------------------------------------------
+    constexpr std::array<int, 16> kBc7Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    struct Bc7Block {
+        int endpoints[2][4] = {};       // 7 位分量
+        int pbits[2] = {};
+        uint8_t indices[kTexels] = {};
+        uint64_t error = std::numeric_limits<uint64_t>::max();
+    };
+
+    // 7 位分量 + 共享 p 位（解码值 = q << 1 | p）：两种 p 位都试，取误差小的。
+    // 不透明块固定 p = 1，alpha 端点精确为 255
+    void quantizeBc7Endpoint(const float value[4], bool opaque, int quantized[4], int& pbit) {
+        float bestError = std::numeric_limits<float>::max();
+        for (int p = opaque ? 1 : 0; p < 2; p++) {
+            int candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                candidate[c] = std::clamp(static_cast<int>(std::lround((value[c] - p) * 0.5f)), 0, 127);
+                const float d = static_cast<float>(candidate[c] << 1 | p) - value[c];
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                pbit = p;
+                std::copy(candidate, candidate + 4, quantized);
+            }
+        }
+    }
+
+    Bc7Block evaluateBc7Block(const Block& block, bool opaque, const float e0[4], const float e1[4]) {
+        Bc7Block result;
+        quantizeBc7Endpoint(e0, opaque, result.endpoints[0], result.pbits[0]);
+        quantizeBc7Endpoint(e1, opaque, result.endpoints[1], result.pbits[1]);
+
+        int palette[16][4];
+        for (int c = 0; c < 4; c++) {
+            const int a = result.endpoints[0][c] << 1 | result.pbits[0];
+            const int b = result.endpoints[1][c] << 1 | result.pbits[1];
+            for (int i = 0; i < 16; i++) {
+                palette[i][c] = ((64 - kBc7Weights[i]) * a + kBc7Weights[i] * b + 32) >> 6;
+            }
+        }
+        // 调色板近似在端点连线上：先按投影找到最近的权重，只比较它和相邻的两个
+        float direction[4];
+        float lengthSquared = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            direction[c] = static_cast<float>(palette[15][c] - palette[0][c]);
+            lengthSquared += direction[c] * direction[c];
+        }
+        const float scale = lengthSquared > 0.0f ? 64.0f / lengthSquared : 0.0f;
+        result.error = 0;
+        for (uint32_t i = 0; i < kTexels; i++) {
+            float projection = 0.0f;
+            for (int c = 0; c < 4; c++) projection += (block[i][c] - palette[0][c]) * direction[c];
+            const int weight = static_cast<int>(projection * scale);
+            const int nearest = static_cast<int>(std::lower_bound(kBc7Weights.begin(), kBc7Weights.end(), weight) - kBc7Weights.begin());
+            uint32_t bestError = std::numeric_limits<uint32_t>::max();
+            for (int p = std::max(nearest - 1, 0); p <= std::min(nearest + 1, 15); p++) {
+                uint32_t error = 0;
+                for (int c = 0; c < 4; c++) {
+                    const int d = palette[p][c] - block[i][c];
+                    error += static_cast<uint32_t>(d * d);
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    result.indices[i] = static_cast<uint8_t>(p);
+                }
+            }
+            result.error += bestError;
+        }
+        return result;
+    }
+
+    void encodeBc7Block(const Block& block, uint8_t* out) {
+        float points[kTexels][4];
+        bool opaque = true;
+        for (uint32_t i = 0; i < kTexels; i++) {
+            for (int c = 0; c < 4; c++) points[i][c] = block[i][c];
+            opaque = opaque && block[i][3] == 255;
+        }
+        float e0[4];
+        float e1[4];
+        computeAxisEndpoints(points, 4, 0.0f, e0, e1);
+        Bc7Block best = evaluateBc7Block(block, opaque, e0, e1);
+        for (int iteration = 0; iteration < 2 && best.error > 0; iteration++) {
+            float t[kTexels];
+            for (uint32_t i = 0; i < kTexels; i++) t[i] = kBc7Weights[best.indices[i]] / 64.0f;
+            if (!fitEndpoints(points, t, 4, e0, e1)) break;
+            const Bc7Block candidate = evaluateBc7Block(block, opaque, e0, e1);
+            if (candidate.error >= best.error) break;
+            best = candidate;
+        }
+
+        // 锚点（像素 0）索引的最高位隐含为 0：超过 7 时交换端点并翻转全部索引（权重表首尾对称）
+        if (best.indices[0] >= 8) {
+            std::swap(best.endpoints[0], best.endpoints[1]);
+            std::swap(best.pbits[0], best.pbits[1]);
+            for (auto& index : best.indices) index = static_cast<uint8_t>(15 - index);
+        }
+
+        std::memset(out, 0, 16);
+        BitWriter writer(out);
+        writer.write(1u << 6, 7);                   // mode 6：6 个 0 后跟 1
+        for (int c = 0; c < 4; c++) {
+            writer.write(static_cast<uint32_t>(best.endpoints[0][c]), 7);
+            writer.write(static_cast<uint32_t>(best.endpoints[1][c]), 7);
+        }
+        writer.write(static_cast<uint32_t>(best.pbits[0]), 1);
+        writer.write(static_cast<uint32_t>(best.pbits[1]), 1);
+        writer.write(best.indices[0], 3);
+        for (uint32_t i = 1; i < kTexels; i++) {
+            writer.write(best.indices[i], 4);
+        }
+    }
+
+    void encodeBlock(BlockFormat format, const Block& block, uint8_t* out) {
+        switch (format) {
+        case BlockFormat::BC1:
+            encodeColorBlock(block, out);
+            break;
+        case BlockFormat::BC3:
+            encodeChannelBlock(block, 3, out);
+            encodeColorBlock(block, out + 8);
+            break;
+        case BlockFormat::BC4:
+            encodeChannelBlock(block, 0, out);
+            break;
+        case BlockFormat::BC5:
+            encodeChannelBlock(block, 0, out);
+            encodeChannelBlock(block, 1, out + 8);
+            break;
+        case BlockFormat::BC7:
+            encodeBc7Block(block, out);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+uint32_t BlockCompressor::getBlockBytes(BlockFormat format) {
+    return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+}
+
+size_t BlockCompressor::getEncodedSize(BlockFormat format, uint32_t width, uint32_t height) {
+    const size_t blocksX = (width + kBlockDim - 1) / kBlockDim;
+    const size_t blocksY = (height + kBlockDim - 1) / kBlockDim;
+    return blocksX * blocksY * getBlockBytes(format);
+}
+
+void BlockCompressor::encode(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* output,
+                             JobSystem* jobs) {
+    if (width == 0 || height == 0) {
+        return;
+    }
+    const uint32_t blocksX = (width + kBlockDim - 1) / kBlockDim;
+    const uint32_t blocksY = (height + kBlockDim - 1) / kBlockDim;
+    const size_t rowBytes = static_cast<size_t>(blocksX) * getBlockBytes(format);
+    auto encodeRow = [&](size_t row) {
+        Block block;
+        uint8_t* out = output + row * rowBytes;
+        for (uint32_t x = 0; x < blocksX; x++) {
+            fetchBlock(rgba, width, height, x, static_cast<uint32_t>(row), block);
+            encodeBlock(format, block, out + x * getBlockBytes(format));
+        }
+    };
+    // 块行之间没有依赖，输出区间互不重叠
+    if (jobs && static_cast<size_t>(blocksX) * blocksY >= kParallelMinBlocks) {
+        jobs->parallelFor(blocksY, encodeRow);
+    } else {
+        for (uint32_t y = 0; y < blocksY; y++) encodeRow(y);
+    }
+}
@@ -0,0 +1,1106 @@
+#include "Assets/GltfImporter.h"
+#include "Assets/MappedFile.h"
+#include "Assets/TextureCache.h"
+#include "Core/JobSystem.h"
+#include "Core/Descriptor.h"
+#include "Scene/Scene.h"
+#include "Scene/Renderable.h"
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <print>
+#include <span>
+#include <array>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // ---------------------------------------------------------------------
+    // 最小 JSON DOM：glTF 的 JSON 部分通常只有几 KB ~ 几 MB，对象按键线性查找即可
+    // ---------------------------------------------------------------------
+    struct JsonValue {
+        enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+        Type type = Type::Null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<JsonValue> array;
+        std::vector<std::pair<std::string, JsonValue>> object;
+
+        static const JsonValue& null() {
+            static const JsonValue value;
+            return value;
+        }
+        // 缺失的键 / 越界的下标返回 null，便于链式访问可选字段
+        const JsonValue& operator[](std::string_view key) const {
+            if (type == Type::Object) {
+                for (const auto& [name, value] : object) {
+                    if (name == key) return value;
+                }
+            }
+            return null();
+        }
+        const JsonValue& operator[](size_t index) const {
+            return type == Type::Array && index < array.size() ? array[index] : null();
+        }
+        bool isNull() const { return type == Type::Null; }
+        size_t size() const { return type == Type::Array ? array.size() : 0; }
+        double asNumber(double fallback) const { return type == Type::Number ? number : fallback; }
+        int64_t asInt(int64_t fallback) const { return type == Type::Number ? static_cast<int64_t>(number) : fallback; }
+        const std::string& asString() const { return string; }
+    };
+
+    class JsonParser {
+    private:
+        static constexpr int kMaxDepth = 128;
+        const char* m_p;
+        const char* m_end;
+        const std::string& m_name;
+
+        [[noreturn]] void fail(const char* what) const {
+            throw std::runtime_error("Malformed glTF JSON in " + m_name + ": " + what);
+        }
+        void skipWhitespace() {
+            while (m_p < m_end && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')) m_p++;
+        }
+        bool consume(char c) {
+            skipWhitespace();
+            if (m_p < m_end && *m_p == c) {
+                m_p++;
+                return true;
+            }
+            return false;
+        }
+        void expect(char c) {
+            if (!this->consume(c)) fail("unexpected character");
+        }
+        void expectLiteral(std::string_view literal) {
+            if (static_cast<size_t>(m_end - m_p) < literal.size() || std::memcmp(m_p, literal.data(), literal.size()) != 0) {
+                fail("invalid literal");
+            }
+            m_p += literal.size();
+        }
+        uint32_t parseHex4() {
+            if (m_end - m_p < 4) fail("truncated \\u escape");
+            uint32_t value = 0;
+            auto [next, ec] = std::from_chars(m_p, m_p + 4, value, 16);
+            if (ec != std::errc() || next != m_p + 4) fail("invalid \\u escape");
+            m_p += 4;
+            return value;
+        }
+        static void appendUtf8(std::string& out, uint32_t codepoint) {
+            if (codepoint < 0x80) {
+                out += static_cast<char>(codepoint);
+            } else if (codepoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codepoint >> 6));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codepoint >> 12));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codepoint >> 18));
+                out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+        }
+        std::string parseString() {
+            skipWhitespace();
+            if (m_p >= m_end || *m_p != '"') fail("expected string");
+            m_p++;
+            std::string out;
+            while (true) {
+                if (m_p >= m_end) fail("unterminated string");
+                const char c = *m_p++;
+                if (c == '"') break;
+                if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (m_p >= m_end) fail("unterminated escape");
+                switch (*m_p++) {
+                    case '"':  out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/':  out += '/'; break;
+                    case 'b':  out += '\b'; break;
+                    case 'f':  out += '\f'; break;
+                    case 'n':  out += '\n'; break;
+                    case 'r':  out += '\r'; break;
+                    case 't':  out += '\t'; break;
+                    case 'u': {
+                        uint32_t codepoint = this->parseHex4();
+                        // 代理对
+                        if (codepoint >= 0xD800 && codepoint <= 0xDBFF && m_end - m_p >= 6 && m_p[0] == '\\' && m_p[1] == 'u') {
+                            m_p += 2;
+                            const uint32_t low = this->parseHex4();
+                            if (low < 0xDC00 || low > 0xDFFF) fail("invalid surrogate pair");
+                            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(out, codepoint);
+                        break;
+                    }
+                    default:
+                        fail("invalid escape");
+                }
+            }
+            return out;
+        }
+        JsonValue parseValue(int depth) {
+            if (depth > kMaxDepth) fail("nesting too deep");
+            skipWhitespace();
+            if (m_p >= m_end) fail("unexpected end of input");
+            JsonValue value;
+            switch (*m_p) {
+                case '{':
+                    m_p++;
+                    value.type = JsonValue::Type::Object;
+                    if (this->consume('}')) break;
+                    do {
+                        std::string key = this->parseString();
+                        this->expect(':');
+                        value.object.emplace_back(std::move(key), this->parseValue(depth + 1));
+                    } while (this->consume(','));
+                    this->expect('}');
+                    break;
+                case '[':
+                    m_p++;
+                    value.type = JsonValue::Type::Array;
+                    if (this->consume(']')) break;
+                    do {
+                        value.array.push_back(this->parseValue(depth + 1));
+                    } while (this->consume(','));
+                    this->expect(']');
+                    break;
+                case '"':
+                    value.type = JsonValue::Type::String;
+                    value.string = this->parseString();
+                    break;
+                case 't':
+                    this->expectLiteral("true");
+                    value.type = JsonValue::Type::Bool;
+                    value.boolean = true;
+                    break;
+                case 'f':
+                    this->expectLiteral("false");
+                    value.type = JsonValue::Type::Bool;
+                    break;
+                case 'n':
+                    this->expectLiteral("null");
+                    break;
+                default: {
+                    auto [next, ec] = std::from_chars(m_p, m_end, value.number);
+                    if (ec != std::errc()) fail("invalid number");
+                    m_p = next;
+                    value.type = JsonValue::Type::Number;
+                    break;
+                }
+            }
+            return value;
+        }
+
+    public:
+        JsonParser(std::string_view text, const std::string& name)
+            : m_p(text.data()), m_end(text.data() + text.size()), m_name(name) {
+            // UTF-8 BOM
+            if (text.size() >= 3 && std::memcmp(m_p, "\xEF\xBB\xBF", 3) == 0) m_p += 3;
+        }
+        JsonValue parse() {
+            JsonValue root = this->parseValue(0);
+            skipWhitespace();
+            if (m_p != m_end && *m_p != '\0') fail("trailing characters");
+            return root;
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // 文件与缓冲区
+    // ---------------------------------------------------------------------
+    constexpr uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+    constexpr uint32_t kChunkJson = 0x4E4F534A;     // "JSON"
+    constexpr uint32_t kChunkBin = 0x004E4942;      // "BIN\0"
+
+    uint32_t readU32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // uri 中的 %XX 转义（文件名含空格等）
+    std::string decodeUri(const std::string& uri) {
+        std::string out;
+        for (size_t i = 0; i < uri.size(); i++) {
+            uint32_t value = 0;
+            if (uri[i] == '%' && i + 2 < uri.size() &&
+                std::from_chars(uri.data() + i + 1, uri.data() + i + 3, value, 16).ptr == uri.data() + i + 3) {
+                out += static_cast<char>(value);
+                i += 2;
+            } else {
+                out += uri[i];
+            }
+        }
+        return out;
+    }
+
+    struct Document {
+        std::string name;
+        std::filesystem::path baseDir;
+        MappedFile file;
+        std::vector<MappedFile> externalFiles;      // .gltf 引用的外部 .bin
+        std::vector<std::span<const uint8_t>> buffers;
+        JsonValue root;
+    };
+
+    Document openDocument(const std::string& path) {
+        Document doc;
+        doc.name = path;
+        doc.baseDir = std::filesystem::path(path).parent_path();
+        doc.file = MappedFile(path);
+        const uint8_t* data = doc.file.getData();
+        const size_t size = doc.file.getSize();
+
+        std::string_view json;
+        std::span<const uint8_t> binChunk;
+        if (size >= 12 && readU32(data) == kGlbMagic) {
+            // GLB：12 字节文件头 + JSON 块 + 可选 BIN 块（块按 4 字节对齐）
+            if (readU32(data + 4) != 2) {
+                throw std::runtime_error("Unsupported GLB version in " + path);
+            }
+            const size_t length = readU32(data + 8);
+            if (length > size) {
+                throw std::runtime_error("Truncated GLB file: " + path);
+            }
+            size_t offset = 12;
+            bool first = true;
+            while (offset + 8 <= length) {
+                const size_t chunkLength = readU32(data + offset);
+                const uint32_t chunkType = readU32(data + offset + 4);
+                offset += 8;
+                if (chunkLength > length - offset) {
+                    throw std::runtime_error("Truncated GLB chunk in " + path);
+                }
+                if (first && chunkType != kChunkJson) {
+                    throw std::runtime_error("GLB does not start with a JSON chunk: " + path);
+                }
+                if (chunkType == kChunkJson && first) {
+                    json = std::string_view(reinterpret_cast<const char*>(data + offset), chunkLength);
+                } else if (chunkType == kChunkBin && binChunk.empty()) {
+                    binChunk = std::span<const uint8_t>(data + offset, chunkLength);
+                }
+                first = false;
+                offset += (chunkLength + 3) & ~size_t(3);
+            }
+            if (first) {
+                throw std::runtime_error("GLB has no JSON chunk: " + path);
+            }
+        } else {
+            json = std::string_view(reinterpret_cast<const char*>(data), size);
+        }
+
+        doc.root = JsonParser(json, path).parse();
+        const std::string& version = doc.root["asset"]["version"].asString();
+        if (version.empty() || version[0] != '2') {
+            throw std::runtime_error("Unsupported glTF version '" + version + "' in " + path);
+        }
+
+        const JsonValue& buffers = doc.root["buffers"];
+        for (size_t i = 0; i < buffers.size(); i++) {
+            const JsonValue& buffer = buffers[i];
+            const size_t byteLength = static_cast<size_t>(buffer["byteLength"].asInt(0));
+            const JsonValue& uri = buffer["uri"];
+            std::span<const uint8_t> bytes;
+            if (uri.isNull()) {
+                // 没有 uri 的第一个缓冲区引用 GLB 的 BIN 块
+                if (i != 0 || binChunk.empty()) {
+                    throw std::runtime_error("glTF buffer " + std::to_string(i) + " has no data: " + path);
+                }
+                bytes = binChunk;
+            } else if (uri.asString().starts_with("data:")) {
+                throw std::runtime_error("glTF data: URIs are not supported (convert to .glb): " + path);
+            } else {
+                doc.externalFiles.emplace_back((doc.baseDir / decodeUri(uri.asString())).string());
+                bytes = doc.externalFiles.back().getBytes();
+            }
+            if (byteLength > bytes.size()) {
+                throw std::runtime_error("glTF buffer " + std::to_string(i) + " is shorter than its byteLength: " + path);
+            }
+            doc.buffers.push_back(bytes.first(byteLength));
+        }
+        return doc;
+    }
+
+    // 取 bufferView 的字节区间（越界时抛出）
+    std::span<const uint8_t> getBufferView(const Document& doc, int64_t index, size_t* byteStride = nullptr) {
+        const JsonValue& view = doc.root["bufferViews"][static_cast<size_t>(index)];
+        const int64_t buffer = view["buffer"].asInt(-1);
+        if (view.isNull() || buffer < 0 || static_cast<size_t>(buffer) >= doc.buffers.size()) {
+            throw std::runtime_error("Invalid glTF bufferView " + std::to_string(index) + " in " + doc.name);
+        }
+        const std::span<const uint8_t> bytes = doc.buffers[static_cast<size_t>(buffer)];
+        const size_t offset = static_cast<size_t>(view["byteOffset"].asInt(0));
+        const size_t length = static_cast<size_t>(view["byteLength"].asInt(0));
+        if (offset > bytes.size() || length > bytes.size() - offset) {
+            throw std::runtime_error("glTF bufferView " + std::to_string(index) + " is out of range in " + doc.name);
+        }
+        if (byteStride) {
+            // 规范：byteStride 在 [4, 252] 内且是 4 的倍数（未给出时为 0，表示紧密排列）
+            const int64_t stride = view["byteStride"].asInt(0);
+            if (stride != 0 && (stride < 4 || stride > 252 || stride % 4 != 0)) {
+                throw std::runtime_error("Invalid byteStride " + std::to_string(stride) + " of glTF bufferView "
+                                         + std::to_string(index) + " in " + doc.name);
+            }
+            *byteStride = static_cast<size_t>(stride);
+        }
+        return bytes.subspan(offset, length);
+    }
+
+    // ---------------------------------------------------------------------
+    // 访问器
+    // ---------------------------------------------------------------------
+    constexpr int kByte = 5120;
+    constexpr int kUnsignedByte = 5121;
+    constexpr int kShort = 5122;
+    constexpr int kUnsignedShort = 5123;
+    constexpr int kUnsignedInt = 5125;
+    constexpr int kFloat = 5126;
+
+    size_t componentSize(int componentType) {
+        switch (componentType) {
+            case kByte: case kUnsignedByte: return 1;
+            case kShort: case kUnsignedShort: return 2;
+            case kUnsignedInt: case kFloat: return 4;
+            default: return 0;
+        }
+    }
+
+    uint32_t componentCount(const std::string& type) {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4" || type == "MAT2") return 4;
+        if (type == "MAT3") return 9;
+        if (type == "MAT4") return 16;
+        return 0;
+    }
+
+    struct Accessor {
+        const uint8_t* data = nullptr;      // 没有 bufferView 时为空（按规范视为全零）
+        size_t count = 0;
+        size_t stride = 0;
+        int64_t bufferView = -1;
+        int componentType = 0;
+        uint32_t components = 0;
+        bool normalized = false;
+
+        bool isValid() const { return components != 0; }
+        const uint8_t* element(size_t i) const { return data ? data + i * stride : nullptr; }
+    };
+
+    Accessor getAccessor(const Document& doc, int64_t index) {
+        const JsonValue& json = doc.root["accessors"][static_cast<size_t>(index)];
+        const std::string label = "glTF accessor " + std::to_string(index) + " in " + doc.name;
+        if (index < 0 || json.isNull()) {
+            throw std::runtime_error("Missing " + label);
+        }
+        if (!json["sparse"].isNull()) {
+            throw std::runtime_error("Sparse accessors are not supported: " + label);
+        }
+        Accessor accessor;
+        accessor.count = static_cast<size_t>(json["count"].asInt(0));
+        accessor.componentType = static_cast<int>(json["componentType"].asInt(0));
+        accessor.components = componentCount(json["type"].asString());
+        accessor.normalized = json["normalized"].type == JsonValue::Type::Bool && json["normalized"].boolean;
+        const size_t elementSize = componentSize(accessor.componentType) * accessor.components;
+        if (elementSize == 0) {
+            throw std::runtime_error("Invalid component type of " + label);
+        }
+        accessor.stride = elementSize;
+        accessor.bufferView = json["bufferView"].asInt(-1);
+        if (accessor.bufferView < 0) {
+            return accessor;
+        }
+
+        size_t byteStride = 0;
+        const std::span<const uint8_t> view = getBufferView(doc, accessor.bufferView, &byteStride);
+        if (byteStride != 0) {
+            if (byteStride < elementSize) {
+                throw std::runtime_error("byteStride is smaller than the element size of " + label);
+            }
+            accessor.stride = byteStride;
+        }
+        const size_t offset = static_cast<size_t>(json["byteOffset"].asInt(0));
+        if (accessor.count > 0) {
+            // 最后一个元素的起点不能超过 room；用除法比较，count 来自文件，stride * (count - 1) 可能溢出
+            if (offset > view.size() || elementSize > view.size() - offset) {
+                throw std::runtime_error("Out of range " + label);
+            }
+            const size_t room = view.size() - offset - elementSize;
+            if (accessor.count - 1 > room / accessor.stride) {
+                throw std::runtime_error("Out of range " + label);
+            }
+        }
+        accessor.data = view.data() + offset;
+        return accessor;
+    }
+
+    float readComponent(const uint8_t* p, int componentType, bool normalized) {
+        switch (componentType) {
+            case kFloat: { float v; std::memcpy(&v, p, 4); return v; }
+            case kUnsignedByte: { const uint8_t v = *p; return normalized ? v / 255.0f : v; }
+            case kByte: { int8_t v; std::memcpy(&v, p, 1); return normalized ? std::max(v / 127.0f, -1.0f) : v; }
+            case kUnsignedShort: { uint16_t v; std::memcpy(&v, p, 2); return normalized ? v / 65535.0f : v; }
+            case kShort: { int16_t v; std::memcpy(&v, p, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : v; }
+            case kUnsignedInt: { uint32_t v; std::memcpy(&v, p, 4); return static_cast<float>(v); }
+            default: return 0.0f;
+        }
+    }
+
+    uint32_t readIndex(const uint8_t* p, int componentType) {
+        switch (componentType) {
+            case kUnsignedByte: return *p;
+            case kUnsignedShort: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+            default: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // 图元准备
+    // ---------------------------------------------------------------------
+    constexpr size_t kVertexChunk = 64u * 1024;
+    constexpr size_t kIndexChunk = 256u * 1024;
+
+    struct PrimitiveJob {
+        std::string name;
+        uint32_t material = 0;
+        Accessor position;
+        Accessor normal;
+        Accessor texCoord;
+        Accessor indices;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        bool zeroCopyVertices = false;      // 顶点直接引用映射内存
+        bool directIndices = false;         // 索引直接引用映射内存
+        std::vector<Vertex> vertices;
+        std::vector<uint16_t> indices16;
+        std::vector<uint32_t> indices32;
+        vk::IndexType indexType = vk::IndexType::eUint32;
+        float uvDensity = 0.0f;             // Mesh::computeUvDensity
+    };
+
+    struct WorkChunk {
+        uint32_t primitive = 0;
+        bool indices = false;
+        size_t begin = 0;
+        size_t end = 0;
+        uint32_t maxIndex = 0;
+    };
+
+    // 三个属性在同一个 bufferView 中以 32 字节步长、与 Vertex 相同的偏移交织，且都是 float
+    bool matchesVertexLayout(const PrimitiveJob& job) {
+        const Accessor& p = job.position;
+        const Accessor& n = job.normal;
+        const Accessor& t = job.texCoord;
+        if (!p.data || !n.data || !t.data) return false;
+        if (p.componentType != kFloat || n.componentType != kFloat || t.componentType != kFloat || t.normalized) return false;
+        if (p.bufferView != n.bufferView || p.bufferView != t.bufferView) return false;
+        if (p.stride != sizeof(Vertex) || n.stride != sizeof(Vertex) || t.stride != sizeof(Vertex)) return false;
+        return n.data == p.data + offsetof(Vertex, normal) && t.data == p.data + offsetof(Vertex, texCoord);
+    }
+
+    void setupPrimitive(const Document& doc, const JsonValue& primitive, PrimitiveJob& job) {
+        const JsonValue& attributes = primitive["attributes"];
+        const int64_t position = attributes["POSITION"].asInt(-1);
+        if (position < 0) {
+            throw std::runtime_error("glTF primitive without POSITION: " + job.name);
+        }
+        job.position = getAccessor(doc, position);
+        if (job.position.componentType != kFloat || job.position.components != 3) {
+            throw std::runtime_error("Quantized or non-VEC3 positions are not supported: " + job.name);
+        }
+        if (job.position.count > UINT32_MAX) {
+            throw std::runtime_error("glTF primitive has too many vertices: " + job.name);
+        }
+        job.vertexCount = static_cast<uint32_t>(job.position.count);
+
+        if (const int64_t normal = attributes["NORMAL"].asInt(-1); normal >= 0) {
+            job.normal = getAccessor(doc, normal);
+            if (job.normal.componentType != kFloat || job.normal.components != 3 || job.normal.count != job.position.count) {
+                throw std::runtime_error("Invalid NORMAL accessor: " + job.name);
+            }
+        }
+        if (const int64_t texCoord = attributes["TEXCOORD_0"].asInt(-1); texCoord >= 0) {
+            job.texCoord = getAccessor(doc, texCoord);
+            const bool supported = job.texCoord.componentType == kFloat ||
+                ((job.texCoord.componentType == kUnsignedByte || job.texCoord.componentType == kUnsignedShort) && job.texCoord.normalized);
+            if (!supported || job.texCoord.components != 2 || job.texCoord.count != job.position.count) {
+                throw std::runtime_error("Invalid TEXCOORD_0 accessor: " + job.name);
+            }
+        }
+        job.zeroCopyVertices = matchesVertexLayout(job);
+        if (!job.zeroCopyVertices) {
+            job.vertices.resize(job.vertexCount);
+        }
+
+        size_t indexCount = job.position.count;
+        if (const int64_t indices = primitive["indices"].asInt(-1); indices >= 0) {
+            job.indices = getAccessor(doc, indices);
+            const int type = job.indices.componentType;
+            if (job.indices.components != 1 || (type != kUnsignedByte && type != kUnsignedShort && type != kUnsignedInt)) {
+                throw std::runtime_error("Invalid index accessor: " + job.name);
+            }
+            indexCount = job.indices.count;
+            // 紧密排列的 16 / 32 位索引直接引用映射内存；8 位索引扩展为 16 位
+            job.directIndices = job.indices.data && type != kUnsignedByte && job.indices.stride == componentSize(type);
+            job.indexType = type == kUnsignedInt ? vk::IndexType::eUint32 : vk::IndexType::eUint16;
+        } else {
+            job.indexType = job.vertexCount <= UINT16_MAX ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+        }
+        if (indexCount % 3 != 0 || indexCount > UINT32_MAX) {
+            throw std::runtime_error("Invalid triangle index count in " + job.name);
+        }
+        job.indexCount = static_cast<uint32_t>(indexCount);
+        if (!job.directIndices) {
+            if (job.indexType == vk::IndexType::eUint16) {
+                job.indices16.resize(indexCount);
+            } else {
+                job.indices32.resize(indexCount);
+            }
+        }
+    }
+
+    void fillVertices(PrimitiveJob& job, size_t begin, size_t end) {
+        const bool floatTexCoord = job.texCoord.componentType == kFloat;
+        for (size_t i = begin; i < end; i++) {
+            Vertex& vertex = job.vertices[i];
+            if (const uint8_t* p = job.position.element(i)) {
+                std::memcpy(&vertex.pos, p, sizeof(vertex.pos));
+            } else {
+                vertex.pos = glm::vec3(0.0f);
+            }
+            if (const uint8_t* p = job.normal.element(i)) {
+                std::memcpy(&vertex.normal, p, sizeof(vertex.normal));
+            } else {
+                vertex.normal = glm::vec3(0.0f);
+            }
+            if (const uint8_t* p = job.texCoord.element(i)) {
+                if (floatTexCoord) {
+                    std::memcpy(&vertex.texCoord, p, sizeof(vertex.texCoord));
+                } else {
+                    const size_t size = componentSize(job.texCoord.componentType);
+                    vertex.texCoord.x = readComponent(p, job.texCoord.componentType, true);
+                    vertex.texCoord.y = readComponent(p + size, job.texCoord.componentType, true);
+                }
+            } else {
+                vertex.texCoord = glm::vec2(0.0f);
+            }
+        }
+    }
+
+    // 转换（或只扫描）一段索引，返回其中的最大值
+    uint32_t fillIndices(PrimitiveJob& job, size_t begin, size_t end) {
+        uint32_t maxIndex = 0;
+        const bool generated = job.indices.components == 0;
+        for (size_t i = begin; i < end; i++) {
+            uint32_t index = static_cast<uint32_t>(i);
+            if (!generated) {
+                const uint8_t* p = job.indices.element(i);
+                index = p ? readIndex(p, job.indices.componentType) : 0;
+            }
+            maxIndex = std::max(maxIndex, index);
+            if (job.directIndices) continue;
+            if (job.indexType == vk::IndexType::eUint16) {
+                job.indices16[i] = static_cast<uint16_t>(index);
+            } else {
+                job.indices32[i] = index;
+            }
+        }
+        return maxIndex;
+    }
+
+    uint32_t getIndex(const PrimitiveJob& job, size_t i) {
+        if (job.directIndices) return readIndex(job.indices.element(i), job.indices.componentType);
+        return job.indexType == vk::IndexType::eUint16 ? job.indices16[i] : job.indices32[i];
+    }
+
+    // 缺少 NORMAL 时按面积加权生成平滑法线
+    void generateNormals(PrimitiveJob& job) {
+        for (size_t i = 0; i + 2 < job.indexCount; i += 3) {
+            Vertex& a = job.vertices[getIndex(job, i)];
+            Vertex& b = job.vertices[getIndex(job, i + 1)];
+            Vertex& c = job.vertices[getIndex(job, i + 2)];
+            const glm::vec3 normal = glm::cross(b.pos - a.pos, c.pos - a.pos);
+            a.normal += normal;
+            b.normal += normal;
+            c.normal += normal;
+        }
+        for (Vertex& vertex : job.vertices) {
+            const float length = glm::length(vertex.normal);
+            vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+
+    MeshView makeView(const PrimitiveJob& job) {
+        MeshView view;
+        view.vertexFormat = VertexFormat::Standard;
+        view.vertices = job.zeroCopyVertices ? static_cast<const void*>(job.position.data)
+                                             : static_cast<const void*>(job.vertices.data());
+        view.vertexCount = job.vertexCount;
+        view.vertexStride = sizeof(Vertex);
+        if (job.directIndices) {
+            view.indices = job.indices.data;
+        } else if (job.indexType == vk::IndexType::eUint16) {
+            view.indices = job.indices16.data();
+        } else {
+            view.indices = job.indices32.data();
+        }
+        view.indexCount = job.indexCount;
+        view.indexType = job.indexType;
+        view.uvDensity = job.uvDensity;
+        return view;
+    }
+
+    // ---------------------------------------------------------------------
+    // 材质与纹理
+    // ---------------------------------------------------------------------
+    // 贴图用途：metallicRoughness 按规范 B = metallic、G = roughness，正好是 ORM 布局；
+    // occlusion 与它是同一张图时 R 即遮蔽（kRoleOrm），否则 R 置 1（kRoleRoughnessMetallic）
+    enum TextureRole : uint32_t {
+        kRoleColor, kRoleNormal, kRoleOrm, kRoleRoughnessMetallic, kRoleCount
+    };
+
+    // 一个用途的纹理数据：缓存映射、块压缩结果或未压缩像素三者之一
+    struct TextureSource {
+        std::optional<CachedTexture> cached;
+        std::optional<EncodedTexture> encoded;
+        ImageData image;
+    };
+
+    struct ImageJob {
+        std::array<bool, kRoleCount> roles{};
+        std::future<std::array<TextureSource, kRoleCount>> result;
+        std::array<std::shared_ptr<Texture>, kRoleCount> textures;
+    };
+
+    TextureImportSettings getRoleSettings(TextureRole role, bool compress) {
+        TextureImportSettings settings;
+        settings.srgb = role == kRoleColor;
+        settings.usage = role == kRoleColor ? TextureUsage::Color
+                       : role == kRoleNormal ? TextureUsage::Normal
+                       : TextureUsage::Orm;
+        settings.compress = compress;
+        return settings;
+    }
+
+    // 纹理名（显存追踪），同时是 .vtex 缓存的文件名
+    std::string getRoleLabel(const std::string& label, TextureRole role) {
+        switch (role) {
+        case kRoleNormal: return label + ".normal";
+        case kRoleOrm: return label + ".orm";
+        case kRoleRoughnessMetallic: return label + ".rm";
+        default: return label;
+        }
+    }
+
+    // 按用途整理像素：法线反转 G（glTF 的 +Y 指向 v 减小的方向，pbr.frag 的切线空间 B 指向 v 增大的方向），
+    // 没有遮蔽的 metallicRoughness 把 R 置 1
+    ImageData prepareRole(const ImageData& image, TextureRole role) {
+        ImageData out = image;
+        for (size_t i = 0; i + 3 < out.pixels.size(); i += 4) {
+            if (role == kRoleNormal) {
+                out.pixels[i + 1] = static_cast<uint8_t>(255 - out.pixels[i + 1]);
+            } else if (role == kRoleRoughnessMetallic) {
+                out.pixels[i + 0] = 255;
+            }
+            if (role != kRoleColor) {
+                out.pixels[i + 3] = 255;
+            }
+        }
+        return out;
+    }
+
+    ImageData makeSolidImage(uint8_t r, uint8_t g, uint8_t b) {
+        return ImageData{1, 1, {r, g, b, 255}};
+    }
+
+    // 纹理对象的 source 图像下标，-1 表示没有纹理
+    int64_t getImageIndex(const Document& doc, const JsonValue& textureInfo) {
+        if (textureInfo.isNull()) return -1;
+        const JsonValue& texture = doc.root["textures"][static_cast<size_t>(textureInfo["index"].asInt(-1))];
+        const int64_t image = texture["source"].asInt(-1);
+        return image >= 0 && static_cast<size_t>(image) < doc.root["images"].size() ? image : -1;
+    }
+
+    // ---------------------------------------------------------------------
+    // 节点
+    // ---------------------------------------------------------------------
+    glm::mat4 getLocalMatrix(const JsonValue& node) {
+        const JsonValue& matrix = node["matrix"];
+        if (matrix.size() == 16) {
+            // glTF 与 glm 都是列主序
+            glm::mat4 result;
+            float* out = glm::value_ptr(result);
+            for (size_t i = 0; i < 16; i++) out[i] = static_cast<float>(matrix[i].asNumber(0.0));
+            return result;
+        }
+        const JsonValue& t = node["translation"];
+        const JsonValue& r = node["rotation"];
+        const JsonValue& s = node["scale"];
+        const glm::vec3 translation(t[0].asNumber(0.0), t[1].asNumber(0.0), t[2].asNumber(0.0));
+        const glm::quat rotation(static_cast<float>(r[3].asNumber(1.0)), static_cast<float>(r[0].asNumber(0.0)),
+                                 static_cast<float>(r[1].asNumber(0.0)), static_cast<float>(r[2].asNumber(0.0)));
+        const glm::vec3 scale(s[0].asNumber(1.0), s[1].asNumber(1.0), s[2].asNumber(1.0));
+        return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+    }
+}
+
+GltfAsset GltfImporter::load(Context* context, const std::string& path, const GltfImportSettings& settings) {
+    auto wallStart = Clock::now();
+    JobSystem* jobs = context->getJobSystem();
+    UploadEngine* uploads = context->getUploadEngine();
+    const uint64_t uploadedBefore = uploads->getUploadedBytes();
+    GltfAsset asset;
+    GltfImportStats& stats = asset.stats;
+
+    // 1. 映射文件并解析 JSON（映射在本函数内保持，零拷贝的视图在上传完成前有效）
+    auto start = Clock::now();
+    Document doc = openDocument(path);
+    stats.fileBytes = doc.file.getSize();
+    for (const auto& file : doc.externalFiles) stats.fileBytes += file.getSize();
+    stats.mapMs = elapsedMs(start);
+
+    // 2. 图像解码最先派发，与顶点准备重叠
+    const JsonValue& materials = doc.root["materials"];
+    const JsonValue& images = doc.root["images"];
+    std::vector<ImageJob> imageJobs(images.size());
+    const TextureFormatSupport formatSupport = Texture::queryFormatSupport(context);
+    if (settings.importTextures) {
+        for (size_t i = 0; i < materials.size(); i++) {
+            const JsonValue& material = materials[i];
+            const JsonValue& pbr = material["pbrMetallicRoughness"];
+            if (const int64_t image = getImageIndex(doc, pbr["baseColorTexture"]); image >= 0) {
+                imageJobs[image].roles[kRoleColor] = true;
+            }
+            if (const int64_t image = getImageIndex(doc, material["normalTexture"]); image >= 0) {
+                imageJobs[image].roles[kRoleNormal] = true;
+            }
+            if (const int64_t image = getImageIndex(doc, pbr["metallicRoughnessTexture"]); image >= 0) {
+                const bool occlusion = getImageIndex(doc, material["occlusionTexture"]) == image;
+                imageJobs[image].roles[occlusion ? kRoleOrm : kRoleRoughnessMetallic] = true;
+            }
+        }
+        for (size_t i = 0; i < imageJobs.size(); i++) {
+            ImageJob& job = imageJobs[i];
+            if (std::none_of(job.roles.begin(), job.roles.end(), [](bool used) { return used; })) continue;
+            const JsonValue& image = images[i];
+            const std::string label = path + "#image" + std::to_string(i);
+            std::span<const uint8_t> bytes;
+            std::string file;
+            if (const int64_t view = image["bufferView"].asInt(-1); view >= 0) {
+                bytes = getBufferView(doc, view);
+            } else if (!image["uri"].isNull() && !image["uri"].asString().starts_with("data:")) {
+                file = (doc.baseDir / decodeUri(image["uri"].asString())).string();
+            } else {
+                throw std::runtime_error("Unsupported glTF image source: " + label);
+            }
+            job.result = jobs->submit([jobs, formatSupport, bytes, file, label, roles = job.roles, compress = settings.compressTextures]() {
+                std::array<TextureSource, kRoleCount> result;
+                // 外部图像在工作线程上映射；glTF 的 UV 原点在左上角，不翻转
+                MappedFile mapped;
+                std::span<const uint8_t> source = bytes;
+                if (!file.empty()) {
+                    mapped = MappedFile(file);
+                    source = mapped.getBytes();
+                }
+                // 各用途分别查缓存，全部命中时不解码
+                const uint64_t sourceHash = compress ? TextureCache::hashBytes(source.data(), source.size()) : 0;
+                bool needsDecode = false;
+                for (uint32_t role = 0; role < kRoleCount; role++) {
+                    if (!roles[role]) continue;
+                    if (compress) {
+                        const TextureImportSettings roleSettings = getRoleSettings(static_cast<TextureRole>(role), compress);
+                        result[role].cached = TextureCache::open(getRoleLabel(label, static_cast<TextureRole>(role)),
+                                                                 roleSettings, sourceHash, formatSupport);
+                    }
+                    needsDecode = needsDecode || !result[role].cached;
+                }
+                if (!needsDecode) {
+                    return result;
+                }
+
+                const ImageData rgba = Texture::decode(source.data(), source.size(), label, false);
+                for (uint32_t role = 0; role < kRoleCount; role++) {
+                    if (!roles[role] || result[role].cached) continue;
+                    const auto textureRole = static_cast<TextureRole>(role);
+                    const TextureImportSettings roleSettings = getRoleSettings(textureRole, compress);
+                    ImageData image = textureRole == kRoleColor ? rgba : prepareRole(rgba, textureRole);
+                    result[role].encoded = Texture::encode(image, roleSettings, formatSupport, jobs);
+                    if (!result[role].encoded) {
+                        result[role].image = std::move(image);
+                        continue;
+                    }
+                    // 写缓存失败（只读目录等）不影响本次导入
+                    try {
+                        TextureCache::write(getRoleLabel(label, textureRole), roleSettings, sourceHash, formatSupport, *result[role].encoded);
+                    } catch (const std::exception& e) {
+                        std::println("Warning: {}", e.what());
+                    }
+                }
+                return result;
+            });
+        }
+    }
+
+    // 3. 收集三角形图元
+    const JsonValue& meshes = doc.root["meshes"];
+    const uint32_t defaultMaterial = static_cast<uint32_t>(materials.size());
+    std::vector<PrimitiveJob> primitives;
+    std::vector<std::vector<uint32_t>> meshPrimitives(meshes.size());   // glTF mesh -> primitives 下标
+    for (size_t m = 0; m < meshes.size(); m++) {
+        const JsonValue& list = meshes[m]["primitives"];
+        for (size_t p = 0; p < list.size(); p++) {
+            const JsonValue& primitive = list[p];
+            stats.primitiveCount++;
+            // mode 缺省为 4 (TRIANGLES)
+            if (primitive["mode"].asInt(4) != 4) {
+                stats.skippedPrimitives++;
+                continue;
+            }
+            PrimitiveJob job;
+            job.name = path + "#" + (meshes[m]["name"].asString().empty() ? "mesh" + std::to_string(m) : meshes[m]["name"].asString())
+                     + "/" + std::to_string(p);
+            const int64_t material = primitive["material"].asInt(-1);
+            job.material = material >= 0 && material < static_cast<int64_t>(defaultMaterial)
+                ? static_cast<uint32_t>(material) : defaultMaterial;
+            setupPrimitive(doc, primitive, job);
+            if (job.vertexCount == 0 || job.indexCount == 0) {
+                stats.skippedPrimitives++;
+                continue;
+            }
+            meshPrimitives[m].push_back(static_cast<uint32_t>(primitives.size()));
+            primitives.push_back(std::move(job));
+        }
+    }
+
+    // 4. 分块并行：交织非零拷贝的顶点，转换 / 校验索引
+    start = Clock::now();
+    std::vector<WorkChunk> chunks;
+    for (uint32_t p = 0; p < primitives.size(); p++) {
+        const PrimitiveJob& job = primitives[p];
+        if (!job.zeroCopyVertices) {
+            for (size_t begin = 0; begin < job.vertexCount; begin += kVertexChunk) {
+                chunks.push_back(WorkChunk{p, false, begin, std::min<size_t>(begin + kVertexChunk, job.vertexCount)});
+            }
+        }
+        for (size_t begin = 0; begin < job.indexCount; begin += kIndexChunk) {
+            chunks.push_back(WorkChunk{p, true, begin, std::min<size_t>(begin + kIndexChunk, job.indexCount)});
+        }
+    }
+    jobs->parallelFor(chunks.size(), [&](size_t i) {
+        WorkChunk& chunk = chunks[i];
+        PrimitiveJob& job = primitives[chunk.primitive];
+        if (chunk.indices) {
+            chunk.maxIndex = fillIndices(job, chunk.begin, chunk.end);
+        } else {
+            fillVertices(job, chunk.begin, chunk.end);
+        }
+    });
+    for (const WorkChunk& chunk : chunks) {
+        if (chunk.indices && chunk.maxIndex >= primitives[chunk.primitive].vertexCount) {
+            throw std::runtime_error("glTF index out of range in " + primitives[chunk.primitive].name);
+        }
+    }
+    std::vector<uint32_t> needNormals;
+    for (uint32_t p = 0; p < primitives.size(); p++) {
+        if (!primitives[p].normal.isValid()) needNormals.push_back(p);
+    }
+    jobs->parallelFor(needNormals.size(), [&](size_t i) { generateNormals(primitives[needNormals[i]]); });
+    jobs->parallelFor(primitives.size(), [&](size_t p) {
+        PrimitiveJob& job = primitives[p];
+        const auto* vertices = static_cast<const Vertex*>(makeView(job).vertices);
+        job.uvDensity = Mesh::computeUvDensity(vertices, job.indexCount, [&](size_t i) { return getIndex(job, i); });
+    });
+    stats.prepareMs = elapsedMs(start);
+
+    // 5. 主线程创建网格：零拷贝的视图直接从映射内存拷贝进 staging
+    start = Clock::now();
+    for (const PrimitiveJob& job : primitives) {
+        asset.meshes.push_back(std::make_shared<Mesh>(context, makeView(job), job.name));
+        asset.meshMaterials.push_back(job.material);
+        if (job.zeroCopyVertices) stats.zeroCopyPrimitives++;
+    }
+    stats.gpuCreateMs += elapsedMs(start);
+
+    // 6. 纹理与材质
+    for (size_t i = 0; i < imageJobs.size(); i++) {
+        ImageJob& job = imageJobs[i];
+        if (!job.result.valid()) continue;
+        start = Clock::now();
+        std::array<TextureSource, kRoleCount> sources = job.result.get();
+        stats.decodeMs += elapsedMs(start);
+
+        start = Clock::now();
+        const std::string label = path + "#image" + std::to_string(i);
+        for (uint32_t role = 0; role < kRoleCount; role++) {
+            if (!job.roles[role]) continue;
+            const auto textureRole = static_cast<TextureRole>(role);
+            const std::string name = getRoleLabel(label, textureRole);
+            TextureSource& source = sources[role];
+            if (source.cached) {
+                stats.textureCacheHits++;
+                const TextureView view = source.cached->view;
+                job.textures[role] = Texture::createFromSource(context, TextureStreamSource(std::move(source.cached->file), {}, view), name);
+            } else if (source.encoded) {
+                const TextureView view = source.encoded->getView();
+                job.textures[role] = Texture::createFromSource(context,
+                    TextureStreamSource(MappedFile(), std::move(source.encoded->data), view), name);
+            } else {
+                job.textures[role] = std::make_shared<Texture>(context, source.image, name,
+                                                               getRoleSettings(textureRole, settings.compressTextures));
+            }
+        }
+        for (const auto& texture : job.textures) {
+            if (texture) stats.textureCount++;
+        }
+        stats.gpuCreateMs += elapsedMs(start);
+    }
+
+    // 缺省贴图为 1x1，着色器中 纹理 * 因子 = 因子
+    start = Clock::now();
+    std::array<std::shared_ptr<Texture>, kRoleCount> fallbacks;
+    auto getFallback = [&](TextureRole role) {
+        if (!fallbacks[role]) {
+            const ImageData image = role == kRoleNormal ? makeSolidImage(128, 128, 255) : makeSolidImage(255, 255, 255);
+            TextureImportSettings fallbackSettings = getRoleSettings(role, false);
+            fallbackSettings.generateMips = false;
+            fallbacks[role] = std::make_shared<Texture>(context, image, path + "#default" + std::to_string(static_cast<uint32_t>(role)),
+                                                        fallbackSettings);
+        }
+        return fallbacks[role];
+    };
+    auto getTexture = [&](const JsonValue& textureInfo, TextureRole role) {
+        const int64_t image = settings.importTextures ? getImageIndex(doc, textureInfo) : -1;
+        if (image >= 0 && imageJobs[image].textures[role]) return imageJobs[image].textures[role];
+        return getFallback(role);
+    };
+    for (size_t i = 0; i <= materials.size(); i++) {
+        // 最后一个是规范中的默认材质（metallic = roughness = 1）
+        const JsonValue& material = materials[i];
+        const JsonValue& pbr = material["pbrMetallicRoughness"];
+        const JsonValue& factor = pbr["baseColorFactor"];
+        // 遮蔽只在与 metallicRoughness 同一张图时可用（打包在 R 通道）
+        const int64_t ormImage = getImageIndex(doc, pbr["metallicRoughnessTexture"]);
+        const bool occlusion = ormImage >= 0 && getImageIndex(doc, material["occlusionTexture"]) == ormImage;
+        MaterialUBO ubo{
+            .albedo = glm::vec3(factor[0].asNumber(1.0), factor[1].asNumber(1.0), factor[2].asNumber(1.0)),
+            .metallic = static_cast<float>(pbr["metallicFactor"].asNumber(1.0)),
+            .roughness = static_cast<float>(pbr["roughnessFactor"].asNumber(1.0)),
+            .ao = occlusion ? static_cast<float>(material["occlusionTexture"]["strength"].asNumber(1.0)) : 1.0f,
+            .normalScale = static_cast<float>(material["normalTexture"]["scale"].asNumber(1.0))
+        };
+        MaterialTextures textures{
+            .albedo = getTexture(pbr["baseColorTexture"], kRoleColor),
+            .normal = getTexture(material["normalTexture"], kRoleNormal),
+            .orm = getTexture(pbr["metallicRoughnessTexture"], occlusion ? kRoleOrm : kRoleRoughnessMetallic)
+        };
+        asset.materials.push_back(std::make_shared<Material>(context, PipelineType::Main, ubo, std::move(textures)));
+    }
+    stats.materialCount = materials.size();
+    stats.gpuCreateMs += elapsedMs(start);
+
+    // 7. 展开节点层次：scene 的根节点（没有 scenes 时取所有不是子节点的节点）
+    const JsonValue& nodes = doc.root["nodes"];
+    std::vector<size_t> roots;
+    const JsonValue& scene = doc.root["scenes"][static_cast<size_t>(doc.root["scene"].asInt(0))];
+    if (!scene.isNull()) {
+        for (size_t i = 0; i < scene["nodes"].size(); i++) roots.push_back(static_cast<size_t>(scene["nodes"][i].asInt(0)));
+    } else {
+        std::vector<bool> isChild(nodes.size(), false);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const JsonValue& children = nodes[i]["children"];
+            for (size_t c = 0; c < children.size(); c++) {
+                const size_t child = static_cast<size_t>(children[c].asInt(0));
+                if (child < isChild.size()) isChild[child] = true;
+            }
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (!isChild[i]) roots.push_back(i);
+        }
+    }
+    struct NodeEntry {
+        size_t node;
+        glm::mat4 parent;
+        size_t depth;
+    };
+    std::vector<NodeEntry> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) stack.push_back(NodeEntry{*it, glm::mat4(1.0f), 0});
+    while (!stack.empty()) {
+        const NodeEntry entry = stack.back();
+        stack.pop_back();
+        // 深度超过节点数说明层次中有环
+        if (entry.node >= nodes.size() || entry.depth > nodes.size()) {
+            throw std::runtime_error("Invalid glTF node hierarchy in " + path);
+        }
+        const JsonValue& node = nodes[entry.node];
+        const glm::mat4 world = entry.parent * getLocalMatrix(node);
+        const int64_t mesh = node["mesh"].asInt(-1);
+        if (mesh >= 0 && static_cast<size_t>(mesh) < meshPrimitives.size()) {
+            for (uint32_t primitive : meshPrimitives[mesh]) {
+                asset.instances.push_back(GltfInstance{primitive, world});
+            }
+        }
+        const JsonValue& children = node["children"];
+        for (size_t c = children.size(); c-- > 0;) {
+            stack.push_back(NodeEntry{static_cast<size_t>(children[c].asInt(0)), world, entry.depth + 1});
+        }
+    }
+    stats.instanceCount = asset.instances.size();
+
+    // 8. 一次提交并等待传输完成（之后才能解除映射）
+    auto waitStart = Clock::now();
+    uploads->waitIdle();
+    stats.uploadWaitMs = elapsedMs(waitStart);
+    stats.uploadedBytes = uploads->getUploadedBytes() - uploadedBefore;
+    stats.wallMs = elapsedMs(wallStart);
+
+    std::println("Imported glTF {}: {} primitive(s) ({} zero-copy, {} skipped), {} material(s), {} texture(s) ({} from cache), {} instance(s) in {:.2f} ms",
+                 path, asset.meshes.size(), stats.zeroCopyPrimitives, stats.skippedPrimitives,
+                 stats.materialCount, stats.textureCount, stats.textureCacheHits, stats.instanceCount, stats.wallMs);
+    std::println("  map+json {:.2f} ms | prepare {:.2f} ms | decode wait {:.2f} ms | gpu create {:.2f} ms | upload wait {:.2f} ms | {:.2f} MB file, {:.2f} MB uploaded",
+                 stats.mapMs, stats.prepareMs, stats.decodeMs, stats.gpuCreateMs, stats.uploadWaitMs,
+                 stats.fileBytes / (1024.0 * 1024.0), stats.uploadedBytes / (1024.0 * 1024.0));
+    return asset;
+}
+
+std::vector<std::shared_ptr<Renderable>> GltfImporter::instantiate(const GltfAsset& asset, Scene& scene,
+                                                                  DescriptorManager* descriptors,
+                                                                  uint32_t firstObjectIndex, uint32_t objectCapacity) {
+    std::vector<std::shared_ptr<Renderable>> renderables;
+    for (const GltfInstance& instance : asset.instances) {
+        const uint32_t objectIndex = firstObjectIndex + static_cast<uint32_t>(renderables.size());
+        if (objectIndex >= objectCapacity) {
+            std::println("Warning: glTF scene has {} instance(s), only {} fit into the object capacity",
+                         asset.instances.size(), renderables.size());
+            break;
+        }
+        const auto& material = asset.materials[asset.meshMaterials[instance.mesh]];
+        material->bindToDescriptorSet(descriptors, 1, objectIndex);
+        auto renderable = std::make_shared<Renderable>(asset.meshes[instance.mesh], material, objectIndex);
+        renderable->updateTransform(instance.transform);
+        scene.addRenderable(renderable);
+        renderables.push_back(std::move(renderable));
+    }
+    return renderables;
+}
@@ -0,0 +1,158 @@
+#include "Assets/Ktx2.h"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#include <vulkan/vulkan_format_traits.hpp>
+#include "3rd/stb_image.h"
+#ifdef VORTEX_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+    constexpr uint8_t kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    // 文件头各字段的偏移（标识符之后是 9 个 uint32，再是 DFD / KVD / SGD 索引）
+    constexpr size_t kVkFormatOffset = 12;
+    constexpr size_t kPixelWidthOffset = 20;
+    constexpr size_t kPixelHeightOffset = 24;
+    constexpr size_t kPixelDepthOffset = 28;
+    constexpr size_t kLayerCountOffset = 32;
+    constexpr size_t kFaceCountOffset = 36;
+    constexpr size_t kLevelCountOffset = 40;
+    constexpr size_t kSupercompressionOffset = 44;
+    constexpr size_t kLevelIndexOffset = 80;
+    constexpr size_t kLevelIndexEntrySize = 24;         // byteOffset, byteLength, uncompressedByteLength
+
+    constexpr uint32_t kSupercompressionNone = 0;
+    constexpr uint32_t kSupercompressionBasisLZ = 1;
+    constexpr uint32_t kSupercompressionZstd = 2;
+    constexpr uint32_t kSupercompressionZlib = 3;
+
+    // 解压后各级的起点按 16 字节对齐（满足块大小与 bufferOffset 的对齐要求）
+    constexpr uint64_t kLevelAlignment = 16;
+
+    uint32_t readU32(const uint8_t* bytes, size_t offset) {
+        uint32_t value;
+        std::memcpy(&value, bytes + offset, sizeof(value));
+        return value;
+    }
+
+    uint64_t readU64(const uint8_t* bytes, size_t offset) {
+        uint64_t value;
+        std::memcpy(&value, bytes + offset, sizeof(value));
+        return value;
+    }
+
+    // 单层 2D 纹理一个 mip 级的字节数：块数 × 块字节数（溢出时返回 UINT64_MAX，不会与任何数据长度相等）
+    uint64_t levelByteSize(vk::Format format, uint32_t width, uint32_t height, uint32_t level) {
+        const auto extent = vk::blockExtent(format);
+        const uint64_t blocksX = (std::max(width >> level, 1u) + uint64_t{extent[0]} - 1) / extent[0];
+        const uint64_t blocksY = (std::max(height >> level, 1u) + uint64_t{extent[1]} - 1) / extent[1];
+        const uint64_t blockBytes = vk::blockSize(format);
+        if (blocksX > UINT64_MAX / blocksY / blockBytes) {
+            return UINT64_MAX;
+        }
+        return blocksX * blocksY * blockBytes;
+    }
+
+    void decompressLevel(uint32_t scheme, const uint8_t* source, uint64_t sourceSize, uint8_t* target, uint64_t targetSize,
+                         const std::string& name) {
+        if (scheme == kSupercompressionZlib) {
+            const int written = stbi_zlib_decode_buffer(reinterpret_cast<char*>(target), static_cast<int>(targetSize),
+                                                        reinterpret_cast<const char*>(source), static_cast<int>(sourceSize));
+            if (written < 0 || static_cast<uint64_t>(written) != targetSize) {
+                throw std::runtime_error("KTX2: failed to inflate mip level of " + name);
+            }
+            return;
+        }
+#ifdef VORTEX_HAS_ZSTD
+        const size_t written = ZSTD_decompress(target, static_cast<size_t>(targetSize), source, static_cast<size_t>(sourceSize));
+        if (ZSTD_isError(written) || written != targetSize) {
+            throw std::runtime_error("KTX2: failed to decompress Zstandard mip level of " + name);
+        }
+#else
+        (void)source; (void)sourceSize; (void)target; (void)targetSize;
+        throw std::runtime_error("KTX2: Zstandard supercompression requires building with libzstd: " + name);
+#endif
+    }
+}
+
+bool Ktx2::isKtx2(const uint8_t* bytes, size_t size) {
+    return size >= sizeof(kIdentifier) && std::memcmp(bytes, kIdentifier, sizeof(kIdentifier)) == 0;
+}
+
+Ktx2Image Ktx2::parse(const uint8_t* bytes, size_t size, const std::string& name) {
+    if (!isKtx2(bytes, size) || size < kLevelIndexOffset) {
+        throw std::runtime_error("Not a KTX2 file: " + name);
+    }
+    Ktx2Image image;
+    image.source = bytes;
+    image.format = static_cast<vk::Format>(readU32(bytes, kVkFormatOffset));
+    image.width = readU32(bytes, kPixelWidthOffset);
+    image.height = readU32(bytes, kPixelHeightOffset);
+    image.supercompression = readU32(bytes, kSupercompressionOffset);
+    const uint32_t depth = readU32(bytes, kPixelDepthOffset);
+    const uint32_t layers = readU32(bytes, kLayerCountOffset);
+    const uint32_t faces = readU32(bytes, kFaceCountOffset);
+    const uint32_t levelCount = std::max(readU32(bytes, kLevelCountOffset), 1u);
+
+    if (image.format == vk::Format::eUndefined) {
+        throw std::runtime_error("KTX2: Basis Universal textures need a transcoder and are not supported: " + name);
+    }
+    if (image.width == 0 || image.height == 0 || depth > 1 || layers > 1 || faces != 1) {
+        throw std::runtime_error("KTX2: only single 2D textures are supported: " + name);
+    }
+    if (vk::blockSize(image.format) == 0 || vk::planeCount(image.format) != 1) {
+        throw std::runtime_error("KTX2: unsupported vkFormat " + vk::to_string(image.format) + ": " + name);
+    }
+    if (image.supercompression != kSupercompressionNone && image.supercompression != kSupercompressionZstd &&
+        image.supercompression != kSupercompressionZlib) {
+        throw std::runtime_error("KTX2: unsupported supercompression scheme " + std::to_string(image.supercompression) +
+                                 (image.supercompression == kSupercompressionBasisLZ ? " (BasisLZ)" : "") + ": " + name);
+    }
+    if (levelCount > static_cast<uint32_t>(std::bit_width(std::max(image.width, image.height)))) {
+        throw std::runtime_error("KTX2: " + std::to_string(levelCount) + " mip levels exceed the full chain of a " +
+                                 std::to_string(image.width) + "x" + std::to_string(image.height) + " texture: " + name);
+    }
+    if (kLevelIndexOffset + static_cast<uint64_t>(levelCount) * kLevelIndexEntrySize > size) {
+        throw std::runtime_error("KTX2: truncated level index: " + name);
+    }
+
+    // 级别索引按 mip 0 在前排列（数据在文件中通常是小 mip 在前）
+    uint64_t decompressedSize = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const size_t entry = kLevelIndexOffset + level * kLevelIndexEntrySize;
+        const uint64_t byteOffset = readU64(bytes, entry);
+        const uint64_t byteLength = readU64(bytes, entry + 8);
+        const uint64_t uncompressedLength = readU64(bytes, entry + 16);
+        if (byteLength == 0 || byteOffset > size || byteLength > size - byteOffset) {
+            throw std::runtime_error("KTX2: mip level " + std::to_string(level) + " is outside the file: " + name);
+        }
+        // 上传按格式的块大小计算各级的拷贝区域，数据长度必须与之一致
+        const uint64_t expectedLength = levelByteSize(image.format, image.width, image.height, level);
+        const uint64_t levelLength = image.supercompression == kSupercompressionNone ? byteLength : uncompressedLength;
+        if (levelLength != expectedLength) {
+            throw std::runtime_error("KTX2: mip level " + std::to_string(level) + " has " + std::to_string(levelLength) +
+                                     " bytes, expected " + std::to_string(expectedLength) + ": " + name);
+        }
+        if (image.supercompression == kSupercompressionNone) {
+            image.levels.push_back(TextureLevel{byteOffset, byteLength});
+        } else {
+            decompressedSize = (decompressedSize + kLevelAlignment - 1) & ~(kLevelAlignment - 1);
+            image.levels.push_back(TextureLevel{decompressedSize, uncompressedLength});
+            decompressedSize += uncompressedLength;
+        }
+    }
+
+    if (image.supercompression != kSupercompressionNone) {
+        image.decompressed.resize(static_cast<size_t>(decompressedSize));
+        for (uint32_t level = 0; level < levelCount; level++) {
+            const size_t entry = kLevelIndexOffset + level * kLevelIndexEntrySize;
+            decompressLevel(image.supercompression, bytes + readU64(bytes, entry), readU64(bytes, entry + 8),
+                            image.decompressed.data() + image.levels[level].offset, image.levels[level].size, name);
+        }
+    }
+    return image;
+}
@@ -1,43 +1,80 @@
 #include "Assets/Material.h"
 #include "Core/Descriptor.h"
+#include "Assets/AssetRegistry.h"
+#include <array>
+#include <optional>
 
-Material::Material(Context* context,
+namespace {
+    // 纹理作为一个批次交给注册表：已加载的直接共享，其余并行解码
+    MaterialTextures loadTextures(AssetRegistry& registry,
+                                  const std::string& albedoPath,
+                                  const std::string& normalPath,
+                                  const std::string& metallicPath,
+                                  const std::string& roughnessPath,
+                                  const std::string& occlusionPath) {
+        // 按用途选择格式：反照率 BC7 / BC1（sRGB），法线 BC5（两通道），ORM 打包为一张线性 BC7 / BC1
+        std::vector<AssetRegistry::TextureRequest> requests;
+        std::array<std::optional<size_t>, 3> slots;
+        if (!albedoPath.empty()) {
+            slots[0] = requests.size();
+            requests.push_back({albedoPath, TextureImportSettings{.srgb = true, .usage = TextureUsage::Color}});
+        }
+        if (!normalPath.empty()) {
+            slots[1] = requests.size();
+            requests.push_back({normalPath, TextureImportSettings{.srgb = false, .usage = TextureUsage::Normal}});
+        }
+        if (!occlusionPath.empty() || !roughnessPath.empty() || !metallicPath.empty()) {
+            slots[2] = requests.size();
+            requests.push_back({"", TextureImportSettings{.srgb = false, .usage = TextureUsage::Orm},
+                                {occlusionPath, roughnessPath, metallicPath}});
+        }
+        std::vector<TextureHandle> handles = registry.loadTextures(requests);
+
+        MaterialTextures textures;
+        if (slots[0]) textures.albedo = handles[*slots[0]];
+        if (slots[1]) textures.normal = handles[*slots[1]];
+        if (slots[2]) textures.orm = handles[*slots[2]];
+        return textures;
+    }
+}
+
+Material::Material(AssetRegistry& registry,
                    PipelineType pipelineType,
                    const MaterialUBO& uboData,
                    const std::string& albedoPath,
                    const std::string& normalPath,
                    const std::string& metallicPath,
-                   const std::string& roughnessPath)
+                   const std::string& roughnessPath,
+                   const std::string& occlusionPath)
+    : Material(registry.getContext(), pipelineType, uboData,
+               loadTextures(registry, albedoPath, normalPath, metallicPath, roughnessPath, occlusionPath)) {
+}
+
+Material::Material(Context* context,
+                   PipelineType pipelineType,
+                   const MaterialUBO& uboData,
+                   MaterialTextures textures)
     : m_context(context)
     , m_pipelineType(pipelineType)
-    , m_uboData(uboData) {
-
-    // Load textures only if paths are provided
-    if (!albedoPath.empty()) {
-        m_albedoMap = std::make_unique<Texture>(context, albedoPath);
-    }
-    if (!normalPath.empty()) {
-        m_normalMap = std::make_unique<Texture>(context, normalPath);
-    }
-    if (!metallicPath.empty()) {
-        m_metallicMap = std::make_unique<Texture>(context, metallicPath);
-    }
-    if (!roughnessPath.empty()) {
-        m_roughnessMap = std::make_unique<Texture>(context, roughnessPath);
-    }
+    , m_uboData(uboData)
+    , m_albedoMap(std::move(textures.albedo))
+    , m_normalMap(std::move(textures.normal))
+    , m_ormMap(std::move(textures.orm)) {
 }
 
 // 移动构造函数和移动赋值运算符使用 = default，在头文件中已声明
 
 void Material::bindToDescriptorSet(DescriptorManager* descriptorManager,
                                   uint32_t layoutIdx,
-                                  uint32_t setInstance) {
+                                  uint32_t setInstance,
+                                  uint32_t copy) {
     // binding 3: albedoMap
     if (m_albedoMap) {
         descriptorManager->bindImageToSet(
             layoutIdx, setInstance, 3,
             m_albedoMap->getImageView(),
-            m_albedoMap->getSampler()
+            m_albedoMap->getSampler(),
+            copy
         );
     }
 
@@ -46,25 +83,18 @@ void Material::bindToDescriptorSet(DescriptorManager* descriptorManager,
         descriptorManager->bindImageToSet(
             layoutIdx, setInstance, 4,
             m_normalMap->getImageView(),
-            m_normalMap->getSampler()
+            m_normalMap->getSampler(),
+            copy
         );
     }
 
-    // binding 5: metallicMap
-    if (m_metallicMap) {
+    // binding 5: ormMap（R = 遮蔽，G = 粗糙度，B = 金属度）
+    if (m_ormMap) {
         descriptorManager->bindImageToSet(
             layoutIdx, setInstance, 5,
-            m_metallicMap->getImageView(),
-            m_metallicMap->getSampler()
-        );
-    }
-
-    // binding 6: roughnessMap
-    if (m_roughnessMap) {
-        descriptorManager->bindImageToSet(
-            layoutIdx, setInstance, 6,
-            m_roughnessMap->getImageView(),
-            m_roughnessMap->getSampler()
+            m_ormMap->getImageView(),
+            m_ormMap->getSampler(),
+            copy
         );
     }
 }
@@ -1,312 +1,587 @@
 #include "Assets/Mesh.h"
-#include <iostream>
+#include "Assets/VertexDedup.h"
+#include "Assets/ObjParser.h"
+#include "Assets/MappedFile.h"
+#include "Assets/MeshSimplifier.h"
+#include "Core/MemoryTracker.h"
+#include "Core/UploadEngine.h"
 #include <print>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
 
 
-// 定义 tinyobj 实现
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "3rd/tiny_obj_loader.h"
+namespace {
+    // 八面体编码：单位向量投影到 |x|+|y|+|z|=1，下半球沿对角线折叠到外侧
+    glm::vec2 octEncode(glm::vec3 n) {
+        n /= (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+        glm::vec2 p(n.x, n.y);
+        if (n.z < 0.0f) {
+            p = glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                          (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+        }
+        return p;
+    }
 
+    // 与 pbr_compact.vert 中的解码一致
+    glm::vec3 octDecode(glm::vec2 e) {
+        glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        const float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
 
-namespace {
-    // Hash function for Vertex to enable unordered_map
-    struct VertexHash {
-        size_t operator()(const Vertex& vertex) const noexcept {
-            size_t h1 = std::hash<float>()(vertex.pos.x);
-            size_t h2 = std::hash<float>()(vertex.pos.y);
-            size_t h3 = std::hash<float>()(vertex.pos.z);
-            size_t h4 = std::hash<float>()(vertex.normal.x);
-            size_t h5 = std::hash<float>()(vertex.normal.y);
-            size_t h6 = std::hash<float>()(vertex.normal.z);
-            size_t h7 = std::hash<float>()(vertex.texCoord.x);
-            size_t h8 = std::hash<float>()(vertex.texCoord.y);
-            return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3) ^ (h5 << 4) ^ (h6 << 5) ^ (h7 << 6) ^ (h8 << 7);
+    int16_t toSnorm16(float value) {
+        return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+    float fromSnorm16(int16_t value) {
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    // 包围盒的外接球（xyz 中心，w 半径），与 MeshCache 由文件头包围盒还原的结果一致
+    glm::vec4 computeBoundingSphere(const std::vector<Vertex>& vertices) {
+        if (vertices.empty()) return glm::vec4(0.0f);
+        glm::vec3 boundsMin = vertices[0].pos;
+        glm::vec3 boundsMax = vertices[0].pos;
+        for (const Vertex& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.pos);
+            boundsMax = glm::max(boundsMax, vertex.pos);
+        }
+        return glm::vec4((boundsMin + boundsMax) * 0.5f, glm::length(boundsMax - boundsMin) * 0.5f);
+    }
+
+    // LOD 链：每级以上一级三角形数的一半为目标，累计误差不超过包围盒对角线的 5%
+    constexpr uint32_t kMaxLodLevels = 6;           // 含 0 级
+    constexpr float kLodReduction = 0.5f;
+    constexpr float kLodMaxRelativeError = 0.05f;
+    constexpr size_t kLodMinTriangles = 64;
+    constexpr float kLodMinProgress = 0.85f;        // 去掉的三角形不到 15% 时停止（锁定的边界 / 接缝太多）
+}
+
+// Parse OBJ text into deduplicated vertices / indices (CPU only, thread safe)
+MeshData Mesh::parseObj(std::string_view text, const std::string& name, JobSystem* jobs) {
+    ObjData obj = ObjParser::parse(text, name, jobs);
+
+    // 按需从属性数组组装顶点，不额外保存每个角点的完整顶点
+    auto fetch = [&](size_t corner) {
+        const ObjIndex& index = obj.corners[corner];
+        Vertex vertex{};
+
+        // Position (location = 0)
+        vertex.pos = {
+            obj.positions[3 * index.position + 0],
+            obj.positions[3 * index.position + 1],
+            obj.positions[3 * index.position + 2]
+        };
+
+        // Normal (location = 1)
+        if (index.normal >= 0) {
+            vertex.normal = {
+                obj.normals[3 * index.normal + 0],
+                obj.normals[3 * index.normal + 1],
+                obj.normals[3 * index.normal + 2]
+            };
+        } else {
+            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f); // Default normal
         }
+
+        // Texture coordinate (location = 2)
+        if (index.texCoord >= 0) {
+            vertex.texCoord = {
+                obj.texCoords[2 * index.texCoord + 0],
+                obj.texCoords[2 * index.texCoord + 1]
+            };
+        } else {
+            vertex.texCoord = glm::vec2(0.0f, 0.0f); // Default UV
+        }
+        return vertex;
     };
+
+    // Deduplicate vertices (bit-exact keys, open addressing, partitioned across workers for large meshes)
+    auto unique = VertexDedup::deduplicate<Vertex>(obj.corners.size(), fetch, jobs);
+    MeshData data;
+    data.vertices = std::move(unique.vertices);
+    data.indices = std::move(unique.indices);
+    // 每个 o / g 组记为一个子网格
+    for (const ObjShape& shape : obj.shapes) {
+        data.submeshes.push_back(Submesh{shape.firstCorner, shape.cornerCount});
+    }
+    return data;
 }
 
-// Load from OBJ file constructor
-Mesh::Mesh(Context* context, const std::string& objPath)
-    : m_context(context)
-    , m_indexCount(0)
-    , m_vertexBuffer(nullptr)
-    , m_indexBuffer(nullptr)
-    , m_vertexAllocation(VK_NULL_HANDLE)
-    , m_indexAllocation(VK_NULL_HANDLE) {
+MeshData Mesh::loadObj(const std::string& objPath) {
+    MappedFile file(objPath);
+    return Mesh::parseObj(std::string_view(reinterpret_cast<const char*>(file.getData()), file.getSize()), objPath);
+}
+
+void Mesh::compress(MeshData& data) {
+    QuantizationInfo& info = data.quantization;
+    info = QuantizationInfo{};
+    data.compactVertices.clear();
+    if (data.vertices.empty()) {
+        return;
+    }
 
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
+    // 1. 包围盒：位置量化到 [min, min + extent]，退化的轴保持 1 避免除零
+    glm::vec3 boundsMax = data.vertices[0].pos;
+    info.boundsMin = data.vertices[0].pos;
+    for (const auto& vertex : data.vertices) {
+        info.boundsMin = glm::min(info.boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+    info.boundsExtent = boundsMax - info.boundsMin;
+    for (int axis = 0; axis < 3; axis++) {
+        if (info.boundsExtent[axis] <= 0.0f) info.boundsExtent[axis] = 1.0f;
+    }
 
-    // Load OBJ file (triangulate = true, mtl_basedir = NULL 不加载 MTL)
-    bool triangulate = true;
-    const char* mtl_basedir = nullptr;  // 不加载 MTL 文件
+    // 2. 逐顶点编码，同时按解码结果统计最大误差
+    data.compactVertices.resize(data.vertices.size());
+    for (size_t i = 0; i < data.vertices.size(); i++) {
+        const Vertex& vertex = data.vertices[i];
+        CompactVertex& compact = data.compactVertices[i];
+
+        const glm::vec3 unit = glm::clamp((vertex.pos - info.boundsMin) / info.boundsExtent, 0.0f, 1.0f);
+        glm::vec3 decodedPos;
+        for (int axis = 0; axis < 3; axis++) {
+            compact.position[axis] = static_cast<uint16_t>(std::lround(unit[axis] * 65535.0f));
+            decodedPos[axis] = info.boundsMin[axis] + compact.position[axis] / 65535.0f * info.boundsExtent[axis];
+        }
+        compact.position[3] = 0;
+        info.maxPositionError = std::max(info.maxPositionError, glm::length(decodedPos - vertex.pos));
+
+        const float length = glm::length(vertex.normal);
+        const glm::vec3 normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+        const glm::vec2 oct = octEncode(normal);
+        compact.normal[0] = toSnorm16(oct.x);
+        compact.normal[1] = toSnorm16(oct.y);
+        const glm::vec3 decodedNormal = octDecode(glm::vec2(fromSnorm16(compact.normal[0]), fromSnorm16(compact.normal[1])));
+        const float cosAngle = std::clamp(glm::dot(normal, decodedNormal), -1.0f, 1.0f);
+        info.maxNormalErrorDegrees = std::max(info.maxNormalErrorDegrees, glm::degrees(std::acos(cosAngle)));
+
+        for (int c = 0; c < 2; c++) {
+            compact.texCoord[c] = glm::packHalf1x16(vertex.texCoord[c]);
+            const float decoded = glm::unpackHalf1x16(compact.texCoord[c]);
+            info.maxTexCoordError = std::max(info.maxTexCoordError, std::abs(decoded - vertex.texCoord[c]));
+        }
+    }
+}
 
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.c_str(), mtl_basedir, triangulate)) {
-        throw std::runtime_error("Failed to load OBJ file: " + objPath + "\n" + err);
+void Mesh::optimize(MeshData& data) {
+    if (data.vertices.empty() || data.indices.empty()) {
+        return;
+    }
+    // LOD 链引用优化前的顶点编号：只保留 0 级，之后由 buildLods 重新生成
+    if (!data.lods.empty()) {
+        data.indices.resize(data.lods.front().indexCount);
+        data.lods.clear();
     }
+    const size_t vertexCount = data.vertices.size();
+    data.cacheBefore = MeshOptimizer::analyzeVertexCache(data.indices, vertexCount);
 
-    // 只打印严重错误，忽略 MTL 相关警告
-    if (!err.empty()) {
-        std::cerr << "OBJ loading error: " << err << std::endl;
+    // 顺序不能交换：过度绘制排序以缓存重排后的簇为单位，顶点读取重排依赖最终的索引顺序。
+    // 三角形只在各自的子网格内重排，子网格的索引区间保持不变
+    if (data.submeshes.empty()) {
+        data.submeshes.push_back(Submesh{0, static_cast<uint32_t>(data.indices.size())});
+    }
+    std::vector<uint32_t> slice;
+    for (const Submesh& submesh : data.submeshes) {
+        const auto begin = data.indices.begin() + submesh.firstIndex;
+        slice.assign(begin, begin + submesh.indexCount);
+        MeshOptimizer::optimizeVertexCache(slice, vertexCount);
+        MeshOptimizer::optimizeOverdraw(slice, &data.vertices[0].pos.x, sizeof(Vertex), vertexCount);
+        std::copy(slice.begin(), slice.end(), begin);
     }
 
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
-    std::unordered_map<Vertex, uint32_t, VertexHash> uniqueVertices{};
+    size_t usedVertices = 0;
+    const std::vector<uint32_t> remap = MeshOptimizer::optimizeVertexFetch(data.indices, vertexCount, usedVertices);
+    std::vector<Vertex> reordered(usedVertices);
+    for (size_t v = 0; v < vertexCount; v++) {
+        if (remap[v] != UINT32_MAX) reordered[remap[v]] = data.vertices[v];
+    }
+    data.vertices.swap(reordered);
 
-    // Process each shape in the OBJ file
-    for (const auto& shape : shapes) {
-        for (const auto& index : shape.mesh.indices) {
-            Vertex vertex{};
+    data.cacheAfter = MeshOptimizer::analyzeVertexCache(data.indices, data.vertices.size());
+    data.optimized = true;
+    // 顶点顺序已经改变，之前的压缩结果与网格簇作废
+    data.compactVertices.clear();
+    data.meshlets.clear();
+}
 
-            // Position (location = 0)
-            vertex.pos = {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
+void Mesh::buildLods(MeshData& data) {
+    if (!data.lods.empty()) {
+        data.indices.resize(data.lods.front().indexCount);
+        data.lods.clear();
+    }
+    // 簇按级别划分，索引追加之后需要重新划分
+    data.meshlets.clear();
+    if (data.vertices.empty() || data.indices.empty()) {
+        return;
+    }
+    if (data.submeshes.empty()) {
+        data.submeshes.push_back(Submesh{0, static_cast<uint32_t>(data.indices.size())});
+    }
+    data.lods.push_back(MeshLod{0, static_cast<uint32_t>(data.indices.size())});
+
+    // 每级在上一级的结果上继续简化（比每次从 0 级开始快），各级误差按三角不等式累加为相对 0 级的误差。
+    // 级别之间不区分子网格：简化后的三角形可能跨越原来的子网格边界
+    const size_t vertexCount = data.vertices.size();
+    const float errorBudget = computeBoundingSphere(data.vertices).w * 2.0f * kLodMaxRelativeError;
+    std::vector<uint32_t> current = data.indices;
+    float error = 0.0f;
+    for (uint32_t level = 1; level < kMaxLodLevels; level++) {
+        const size_t targetTriangles = static_cast<size_t>(static_cast<float>(current.size() / 3) * kLodReduction);
+        if (targetTriangles < kLodMinTriangles) break;
+        std::vector<uint32_t> next = current;
+        const float stepError = MeshSimplifier::simplify(next, &data.vertices[0].pos.x, sizeof(Vertex), vertexCount,
+                                                         targetTriangles * 3, std::max(errorBudget - error, 0.0f));
+        if (static_cast<float>(next.size()) > static_cast<float>(current.size()) * kLodMinProgress) break;
+        MeshOptimizer::optimizeVertexCache(next, vertexCount);
+        error += stepError;
+        data.lods.push_back(MeshLod{static_cast<uint32_t>(data.indices.size()), static_cast<uint32_t>(next.size()), 0, 0, error});
+        data.indices.insert(data.indices.end(), next.begin(), next.end());
+        current.swap(next);
+    }
+}
 
-            // Normal (location = 1)
-            if (index.normal_index >= 0) {
-                vertex.normal = {
-                    attrib.normals[3 * index.normal_index + 0],
-                    attrib.normals[3 * index.normal_index + 1],
-                    attrib.normals[3 * index.normal_index + 2]
-                };
-            } else {
-                vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f); // Default normal
-            }
-
-            // Texture coordinate (location = 2)
-            if (index.texcoord_index >= 0) {
-                vertex.texCoord = {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    attrib.texcoords[2 * index.texcoord_index + 1]
-                };
-            } else {
-                vertex.texCoord = glm::vec2(0.0f, 0.0f); // Default UV
-            }
-
-            // Deduplicate vertices using hash map
-            if (uniqueVertices.count(vertex) == 0) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-            }
-            indices.push_back(uniqueVertices[vertex]);
+void Mesh::buildMeshlets(MeshData& data) {
+    data.meshlets.clear();
+    if (data.vertices.empty() || data.indices.empty()) {
+        return;
+    }
+    if (data.submeshes.empty()) {
+        data.submeshes.push_back(Submesh{0, static_cast<uint32_t>(data.indices.size())});
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    ranges.reserve(data.submeshes.size());
+    for (const Submesh& submesh : data.submeshes) {
+        ranges.emplace_back(submesh.firstIndex, submesh.indexCount);
+    }
+    // 0 级即各子网格，更粗的级别各自划分，簇不会跨越级别
+    for (size_t level = 1; level < data.lods.size(); level++) {
+        ranges.emplace_back(data.lods[level].firstIndex, data.lods[level].indexCount);
+    }
+    data.meshlets = MeshletBuilder::build(data.indices, ranges, &data.vertices[0].pos.x, sizeof(Vertex), data.vertices.size());
+
+    // 簇按区间顺序输出，同一级的簇是连续的一段
+    for (MeshLod& lod : data.lods) {
+        lod.firstMeshlet = 0;
+        lod.meshletCount = 0;
+        for (size_t m = 0; m < data.meshlets.size(); m++) {
+            const uint32_t firstIndex = data.meshlets[m].firstIndex;
+            if (firstIndex < lod.firstIndex || firstIndex >= lod.firstIndex + lod.indexCount) continue;
+            if (lod.meshletCount++ == 0) lod.firstMeshlet = static_cast<uint32_t>(m);
         }
     }
 
-    m_indexCount = static_cast<uint32_t>(indices.size());
+    // 簇内重排改变了三角形顺序，重新统计优化后的缓存命中（只统计 0 级）
+    if (data.optimized) {
+        const size_t lod0Count = data.lods.empty() ? data.indices.size() : data.lods.front().indexCount;
+        const std::vector<uint32_t> lod0(data.indices.begin(), data.indices.begin() + lod0Count);
+        data.cacheAfter = MeshOptimizer::analyzeVertexCache(lod0, data.vertices.size());
+    }
+}
 
-    // Create Vulkan buffers
-    this->createVertexBuffer(vertices);
-    this->createIndexBuffer(indices);
+void Mesh::process(MeshData& data, const MeshImportSettings& settings) {
+    if (settings.optimize && !data.optimized) {
+        Mesh::optimize(data);
+    }
+    // 在优化之后简化：各级沿用重排后的顶点，只追加索引
+    if (settings.lods && data.lods.empty()) {
+        Mesh::buildLods(data);
+    }
+    // 在优化之后划分：簇以缓存重排后的三角形顺序为种子生长
+    if (settings.meshlets && data.meshlets.empty()) {
+        Mesh::buildMeshlets(data);
+    }
+    if (settings.vertexFormat == VertexFormat::Compact && data.compactVertices.size() != data.vertices.size()) {
+        Mesh::compress(data);
+    }
+}
 
-    std::println("Loaded OBJ:{} - Vertices:{},Indices:{}",objPath,vertices.size(),indices.size());
+// Load from OBJ file constructor
+Mesh::Mesh(Context* context, const std::string& objPath, const MeshImportSettings& settings)
+    : Mesh(context, Mesh::loadObj(objPath), objPath, settings) {
 }
 
-// Destructor
-Mesh::~Mesh() {
-    if (m_context && m_vertexBuffer && m_vertexAllocation != VK_NULL_HANDLE) {
-        auto allocator = m_context->getVmaAllocator();
-        vmaDestroyBuffer(allocator, static_cast<VkBuffer>(m_vertexBuffer), m_vertexAllocation);
+// Create from already parsed data (arena allocation + upload only)
+Mesh::Mesh(Context* context, const MeshData& data, const std::string& name, const MeshImportSettings& settings)
+    : m_context(context)
+    , m_name(name)
+    , m_indexCount(static_cast<uint32_t>(data.indices.size()))
+    , m_geometry(GeometryArena::kInvalidHandle)
+    , m_vertexFormat(settings.vertexFormat) {
+
+    // 导入器通常已在工作线程上处理过，这里只处理直接构造的情况
+    const MeshData* source = &data;
+    MeshData processed;
+    const bool needsOptimize = settings.optimize && !data.optimized;
+    const bool needsLods = settings.lods && data.lods.empty();
+    const bool needsMeshlets = settings.meshlets && data.meshlets.empty();
+    const bool needsCompress = m_vertexFormat == VertexFormat::Compact && data.compactVertices.size() != data.vertices.size();
+    if (needsOptimize || needsLods || needsMeshlets || needsCompress) {
+        processed = data;
+        Mesh::process(processed, settings);
+        source = &processed;
+    }
+    if (settings.meshlets) {
+        m_meshlets = source->meshlets;
+    }
+    this->initLods(source->lods.data(), static_cast<uint32_t>(source->lods.size()), static_cast<uint32_t>(source->indices.size()));
+    m_boundingSphere = computeBoundingSphere(source->vertices);
+    m_uvDensity = Mesh::computeUvDensity(source->vertices.data(), m_indexCount,
+                                         [&](size_t i) { return source->indices[i]; });
+    m_submeshes = source->submeshes;
+    if (m_submeshes.empty()) {
+        m_submeshes.push_back(Submesh{0, m_indexCount});
+    }
+
+    if (m_vertexFormat == VertexFormat::Compact) {
+        m_quantization = source->quantization;
+        this->createGeometry(source->compactVertices.data(), static_cast<uint32_t>(source->compactVertices.size()),
+                             sizeof(CompactVertex), source->indices);
+
+        const glm::vec3& extent = m_quantization.boundsExtent;
+        const float diagonal = glm::length(extent);
+        std::println("Loaded OBJ:{} - Vertices:{},Indices:{} (compact, {} -> {} bytes/vertex)",
+                     name, source->vertices.size(), source->indices.size(), sizeof(Vertex), sizeof(CompactVertex));
+        std::println("  quantization error: position {:.6f} ({:.4f}% of bounds), normal {:.4f} deg, uv {:.6f}",
+                     m_quantization.maxPositionError,
+                     diagonal > 0.0f ? m_quantization.maxPositionError / diagonal * 100.0f : 0.0f,
+                     m_quantization.maxNormalErrorDegrees, m_quantization.maxTexCoordError);
+    } else {
+        this->createGeometry(source->vertices.data(), static_cast<uint32_t>(source->vertices.size()), sizeof(Vertex), source->indices);
+        std::println("Loaded OBJ:{} - Vertices:{},Indices:{}", name, source->vertices.size(), source->indices.size());
+    }
+    if (source->optimized) {
+        std::println("  vertex cache: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {}-bit indices",
+                     source->cacheBefore.acmr, source->cacheAfter.acmr,
+                     source->cacheBefore.atvr, source->cacheAfter.atvr,
+                     this->getRange().indexType == vk::IndexType::eUint16 ? 16 : 32);
+    }
+    if (settings.meshlets) {
+        this->createMeshletBuffer(source->indices.data(), vk::IndexType::eUint32, static_cast<uint32_t>(source->vertices.size()));
+        if (!m_meshlets.empty()) {
+            std::println("  meshlets: {} ({:.1f} triangles avg)", m_meshlets.size(),
+                         static_cast<double>(source->indices.size()) / 3.0 / static_cast<double>(m_meshlets.size()));
+        }
     }
-    if (m_context && m_indexBuffer && m_indexAllocation != VK_NULL_HANDLE) {
-        auto allocator = m_context->getVmaAllocator();
-        vmaDestroyBuffer(allocator, static_cast<VkBuffer>(m_indexBuffer), m_indexAllocation);
+    if (m_lods.size() > 1) {
+        std::string chain;
+        for (const MeshLod& lod : m_lods) {
+            chain += (chain.empty() ? "" : " -> ") + std::to_string(lod.indexCount / 3);
+        }
+        std::println("  LOD chain: {} triangles, max error {:.6f} ({:.3f}% of bounds)", chain, m_lods.back().error,
+                     m_boundingSphere.w > 0.0f ? m_lods.back().error / (m_boundingSphere.w * 2.0f) * 100.0f : 0.0f);
     }
 }
 
+// Create from a GPU-ready view (e.g. a mapped .vmesh), no conversion before staging
+Mesh::Mesh(Context* context, const MeshView& view, const std::string& name)
+    : m_context(context)
+    , m_name(name)
+    , m_indexCount(view.indexCount)
+    , m_geometry(GeometryArena::kInvalidHandle)
+    , m_vertexFormat(view.vertexFormat)
+    , m_quantization(view.quantization)
+    , m_submeshes(view.submeshes, view.submeshes + view.submeshCount)
+    , m_meshlets(view.meshlets, view.meshlets + view.meshletCount)
+    , m_boundingSphere(view.boundingSphere)
+    , m_uvDensity(view.uvDensity) {
+    this->initLods(view.lods, view.lodCount, view.indexCount);
+    if (m_submeshes.empty()) {
+        m_submeshes.push_back(Submesh{0, m_indexCount});
+    }
+    this->createGeometry(view);
+    this->createMeshletBuffer(view.indices, view.indexType, view.vertexCount);
+    std::println("Loaded mesh:{} - Vertices:{},Indices:{},Submeshes:{},Meshlets:{},LODs:{} ({}, {}-bit indices)",
+                 name, view.vertexCount, view.indexCount, m_submeshes.size(), m_meshlets.size(), m_lods.size(),
+                 view.vertexFormat == VertexFormat::Compact ? "compact" : "standard",
+                 view.indexType == vk::IndexType::eUint16 ? 16 : 32);
+}
+
+// Destructor
+Mesh::~Mesh() {
+    this->releaseGeometry();
+}
+
 // Move constructor
 Mesh::Mesh(Mesh&& other) noexcept
     : m_context(other.m_context)
+    , m_name(std::move(other.m_name))
     , m_indexCount(other.m_indexCount)
-    , m_vertexBuffer(other.m_vertexBuffer)
-    , m_indexBuffer(other.m_indexBuffer)
-    , m_vertexAllocation(other.m_vertexAllocation)
-    , m_indexAllocation(other.m_indexAllocation) {
+    , m_geometry(other.m_geometry)
+    , m_vertexFormat(other.m_vertexFormat)
+    , m_quantization(other.m_quantization)
+    , m_submeshes(std::move(other.m_submeshes))
+    , m_meshlets(std::move(other.m_meshlets))
+    , m_meshletBuffer(other.m_meshletBuffer)
+    , m_meshletAllocation(other.m_meshletAllocation)
+    , m_meshletBufferSize(other.m_meshletBufferSize)
+    , m_lods(std::move(other.m_lods))
+    , m_boundingSphere(other.m_boundingSphere)
+    , m_uvDensity(other.m_uvDensity) {
     // Reset source object
-    other.m_vertexBuffer = nullptr;
-    other.m_indexBuffer = nullptr;
-    other.m_vertexAllocation = VK_NULL_HANDLE;
-    other.m_indexAllocation = VK_NULL_HANDLE;
+    other.m_geometry = GeometryArena::kInvalidHandle;
+    other.m_meshletBuffer = nullptr;
+    other.m_meshletAllocation = VK_NULL_HANDLE;
+    other.m_meshletBufferSize = 0;
 }
 
 // Move assignment operator
 Mesh& Mesh::operator=(Mesh&& other) noexcept {
     if (this != &other) {
-        // Destroy current resources
-        if (m_context) {
-            auto allocator = m_context->getVmaAllocator();
-            if (m_vertexBuffer && m_vertexAllocation != VK_NULL_HANDLE) {
-                vmaDestroyBuffer(allocator, static_cast<VkBuffer>(m_vertexBuffer), m_vertexAllocation);
-            }
-            if (m_indexBuffer && m_indexAllocation != VK_NULL_HANDLE) {
-                vmaDestroyBuffer(allocator, static_cast<VkBuffer>(m_indexBuffer), m_indexAllocation);
-            }
-        }
+        // Release current range
+        this->releaseGeometry();
 
         // Transfer ownership
         m_context = other.m_context;
+        m_name = std::move(other.m_name);
         m_indexCount = other.m_indexCount;
-        m_vertexBuffer = other.m_vertexBuffer;
-        m_indexBuffer = other.m_indexBuffer;
-        m_vertexAllocation = other.m_vertexAllocation;
-        m_indexAllocation = other.m_indexAllocation;
+        m_geometry = other.m_geometry;
+        m_vertexFormat = other.m_vertexFormat;
+        m_quantization = other.m_quantization;
+        m_submeshes = std::move(other.m_submeshes);
+        m_meshlets = std::move(other.m_meshlets);
+        m_meshletBuffer = other.m_meshletBuffer;
+        m_meshletAllocation = other.m_meshletAllocation;
+        m_meshletBufferSize = other.m_meshletBufferSize;
+        m_lods = std::move(other.m_lods);
+        m_boundingSphere = other.m_boundingSphere;
+        m_uvDensity = other.m_uvDensity;
 
         // Reset source object
-        other.m_vertexBuffer = nullptr;
-        other.m_indexBuffer = nullptr;
-        other.m_vertexAllocation = VK_NULL_HANDLE;
-        other.m_indexAllocation = VK_NULL_HANDLE;
+        other.m_geometry = GeometryArena::kInvalidHandle;
+        other.m_meshletBuffer = nullptr;
+        other.m_meshletAllocation = VK_NULL_HANDLE;
+        other.m_meshletBufferSize = 0;
     }
     return *this;
 }
 
-// Create vertex buffer from vertex data
-void Mesh::createVertexBuffer(const std::vector<Vertex>& vertices) {
-    vk::DeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-
-    // 1. Create staging buffer (CPU visible)
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-    createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_MEMORY_USAGE_CPU_ONLY,
-        stagingBuffer,
-        stagingAllocation
-    );
-
-    // 2. Copy data to staging buffer
-    void* data;
-    vmaMapMemory(m_context->getVmaAllocator(), stagingAllocation, &data);
-    memcpy(data, vertices.data(), static_cast<size_t>(bufferSize));
-    vmaUnmapMemory(m_context->getVmaAllocator(), stagingAllocation);
-
-    // 3. Create device-local vertex buffer
-    VkBuffer vertexBuffer;
-    createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VMA_MEMORY_USAGE_GPU_ONLY,
-        vertexBuffer,
-        m_vertexAllocation
-    );
-    m_vertexBuffer = vertexBuffer;
+void Mesh::initLods(const MeshLod* lods, uint32_t lodCount, uint32_t indexCount) {
+    m_lods.assign(lods, lods + lodCount);
+    if (m_lods.empty()) {
+        m_lods.push_back(MeshLod{0, indexCount, 0, static_cast<uint32_t>(m_meshlets.size()), 0.0f});
+    }
+    // 没有上传簇时各级都走整段索引绘制
+    if (m_meshlets.empty()) {
+        for (MeshLod& lod : m_lods) {
+            lod.firstMeshlet = 0;
+            lod.meshletCount = 0;
+        }
+    }
+    m_indexCount = m_lods.front().indexCount;
+}
 
-    // 4. Execute copy from staging to device-local buffer
-    copyBuffer(stagingBuffer, static_cast<vk::Buffer>(m_vertexBuffer), bufferSize);
+uint32_t Mesh::selectLod(float pixelsPerUnit, uint32_t currentLevel, float maxPixelError, float hysteresis) const {
+    for (uint32_t level = static_cast<uint32_t>(m_lods.size()) - 1; level > 0; level--) {
+        const float limit = level > currentLevel ? maxPixelError * (1.0f - hysteresis) : maxPixelError;
+        if (m_lods[level].error * pixelsPerUnit <= limit) {
+            return level;
+        }
+    }
+    return 0;
+}
 
-    // 5. Cleanup staging buffer
-    vmaDestroyBuffer(m_context->getVmaAllocator(), stagingBuffer, stagingAllocation);
+VkDeviceSize Mesh::getMemorySize() const {
+    if (m_geometry == GeometryArena::kInvalidHandle) {
+        return 0;
+    }
+    const GeometryRange& range = m_context->getGeometryArena()->getRange(m_geometry);
+    const VkDeviceSize indexSize = range.indexType == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    return static_cast<VkDeviceSize>(range.vertexCount) * range.vertexStride
+         + static_cast<VkDeviceSize>(range.indexCount) * indexSize
+         + m_meshletBufferSize;
 }
 
-// Create index buffer from index data
-void Mesh::createIndexBuffer(const std::vector<uint32_t>& indices) {
-    VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-
-    // 1. Create staging buffer
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-    createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_MEMORY_USAGE_CPU_ONLY,
-        stagingBuffer,
-        stagingAllocation
-    );
+// Sub-allocate vertex / index ranges in the shared arena and record the upload
+void Mesh::createGeometry(const void* vertices, uint32_t vertexCount, uint32_t vertexStride, const std::vector<uint32_t>& indices) {
+    // 索引相对 vertexOffset，单个网格不超过 65535 个顶点时 16 位索引足够（图元重启未开启）
+    // 不阻塞：拷贝进入上传引擎的当前批次，下一帧图形提交前完成
+    GeometryArena* arena = m_context->getGeometryArena();
+    if (vertexCount <= UINT16_MAX) {
+        std::vector<uint16_t> indices16(indices.begin(), indices.end());
+        m_geometry = arena->allocate(vertices, vertexCount, vertexStride,
+                                     indices16.data(), static_cast<uint32_t>(indices16.size()), vk::IndexType::eUint16);
+    } else {
+        m_geometry = arena->allocate(vertices, vertexCount, vertexStride,
+                                     indices.data(), static_cast<uint32_t>(indices.size()), vk::IndexType::eUint32);
+    }
+}
 
-    // 2. Copy data to staging buffer
-    void* data;
-    vmaMapMemory(m_context->getVmaAllocator(), stagingAllocation, &data);
-    memcpy(data, indices.data(), static_cast<size_t>(bufferSize));
-    vmaUnmapMemory(m_context->getVmaAllocator(), stagingAllocation);
-
-    // 3. Create device-local index buffer
-    VkBuffer indexBuffer;
-    createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VMA_MEMORY_USAGE_GPU_ONLY,
-        indexBuffer,
-        m_indexAllocation
+void Mesh::createGeometry(const MeshView& view) {
+    m_geometry = m_context->getGeometryArena()->allocate(
+        view.vertices, view.vertexCount, view.vertexStride,
+        view.indices, view.indexCount, view.indexType
     );
-    m_indexBuffer = indexBuffer;
-
-    // 4. Execute copy
-    copyBuffer(stagingBuffer, static_cast<vk::Buffer>(m_indexBuffer), bufferSize);
-
-    // 5. Cleanup staging buffer
-    vmaDestroyBuffer(m_context->getVmaAllocator(), stagingBuffer, stagingAllocation);
 }
 
-// Create a Vulkan buffer with specified properties
-void Mesh::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage,
-                        VkBuffer& buffer, VmaAllocation& allocation) {
+// Per-mesh storage buffer with the meshlet bounds, read by the cluster culling shader
+// (followed by the per-meshlet vertex / triangle lists when the mesh shader path is available)
+void Mesh::createMeshletBuffer(const void* indices, vk::IndexType indexType, uint32_t vertexCount) {
+    if (m_meshlets.empty()) {
+        return;
+    }
+    // 与 GeometryArena 一致：传输与图形队列族不同时使用 CONCURRENT，不做所有权转移
+    UploadEngine* uploads = m_context->getUploadEngine();
+    const uint32_t queueFamilies[] = { m_context->getGraphicsQueueFamily(), uploads->getQueueFamily() };
+    const bool concurrent = uploads->usesOwnershipTransfer();
+    const VkDeviceSize meshletBytes = static_cast<VkDeviceSize>(m_meshlets.size()) * sizeof(Meshlet);
+
+    // 局部数据只在网格着色器路径可用时生成（不进入 .vmesh 缓存，上传时由索引推出）
+    const bool meshShader = m_context->getFeatures().meshShader;
+    std::vector<uint32_t> localData;
+    if (meshShader) {
+        const uint32_t wordBase = static_cast<uint32_t>(meshletBytes / sizeof(uint32_t));
+        localData = indexType == vk::IndexType::eUint16
+            ? MeshletBuilder::buildLocalData(m_meshlets, static_cast<const uint16_t*>(indices), vertexCount, wordBase)
+            : MeshletBuilder::buildLocalData(m_meshlets, static_cast<const uint32_t*>(indices), vertexCount, wordBase);
+    }
+    const VkDeviceSize size = meshletBytes + static_cast<VkDeviceSize>(localData.size()) * sizeof(uint32_t);
+
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size;
-    bufferInfo.usage = usage;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = concurrent ? 2 : 0;
+    bufferInfo.pQueueFamilyIndices = concurrent ? queueFamilies : nullptr;
 
     VmaAllocationCreateInfo allocInfo{};
-    allocInfo.usage = memoryUsage;
-
-    VkResult result = vmaCreateBuffer(
-        m_context->getVmaAllocator(),
-        &bufferInfo,
-        &allocInfo,
-        &buffer,
-        &allocation,
-        nullptr
-    );
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create buffer");
+    VkBuffer buffer;
+    if (vmaCreateBuffer(m_context->getVmaAllocator(), &bufferInfo, &allocInfo, &buffer, &m_meshletAllocation, nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create meshlet buffer: " + m_name);
     }
-}
-
-// Copy data from srcBuffer to dstBuffer using command buffer
-void Mesh::copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, VkDeviceSize size) {
-    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
+    m_meshletBuffer = buffer;
+    m_meshletBufferSize = size;
+    m_context->getMemoryTracker()->track(m_meshletAllocation, m_name + " [meshlets]", MemoryCategory::Mesh);
 
-    vk::BufferCopy copyRegion{};
-    copyRegion.size = size;
-    commandBuffer.copyBuffer(srcBuffer, dstBuffer, 1, &copyRegion);
-
-    endSingleTimeCommands(commandBuffer);
-}
-
-// Begin a one-time submit command buffer
-vk::CommandBuffer Mesh::beginSingleTimeCommands() {
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo.level = vk::CommandBufferLevel::ePrimary;
-    allocInfo.commandPool = m_context->getTransientCommandPool();
-    allocInfo.commandBufferCount = 1;
-
-    vk::CommandBuffer commandBuffer = m_context->getDevice().allocateCommandBuffers(allocInfo)[0];
-
-    vk::CommandBufferBeginInfo beginInfo{};
-    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
-    commandBuffer.begin(beginInfo);
-
-    return commandBuffer;
+    vk::PipelineStageFlags2 dstStage = vk::PipelineStageFlagBits2::eComputeShader;
+    if (meshShader) {
+        dstStage |= vk::PipelineStageFlagBits2::eTaskShaderEXT | vk::PipelineStageFlagBits2::eMeshShaderEXT;
+    }
+    uploads->uploadBuffer(m_meshletBuffer, m_meshlets.data(), meshletBytes, 0,
+                          dstStage, vk::AccessFlagBits2::eShaderStorageRead, true);
+    if (!localData.empty()) {
+        uploads->uploadBuffer(m_meshletBuffer, localData.data(), size - meshletBytes, meshletBytes,
+                              dstStage, vk::AccessFlagBits2::eShaderStorageRead, true);
+    }
 }
 
-// End and submit a one-time command buffer
-void Mesh::endSingleTimeCommands(vk::CommandBuffer commandBuffer) {
-    commandBuffer.end();
-
-    vk::SubmitInfo submitInfo{};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    auto graphicsQueue = m_context->getGraphicsQueue();
-    auto res = graphicsQueue.submit(1, &submitInfo, nullptr);
-    graphicsQueue.waitIdle();
-
-    m_context->getDevice().freeCommandBuffers(m_context->getTransientCommandPool(), 1, &commandBuffer);
+void Mesh::releaseGeometry() {
+    if (m_context && m_geometry != GeometryArena::kInvalidHandle) {
+        m_context->getGeometryArena()->free(m_geometry);
+        m_geometry = GeometryArena::kInvalidHandle;
+    }
+    if (m_context && m_meshletBuffer) {
+        m_context->getMemoryTracker()->untrack(m_meshletAllocation);
+        vmaDestroyBuffer(m_context->getVmaAllocator(), static_cast<VkBuffer>(m_meshletBuffer), m_meshletAllocation);
+        m_meshletBuffer = nullptr;
+        m_meshletAllocation = VK_NULL_HANDLE;
+        m_meshletBufferSize = 0;
+    }
 }
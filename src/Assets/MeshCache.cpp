@@ -0,0 +1,227 @@
+#include "Assets/MeshCache.h"
+#include <thread>
+#include <functional>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<MeshCacheHeader>, "MeshCacheHeader is written as raw bytes");
+static_assert(std::is_trivially_copyable_v<MeshLod>, "MeshLod is written as raw bytes");
+
+namespace {
+    constexpr uint64_t kBlobAlignment = 16;
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + kBlobAlignment - 1) & ~(kBlobAlignment - 1);
+    }
+
+    struct SourceSignature {
+        uint64_t size = 0;
+        int64_t time = 0;
+    };
+
+    std::optional<SourceSignature> getSourceSignature(const std::string& sourcePath) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(sourcePath, ec);
+        if (ec) return std::nullopt;
+        const auto time = std::filesystem::last_write_time(sourcePath, ec);
+        if (ec) return std::nullopt;
+        return SourceSignature{size, static_cast<int64_t>(time.time_since_epoch().count())};
+    }
+
+    bool useIndex16(size_t vertexCount) {
+        // 与 Mesh::createGeometry 的选择一致
+        return vertexCount <= UINT16_MAX;
+    }
+}
+
+std::filesystem::path MeshCache::getCachePath(const std::string& sourcePath, const MeshImportSettings& settings) {
+    const std::filesystem::path source(sourcePath);
+    std::string name = source.filename().string();
+    name += settings.vertexFormat == VertexFormat::Compact ? ".compact" : ".std";
+    name += settings.optimize ? ".opt" : ".raw";
+    if (settings.meshlets) name += ".mlt";
+    if (settings.lods) name += ".lod";
+    name += ".vmesh";
+    return source.parent_path() / ".vcache" / name;
+}
+
+std::optional<CachedMesh> MeshCache::open(const std::string& sourcePath, const MeshImportSettings& settings) {
+    const auto signature = getSourceSignature(sourcePath);
+    const std::filesystem::path cachePath = getCachePath(sourcePath, settings);
+    std::error_code ec;
+    if (!signature || !std::filesystem::exists(cachePath, ec)) {
+        return std::nullopt;
+    }
+
+    CachedMesh cached;
+    try {
+        cached.file = MappedFile(cachePath.string());
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    const size_t fileSize = cached.file.getSize();
+    if (fileSize < sizeof(MeshCacheHeader)) {
+        return std::nullopt;
+    }
+
+    // 映射起点按页对齐，文件头可以直接按结构体读取
+    const auto* header = reinterpret_cast<const MeshCacheHeader*>(cached.file.getData());
+    const uint32_t expectedFlags = (settings.optimize ? MeshCacheHeader::kFlagOptimized : 0)
+                                 | (settings.meshlets ? MeshCacheHeader::kFlagMeshlets : 0)
+                                 | (settings.lods ? MeshCacheHeader::kFlagLods : 0);
+    if (header->magic != MeshCacheHeader::kMagic ||
+        header->version != MeshCacheHeader::kVersion ||
+        header->vertexFormat != static_cast<uint32_t>(settings.vertexFormat) ||
+        header->flags != expectedFlags ||
+        header->sourceSize != signature->size ||
+        header->sourceTime != signature->time ||
+        header->fileSize != fileSize) {
+        return std::nullopt;
+    }
+
+    // 数据块必须落在文件内（损坏或截断的缓存直接忽略，重新导入时覆盖）
+    const uint64_t submeshBytes = static_cast<uint64_t>(header->submeshCount) * sizeof(Submesh);
+    const uint64_t vertexBytes = static_cast<uint64_t>(header->vertexCount) * header->vertexStride;
+    const uint64_t indexBytes = static_cast<uint64_t>(header->indexCount) * header->indexSize;
+    const uint64_t meshletBytes = static_cast<uint64_t>(header->meshletCount) * sizeof(Meshlet);
+    const uint64_t lodBytes = static_cast<uint64_t>(header->lodCount) * sizeof(MeshLod);
+    if ((header->indexSize != 2 && header->indexSize != 4) ||
+        header->submeshOffset + submeshBytes > fileSize ||
+        header->vertexOffset + vertexBytes > fileSize ||
+        header->indexOffset + indexBytes > fileSize ||
+        header->meshletOffset + meshletBytes > fileSize ||
+        header->lodOffset + lodBytes > fileSize) {
+        return std::nullopt;
+    }
+
+    const uint8_t* base = cached.file.getData();
+    cached.header = header;
+    cached.view.vertexFormat = static_cast<VertexFormat>(header->vertexFormat);
+    cached.view.vertices = base + header->vertexOffset;
+    cached.view.vertexCount = header->vertexCount;
+    cached.view.vertexStride = header->vertexStride;
+    cached.view.indices = base + header->indexOffset;
+    cached.view.indexCount = header->indexCount;
+    cached.view.indexType = header->indexSize == 2 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+    cached.view.submeshes = reinterpret_cast<const Submesh*>(base + header->submeshOffset);
+    cached.view.submeshCount = header->submeshCount;
+    cached.view.meshlets = reinterpret_cast<const Meshlet*>(base + header->meshletOffset);
+    cached.view.meshletCount = header->meshletCount;
+    cached.view.lods = reinterpret_cast<const MeshLod*>(base + header->lodOffset);
+    cached.view.lodCount = header->lodCount;
+    const glm::vec3 boundsMin(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+    const glm::vec3 boundsMax(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+    cached.view.boundingSphere = glm::vec4((boundsMin + boundsMax) * 0.5f, glm::length(boundsMax - boundsMin) * 0.5f);
+    cached.view.uvDensity = header->uvDensity;
+    cached.view.quantization = header->quantization;
+    return cached;
+}
+
+uint64_t MeshCache::write(const std::string& sourcePath, const MeshData& data, const MeshImportSettings& settings) {
+    const auto signature = getSourceSignature(sourcePath);
+    if (!signature) {
+        throw std::runtime_error("MeshCache: cannot stat source file: " + sourcePath);
+    }
+    const bool compact = settings.vertexFormat == VertexFormat::Compact;
+    if (compact && data.compactVertices.size() != data.vertices.size()) {
+        throw std::runtime_error("MeshCache: mesh data has not been compressed: " + sourcePath);
+    }
+
+    MeshCacheHeader header;
+    header.vertexFormat = static_cast<uint32_t>(settings.vertexFormat);
+    header.flags = (data.optimized ? MeshCacheHeader::kFlagOptimized : 0)
+                 | (settings.meshlets ? MeshCacheHeader::kFlagMeshlets : 0)
+                 | (settings.lods ? MeshCacheHeader::kFlagLods : 0);
+    header.vertexCount = static_cast<uint32_t>(data.vertices.size());
+    header.vertexStride = compact ? sizeof(CompactVertex) : sizeof(Vertex);
+    header.indexCount = static_cast<uint32_t>(data.indices.size());
+    header.indexSize = useIndex16(data.vertices.size()) ? 2 : 4;
+    header.meshletCount = settings.meshlets ? static_cast<uint32_t>(data.meshlets.size()) : 0;
+    header.lodCount = static_cast<uint32_t>(data.lods.size());
+    header.sourceSize = signature->size;
+    header.sourceTime = signature->time;
+    header.quantization = data.quantization;
+    header.cacheBefore = data.cacheBefore;
+    header.cacheAfter = data.cacheAfter;
+
+    std::vector<Submesh> submeshes = data.submeshes;
+    if (submeshes.empty()) {
+        submeshes.push_back(Submesh{0, header.indexCount});
+    }
+    header.submeshCount = static_cast<uint32_t>(submeshes.size());
+
+    if (!data.vertices.empty()) {
+        glm::vec3 boundsMin = data.vertices[0].pos;
+        glm::vec3 boundsMax = data.vertices[0].pos;
+        for (const auto& vertex : data.vertices) {
+            boundsMin = glm::min(boundsMin, vertex.pos);
+            boundsMax = glm::max(boundsMax, vertex.pos);
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            header.boundsMin[axis] = boundsMin[axis];
+            header.boundsMax[axis] = boundsMax[axis];
+        }
+        const size_t lod0IndexCount = data.lods.empty() ? data.indices.size() : data.lods[0].indexCount;
+        header.uvDensity = Mesh::computeUvDensity(data.vertices.data(), lod0IndexCount,
+                                                  [&](size_t i) { return data.indices[i]; });
+    }
+
+    const uint64_t vertexBytes = static_cast<uint64_t>(header.vertexCount) * header.vertexStride;
+    const uint64_t indexBytes = static_cast<uint64_t>(header.indexCount) * header.indexSize;
+    header.submeshOffset = alignUp(sizeof(MeshCacheHeader));
+    header.vertexOffset = alignUp(header.submeshOffset + submeshes.size() * sizeof(Submesh));
+    header.indexOffset = alignUp(header.vertexOffset + vertexBytes);
+    header.meshletOffset = alignUp(header.indexOffset + indexBytes);
+    header.lodOffset = alignUp(header.meshletOffset + static_cast<uint64_t>(header.meshletCount) * sizeof(Meshlet));
+    header.fileSize = header.lodOffset + static_cast<uint64_t>(header.lodCount) * sizeof(MeshLod);
+
+    std::vector<uint16_t> indices16;
+    const void* indexData = data.indices.data();
+    if (header.indexSize == 2) {
+        indices16.assign(data.indices.begin(), data.indices.end());
+        indexData = indices16.data();
+    }
+    const void* vertexData = compact ? static_cast<const void*>(data.compactVertices.data())
+                                     : static_cast<const void*>(data.vertices.data());
+
+    const std::filesystem::path cachePath = getCachePath(sourcePath, settings);
+    std::filesystem::create_directories(cachePath.parent_path());
+    std::filesystem::path tempPath = cachePath;
+    tempPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("MeshCache: failed to create " + tempPath.string());
+        }
+        const char padding[kBlobAlignment] = {};
+        auto writeAt = [&](uint64_t offset, const void* bytes, uint64_t size) {
+            const uint64_t position = static_cast<uint64_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(offset - position));
+            file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        };
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.submeshOffset, submeshes.data(), submeshes.size() * sizeof(Submesh));
+        writeAt(header.vertexOffset, vertexData, vertexBytes);
+        writeAt(header.indexOffset, indexData, indexBytes);
+        writeAt(header.meshletOffset, data.meshlets.data(), static_cast<uint64_t>(header.meshletCount) * sizeof(Meshlet));
+        writeAt(header.lodOffset, data.lods.data(), static_cast<uint64_t>(header.lodCount) * sizeof(MeshLod));
+        if (!file) {
+            throw std::runtime_error("MeshCache: failed to write " + tempPath.string());
+        }
+    }
+
+    // rename 在同一目录内是原子的；Windows 上目标存在时需要先删除
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(cachePath, ec);
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            throw std::runtime_error("MeshCache: failed to move cache into place: " + cachePath.string());
+        }
+    }
+    return header.fileSize;
+}
@@ -0,0 +1,243 @@
+#include "Assets/MeshOptimizer.h"
+#include "Assets/MeshAdjacency.h"
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace {
+    constexpr uint32_t kInvalid = UINT32_MAX;
+
+    // 固定大小的 FIFO 缓存（与大多数硬件的后变换缓存行为接近）
+    class FifoCache {
+    private:
+        std::vector<uint32_t> m_timestamps;     // 顶点进入缓存时的计数，0 表示从未进入
+        uint32_t m_time = 0;
+        uint32_t m_size;
+    public:
+        FifoCache(size_t vertexCount, uint32_t size) : m_timestamps(vertexCount, 0), m_size(size) {}
+        // 返回是否未命中
+        bool access(uint32_t vertex) {
+            if (m_timestamps[vertex] != 0 && m_time - m_timestamps[vertex] < m_size) {
+                return false;
+            }
+            m_timestamps[vertex] = ++m_time;
+            return true;
+        }
+    };
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    VertexCacheStats stats;
+    if (indices.empty()) {
+        return stats;
+    }
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t misses = 0;
+    size_t uniqueVertices = 0;
+    for (uint32_t index : indices) {
+        misses += cache.access(index) ? 1 : 0;
+        if (!referenced[index]) {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+    }
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(uniqueVertices);
+    return stats;
+}
+
+// Tipsify (Sander, Nehab, Barczak 2007)：围绕 "扇心" 顶点输出其所有未输出的三角形，
+// 下一个扇心优先选择仍在缓存中且剩余三角形能在缓存淘汰前输出完的相邻顶点
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    MeshAdjacency adjacency;
+    adjacency.build(indices, vertexCount);
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    uint32_t timestamp = cacheSize + 1;
+    size_t cursor = 0;
+
+    auto skipDeadEnd = [&]() -> uint32_t {
+        while (!deadEnd.empty()) {
+            const uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0) return vertex;
+        }
+        while (cursor < vertexCount) {
+            if (liveTriangles[cursor] > 0) return static_cast<uint32_t>(cursor);
+            cursor++;
+        }
+        return kInvalid;
+    };
+
+    uint32_t fan = skipDeadEnd();
+    while (fan != kInvalid) {
+        candidates.clear();
+        for (uint32_t k = adjacency.offsets[fan]; k < adjacency.offsets[fan + 1]; k++) {
+            const uint32_t triangle = adjacency.triangles[k];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+            for (int corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                result.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (timestamp - cacheTime[vertex] > cacheSize) {
+                    cacheTime[vertex] = timestamp++;
+                }
+            }
+        }
+
+        // 选择下一个扇心：仍在缓存中、且输出其剩余三角形后不会被挤出缓存的顶点中最 "老" 的
+        uint32_t best = kInvalid;
+        int bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0) continue;
+            int priority = 0;
+            if (timestamp - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = static_cast<int>(timestamp - cacheTime[vertex]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = vertex;
+            }
+        }
+        fan = best != kInvalid ? best : skipDeadEnd();
+    }
+    indices.swap(result);
+}
+
+// 簇切分与排序（Sander 等人的 "fast triangle reordering" 的简化实现）：
+// 缓存完全失效处（三个顶点都未命中）为硬边界；硬簇内 ACMR 已经足够好时再切出软边界。
+// 每个簇按 dot(簇中心 - 网格中心, 簇法线) 从大到小排列，外侧的面先画
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+                                     size_t vertexCount, float threshold, uint32_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+    auto position = [&](uint32_t vertex) {
+        const float* p = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // 1. 硬边界
+    std::vector<size_t> hardBoundaries{0};
+    {
+        FifoCache cache(vertexCount, cacheSize);
+        for (size_t t = 0; t < triangleCount; t++) {
+            int misses = 0;
+            for (int corner = 0; corner < 3; corner++) {
+                misses += cache.access(indices[t * 3 + corner]) ? 1 : 0;
+            }
+            if (t > 0 && misses == 3) hardBoundaries.push_back(t);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // 2. 软边界：簇的累计 ACMR 不超过 threshold * 硬簇整体 ACMR 时就可以结束该簇
+    std::vector<size_t> boundaries;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); h++) {
+        const size_t begin = hardBoundaries[h];
+        const size_t end = hardBoundaries[h + 1];
+
+        FifoCache whole(vertexCount, cacheSize);
+        size_t totalMisses = 0;
+        for (size_t t = begin * 3; t < end * 3; t++) {
+            totalMisses += whole.access(indices[t]) ? 1 : 0;
+        }
+        const float target = threshold * static_cast<float>(totalMisses) / static_cast<float>(end - begin);
+
+        FifoCache cache(vertexCount, cacheSize);
+        size_t clusterStart = begin;
+        size_t clusterMisses = 0;
+        boundaries.push_back(begin);
+        for (size_t t = begin; t < end; t++) {
+            for (int corner = 0; corner < 3; corner++) {
+                clusterMisses += cache.access(indices[t * 3 + corner]) ? 1 : 0;
+            }
+            const size_t clusterTriangles = t - clusterStart + 1;
+            if (t + 1 < end && static_cast<float>(clusterMisses) / static_cast<float>(clusterTriangles) <= target) {
+                boundaries.push_back(t + 1);
+                clusterStart = t + 1;
+                clusterMisses = 0;
+            }
+        }
+    }
+    boundaries.push_back(triangleCount);
+
+    // 3. 按朝外程度排序
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    struct Cluster {
+        size_t begin;
+        size_t end;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters;
+    std::vector<glm::vec3> centers;
+    std::vector<glm::vec3> normals;
+    for (size_t c = 0; c + 1 < boundaries.size(); c++) {
+        glm::vec3 center(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = boundaries[c]; t < boundaries[c + 1]; t++) {
+            const glm::vec3 a = position(indices[t * 3 + 0]);
+            const glm::vec3 b = position(indices[t * 3 + 1]);
+            const glm::vec3 d = position(indices[t * 3 + 2]);
+            const glm::vec3 cross = glm::cross(b - a, d - a);
+            const float triangleArea = glm::length(cross);
+            center += (a + b + d) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+        meshCenter += center;
+        meshArea += area;
+        centers.push_back(area > 0.0f ? center / area : center);
+        normals.push_back(glm::length(normal) > 0.0f ? glm::normalize(normal) : normal);
+        clusters.push_back(Cluster{boundaries[c], boundaries[c + 1], 0.0f});
+    }
+    if (meshArea > 0.0f) {
+        meshCenter /= meshArea;
+    }
+    for (size_t c = 0; c < clusters.size(); c++) {
+        clusters[c].sortKey = glm::dot(centers[c] - meshCenter, normals[c]);
+    }
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (const auto& cluster : clusters) {
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+    indices.swap(result);
+}
+
+std::vector<uint32_t> MeshOptimizer::optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, size_t& newVertexCount) {
+    std::vector<uint32_t> remap(vertexCount, kInvalid);
+    uint32_t next = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == kInvalid) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    newVertexCount = next;
+    return remap;
+}
@@ -0,0 +1,323 @@
+#include "Assets/MeshSimplifier.h"
+#include "Assets/MeshAdjacency.h"
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+namespace {
+    constexpr uint32_t kInvalid = UINT32_MAX;
+
+    glm::vec3 loadPosition(const float* positions, size_t positionStride, uint32_t vertex) {
+        const float* p = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    }
+
+    // 平面距离平方的二次型（对称 4x4 的上三角）+ 累计的面积权重，双精度避免大坐标下的抵消误差
+    struct Quadric {
+        double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+        double c = 0.0;
+        double weight = 0.0;
+
+        void addPlane(const glm::dvec3& n, double d, double w) {
+            a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+            a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+            b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        void add(const Quadric& other) {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02;
+            a11 += other.a11; a12 += other.a12; a22 += other.a22;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        // 到累计平面的距离平方的面积加权平均
+        double evaluate(const glm::vec3& p) const {
+            if (weight <= 0.0) return 0.0;
+            const double x = p.x, y = p.y, z = p.z;
+            const double r = a00 * x * x + a11 * y * y + a22 * z * z
+                           + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                           + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(r, 0.0) / weight;
+        }
+    };
+
+    struct PositionKey {
+        uint32_t bits[3];
+        bool operator==(const PositionKey& other) const {
+            return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+        }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& key) const {
+            uint64_t h = 1469598103934665603ull;
+            for (uint32_t bits : key.bits) {
+                h = (h ^ bits) * 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    // 位置完全相同的顶点归到同一个代表顶点（最小编号），wedge 把同一位置的顶点串成环
+    void weldPositions(const float* positions, size_t positionStride, size_t vertexCount,
+                       std::vector<uint32_t>& remap, std::vector<uint32_t>& wedge) {
+        remap.resize(vertexCount);
+        wedge.resize(vertexCount);
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> first;
+        first.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            const glm::vec3 p = loadPosition(positions, positionStride, v) + glm::vec3(0.0f);    // -0.0 与 0.0 视为同一位置
+            PositionKey key;
+            std::memcpy(key.bits, &p.x, sizeof(key.bits));
+            const auto [it, inserted] = first.try_emplace(key, v);
+            remap[v] = it->second;
+            if (inserted) {
+                wedge[v] = v;
+            } else {
+                wedge[v] = wedge[it->second];
+                wedge[it->second] = v;
+            }
+        }
+    }
+
+    // 位置层面的有向边：没有反向边的是开放边界，同向出现多次的是非流形边，两端的位置都锁定。
+    // 三个以上属性分支交汇的位置也锁定（接缝拐点，沿任何方向折叠都会拉伸其中一个分支）
+    std::vector<uint8_t> findLockedPositions(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap,
+                                             const std::vector<uint32_t>& wedge) {
+        const size_t vertexCount = remap.size();
+        std::vector<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t a = remap[indices[i + corner]];
+                const uint32_t b = remap[indices[i + (corner + 1) % 3]];
+                if (a != b) edges.push_back(static_cast<uint64_t>(a) << 32 | b);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<uint8_t> locked(vertexCount, 0);
+        for (size_t i = 0; i < edges.size();) {
+            size_t end = i + 1;
+            while (end < edges.size() && edges[end] == edges[i]) end++;
+            const uint32_t a = static_cast<uint32_t>(edges[i] >> 32);
+            const uint32_t b = static_cast<uint32_t>(edges[i]);
+            const uint64_t reverse = static_cast<uint64_t>(b) << 32 | a;
+            const auto range = std::equal_range(edges.begin(), edges.end(), reverse);
+            if (end - i != 1 || range.second - range.first != 1) {
+                locked[a] = 1;
+                locked[b] = 1;
+            }
+            i = end;
+        }
+
+        std::vector<uint8_t> referenced(vertexCount, 0);
+        for (uint32_t index : indices) referenced[index] = 1;
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            if (remap[v] != v) continue;
+            uint32_t branches = 0;
+            uint32_t w = v;
+            do {
+                branches += referenced[w];
+                w = wedge[w];
+            } while (w != v);
+            if (branches > 2) locked[v] = 1;
+        }
+        return locked;
+    }
+
+    struct Collapse {
+        uint32_t from;          // 代表顶点（位置）
+        uint32_t to;
+        float error;            // 距离平方
+    };
+
+    // 单次简化的工作状态：remap / wedge / locked 在整个过程中不变，邻接每一轮重建
+    struct Simplifier {
+        std::vector<uint32_t>& indices;
+        const float* positions;
+        size_t positionStride;
+        size_t vertexCount;
+
+        std::vector<uint32_t> remap;
+        std::vector<uint32_t> wedge;
+        std::vector<uint8_t> locked;
+        std::vector<Quadric> quadrics;
+        MeshAdjacency adjacency;
+
+        glm::vec3 position(uint32_t vertex) const {
+            return loadPosition(positions, positionStride, vertex);
+        }
+
+        void computeQuadrics() {
+            quadrics.assign(vertexCount, Quadric{});
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                const uint32_t p[3] = { remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]] };
+                const glm::dvec3 a(this->position(p[0]));
+                const glm::dvec3 b(this->position(p[1]));
+                const glm::dvec3 c(this->position(p[2]));
+                glm::dvec3 n = glm::cross(b - a, c - a);
+                const double length = glm::length(n);
+                if (length <= 0.0) continue;
+                n /= length;
+                const double area = length * 0.5;
+                for (uint32_t corner : p) {
+                    quadrics[corner].addPlane(n, -glm::dot(n, a), area);
+                }
+            }
+        }
+
+        // from 的每个属性分支映射到与它共享三角形的 to 的分支；某个分支找不到或有多个候选时不能折叠
+        bool mapWedges(uint32_t from, uint32_t to, std::vector<std::pair<uint32_t, uint32_t>>& mapping) const {
+            mapping.clear();
+            uint32_t v = from;
+            do {
+                uint32_t target = kInvalid;
+                for (uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; k++) {
+                    const uint32_t t = adjacency.triangles[k];
+                    for (uint32_t corner = 0; corner < 3; corner++) {
+                        const uint32_t u = indices[t * 3 + corner];
+                        if (remap[u] != to) continue;
+                        if (target != kInvalid && target != u) return false;
+                        target = u;
+                    }
+                }
+                if (adjacency.offsets[v] != adjacency.offsets[v + 1]) {
+                    if (target == kInvalid) return false;
+                    mapping.emplace_back(v, target);
+                }
+                v = wedge[v];
+            } while (v != from);
+            return !mapping.empty();
+        }
+
+        // 折叠后仍保留的相邻三角形不能翻面（也不能退化成零面积）
+        bool flipsTriangle(uint32_t from, uint32_t to) const {
+            const glm::vec3 target = this->position(to);
+            uint32_t v = from;
+            do {
+                for (uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; k++) {
+                    const uint32_t t = adjacency.triangles[k];
+                    uint32_t p[3];
+                    bool removed = false;
+                    for (uint32_t corner = 0; corner < 3; corner++) {
+                        p[corner] = remap[indices[t * 3 + corner]];
+                        removed = removed || p[corner] == to;
+                    }
+                    if (removed) continue;
+                    glm::vec3 before[3], after[3];
+                    for (uint32_t corner = 0; corner < 3; corner++) {
+                        before[corner] = this->position(p[corner]);
+                        after[corner] = p[corner] == from ? target : before[corner];
+                    }
+                    const glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+                    const glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+                    if (glm::dot(n0, n0) > 0.0f && glm::dot(n0, n1) <= 0.0f) return true;
+                }
+                v = wedge[v];
+            } while (v != from);
+            return false;
+        }
+
+        // 一轮：收集候选边并按误差排序，贪心执行互不相邻的折叠，返回执行的次数
+        size_t runPass(size_t targetIndexCount, double errorLimit, double& maxError) {
+            adjacency.build(indices, vertexCount);
+
+            std::vector<Collapse> candidates;
+            candidates.reserve(indices.size() / 2);
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const uint32_t a = remap[indices[i + corner]];
+                    const uint32_t b = remap[indices[i + (corner + 1) % 3]];
+                    // 内部边在两个三角形中各出现一次（方向相反），开放边界的两端都已锁定
+                    if (a >= b || (locked[a] && locked[b])) continue;
+                    const double ab = locked[a] ? HUGE_VAL : quadrics[a].evaluate(this->position(b));
+                    const double ba = locked[b] ? HUGE_VAL : quadrics[b].evaluate(this->position(a));
+                    candidates.push_back(ab <= ba ? Collapse{a, b, static_cast<float>(ab)}
+                                                  : Collapse{b, a, static_cast<float>(ba)});
+                }
+            }
+            if (candidates.empty()) return 0;
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+            // 每次内部折叠约去掉两个三角形；本轮的误差上限取第 goal 个候选误差的 1.5 倍，
+            // 避免一轮内为了凑数折叠掉误差远高于其余候选的边
+            const size_t triangleGoal = (indices.size() - targetIndexCount) / 3;
+            const size_t edgeGoal = std::min(candidates.size() - 1, triangleGoal / 2);
+            const double passLimit = std::min(errorLimit, static_cast<double>(candidates[edgeGoal].error) * 1.5 + 1e-30);
+
+            std::vector<uint32_t> target(vertexCount);
+            std::iota(target.begin(), target.end(), 0u);
+            std::vector<uint8_t> touched(vertexCount, 0);
+            std::vector<std::pair<uint32_t, uint32_t>> mapping;
+            size_t removedTriangles = 0;
+            size_t collapses = 0;
+            for (const Collapse& collapse : candidates) {
+                if (removedTriangles >= triangleGoal || collapse.error > passLimit) break;
+                if (touched[collapse.from] || touched[collapse.to]) continue;
+                if (!this->mapWedges(collapse.from, collapse.to, mapping)) continue;
+                if (this->flipsTriangle(collapse.from, collapse.to)) continue;
+
+                // 本轮不再动 from 的一环邻域：它们的邻接已经过时
+                for (const auto& [v, w] : mapping) {
+                    target[v] = w;
+                    for (uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; k++) {
+                        const uint32_t t = adjacency.triangles[k];
+                        bool removed = false;
+                        for (uint32_t corner = 0; corner < 3; corner++) {
+                            const uint32_t p = remap[indices[t * 3 + corner]];
+                            touched[p] = 1;
+                            removed = removed || p == collapse.to;
+                        }
+                        removedTriangles += removed ? 1 : 0;
+                    }
+                }
+                quadrics[collapse.to].add(quadrics[collapse.from]);
+                maxError = std::max(maxError, static_cast<double>(collapse.error));
+                collapses++;
+            }
+            if (collapses == 0) return 0;
+
+            // 重写索引并去掉退化的三角形（位置层面有两个角重合）
+            size_t write = 0;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                const uint32_t a = target[indices[i]];
+                const uint32_t b = target[indices[i + 1]];
+                const uint32_t c = target[indices[i + 2]];
+                if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c]) continue;
+                indices[write++] = a;
+                indices[write++] = b;
+                indices[write++] = c;
+            }
+            indices.resize(write);
+            return collapses;
+        }
+    };
+}
+
+float MeshSimplifier::simplify(std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+                               size_t vertexCount, size_t targetIndexCount, float targetError) {
+    if (indices.size() <= targetIndexCount || indices.size() < 3 || vertexCount == 0) {
+        return 0.0f;
+    }
+    Simplifier simplifier{indices, positions, positionStride, vertexCount};
+    weldPositions(positions, positionStride, vertexCount, simplifier.remap, simplifier.wedge);
+    simplifier.locked = findLockedPositions(indices, simplifier.remap, simplifier.wedge);
+    simplifier.computeQuadrics();
+
+    const double errorLimit = static_cast<double>(targetError) * targetError;
+    double maxError = 0.0;
+    while (indices.size() > targetIndexCount) {
+        if (simplifier.runPass(targetIndexCount, errorLimit, maxError) == 0) break;
+    }
+    return static_cast<float>(std::sqrt(maxError));
+}
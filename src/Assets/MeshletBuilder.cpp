@@ -0,0 +1,262 @@
+#include "Assets/MeshletBuilder.h"
+#include "Assets/MeshAdjacency.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <glm/glm.hpp>
+
+namespace {
+    constexpr uint32_t kInvalid = UINT32_MAX;
+    constexpr float kLiveWeight = 0.05f;
+
+    glm::vec3 loadPosition(const float* positions, size_t positionStride, uint32_t vertex) {
+        const float* p = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    }
+
+    // 面积为零的三角形返回零向量（不参与法线锥）
+    glm::vec3 triangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        const glm::vec3 n = glm::cross(b - a, c - a);
+        const float length = glm::length(n);
+        return length > 0.0f ? n / length : glm::vec3(0.0f);
+    }
+
+    template<typename Index>
+    std::vector<uint32_t> packLocalData(std::vector<Meshlet>& meshlets, const Index* indices, size_t vertexCount, uint32_t wordBase) {
+        std::vector<uint32_t> data;
+        size_t words = 0;
+        for (const Meshlet& meshlet : meshlets) {
+            words += meshlet.vertexCount + meshlet.triangleCount;
+        }
+        data.reserve(words);
+
+        // 顶点在当前簇中的局部编号，按簇号打标记，不需要逐簇清空
+        std::vector<uint32_t> stamp(vertexCount, kInvalid);
+        std::vector<uint8_t> local(vertexCount, 0);
+        std::vector<uint32_t> triangles;
+        triangles.reserve(MeshletBuilder::kMaxTriangles);
+        for (size_t m = 0; m < meshlets.size(); m++) {
+            Meshlet& meshlet = meshlets[m];
+            meshlet.dataOffset = wordBase + static_cast<uint32_t>(data.size());
+            triangles.clear();
+            uint32_t localCount = 0;
+            const Index* corners = indices + meshlet.firstIndex;
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                uint32_t packed = 0;
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    const uint32_t vertex = corners[t * 3 + corner];
+                    if (vertex >= vertexCount) {
+                        throw std::runtime_error("Meshlet references a vertex out of range");
+                    }
+                    if (stamp[vertex] != m) {
+                        if (localCount == MeshletBuilder::kMaxVertices) {
+                            throw std::runtime_error("Meshlet exceeds the mesh shader vertex limit");
+                        }
+                        stamp[vertex] = static_cast<uint32_t>(m);
+                        local[vertex] = static_cast<uint8_t>(localCount++);
+                        data.push_back(vertex);
+                    }
+                    packed |= static_cast<uint32_t>(local[vertex]) << (corner * 8);
+                }
+                triangles.push_back(packed);
+            }
+            meshlet.vertexCount = localCount;
+            data.insert(data.end(), triangles.begin(), triangles.end());
+        }
+        return data;
+    }
+}
+
+std::vector<Meshlet> MeshletBuilder::build(std::vector<uint32_t>& indices, const std::vector<std::pair<uint32_t, uint32_t>>& ranges,
+                                           const float* positions, size_t positionStride, size_t vertexCount, float coneWeight) {
+    std::vector<Meshlet> meshlets;
+    if (indices.empty() || vertexCount == 0) {
+        return meshlets;
+    }
+    const size_t triangleCount = indices.size() / 3;
+    MeshAdjacency adjacency;
+    adjacency.build(indices, vertexCount);
+
+    std::vector<glm::vec3> normals(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        normals[t] = triangleNormal(loadPosition(positions, positionStride, indices[t * 3 + 0]),
+                                    loadPosition(positions, positionStride, indices[t * 3 + 1]),
+                                    loadPosition(positions, positionStride, indices[t * 3 + 2]));
+    }
+
+    // 每个顶点尚未输出的相邻三角形数：为 0 的顶点不再扫描
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> vertexMeshlet(vertexCount, kInvalid);   // 顶点当前所在的簇编号
+    std::vector<uint32_t> meshletVertices;
+    meshletVertices.reserve(kMaxVertices);
+    std::vector<uint32_t> reordered;
+
+    for (const auto& [firstIndex, indexCount] : ranges) {
+        const size_t begin = firstIndex / 3;
+        const size_t end = (static_cast<size_t>(firstIndex) + indexCount) / 3;
+        reordered.clear();
+        reordered.reserve(static_cast<size_t>(indexCount));
+        size_t scan = begin;
+
+        while (true) {
+            // 新簇从扫描顺序中下一个未输出的三角形开始，保持缓存优化后的局部性
+            while (scan < end && emitted[scan]) scan++;
+            if (scan == end) break;
+
+            const uint32_t id = static_cast<uint32_t>(meshlets.size());
+            Meshlet meshlet;
+            meshlet.firstIndex = firstIndex + static_cast<uint32_t>(reordered.size());
+            meshletVertices.clear();
+            glm::vec3 normalSum(0.0f);
+
+            auto emit = [&](size_t t) {
+                emitted[t] = true;
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const uint32_t vertex = indices[t * 3 + corner];
+                    liveTriangles[vertex]--;
+                    if (vertexMeshlet[vertex] != id) {
+                        vertexMeshlet[vertex] = id;
+                        meshletVertices.push_back(vertex);
+                    }
+                    reordered.push_back(vertex);
+                }
+                normalSum += normals[t];
+                meshlet.triangleCount++;
+            };
+            emit(scan);
+
+            while (meshlet.triangleCount < kMaxTriangles) {
+                const float axisLength = glm::length(normalSum);
+                const glm::vec3 axis = axisLength > 0.0f ? normalSum / axisLength : glm::vec3(0.0f);
+                size_t best = kInvalid;
+                float bestScore = std::numeric_limits<float>::max();
+                for (uint32_t vertex : meshletVertices) {
+                    if (liveTriangles[vertex] == 0) continue;
+                    for (uint32_t k = adjacency.offsets[vertex]; k < adjacency.offsets[vertex + 1]; k++) {
+                        const uint32_t t = adjacency.triangles[k];
+                        if (emitted[t] || t < begin || t >= end) continue;
+                        uint32_t extra = 0;
+                        uint32_t live = 0;
+                        for (size_t corner = 0; corner < 3; corner++) {
+                            const uint32_t v = indices[t * 3 + corner];
+                            extra += vertexMeshlet[v] != id ? 1 : 0;
+                            live += liveTriangles[v];
+                        }
+                        if (meshletVertices.size() + extra > kMaxVertices) continue;
+                        // 相邻三角形所剩无几的顶点优先收尾，簇更紧凑（边界上悬空的顶点更少）
+                        const float score = static_cast<float>(extra) + coneWeight * (1.0f - glm::dot(normals[t], axis))
+                                          + kLiveWeight * static_cast<float>(live);
+                        if (score < bestScore) {
+                            bestScore = score;
+                            best = t;
+                        }
+                    }
+                }
+                // 没有相邻且放得下的三角形时结束当前簇
+                if (best == kInvalid) break;
+                emit(best);
+            }
+
+            meshlet.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+            meshlets.push_back(meshlet);
+        }
+        std::copy(reordered.begin(), reordered.end(), indices.begin() + firstIndex);
+    }
+
+    for (Meshlet& meshlet : meshlets) {
+        MeshletBuilder::computeBounds(meshlet, indices, positions, positionStride);
+    }
+    return meshlets;
+}
+
+std::vector<uint32_t> MeshletBuilder::buildLocalData(std::vector<Meshlet>& meshlets, const uint32_t* indices, size_t vertexCount, uint32_t wordBase) {
+    return packLocalData(meshlets, indices, vertexCount, wordBase);
+}
+
+std::vector<uint32_t> MeshletBuilder::buildLocalData(std::vector<Meshlet>& meshlets, const uint16_t* indices, size_t vertexCount, uint32_t wordBase) {
+    return packLocalData(meshlets, indices, vertexCount, wordBase);
+}
+
+void MeshletBuilder::computeBounds(Meshlet& meshlet, const std::vector<uint32_t>& indices,
+                                   const float* positions, size_t positionStride) {
+    const uint32_t* corners = indices.data() + meshlet.firstIndex;
+    const size_t cornerCount = static_cast<size_t>(meshlet.triangleCount) * 3;
+    if (cornerCount == 0) {
+        return;
+    }
+    auto position = [&](size_t corner) { return loadPosition(positions, positionStride, corners[corner]); };
+
+    // 1. 包围球（Ritter）：先取相距较远的两点作直径，再逐点扩张
+    const glm::vec3 p0 = position(0);
+    glm::vec3 a = p0;
+    float farthest = -1.0f;
+    for (size_t i = 0; i < cornerCount; i++) {
+        const float d = glm::dot(position(i) - p0, position(i) - p0);
+        if (d > farthest) { farthest = d; a = position(i); }
+    }
+    glm::vec3 b = a;
+    farthest = -1.0f;
+    for (size_t i = 0; i < cornerCount; i++) {
+        const float d = glm::dot(position(i) - a, position(i) - a);
+        if (d > farthest) { farthest = d; b = position(i); }
+    }
+    glm::vec3 center = (a + b) * 0.5f;
+    float radius = glm::length(b - a) * 0.5f;
+    for (size_t i = 0; i < cornerCount; i++) {
+        const glm::vec3 p = position(i);
+        const float distance = glm::length(p - center);
+        if (distance > radius) {
+            const float grown = (radius + distance) * 0.5f;
+            center += (p - center) * ((grown - radius) / distance);
+            radius = grown;
+        }
+    }
+
+    // 2. 法线锥：轴为单位法线的平均方向，mindp 为各法线与轴夹角余弦的最小值
+    glm::vec3 axis(0.0f);
+    for (size_t t = 0; t < meshlet.triangleCount; t++) {
+        axis += triangleNormal(position(t * 3 + 0), position(t * 3 + 1), position(t * 3 + 2));
+    }
+    const float axisLength = glm::length(axis);
+    float mindp = 1.0f;
+    if (axisLength > 0.0f) {
+        axis /= axisLength;
+        for (size_t t = 0; t < meshlet.triangleCount; t++) {
+            const glm::vec3 n = triangleNormal(position(t * 3 + 0), position(t * 3 + 1), position(t * 3 + 2));
+            if (n != glm::vec3(0.0f)) mindp = std::min(mindp, glm::dot(n, axis));
+        }
+    }
+
+    for (int c = 0; c < 3; c++) {
+        meshlet.center[c] = center[c];
+        meshlet.coneApex[c] = center[c];
+        meshlet.coneAxis[c] = axis[c];
+    }
+    meshlet.radius = radius;
+    meshlet.coneCutoff = 1.0f;
+    // 锥角接近或超过半球时几乎不可能整簇背向，按不可剔除处理
+    if (axisLength <= 0.0f || mindp <= 0.1f) {
+        return;
+    }
+
+    // 3. 锥顶沿 -axis 后移，使所有三角形平面都在锥顶前方：从锥顶看不到任何正面时整簇可剔除
+    float maxt = 0.0f;
+    for (size_t t = 0; t < meshlet.triangleCount; t++) {
+        const glm::vec3 v0 = position(t * 3 + 0);
+        const glm::vec3 n = triangleNormal(v0, position(t * 3 + 1), position(t * 3 + 2));
+        if (n == glm::vec3(0.0f)) continue;
+        const float dc = glm::dot(center - v0, n);
+        const float dn = glm::dot(axis, n);
+        maxt = std::max(maxt, dc / dn);
+    }
+    const glm::vec3 apex = center - axis * maxt;
+    for (int c = 0; c < 3; c++) {
+        meshlet.coneApex[c] = apex[c];
+    }
+    meshlet.coneCutoff = std::sqrt(1.0f - mindp * mindp);
+}
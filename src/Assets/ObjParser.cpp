@@ -0,0 +1,288 @@
+#include "Assets/ObjParser.h"
+#include "Core/JobSystem.h"
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr size_t kChunkSize = 4u << 20;         // 每块约 4 MB 文本
+
+    struct Chunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        // 第一遍：块内各类语句的个数
+        size_t positionCount = 0;
+        size_t texCoordCount = 0;
+        size_t normalCount = 0;
+        size_t cornerCount = 0;
+        // 前缀和：块在全局数组中的起点
+        size_t positionBase = 0;
+        size_t texCoordBase = 0;
+        size_t normalBase = 0;
+        size_t cornerBase = 0;
+        // 第二遍：块内 o / g 出现时的全局角点位置
+        std::vector<size_t> shapeStarts;
+    };
+
+    enum class Statement {
+        Position, TexCoord, Normal, Face, Group, Other
+    };
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) p++;
+        return p;
+    }
+
+    // 识别语句类型，返回关键字之后的位置
+    Statement classify(const char*& p, const char* end) {
+        p = skipSpaces(p, end);
+        if (p >= end) return Statement::Other;
+        auto keyword = [&](const char* word, size_t length) {
+            if (static_cast<size_t>(end - p) < length || std::memcmp(p, word, length) != 0) return false;
+            if (p + length < end && !isSpace(p[length])) return false;
+            p += length;
+            return true;
+        };
+        switch (*p) {
+            case 'v':
+                if (keyword("v", 1)) return Statement::Position;
+                if (keyword("vt", 2)) return Statement::TexCoord;
+                if (keyword("vn", 2)) return Statement::Normal;
+                break;
+            case 'f':
+                if (keyword("f", 1)) return Statement::Face;
+                break;
+            case 'o':
+                if (keyword("o", 1)) return Statement::Group;
+                break;
+            case 'g':
+                if (keyword("g", 1)) return Statement::Group;
+                break;
+            default:
+                break;
+        }
+        return Statement::Other;
+    }
+
+    [[noreturn]] void malformed(const std::string& name, const char* line, const char* end) {
+        throw std::runtime_error("Malformed OBJ statement in " + name + ": '" + std::string(line, end) + "'");
+    }
+
+    // 逐行遍历 [begin, end)，fn(行首, 行尾)
+    template<typename F>
+    void forEachLine(const char* begin, const char* end, F&& fn) {
+        const char* line = begin;
+        while (line < end) {
+            const char* newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            const char* lineEnd = newline ? newline : end;
+            fn(line, lineEnd);
+            line = lineEnd + 1;
+        }
+    }
+
+    // 面的顶点个数（空白分隔的记号数）
+    size_t countTokens(const char* p, const char* end) {
+        size_t count = 0;
+        while (true) {
+            p = skipSpaces(p, end);
+            if (p >= end || *p == '#') return count;
+            count++;
+            while (p < end && !isSpace(*p)) p++;
+        }
+    }
+
+    bool parseFloat(const char*& p, const char* end, float& value) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == '+') p++;
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc()) return false;
+        p = next;
+        return true;
+    }
+
+    bool parseInt(const char*& p, const char* end, int64_t& value) {
+        if (p < end && *p == '+') p++;
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc()) return false;
+        p = next;
+        return true;
+    }
+
+    // OBJ 下标：正数从 1 开始，负数相对于到目前为止的个数
+    bool resolveIndex(int64_t raw, size_t countSoFar, size_t total, int32_t& index) {
+        int64_t resolved = raw > 0 ? raw - 1 : static_cast<int64_t>(countSoFar) + raw;
+        if (raw == 0 || resolved < 0 || resolved >= static_cast<int64_t>(total)) return false;
+        index = static_cast<int32_t>(resolved);
+        return true;
+    }
+
+    void countChunk(Chunk& chunk) {
+        forEachLine(chunk.begin, chunk.end, [&](const char* line, const char* lineEnd) {
+            const char* p = line;
+            switch (classify(p, lineEnd)) {
+                case Statement::Position: chunk.positionCount++; break;
+                case Statement::TexCoord: chunk.texCoordCount++; break;
+                case Statement::Normal:   chunk.normalCount++; break;
+                case Statement::Face: {
+                    const size_t vertices = countTokens(p, lineEnd);
+                    if (vertices >= 3) chunk.cornerCount += (vertices - 2) * 3;
+                    break;
+                }
+                default: break;
+            }
+        });
+    }
+
+    void parseChunk(Chunk& chunk, ObjData& data, const std::string& name) {
+        size_t position = chunk.positionBase;
+        size_t texCoord = chunk.texCoordBase;
+        size_t normal = chunk.normalBase;
+        size_t corner = chunk.cornerBase;
+        const size_t positionTotal = data.positions.size() / 3;
+        const size_t texCoordTotal = data.texCoords.size() / 2;
+        const size_t normalTotal = data.normals.size() / 3;
+        std::vector<ObjIndex> polygon;
+
+        forEachLine(chunk.begin, chunk.end, [&](const char* line, const char* lineEnd) {
+            const char* p = line;
+            switch (classify(p, lineEnd)) {
+                case Statement::Position: {
+                    float* out = &data.positions[position * 3];
+                    if (!parseFloat(p, lineEnd, out[0]) || !parseFloat(p, lineEnd, out[1]) || !parseFloat(p, lineEnd, out[2])) {
+                        malformed(name, line, lineEnd);
+                    }
+                    position++;
+                    break;
+                }
+                case Statement::TexCoord: {
+                    float* out = &data.texCoords[texCoord * 2];
+                    if (!parseFloat(p, lineEnd, out[0])) malformed(name, line, lineEnd);
+                    if (!parseFloat(p, lineEnd, out[1])) out[1] = 0.0f;
+                    texCoord++;
+                    break;
+                }
+                case Statement::Normal: {
+                    float* out = &data.normals[normal * 3];
+                    if (!parseFloat(p, lineEnd, out[0]) || !parseFloat(p, lineEnd, out[1]) || !parseFloat(p, lineEnd, out[2])) {
+                        malformed(name, line, lineEnd);
+                    }
+                    normal++;
+                    break;
+                }
+                case Statement::Face: {
+                    // v | v/vt | v//vn | v/vt/vn
+                    polygon.clear();
+                    while (true) {
+                        p = skipSpaces(p, lineEnd);
+                        if (p >= lineEnd || *p == '#') break;
+                        ObjIndex index;
+                        int64_t raw = 0;
+                        if (!parseInt(p, lineEnd, raw) || !resolveIndex(raw, position, positionTotal, index.position)) {
+                            malformed(name, line, lineEnd);
+                        }
+                        if (p < lineEnd && *p == '/') {
+                            p++;
+                            if (p < lineEnd && *p != '/') {
+                                if (!parseInt(p, lineEnd, raw) || !resolveIndex(raw, texCoord, texCoordTotal, index.texCoord)) {
+                                    malformed(name, line, lineEnd);
+                                }
+                            }
+                            if (p < lineEnd && *p == '/') {
+                                p++;
+                                if (!parseInt(p, lineEnd, raw) || !resolveIndex(raw, normal, normalTotal, index.normal)) {
+                                    malformed(name, line, lineEnd);
+                                }
+                            }
+                        }
+                        if (p < lineEnd && !isSpace(*p)) malformed(name, line, lineEnd);
+                        polygon.push_back(index);
+                    }
+                    // 扇形三角化
+                    for (size_t i = 2; i < polygon.size(); i++) {
+                        data.corners[corner++] = polygon[0];
+                        data.corners[corner++] = polygon[i - 1];
+                        data.corners[corner++] = polygon[i];
+                    }
+                    break;
+                }
+                case Statement::Group:
+                    chunk.shapeStarts.push_back(corner);
+                    break;
+                default:
+                    break;
+            }
+        });
+    }
+}
+
+ObjData ObjParser::parse(std::string_view text, const std::string& name, JobSystem* jobs) {
+    // 1. 按行边界切块（单线程时整个文件一块）
+    const size_t chunkCount = jobs ? std::max<size_t>(1, text.size() / kChunkSize) : 1;
+    std::vector<Chunk> chunks(chunkCount);
+    const char* const textBegin = text.data();
+    const char* const textEnd = text.data() + text.size();
+    const char* cursor = textBegin;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char* end = textEnd;
+        if (i + 1 < chunkCount) {
+            end = std::max(cursor, textBegin + text.size() * (i + 1) / chunkCount);
+            const void* newline = std::memchr(end, '\n', static_cast<size_t>(textEnd - end));
+            end = newline ? static_cast<const char*>(newline) + 1 : textEnd;
+        }
+        chunks[i].begin = cursor;
+        chunks[i].end = end;
+        cursor = end;
+    }
+    auto forEachChunk = [&](auto&& fn) {
+        if (jobs) {
+            jobs->parallelFor(chunkCount, [&](size_t i) { fn(chunks[i]); });
+        } else {
+            for (auto& chunk : chunks) fn(chunk);
+        }
+    };
+
+    // 2. 统计并求前缀和，一次性分配最终大小的数组（不需要合并拷贝）
+    forEachChunk([](Chunk& chunk) { countChunk(chunk); });
+    size_t positions = 0, texCoords = 0, normals = 0, corners = 0;
+    for (auto& chunk : chunks) {
+        chunk.positionBase = positions;
+        chunk.texCoordBase = texCoords;
+        chunk.normalBase = normals;
+        chunk.cornerBase = corners;
+        positions += chunk.positionCount;
+        texCoords += chunk.texCoordCount;
+        normals += chunk.normalCount;
+        corners += chunk.cornerCount;
+    }
+    if (corners > UINT32_MAX) {
+        throw std::runtime_error("OBJ file has too many faces: " + name);
+    }
+
+    ObjData data;
+    data.positions.resize(positions * 3);
+    data.texCoords.resize(texCoords * 2);
+    data.normals.resize(normals * 3);
+    data.corners.resize(corners);
+
+    // 3. 各块直接写入自己的区间
+    forEachChunk([&](Chunk& chunk) { parseChunk(chunk, data, name); });
+
+    // 4. o / g 把角点切成组，丢弃没有面的组
+    std::vector<size_t> boundaries{0};
+    for (const auto& chunk : chunks) {
+        boundaries.insert(boundaries.end(), chunk.shapeStarts.begin(), chunk.shapeStarts.end());
+    }
+    boundaries.push_back(corners);
+    for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+        if (boundaries[i + 1] > boundaries[i]) {
+            data.shapes.push_back(ObjShape{static_cast<uint32_t>(boundaries[i]),
+                                           static_cast<uint32_t>(boundaries[i + 1] - boundaries[i])});
+        }
+    }
+    return data;
+}
@@ -1,130 +1,543 @@
 #include "Assets/Texture.h"
+#include "Core/JobSystem.h"
+#include "Assets/Ktx2.h"
+#include "Assets/MappedFile.h"
+#include "Core/TextureStreamer.h"
+#include "Core/Command.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <cstring>
+#include <algorithm>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "3rd/stb_image.h"
 
-// Constructor: Load texture from file
-Texture::Texture(Context* context, const std::string& filepath)
-    : m_context(context)
-    , m_mipLevels(0)
-    , m_width(0)
-    , m_height(0)
-    , m_allocation(VK_NULL_HANDLE) {
+namespace {
+    // 行数少于该值的 mip 级不分发到工作线程
+    constexpr uint32_t kParallelMinRows = 64;
+
+    const std::array<float, 256>& getSrgbToLinearTable() {
+        static const std::array<float, 256> table = []() {
+            std::array<float, 256> values{};
+            for (int i = 0; i < 256; i++) {
+                const float c = i / 255.0f;
+                values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    // 线性值按 1/4096 量化后查表转回 sRGB 8 位
+    uint8_t linearToSrgb(float value) {
+        static const std::array<uint8_t, 4097> table = []() {
+            std::array<uint8_t, 4097> values{};
+            for (int i = 0; i <= 4096; i++) {
+                const float c = i / 4096.0f;
+                const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                values[i] = static_cast<uint8_t>(std::lround(std::clamp(s, 0.0f, 1.0f) * 255.0f));
+            }
+            return values;
+        }();
+        return table[static_cast<size_t>(std::clamp(value, 0.0f, 1.0f) * 4096.0f + 0.5f)];
+    }
+
+    // 2x2 盒式滤波生成下一级 mip（奇数边长时最后一行 / 列与自身平均）：
+    // sRGB 颜色先转到线性空间再平均，法线解码成向量平均后重新归一化，其余按 8 位值直接平均
+    ImageData downsample(const ImageData& source, TextureUsage usage, bool srgb, JobSystem* jobs) {
+        ImageData target;
+        target.width = std::max(source.width / 2, 1u);
+        target.height = std::max(source.height / 2, 1u);
+        target.pixels.resize(static_cast<size_t>(target.width) * target.height * 4);
+        const auto& toLinear = getSrgbToLinearTable();
+
+        auto filterRow = [&](size_t y) {
+            const uint32_t y0 = std::min(static_cast<uint32_t>(y) * 2, source.height - 1);
+            const uint32_t y1 = std::min(y0 + 1, source.height - 1);
+            for (uint32_t x = 0; x < target.width; x++) {
+                const uint32_t x0 = std::min(x * 2, source.width - 1);
+                const uint32_t x1 = std::min(x0 + 1, source.width - 1);
+                const uint8_t* taps[4] = {
+                    &source.pixels[(static_cast<size_t>(y0) * source.width + x0) * 4],
+                    &source.pixels[(static_cast<size_t>(y0) * source.width + x1) * 4],
+                    &source.pixels[(static_cast<size_t>(y1) * source.width + x0) * 4],
+                    &source.pixels[(static_cast<size_t>(y1) * source.width + x1) * 4]
+                };
+                uint8_t* out = &target.pixels[(y * target.width + x) * 4];
+                if (usage == TextureUsage::Normal) {
+                    float n[3] = {};
+                    for (const uint8_t* tap : taps) {
+                        for (int c = 0; c < 3; c++) n[c] += tap[c] / 127.5f - 1.0f;
+                    }
+                    const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                    const float scale = length > 1e-6f ? 1.0f / length : 0.0f;
+                    for (int c = 0; c < 3; c++) {
+                        out[c] = static_cast<uint8_t>(std::lround(std::clamp(n[c] * scale * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f));
+                    }
+                } else if (usage == TextureUsage::Color && srgb) {
+                    for (int c = 0; c < 3; c++) {
+                        const float sum = toLinear[taps[0][c]] + toLinear[taps[1][c]] + toLinear[taps[2][c]] + toLinear[taps[3][c]];
+                        out[c] = linearToSrgb(sum * 0.25f);
+                    }
+                } else {
+                    for (int c = 0; c < 3; c++) {
+                        out[c] = static_cast<uint8_t>((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+                    }
+                }
+                out[3] = static_cast<uint8_t>((taps[0][3] + taps[1][3] + taps[2][3] + taps[3][3] + 2) / 4);
+            }
+        };
+        if (jobs && target.height >= kParallelMinRows) {
+            jobs->parallelFor(target.height, filterRow);
+        } else {
+            for (uint32_t y = 0; y < target.height; y++) filterRow(y);
+        }
+        return target;
+    }
+
+    bool hasTranslucentPixels(const ImageData& image) {
+        for (size_t i = 3; i < image.pixels.size(); i += 4) {
+            if (image.pixels[i] != 255) return true;
+        }
+        return false;
+    }
+
+    std::optional<BlockFormat> selectBlockFormat(const ImageData& image, TextureUsage usage, const TextureFormatSupport& support) {
+        switch (usage) {
+        case TextureUsage::Normal:
+            if (support.supports(BlockFormat::BC5)) return BlockFormat::BC5;
+            break;
+        case TextureUsage::Mask:
+            if (support.supports(BlockFormat::BC4)) return BlockFormat::BC4;
+            break;
+        case TextureUsage::Color:
+        case TextureUsage::Orm: {
+            if (support.supports(BlockFormat::BC7)) return BlockFormat::BC7;
+            const BlockFormat fallback = hasTranslucentPixels(image) ? BlockFormat::BC3 : BlockFormat::BC1;
+            if (support.supports(fallback)) return fallback;
+            break;
+        }
+        }
+        return std::nullopt;
+    }
 
-    // Load image from file using stb_image
+    uint32_t getChannelCount(vk::Format format) {
+        switch (format) {
+        case vk::Format::eR8Unorm: return 1;
+        case vk::Format::eR8G8Unorm: return 2;
+        default: return 4;
+        }
+    }
+
+    // RGBA8 行写入 staging：只保留目标格式的前 channels 个通道，flipY 时按相反的行序写入
+    void copyPixels(uint8_t* target, const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, bool flipY) {
+        const size_t sourceRowBytes = static_cast<size_t>(width) * 4;
+        const size_t targetRowBytes = static_cast<size_t>(width) * channels;
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t* in = source + y * sourceRowBytes;
+            uint8_t* out = target + (flipY ? height - 1 - y : y) * targetRowBytes;
+            if (channels == 4) {
+                memcpy(out, in, sourceRowBytes);
+                continue;
+            }
+            for (uint32_t x = 0; x < width; x++) {
+                for (uint32_t c = 0; c < channels; c++) out[x * channels + c] = in[x * 4 + c];
+            }
+        }
+    }
+}
+
+// Decode an encoded image (jpg/png/...) to flipped RGBA8 (CPU only, thread safe)
+ImageData Texture::decode(const uint8_t* bytes, size_t size, const std::string& name, bool flipY) {
     int texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+    stbi_uc* pixels = stbi_load_from_memory(bytes, static_cast<int>(size), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
     if (!pixels) {
-        throw std::runtime_error("Failed to load texture image: " + filepath);
+        throw std::runtime_error("Failed to load texture image: " + name);
     }
 
-    m_width = static_cast<uint32_t>(texWidth);
-    m_height = static_cast<uint32_t>(texHeight);
+    ImageData image;
+    image.width = static_cast<uint32_t>(texWidth);
+    image.height = static_cast<uint32_t>(texHeight);
+    image.pixels.resize(static_cast<size_t>(texWidth) * texHeight * 4);
 
     // ⚠️ 关键修复：翻转Y轴以匹配Vulkan的坐标系
     // stb_image加载的图像原点在左上角，Vulkan期望原点在左下角
-    stbi_uc* flippedPixels = new stbi_uc[texWidth * texHeight * 4];
+    const size_t rowBytes = static_cast<size_t>(texWidth) * 4;
     for (int y = 0; y < texHeight; y++) {
-        for (int x = 0; x < texWidth; x++) {
-            int srcIdx = (y * texWidth + x) * 4;
-            int dstIdx = ((texHeight - 1 - y) * texWidth + x) * 4;
-            flippedPixels[dstIdx + 0] = pixels[srcIdx + 0]; // R
-            flippedPixels[dstIdx + 1] = pixels[srcIdx + 1]; // G
-            flippedPixels[dstIdx + 2] = pixels[srcIdx + 2]; // B
-            flippedPixels[dstIdx + 3] = pixels[srcIdx + 3]; // A
-        }
+        const int row = flipY ? texHeight - 1 - y : y;
+        memcpy(image.pixels.data() + row * rowBytes, pixels + y * rowBytes, rowBytes);
     }
+    stbi_image_free(pixels);
+    return image;
+}
 
-    // Calculate mip levels
-    m_mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(m_width, m_height)))) + 1;
+ImageData Texture::loadImage(const std::string& filepath) {
+    const MappedFile file(filepath);
+    return Texture::decode(file.getData(), file.getSize(), filepath);
+}
 
-    vk::DeviceSize imageSize = m_width * m_height * 4; // 4 bytes per pixel (RGBA)
+vk::Format Texture::getBlockFormat(BlockFormat format, bool srgb) {
+    switch (format) {
+    case BlockFormat::BC1: return srgb ? vk::Format::eBc1RgbSrgbBlock : vk::Format::eBc1RgbUnormBlock;
+    case BlockFormat::BC3: return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+    case BlockFormat::BC4: return vk::Format::eBc4UnormBlock;
+    case BlockFormat::BC5: return vk::Format::eBc5UnormBlock;
+    case BlockFormat::BC7: return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+    default: return vk::Format::eUndefined;
+    }
+}
 
-    // Create staging buffer using VMA
-    vk::BufferCreateInfo bufferInfo{};
-    bufferInfo.size = imageSize;
-    bufferInfo.usage = vk::BufferUsageFlagBits::eTransferSrc;
-    bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+vk::Format Texture::getPixelFormat(const TextureImportSettings& settings) {
+    switch (settings.usage) {
+    case TextureUsage::Normal: return vk::Format::eR8G8Unorm;
+    case TextureUsage::Mask: return vk::Format::eR8Unorm;
+    default: return settings.srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+    }
+}
 
-    VmaAllocationCreateInfo allocInfo{};
-    allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+TextureFormatSupport Texture::queryFormatSupport(Context* context) {
+    TextureFormatSupport support;
+    if (!context->getFeatures().textureCompressionBC) {
+        return support;
+    }
+    const vk::FormatFeatureFlags required = vk::FormatFeatureFlagBits::eSampledImage
+                                          | vk::FormatFeatureFlagBits::eSampledImageFilterLinear
+                                          | vk::FormatFeatureFlagBits::eTransferDst;
+    auto isSupported = [&](vk::Format format) {
+        const vk::FormatProperties properties = context->getPhysicalDevice().getFormatProperties(format);
+        return (properties.optimalTilingFeatures & required) == required;
+    };
+    for (uint32_t i = 0; i < static_cast<uint32_t>(BlockFormat::Count); i++) {
+        const auto format = static_cast<BlockFormat>(i);
+        if (isSupported(getBlockFormat(format, true)) && isSupported(getBlockFormat(format, false))) {
+            support.blockFormats |= 1u << i;
+        }
+    }
+    return support;
+}
 
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingAllocation;
+std::optional<EncodedTexture> Texture::encode(const ImageData& image, const TextureImportSettings& settings,
+                                              const TextureFormatSupport& support, JobSystem* jobs) {
+    if (!settings.compress || image.width == 0 || image.height == 0) {
+        return std::nullopt;
+    }
+    const std::optional<BlockFormat> blockFormat = selectBlockFormat(image, settings.usage, support);
+    if (!blockFormat) {
+        return std::nullopt;
+    }
+
+    EncodedTexture encoded;
+    encoded.width = image.width;
+    encoded.height = image.height;
+    encoded.format = getBlockFormat(*blockFormat, settings.srgb);
+    const uint32_t levelCount = settings.generateMips
+        ? static_cast<uint32_t>(std::floor(std::log2(std::max(image.width, image.height)))) + 1
+        : 1;
+    uint64_t offset = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const uint32_t width = std::max(image.width >> level, 1u);
+        const uint32_t height = std::max(image.height >> level, 1u);
+        const uint64_t size = BlockCompressor::getEncodedSize(*blockFormat, width, height);
+        encoded.levels.push_back(TextureLevel{offset, size});
+        offset += size;
+    }
+    encoded.data.resize(static_cast<size_t>(offset));
+
+    // 每一级由上一级滤波得到，编码完成后上一级即可释放
+    ImageData mip;
+    const ImageData* current = &image;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        if (level > 0) {
+            mip = downsample(*current, settings.usage, settings.srgb, jobs);
+            current = &mip;
+        }
+        BlockCompressor::encode(*blockFormat, current->pixels.data(), current->width, current->height,
+                                encoded.data.data() + encoded.levels[level].offset, jobs);
+    }
+    return encoded;
+}
 
-    VkResult result = vmaCreateBuffer(m_context->getVmaAllocator(),
-                                      reinterpret_cast<VkBufferCreateInfo*>(&bufferInfo),
-                                      &allocInfo,
-                                      &stagingBuffer,
-                                      &stagingAllocation,
-                                      nullptr);
+// Constructor: Load texture from file（KTX2 直接上传打包好的 mip 链，其他格式解码后上传）
+Texture::Texture(Context* context, const std::string& filepath, const TextureImportSettings& settings)
+    : m_context(context)
+    , m_name(filepath)
+    , m_mipLevels(0)
+    , m_width(0)
+    , m_height(0)
+    , m_format(vk::Format::eUndefined)
+    , m_allocation(VK_NULL_HANDLE) {
 
-    if (result != VK_SUCCESS) {
-        stbi_image_free(pixels);
-        throw std::runtime_error("Failed to create staging buffer for texture");
+    const MappedFile file(filepath);
+    if (Ktx2::isKtx2(file.getData(), file.getSize())) {
+        const Ktx2Image ktx = Ktx2::parse(file.getData(), file.getSize(), filepath);
+        createFromLevels(ktx.getView());
+    } else {
+        // stb 解码结果按行翻转后直接写入映射的 staging 内存，不经过 ImageData 中间缓冲；
+        // 写入后立即释放解码缓冲，峰值内存只有一份像素
+        int texWidth, texHeight, texChannels;
+        std::unique_ptr<stbi_uc, void (*)(void*)> pixels(
+            stbi_load_from_memory(file.getData(), static_cast<int>(file.getSize()), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha),
+            stbi_image_free);
+        if (!pixels) {
+            throw std::runtime_error("Failed to load texture image: " + filepath);
+        }
+        const auto width = static_cast<uint32_t>(texWidth);
+        const auto height = static_cast<uint32_t>(texHeight);
+        const uint32_t channels = getChannelCount(Texture::getPixelFormat(settings));
+        createFromPixels(width, height, settings, [&](uint8_t* mapped) {
+            // 与 decode 的 flipY 相同：stb 的原点在左上角，OBJ 的 UV 原点在左下角
+            copyPixels(mapped, pixels.get(), width, height, channels, true);
+            pixels.reset();
+        });
     }
+}
 
-    // Copy image data to staging buffer（使用翻转后的像素）
-    void* data;
-    vmaMapMemory(m_context->getVmaAllocator(), stagingAllocation, &data);
-    memcpy(data, flippedPixels, static_cast<size_t>(imageSize));
-    vmaUnmapMemory(m_context->getVmaAllocator(), stagingAllocation);
+// Constructor: create from decoded pixels (GPU image + upload only)
+Texture::Texture(Context* context, const ImageData& image, const std::string& name, const TextureImportSettings& settings)
+    : m_context(context)
+    , m_name(name)
+    , m_mipLevels(0)
+    , m_width(0)
+    , m_height(0)
+    , m_format(vk::Format::eUndefined)
+    , m_allocation(VK_NULL_HANDLE) {
 
-    // 释放原始和翻转后的像素数据
-    delete[] flippedPixels;
-    stbi_image_free(pixels);
+    const uint32_t channels = getChannelCount(Texture::getPixelFormat(settings));
+    createFromPixels(image.width, image.height, settings, [&](uint8_t* mapped) {
+        copyPixels(mapped, image.pixels.data(), image.width, image.height, channels, false);
+    });
+}
 
-    // Create texture image
-    createImage(m_width, m_height, m_mipLevels,
-                vk::Format::eR8G8B8A8Srgb,
-                vk::ImageTiling::eOptimal,
-                vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-                VMA_MEMORY_USAGE_GPU_ONLY);
+// Constructor: upload pre-baked mip levels (block compressed / KTX2)
+Texture::Texture(Context* context, const TextureView& view, const std::string& name)
+    : m_context(context)
+    , m_name(name)
+    , m_mipLevels(0)
+    , m_width(0)
+    , m_height(0)
+    , m_format(vk::Format::eUndefined)
+    , m_allocation(VK_NULL_HANDLE) {
 
-    // Transition image layout and copy buffer to image
-    transitionImageLayout(m_image, vk::Format::eR8G8B8A8Srgb,
-                         vk::ImageLayout::eUndefined,
-                         vk::ImageLayout::eTransferDstOptimal, m_mipLevels);
+    createFromLevels(view);
+}
 
-    copyBufferToImage(static_cast<vk::Buffer>(stagingBuffer), m_image, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
+// Constructor: streamed texture (only the levels chosen by the TextureStreamer are uploaded)
+Texture::Texture(Context* context, TextureStreamSource source, const std::string& name)
+    : m_context(context)
+    , m_name(name)
+    , m_mipLevels(0)
+    , m_width(0)
+    , m_height(0)
+    , m_format(vk::Format::eUndefined)
+    , m_allocation(VK_NULL_HANDLE)
+    , m_stream(std::move(source)) {
+
+    TextureStreamer* streamer = m_context->getTextureStreamer();
+    m_residentMip = streamer->getInitialMip(m_stream->view);
+    createFromLevels(m_stream->view);
+    streamer->registerTexture(this);
+}
 
-    // Cleanup staging buffer
-    vmaDestroyBuffer(m_context->getVmaAllocator(), stagingBuffer, stagingAllocation);
+std::unique_ptr<Texture> Texture::createFromSource(Context* context, TextureStreamSource source, const std::string& name) {
+    if (context->getTextureStreamer()->canStream(source.view)) {
+        return std::make_unique<Texture>(context, std::move(source), name);
+    }
+    return std::make_unique<Texture>(context, source.view, name);
+}
+
+void Texture::createFromPixels(uint32_t width, uint32_t height, const TextureImportSettings& settings,
+                               const std::function<void(uint8_t* mapped)>& writePixels) {
+    m_width = width;
+    m_height = height;
+    m_format = Texture::getPixelFormat(settings);
+
+    // Calculate mip levels
+    m_mipLevels = settings.generateMips
+        ? static_cast<uint32_t>(std::floor(std::log2(std::max(m_width, m_height)))) + 1
+        : 1;
+
+    vk::DeviceSize imageSize = static_cast<vk::DeviceSize>(m_width) * m_height * getChannelCount(m_format);
+
+    // RGBA8 且不超过 4096 时由计算着色器一次生成整条 mip 链，需要 STORAGE 用途（sRGB 通过 UNORM 视图写入）
+    MipGenerator* mips = m_context->getMipGenerator();
+    const bool storageMips = settings.generateMips && mips && mips->supports(m_format, m_width, m_height, m_mipLevels);
+    vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    if (storageMips) {
+        usage |= MipGenerator::getImageUsage();
+    }
 
-    // Generate mipmaps
-    generateMipmaps(m_image, vk::Format::eR8G8B8A8Srgb, texWidth, texHeight, m_mipLevels);
+    // Create texture image
+    createImage(m_width, m_height, m_mipLevels,
+                m_format,
+                vk::ImageTiling::eOptimal,
+                usage,
+                VMA_MEMORY_USAGE_GPU_ONLY,
+                storageMips ? MipGenerator::getImageCreateFlags(m_format) : vk::ImageCreateFlags{});
+
+    // 像素写入上传引擎的 staging 环形缓冲，在传输队列上拷贝 mip 0；
+    // mipmap 由 MipGenerator 在计算队列上生成，其余格式在下一帧图形命令缓冲开头 blit
+    ImageUploadDesc upload{};
+    upload.image = m_image;
+    upload.format = m_format;
+    upload.extent = vk::Extent3D{m_width, m_height, 1};
+    upload.mipLevels = m_mipLevels;
+    upload.generateMips = settings.generateMips;
+    upload.storageMips = storageMips;
+    upload.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    upload.dstStage = vk::PipelineStageFlagBits2::eFragmentShader;
+    m_context->getUploadEngine()->uploadImage(upload, imageSize, writePixels);
 
     // Create image view
-    createImageView(vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor);
+    createImageView(m_format, vk::ImageAspectFlagBits::eColor);
 
     // Create sampler
     createSampler();
 
-    std::cout << "Texture loaded: " << filepath << " (" << m_width << "x" << m_height
+    std::cout << "Texture loaded: " << m_name << " (" << m_width << "x" << m_height
               << ", " << m_mipLevels << " mip levels)" << std::endl;
 }
 
+void Texture::createFromLevels(const TextureView& view) {
+    if (view.levelCount == 0 || !view.data) {
+        throw std::runtime_error("Texture view has no data: " + m_name);
+    }
+    m_width = view.width;
+    m_height = view.height;
+    m_format = view.format;
+    m_mipLevels = view.levelCount;
+
+    // KTX2 的格式来自文件，设备不一定能采样（例如移动端的 ASTC / ETC2）
+    const vk::FormatFeatureFlags required = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eTransferDst;
+    if ((m_context->getPhysicalDevice().getFormatProperties(m_format).optimalTilingFeatures & required) != required) {
+        throw std::runtime_error("Texture format " + vk::to_string(m_format) + " is not supported by the device: " + m_name);
+    }
+
+    createResidentLevels(view);
+    createSampler();
+
+    std::cout << "Texture loaded: " << m_name << " (" << m_width << "x" << m_height
+              << ", " << m_mipLevels << " mip levels, " << vk::to_string(m_format);
+    if (m_stream) {
+        std::cout << ", streamed from mip " << m_residentMip;
+    }
+    std::cout << ")" << std::endl;
+}
+
+void Texture::createResidentLevels(const TextureView& view) {
+    const uint32_t width = std::max(m_width >> m_residentMip, 1u);
+    const uint32_t height = std::max(m_height >> m_residentMip, 1u);
+    const uint32_t levelCount = m_mipLevels - m_residentMip;
+    createImage(width, height, levelCount,
+                m_format,
+                vk::ImageTiling::eOptimal,
+                vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+
+    // 常驻的 mip 级在一次 staging 分配中逐级拷贝，块压缩格式不能 blit，也不需要图形队列收尾。
+    // 各级不一定按 mip 顺序排列（KTX2 文件里小 mip 在前），只拷贝覆盖这些级别的区间
+    uint64_t begin = view.levels[m_residentMip].offset;
+    uint64_t end = 0;
+    for (uint32_t level = m_residentMip; level < m_mipLevels; level++) {
+        begin = std::min(begin, view.levels[level].offset);
+        end = std::max(end, view.levels[level].offset + view.levels[level].size);
+    }
+    ImageUploadDesc upload{};
+    upload.image = m_image;
+    upload.format = m_format;
+    upload.extent = vk::Extent3D{width, height, 1};
+    upload.mipLevels = levelCount;
+    upload.generateMips = false;
+    upload.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    upload.dstStage = vk::PipelineStageFlagBits2::eFragmentShader;
+    for (uint32_t level = m_residentMip; level < m_mipLevels; level++) {
+        upload.levelOffsets.push_back(view.levels[level].offset - begin);
+    }
+    m_context->getUploadEngine()->uploadImage(upload, view.data + begin, end - begin);
+
+    createImageView(m_format, vk::ImageAspectFlagBits::eColor);
+}
+
+VkDeviceSize Texture::getLevelBytes(uint32_t firstMip) const {
+    if (!m_stream) {
+        return this->getMemorySize();
+    }
+    VkDeviceSize bytes = 0;
+    for (uint32_t level = firstMip; level < m_stream->view.levelCount; level++) {
+        bytes += m_stream->levels[level].size;
+    }
+    return bytes;
+}
+
+std::function<void()> Texture::setResidentMip(uint32_t mip, CommandManager* commands) {
+    if (!m_stream) {
+        throw std::runtime_error("Texture is not streamed: " + m_name);
+    }
+    mip = std::min(mip, m_mipLevels - 1);
+    if (mip == m_residentMip) {
+        return {};
+    }
+    const uint32_t previousMip = m_residentMip;
+    const vk::Image oldImage = m_image;
+    const vk::ImageView oldView = m_imageView;
+    const VmaAllocation oldAllocation = m_allocation;
+    m_residentMip = mip;
+    try {
+        createResidentLevels(m_stream->view);
+    } catch (...) {
+        // 新图像创建或上传失败（例如显存不足）时保留原来的级别。
+        // 拷贝可能已经录制进挂起的上传批次（本帧的 recordGraphicsWork 才提交，图形帧等待其完成），新图像在本帧完成后再销毁
+        if (m_image != oldImage) {
+            commands->deferDestroy([context = m_context, image = m_image, view = m_imageView != oldView ? m_imageView : vk::ImageView{},
+                                    allocation = m_allocation]() {
+                destroyImage(context, image, view, allocation);
+            });
+        }
+        m_image = oldImage;
+        m_imageView = oldView;
+        m_allocation = oldAllocation;
+        m_residentMip = previousMip;
+        throw;
+    }
+    return [context = m_context, oldImage, oldView, oldAllocation]() {
+        destroyImage(context, oldImage, oldView, oldAllocation);
+    };
+}
+
+void Texture::destroyImage(Context* context, vk::Image image, vk::ImageView view, VmaAllocation allocation) {
+    if (view) {
+        context->getDevice().destroyImageView(view);
+    }
+    if (image && allocation != VK_NULL_HANDLE) {
+        context->getMemoryTracker()->untrack(allocation);
+        vmaDestroyImage(context->getVmaAllocator(), static_cast<VkImage>(image), allocation);
+    }
+}
+
 // Destructor
 Texture::~Texture() {
     if (m_context) {
-        if (m_sampler) {
-            m_context->getDevice().destroySampler(m_sampler);
-        }
-        if (m_imageView) {
-            m_context->getDevice().destroyImageView(m_imageView);
-        }
-        if (m_image && m_allocation != VK_NULL_HANDLE) {
-            vmaDestroyImage(m_context->getVmaAllocator(), static_cast<VkImage>(m_image), m_allocation);
+        if (m_stream) {
+            m_context->getTextureStreamer()->unregisterTexture(this);
         }
+        destroyImage(m_context, m_image, m_imageView, m_allocation);
     }
 }
 
+VkDeviceSize Texture::getMemorySize() const {
+    if (m_allocation == VK_NULL_HANDLE) return 0;
+    VmaAllocationInfo info{};
+    vmaGetAllocationInfo(m_context->getVmaAllocator(), m_allocation, &info);
+    return info.size;
+}
+
 // Create Vulkan image
 void Texture::createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
                           vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-                          VmaMemoryUsage memoryUsage) {
+                          VmaMemoryUsage memoryUsage, vk::ImageCreateFlags flags) {
     vk::ImageCreateInfo imageInfo{};
+    imageInfo.flags = flags;
     imageInfo.imageType = vk::ImageType::e2D;
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
@@ -151,6 +564,7 @@ void Texture::createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
         throw std::runtime_error("Failed to create image");
     }
     m_image = image;
+    m_context->getMemoryTracker()->track(m_allocation, m_name, MemoryCategory::Texture);
 }
 
 // Create image view
@@ -161,9 +575,12 @@ void Texture::createImageView(vk::Format format, vk::ImageAspectFlags aspectFlag
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = aspectFlags;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = m_mipLevels;
+    viewInfo.subresourceRange.levelCount = m_mipLevels - m_residentMip;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
+    // 纹理视图只用于采样：带 STORAGE 用途的 sRGB 图像（计算生成 mip）的 sRGB 视图不能继承该用途
+    vk::ImageViewUsageCreateInfo usageInfo{vk::ImageUsageFlagBits::eSampled};
+    viewInfo.pNext = &usageInfo;
 
     m_imageView = m_context->getDevice().createImageView(viewInfo);
     if (!m_imageView) {
@@ -171,188 +588,8 @@ void Texture::createImageView(vk::Format format, vk::ImageAspectFlags aspectFlag
     }
 }
 
-// Create texture sampler
+// 从 Context 的采样器缓存取共享采样器（由缓存负责销毁）
 void Texture::createSampler() {
-    vk::PhysicalDeviceProperties properties = m_context->getPhysicalDevice().getProperties();
-
-    vk::SamplerCreateInfo samplerInfo{};
-    samplerInfo.magFilter = vk::Filter::eLinear;
-    samplerInfo.minFilter = vk::Filter::eLinear;
-    samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.anisotropyEnable = VK_TRUE;
-    samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
-    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = vk::CompareOp::eAlways;
-    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
-    samplerInfo.mipLodBias = 0.0f;
-    samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = static_cast<float>(m_mipLevels);
-
-    m_sampler = m_context->getDevice().createSampler(samplerInfo);
-    if (!m_sampler) {
-        throw std::runtime_error("Failed to create texture sampler");
-    }
-}
-
-// Transition image layout
-void Texture::transitionImageLayout(vk::Image image, vk::Format format,
-                                   vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
-                                   uint32_t mipLevels) {
-    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    vk::ImageMemoryBarrier barrier{};
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = mipLevels;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    vk::PipelineStageFlags sourceStage;
-    vk::PipelineStageFlags destinationStage;
-
-    if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal) {
-        barrier.srcAccessMask = {};
-        barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-        destinationStage = vk::PipelineStageFlagBits::eTransfer;
-    } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-        sourceStage = vk::PipelineStageFlagBits::eTransfer;
-        destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-    } else {
-        throw std::invalid_argument("Unsupported layout transition");
-    }
-
-    commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, barrier);
-
-    endSingleTimeCommands(commandBuffer);
-}
-
-// Copy buffer to image
-void Texture::copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) {
-    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    vk::BufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = vk::Offset3D{0, 0, 0};
-    region.imageExtent = vk::Extent3D{width, height, 1};
-
-    commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, region);
-
-    endSingleTimeCommands(commandBuffer);
-}
-
-// Generate mipmaps
-void Texture::generateMipmaps(vk::Image image, vk::Format format, int32_t texWidth,
-                              int32_t texHeight, uint32_t mipLevels) {
-    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    vk::ImageMemoryBarrier barrier{};
-    barrier.image = image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = 1;
-
-    int32_t mipWidth = texWidth;
-    int32_t mipHeight = texHeight;
-
-    for (uint32_t i = 1; i < mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
-
-        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                     vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, barrier);
-
-        vk::ImageBlit blit{};
-        blit.srcOffsets[0] = vk::Offset3D{0, 0, 0};
-        blit.srcOffsets[1] = vk::Offset3D{mipWidth, mipHeight, 1};
-        blit.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-        blit.dstOffsets[0] = vk::Offset3D{0, 0, 0};
-        blit.dstOffsets[1] = vk::Offset3D{mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
-        blit.dstSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-
-        commandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal,
-                               image, vk::ImageLayout::eTransferDstOptimal,
-                               blit, vk::Filter::eLinear);
-
-        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                     vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, barrier);
-
-        if (mipWidth > 1) mipWidth /= 2;
-        if (mipHeight > 1) mipHeight /= 2;
-    }
-
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                 vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, barrier);
-
-    endSingleTimeCommands(commandBuffer);
-}
-
-// Begin single time command buffer
-vk::CommandBuffer Texture::beginSingleTimeCommands() {
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo.level = vk::CommandBufferLevel::ePrimary;
-    allocInfo.commandPool = m_context->getTransientCommandPool();
-    allocInfo.commandBufferCount = 1;
-
-    vk::CommandBuffer commandBuffer = m_context->getDevice().allocateCommandBuffers(allocInfo)[0];
-
-    vk::CommandBufferBeginInfo beginInfo{};
-    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
-
-    commandBuffer.begin(beginInfo);
-    return commandBuffer;
-}
-
-// End single time command buffer
-void Texture::endSingleTimeCommands(vk::CommandBuffer commandBuffer) {
-    commandBuffer.end();
-
-    vk::SubmitInfo submitInfo{};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    m_context->getGraphicsQueue().submit(submitInfo, nullptr);
-    m_context->getGraphicsQueue().waitIdle();
-
-    m_context->getDevice().freeCommandBuffers(m_context->getTransientCommandPool(), commandBuffer);
+    SamplerCache* samplers = m_context->getSamplerCache();
+    m_sampler = samplers->getSampler(samplers->getDefaultCreateInfo());
 }
@@ -0,0 +1,218 @@
+#include "Assets/TextureCache.h"
+#include <thread>
+#include <functional>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<TextureCacheHeader>, "TextureCacheHeader is written as raw bytes");
+static_assert(std::is_trivially_copyable_v<TextureLevel>, "TextureLevel is written as raw bytes");
+
+namespace {
+    constexpr uint64_t kBlobAlignment = 16;
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + kBlobAlignment - 1) & ~(kBlobAlignment - 1);
+    }
+
+    uint32_t encodeSettings(const TextureImportSettings& settings) {
+        return static_cast<uint32_t>(settings.usage)
+             | (settings.srgb ? 1u << 8 : 0u)
+             | (settings.generateMips ? 1u << 9 : 0u);
+    }
+
+    // xxHash64
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+    uint64_t rotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t read64(const uint8_t* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t mixRound(uint64_t accumulator, uint64_t input) {
+        accumulator += input * kPrime2;
+        return rotateLeft(accumulator, 31) * kPrime1;
+    }
+
+    uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+        accumulator ^= mixRound(0, value);
+        return accumulator * kPrime1 + kPrime4;
+    }
+}
+
+std::filesystem::path TextureCache::getCachePath(const std::string& sourcePath, const TextureImportSettings& settings) {
+    const std::filesystem::path source(sourcePath);
+    std::string name = source.filename().string();
+    switch (settings.usage) {
+    case TextureUsage::Color: name += ".color"; break;
+    case TextureUsage::Normal: name += ".normal"; break;
+    case TextureUsage::Mask: name += ".mask"; break;
+    case TextureUsage::Orm: name += ".orm"; break;
+    }
+    name += settings.srgb ? ".srgb" : ".unorm";
+    name += settings.generateMips ? ".mips" : ".nomips";
+    name += ".vtex";
+    return source.parent_path() / ".vcache" / name;
+}
+
+uint64_t TextureCache::hashBytes(const uint8_t* data, size_t size) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint64_t hash;
+    if (size >= 32) {
+        uint64_t v1 = kPrime1 + kPrime2;
+        uint64_t v2 = kPrime2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - kPrime1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = mixRound(v1, read64(p));
+            v2 = mixRound(v2, read64(p + 8));
+            v3 = mixRound(v3, read64(p + 16));
+            v4 = mixRound(v4, read64(p + 24));
+        }
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    } else {
+        hash = kPrime5;
+    }
+    hash += static_cast<uint64_t>(size);
+    for (; p + 8 <= end; p += 8) {
+        hash ^= mixRound(0, read64(p));
+        hash = rotateLeft(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        hash = rotateLeft(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= (*p) * kPrime5;
+        hash = rotateLeft(hash, 11) * kPrime1;
+    }
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::optional<CachedTexture> TextureCache::open(const std::string& sourcePath, const TextureImportSettings& settings,
+                                                uint64_t sourceHash, const TextureFormatSupport& support) {
+    const std::filesystem::path cachePath = getCachePath(sourcePath, settings);
+    std::error_code ec;
+    if (!std::filesystem::exists(cachePath, ec)) {
+        return std::nullopt;
+    }
+
+    CachedTexture cached;
+    try {
+        cached.file = MappedFile(cachePath.string());
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    const size_t fileSize = cached.file.getSize();
+    if (fileSize < sizeof(TextureCacheHeader)) {
+        return std::nullopt;
+    }
+
+    // 设备支持的格式变化（换了 GPU）时重新选择格式并编码
+    const auto* header = reinterpret_cast<const TextureCacheHeader*>(cached.file.getData());
+    if (header->magic != TextureCacheHeader::kMagic ||
+        header->version != TextureCacheHeader::kVersion ||
+        header->settings != encodeSettings(settings) ||
+        header->formatSupport != support.blockFormats ||
+        header->sourceHash != sourceHash ||
+        header->fileSize != fileSize ||
+        header->levelCount == 0 ||
+        header->levelOffset + static_cast<uint64_t>(header->levelCount) * sizeof(TextureLevel) > fileSize) {
+        return std::nullopt;
+    }
+
+    // 各级数据必须落在文件内（损坏或截断的缓存直接忽略，重新导入时覆盖）
+    const uint8_t* base = cached.file.getData();
+    const auto* levels = reinterpret_cast<const TextureLevel*>(base + header->levelOffset);
+    for (uint32_t level = 0; level < header->levelCount; level++) {
+        if (header->dataOffset + levels[level].offset + levels[level].size > fileSize) {
+            return std::nullopt;
+        }
+    }
+
+    cached.view.width = header->width;
+    cached.view.height = header->height;
+    cached.view.format = static_cast<vk::Format>(header->format);
+    cached.view.data = base + header->dataOffset;
+    cached.view.levels = levels;
+    cached.view.levelCount = header->levelCount;
+    return cached;
+}
+
+uint64_t TextureCache::write(const std::string& sourcePath, const TextureImportSettings& settings,
+                             uint64_t sourceHash, const TextureFormatSupport& support, const EncodedTexture& texture) {
+    TextureCacheHeader header;
+    header.format = static_cast<uint32_t>(texture.format);
+    header.width = texture.width;
+    header.height = texture.height;
+    header.levelCount = static_cast<uint32_t>(texture.levels.size());
+    header.settings = encodeSettings(settings);
+    header.formatSupport = support.blockFormats;
+    header.sourceHash = sourceHash;
+    header.levelOffset = alignUp(sizeof(TextureCacheHeader));
+    header.dataOffset = alignUp(header.levelOffset + texture.levels.size() * sizeof(TextureLevel));
+    header.fileSize = header.dataOffset + texture.data.size();
+
+    const std::filesystem::path cachePath = getCachePath(sourcePath, settings);
+    std::filesystem::create_directories(cachePath.parent_path());
+    std::filesystem::path tempPath = cachePath;
+    tempPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("TextureCache: failed to create " + tempPath.string());
+        }
+        const char padding[kBlobAlignment] = {};
+        auto writeAt = [&](uint64_t offset, const void* bytes, uint64_t size) {
+            const uint64_t position = static_cast<uint64_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(offset - position));
+            file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        };
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.levelOffset, texture.levels.data(), texture.levels.size() * sizeof(TextureLevel));
+        writeAt(header.dataOffset, texture.data.data(), texture.data.size());
+        if (!file) {
+            throw std::runtime_error("TextureCache: failed to write " + tempPath.string());
+        }
+    }
+
+    // rename 在同一目录内是原子的；Windows 上目标存在时需要先删除
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(cachePath, ec);
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            throw std::runtime_error("TextureCache: failed to move cache into place: " + cachePath.string());
+        }
+    }
+    return header.fileSize;
+}
@@ -0,0 +1,395 @@
+#include "Core/ClusterCuller.h"
+#include "Core/Pipeline.h"
+#include "Core/MemoryTracker.h"
+#include "Scene/Scene.h"
+#include <print>
+#include <bit>
+#include <array>
+#include <format>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // 与 meshlet_cull.comp 的 push constant 块一致
+    struct CullParams {
+        glm::mat4 model;
+        glm::vec4 cameraPosition;       // xyz: 模型空间相机位置，w: 模型矩阵最大轴缩放
+        uint32_t meshletCount = 0;
+        uint32_t commandOffset = 0;
+        uint32_t countIndex = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t flags = 0;
+        uint32_t firstMeshlet = 0;      // 所选 LOD 级别的第一个簇
+    };
+    static_assert(sizeof(CullParams) <= 128, "push constants must fit the guaranteed 128 bytes");
+
+    struct CullFrameUBO {
+        glm::vec4 planes[6];
+    };
+
+    constexpr uint32_t kCullFrustum = 1u << 0;
+    constexpr uint32_t kCullCone = 1u << 1;
+    constexpr uint32_t kCompact = 1u << 2;
+    constexpr uint32_t kGroupSize = 64;         // local_size_x
+    constexpr vk::DeviceSize kCommandStride = sizeof(VkDrawIndexedIndirectCommand);
+
+    struct Dispatch {
+        vk::DescriptorSet set;
+        CullParams params;
+    };
+
+    uint32_t growCapacity(uint32_t required, uint32_t minimum) {
+        return std::bit_ceil(std::max(required, minimum));
+    }
+}
+
+ClusterCuller::ClusterCuller(Context* context, uint32_t framesInFlight, const std::string& shaderPath)
+    : m_context(context)
+    , m_frames(framesInFlight) {
+    auto device = m_context->getDevice();
+
+    // set 0: meshlets / commands / counts / CullFrame
+    std::array<vk::DescriptorSetLayoutBinding, 4> bindings;
+    for (uint32_t i = 0; i < 3; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding{}
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+    bindings[3] = vk::DescriptorSetLayoutBinding{}
+        .setBinding(3)
+        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+        .setDescriptorCount(1)
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    m_setLayout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{}.setBindings(bindings));
+
+    vk::PushConstantRange pushRange{vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullParams)};
+    m_pipelineLayout = device.createPipelineLayout(
+        vk::PipelineLayoutCreateInfo{}.setSetLayouts(m_setLayout).setPushConstantRanges(pushRange));
+
+    m_maxDrawIndirectCount = m_context->getPhysicalDevice().getProperties().limits.maxDrawIndirectCount;
+    m_stats.drawIndirectCount = m_context->getFeatures().drawIndirectCount;
+
+    // 着色器未编译（没有 glslc）时只禁用簇剔除
+    try {
+        this->createPipeline(shaderPath);
+    } catch (const std::exception& e) {
+        std::println("Warning: cluster culling unavailable: {}", e.what());
+    }
+    if (!m_context->getFeatures().multiDrawIndirect) {
+        std::println("Warning: cluster culling unavailable: multiDrawIndirect is not supported");
+    }
+}
+
+ClusterCuller::~ClusterCuller() {
+    // 此时设备已空闲（Renderer 析构时 waitIdle）
+    auto device = m_context->getDevice();
+    for (auto& frame : m_frames) {
+        this->destroyBuffers(frame);
+        if (frame.pool) device.destroyDescriptorPool(frame.pool);
+    }
+    if (m_pipeline) device.destroyPipeline(m_pipeline);
+    device.destroyPipelineLayout(m_pipelineLayout);
+    device.destroyDescriptorSetLayout(m_setLayout);
+}
+
+void ClusterCuller::createPipeline(const std::string& shaderPath) {
+    auto device = m_context->getDevice();
+    vk::ShaderModule module = PipelineManager::createShaderModule(m_context, shaderPath);
+    vk::ComputePipelineCreateInfo createInfo{};
+    createInfo.stage = vk::PipelineShaderStageCreateInfo{}
+        .setStage(vk::ShaderStageFlagBits::eCompute)
+        .setModule(module)
+        .setPName("main");
+    createInfo.layout = m_pipelineLayout;
+    auto result = device.createComputePipeline(nullptr, createInfo);
+    device.destroyShaderModule(module);
+    if (result.result != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to create cluster culling pipeline!");
+    }
+    m_pipeline = result.value;
+}
+
+void ClusterCuller::destroyBuffers(FrameResources& frame) {
+    auto allocator = m_context->getVmaAllocator();
+    MemoryTracker* tracker = m_context->getMemoryTracker();
+    auto destroy = [&](vk::Buffer& buffer, VmaAllocation& allocation) {
+        if (!buffer) return;
+        tracker->untrack(allocation);
+        vmaDestroyBuffer(allocator, static_cast<VkBuffer>(buffer), allocation);
+        buffer = nullptr;
+        allocation = VK_NULL_HANDLE;
+    };
+    destroy(frame.commands, frame.commandsAllocation);
+    destroy(frame.counts, frame.countsAllocation);
+    destroy(frame.planes, frame.planesAllocation);
+    frame.commandCapacity = 0;
+    frame.countCapacity = 0;
+    frame.countsMapped = nullptr;
+    frame.planesMapped = nullptr;
+}
+
+void ClusterCuller::ensureCapacity(FrameResources& frame, uint32_t commandCount, uint32_t countCount, uint32_t setCount) {
+    // 该槽位上一次的提交已经完成，旧的缓冲与描述符池可以直接销毁
+    auto allocator = m_context->getVmaAllocator();
+    MemoryTracker* tracker = m_context->getMemoryTracker();
+    const size_t frameIndex = static_cast<size_t>(&frame - m_frames.data());
+    auto createBuffer = [&](VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocationCreateFlags flags,
+                            vk::Buffer& buffer, VmaAllocation& allocation, const std::string& name) -> void* {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags = flags;
+
+        VkBuffer handle;
+        VmaAllocationInfo info{};
+        if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &handle, &allocation, &info) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create cluster culling buffer: " + name);
+        }
+        buffer = handle;
+        tracker->track(allocation, name, MemoryCategory::Other);
+        return info.pMappedData;
+    };
+
+    if (!frame.planes) {
+        frame.planesMapped = createBuffer(sizeof(CullFrameUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                          VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                          frame.planes, frame.planesAllocation, std::format("ClusterCull planes[frame {}]", frameIndex));
+    }
+    if (commandCount > frame.commandCapacity) {
+        if (frame.commands) {
+            tracker->untrack(frame.commandsAllocation);
+            vmaDestroyBuffer(allocator, static_cast<VkBuffer>(frame.commands), frame.commandsAllocation);
+        }
+        frame.commandCapacity = growCapacity(commandCount, 1024);
+        createBuffer(frame.commandCapacity * kCommandStride,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, 0,
+                     frame.commands, frame.commandsAllocation, std::format("ClusterCull commands[frame {}]", frameIndex));
+    }
+    if (countCount > frame.countCapacity) {
+        if (frame.counts) {
+            tracker->untrack(frame.countsAllocation);
+            vmaDestroyBuffer(allocator, static_cast<VkBuffer>(frame.counts), frame.countsAllocation);
+        }
+        frame.countCapacity = growCapacity(countCount, 64);
+        // 计数很小，放在主机可见内存里，统计直接回读
+        frame.countsMapped = static_cast<uint32_t*>(createBuffer(
+            frame.countCapacity * sizeof(uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            frame.counts, frame.countsAllocation, std::format("ClusterCull counts[frame {}]", frameIndex)));
+        frame.countsUsed = 0;
+    }
+
+    auto device = m_context->getDevice();
+    if (setCount > frame.poolCapacity) {
+        if (frame.pool) device.destroyDescriptorPool(frame.pool);
+        frame.poolCapacity = growCapacity(setCount, 16);
+        std::array<vk::DescriptorPoolSize, 2> sizes{
+            vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, frame.poolCapacity * 3},
+            vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, frame.poolCapacity}
+        };
+        frame.pool = device.createDescriptorPool(
+            vk::DescriptorPoolCreateInfo{}.setMaxSets(frame.poolCapacity).setPoolSizes(sizes));
+    } else if (frame.pool) {
+        device.resetDescriptorPool(frame.pool);
+    }
+}
+
+void ClusterCuller::readBack(FrameResources& frame) {
+    m_stats.meshletsVisible = 0;
+    m_stats.meshletsTested = 0;
+    if (frame.countsUsed == 0 || !frame.countsMapped) {
+        return;
+    }
+    vmaInvalidateAllocation(m_context->getVmaAllocator(), frame.countsAllocation, 0, VK_WHOLE_SIZE);
+    uint32_t visible = 0;
+    for (uint32_t i = 0; i < frame.countsUsed; i++) {
+        visible += frame.countsMapped[i];
+    }
+    m_stats.meshletsVisible = visible;
+    m_stats.meshletsTested = frame.meshletsTested;
+}
+
+void ClusterCuller::skipFrame(uint32_t frameIndex) {
+    m_slots.clear();
+    m_commandsHandle = RG_INVALID_HANDLE;
+    m_countsHandle = RG_INVALID_HANDLE;
+    m_stats.meshes = 0;
+    m_stats.trianglesTested = 0;
+
+    FrameResources& frame = m_frames.at(frameIndex);
+    this->readBack(frame);
+    frame.countsUsed = 0;
+    frame.meshletsTested = 0;
+}
+
+void ClusterCuller::addPass(RenderGraph& graph, const Scene& scene, uint32_t frameIndex,
+                            const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    this->skipFrame(frameIndex);
+    FrameResources& frame = m_frames.at(frameIndex);
+    if (!this->isEnabled()) {
+        return;
+    }
+
+    // 1. 为每个带 meshlet 的 Renderable 分配命令区间与计数位置
+    struct Candidate {
+        const Renderable* renderable;
+        DrawSlot slot;
+    };
+    std::vector<Candidate> candidates;
+    uint32_t commandCount = 0;
+    for (const auto& renderable : scene.getRenderables()) {
+        const Mesh& mesh = renderable->getMesh();
+        // 只测试 Renderable 当前 LOD 级别的簇（meshlet 中的 firstIndex 已指向该级别的索引）
+        const uint32_t meshletCount = mesh.getLod(renderable->getLod()).meshletCount;
+        if (meshletCount == 0 || !mesh.getMeshletBuffer() || meshletCount > m_maxDrawIndirectCount) continue;
+        candidates.push_back(Candidate{renderable.get(), DrawSlot{commandCount, static_cast<uint32_t>(candidates.size()), meshletCount}});
+        commandCount += meshletCount;
+    }
+    if (candidates.empty()) {
+        return;
+    }
+    const uint32_t countCount = static_cast<uint32_t>(candidates.size());
+    this->ensureCapacity(frame, commandCount, countCount, countCount);
+
+    CullFrameUBO planes{};
+    Camera::extractFrustumPlanes(viewProjection, planes.planes);
+    std::memcpy(frame.planesMapped, &planes, sizeof(planes));
+    vmaFlushAllocation(m_context->getVmaAllocator(), frame.planesAllocation, 0, VK_WHOLE_SIZE);
+
+    // 2. 逐网格分配描述符集并准备 push constant（CPU 侧，执行时只录制）
+    auto device = m_context->getDevice();
+    std::vector<vk::DescriptorSetLayout> layouts(candidates.size(), m_setLayout);
+    std::vector<vk::DescriptorSet> sets = device.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo{}.setDescriptorPool(frame.pool).setSetLayouts(layouts));
+
+    const bool compact = m_context->getFeatures().drawIndirectCount;
+    std::vector<Dispatch> dispatches;
+    dispatches.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const Renderable& renderable = *candidates[i].renderable;
+        const Mesh& mesh = renderable.getMesh();
+        const DrawSlot& slot = candidates[i].slot;
+
+        std::array<vk::DescriptorBufferInfo, 4> infos{
+            vk::DescriptorBufferInfo{mesh.getMeshletBuffer(), 0, VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{frame.commands, 0, VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{frame.counts, 0, VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{frame.planes, 0, sizeof(CullFrameUBO)}
+        };
+        std::array<vk::WriteDescriptorSet, 4> writes;
+        for (uint32_t b = 0; b < 4; b++) {
+            writes[b] = vk::WriteDescriptorSet{}
+                .setDstSet(sets[i])
+                .setDstBinding(b)
+                .setDescriptorCount(1)
+                .setDescriptorType(b == 3 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&infos[b]);
+        }
+        device.updateDescriptorSets(writes, nullptr);
+
+        // Compact 网格的包围体在反量化之前的模型空间，用 Renderable 自身的模型矩阵
+        const glm::mat4& model = renderable.getTransform().model;
+        const glm::mat3 linear(model);
+        const float maxScale = std::max({glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2])});
+        const GeometryRange& range = mesh.getRange();
+        const MeshLod& lod = mesh.getLod(renderable.getLod());
+
+        Dispatch dispatch;
+        dispatch.set = sets[i];
+        dispatch.params.model = model;
+        dispatch.params.cameraPosition = glm::vec4(glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f)), maxScale);
+        dispatch.params.meshletCount = slot.maxDraws;
+        // 20 字节的命令不满足 minStorageBufferOffsetAlignment，区间起点通过 push constant 传入
+        dispatch.params.commandOffset = slot.commandOffset;
+        dispatch.params.countIndex = slot.countIndex;
+        dispatch.params.firstIndex = range.firstIndex;
+        dispatch.params.vertexOffset = range.vertexOffset;
+        dispatch.params.firstMeshlet = lod.firstMeshlet;
+        dispatch.params.flags = (m_settings.frustum ? kCullFrustum : 0) | (compact ? kCompact : 0);
+        // 镜像变换翻转了环绕方向，模型空间的背面测试不再成立
+        if (m_settings.cone && glm::determinant(linear) > 0.0f) {
+            dispatch.params.flags |= kCullCone;
+        }
+        dispatches.push_back(dispatch);
+
+        m_slots[renderable.getObjectIndex()] = slot;
+        m_stats.trianglesTested += lod.indexCount / 3;
+        frame.meshletsTested += slot.maxDraws;
+    }
+    m_stats.meshes = countCount;
+    frame.countsUsed = countCount;
+
+    // 3. 帧图：剔除 pass 写命令与计数，主通道以间接参数读取
+    m_commandsHandle = graph.importBuffer("ClusterCommands", frame.commands, frame.commandCapacity * kCommandStride);
+    m_countsHandle = graph.importBuffer("ClusterCounts", frame.counts, frame.countCapacity * sizeof(uint32_t));
+    const RGHandle commandsHandle = m_commandsHandle;
+    const RGHandle countsHandle = m_countsHandle;
+    const vk::DeviceSize countBytes = countCount * sizeof(uint32_t);
+
+    graph.addPass("ClusterCull",
+        [&](RenderGraphBuilder& builder) {
+            builder.write(commandsHandle, RGAccess::StorageBufferWrite);
+            builder.write(countsHandle, RGAccess::StorageBufferWrite);
+        },
+        [this, countsHandle, countBytes, dispatches = std::move(dispatches)](vk::CommandBuffer commandBuffer, const RenderGraph& graph) {
+            // 计数清零后才能原子累加
+            commandBuffer.fillBuffer(graph.getBuffer(countsHandle), 0, countBytes, 0);
+            vk::MemoryBarrier2 cleared{};
+            cleared.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+            cleared.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+            cleared.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+            cleared.dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite;
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(cleared));
+
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+            for (const Dispatch& dispatch : dispatches) {
+                commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, dispatch.set, nullptr);
+                commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullParams), &dispatch.params);
+                commandBuffer.dispatch((dispatch.params.meshletCount + kGroupSize - 1) / kGroupSize, 1, 1);
+            }
+
+            // 计数在该槽位下一次 addPass 时由主机回读
+            vk::MemoryBarrier2 readback{};
+            readback.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+            readback.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+            readback.dstStageMask = vk::PipelineStageFlagBits2::eHost;
+            readback.dstAccessMask = vk::AccessFlagBits2::eHostRead;
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(readback));
+        });
+}
+
+void ClusterCuller::declareReads(RenderGraphBuilder& builder) const {
+    if (m_commandsHandle == RG_INVALID_HANDLE) {
+        return;
+    }
+    builder.read(m_commandsHandle, RGAccess::IndirectBufferRead);
+    builder.read(m_countsHandle, RGAccess::IndirectBufferRead);
+}
+
+bool ClusterCuller::draw(vk::CommandBuffer commandBuffer, const RenderGraph& graph, const Renderable& renderable) const {
+    auto it = m_slots.find(renderable.getObjectIndex());
+    if (it == m_slots.end()) {
+        return false;
+    }
+    const DrawSlot& slot = it->second;
+    const vk::Buffer commands = graph.getBuffer(m_commandsHandle);
+    const vk::DeviceSize offset = slot.commandOffset * kCommandStride;
+    if (m_context->getFeatures().drawIndirectCount) {
+        commandBuffer.drawIndexedIndirectCount(commands, offset, graph.getBuffer(m_countsHandle),
+                                               slot.countIndex * sizeof(uint32_t), slot.maxDraws,
+                                               static_cast<uint32_t>(kCommandStride));
+    } else {
+        commandBuffer.drawIndexedIndirect(commands, offset, slot.maxDraws, static_cast<uint32_t>(kCommandStride));
+    }
+    return true;
+}
@@ -1,6 +1,8 @@
 #include "Core/Command.h"
 #include "Core/Context.h"
 #include <print>
+#include <array>
+#include <chrono>
 #include <stdexcept>
 #include "Command.h"
 
@@ -12,13 +14,14 @@ CommandManager::CommandManager(Context* context, uint32_t framesInFlight, uint32
     std::println("CommandManager: Creating with {} frames in flight and {} swapchain images", framesInFlight, swapchainImageCount);
 
     m_perFrameData.resize(framesInFlight);
-    m_imageAvailableSemaphores.resize(framesInFlight);
-    m_renderFinishedSemaphores.resize(swapchainImageCount);
 
     auto device = m_context->getDevice();
     auto graphicsQueueFamily = m_context->getGraphicsQueueFamily();
 
-    // 1. 创建每帧的命令池和fence（用于帧同步）
+    // 1. 创建时间线信号量（初始值 0，首帧等待的值也是 0，可以立即运行）
+    m_timeline = this->createTimelineSemaphore();
+
+    // 2. 创建每帧的命令池和命令缓冲
     for (uint32_t i = 0; i < framesInFlight; i++) {
         try {
             // 命令池（每帧独立，GRAPHICS 队列）
@@ -33,48 +36,121 @@ CommandManager::CommandManager(Context* context, uint32_t framesInFlight, uint32
             allocInfo.level = vk::CommandBufferLevel::ePrimary;
             allocInfo.commandBufferCount = 1;
             m_perFrameData[i].primaryBuffer = device.allocateCommandBuffers(allocInfo)[0];
-
-            // Fence（初始 signaled 状态，允许首帧立即运行）
-            vk::FenceCreateInfo fenceInfo{};
-            fenceInfo.flags = vk::FenceCreateFlagBits::eSignaled;
-            m_perFrameData[i].inFlightFence = device.createFence(fenceInfo);
-
         } catch (const vk::SystemError& err) {
             throw std::runtime_error("Failed to create frame resources for frame " +
                 std::to_string(i) + ": " + err.what());
         }
+    }
+
+    // 3. acquire / present 仍需要二值信号量
+    this->createSwapchainSemaphores(swapchainImageCount);
+
+    // 4. 异步计算资源
+    this->createComputeResources();
+
+    std::println("CommandManager: All {} frames initialized successfully", framesInFlight);
+}
+
+CommandManager::~CommandManager() {
+   this->cleanup();
+}
+
+vk::Semaphore CommandManager::createTimelineSemaphore() const {
+    try {
+        vk::SemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+        typeInfo.initialValue = 0;
         vk::SemaphoreCreateInfo semaphoreInfo{};
-        m_imageAvailableSemaphores[i] = device.createSemaphore(semaphoreInfo);
+        semaphoreInfo.pNext = &typeInfo;
+        return m_context->getDevice().createSemaphore(semaphoreInfo);
+    } catch (const vk::SystemError& err) {
+        throw std::runtime_error("Failed to create timeline semaphore: " + std::string(err.what()));
+    }
+}
+
+void CommandManager::createComputeResources() {
+    // 计算队列族与图形相同时，同一个 VkQueue 无法与图形重叠，不启用异步计算
+    m_asyncComputeAvailable = m_context->hasComputeQueue() &&
+                              m_context->getComputeQueueFamily() != m_context->getGraphicsQueueFamily();
+    if (!m_asyncComputeAvailable) {
+        std::println("CommandManager: No separate compute queue family, async compute disabled");
+        return;
+    }
+
+    auto device = m_context->getDevice();
+    m_computeTimeline = this->createTimelineSemaphore();
+    m_computeFrameData.resize(m_framesInFlight);
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        try {
+            vk::CommandPoolCreateInfo poolInfo{};
+            poolInfo.queueFamilyIndex = m_context->getComputeQueueFamily();
+            poolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+            m_computeFrameData[i].commandPool = device.createCommandPool(poolInfo);
+
+            vk::CommandBufferAllocateInfo allocInfo{};
+            allocInfo.commandPool = m_computeFrameData[i].commandPool;
+            allocInfo.level = vk::CommandBufferLevel::ePrimary;
+            allocInfo.commandBufferCount = 1;
+            m_computeFrameData[i].commandBuffer = device.allocateCommandBuffers(allocInfo)[0];
+        } catch (const vk::SystemError& err) {
+            throw std::runtime_error("Failed to create compute resources for frame " +
+                std::to_string(i) + ": " + err.what());
+        }
     }
+    std::println("CommandManager: Async compute enabled on queue family {}", m_context->getComputeQueueFamily());
+}
+
+void CommandManager::createSwapchainSemaphores(uint32_t swapchainImageCount) {
+    auto device = m_context->getDevice();
+    m_imageAvailableSemaphores.resize(m_framesInFlight);
+    m_renderFinishedSemaphores.resize(swapchainImageCount);
 
-    // 2. 为每个 swapchain 图像创建信号量（用于图像同步）
+    vk::SemaphoreCreateInfo semaphoreInfo{};
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        m_imageAvailableSemaphores[i] = device.createSemaphore(semaphoreInfo);
+    }
+    // 为每个 swapchain 图像创建信号量（用于图像同步）
     for (uint32_t i = 0; i < swapchainImageCount; i++) {
         try {
-            vk::SemaphoreCreateInfo semaphoreInfo{};
             m_renderFinishedSemaphores[i] = device.createSemaphore(semaphoreInfo);
         } catch (const vk::SystemError& err) {
             throw std::runtime_error("Failed to create semaphores for swapchain image " +
                 std::to_string(i) + ": " + err.what());
         }
     }
+}
 
-    std::println("CommandManager: All {} frames initialized successfully", framesInFlight);
+void CommandManager::destroySwapchainSemaphores() {
+    auto device = m_context->getDevice();
+    for (auto& sem : m_imageAvailableSemaphores) {
+        if (sem) {
+            device.destroySemaphore(sem);
+        }
+    }
+    m_imageAvailableSemaphores.clear();
+    for (auto& sem : m_renderFinishedSemaphores) {
+        if (sem) {
+            device.destroySemaphore(sem);
+        }
+    }
+    m_renderFinishedSemaphores.clear();
 }
 
-CommandManager::~CommandManager() {
-   this->cleanup();
+void CommandManager::onSwapchainRecreated(uint32_t swapchainImageCount) {
+    this->destroySwapchainSemaphores();
+    this->createSwapchainSemaphores(swapchainImageCount);
+    m_pendingWaits.clear();
 }
 
 void CommandManager::cleanup(){
     auto device = m_context->getDevice();
     // 等待设备空闲，确保没有正在使用的资源
     device.waitIdle();
+    // 所有延迟删除都可以执行了
+    this->collectDeferredDeletions(UINT64_MAX);
     // 销毁每帧资源
     for (size_t i = 0; i < m_perFrameData.size(); i++) {
         auto& frame = m_perFrameData[i];
-        if (frame.inFlightFence) {
-            device.destroyFence(frame.inFlightFence);
-        }
         if( frame.primaryBuffer){
             device.freeCommandBuffers(frame.commandPool, frame.primaryBuffer);
         }
@@ -83,35 +159,131 @@ void CommandManager::cleanup(){
         }
     }
     m_perFrameData.clear();
-    // 销毁信号量
-    for (auto& sem : m_imageAvailableSemaphores) {
-        if (sem) {
-            device.destroySemaphore(sem);
+    for (auto& frame : m_computeFrameData) {
+        if (frame.commandBuffer) {
+            device.freeCommandBuffers(frame.commandPool, frame.commandBuffer);
+        }
+        if (frame.commandPool) {
+            device.destroyCommandPool(frame.commandPool);
         }
     }
-    m_imageAvailableSemaphores.clear();
-    for (auto& sem : m_renderFinishedSemaphores) {
-        if (sem) {
-            device.destroySemaphore(sem);
+    m_computeFrameData.clear();
+    // 销毁信号量
+    this->destroySwapchainSemaphores();
+    if (m_timeline) {
+        device.destroySemaphore(m_timeline);
+        m_timeline = nullptr;
+    }
+    if (m_computeTimeline) {
+        device.destroySemaphore(m_computeTimeline);
+        m_computeTimeline = nullptr;
+    }
+}
+
+uint64_t CommandManager::gpuCompletedValue() const {
+    return m_context->getDevice().getSemaphoreCounterValue(m_timeline);
+}
+
+bool CommandManager::waitForValue(uint64_t value, uint64_t timeoutNs) const {
+    if (value == 0 || this->gpuCompletedValue() >= value) {
+        return true;
+    }
+    vk::SemaphoreWaitInfo waitInfo{};
+    waitInfo.setSemaphores(m_timeline);
+    waitInfo.setValues(value);
+    vk::Result result = m_context->getDevice().waitSemaphores(waitInfo, timeoutNs);
+    if (result == vk::Result::eTimeout) {
+        return false;
+    }
+    if (result != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to wait for timeline value " + std::to_string(value) + "!");
+    }
+    return true;
+}
+
+void CommandManager::addWaitSemaphore(vk::Semaphore semaphore, uint64_t value, vk::PipelineStageFlags2 stage) {
+    m_pendingWaits.push_back(PendingWait{semaphore, value, stage});
+}
+
+void CommandManager::deferDestroy(std::function<void()> deleter) {
+    m_deferredDeletions.push_back(DeferredDeletion{this->getCurrentFrameValue(), std::move(deleter)});
+}
+
+void CommandManager::collectDeferredDeletions(uint64_t completedValue) {
+    // 按提交顺序入队，值单调递增，遇到第一个未完成的即可停止
+    size_t done = 0;
+    while (done < m_deferredDeletions.size() && m_deferredDeletions[done].value <= completedValue) {
+        m_deferredDeletions[done].deleter();
+        done++;
+    }
+    m_deferredDeletions.erase(m_deferredDeletions.begin(), m_deferredDeletions.begin() + static_cast<std::ptrdiff_t>(done));
+}
+
+uint64_t CommandManager::computeCompletedValue() const {
+    if (!m_computeTimeline) return 0;
+    return m_context->getDevice().getSemaphoreCounterValue(m_computeTimeline);
+}
+
+vk::CommandBuffer CommandManager::beginComputeCommands() {
+    if (!m_asyncComputeAvailable) {
+        throw std::runtime_error("Async compute is not available on this device!");
+    }
+    auto& frame = m_computeFrameData[m_currentFrameIndex];
+    // 同一槽位的图形提交等待过这次计算，通常这里已经完成，不会阻塞
+    if (frame.timelineValue > this->computeCompletedValue()) {
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.setSemaphores(m_computeTimeline);
+        waitInfo.setValues(frame.timelineValue);
+        if (m_context->getDevice().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess) {
+            throw std::runtime_error("Failed to wait for compute timeline!");
         }
     }
-    m_renderFinishedSemaphores.clear();
+    frame.commandBuffer.reset();
+    frame.commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    return frame.commandBuffer;
+}
+
+uint64_t CommandManager::submitCompute(vk::CommandBuffer commandBuffer, vk::PipelineStageFlags2 graphicsWaitStage, bool waitForGraphics) {
+    commandBuffer.end();
+
+    const uint64_t signalValue = m_computeSubmittedValue + 1;
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+    if (waitForGraphics && m_submittedValue > 0) {
+        waitInfos.push_back(vk::SemaphoreSubmitInfo{m_timeline, m_submittedValue, vk::PipelineStageFlagBits2::eAllCommands});
+    }
+    vk::SemaphoreSubmitInfo signalInfo{m_computeTimeline, signalValue, vk::PipelineStageFlagBits2::eAllCommands};
+    vk::CommandBufferSubmitInfo commandBufferInfo{commandBuffer};
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.setWaitSemaphoreInfos(waitInfos)
+              .setCommandBufferInfos(commandBufferInfo)
+              .setSignalSemaphoreInfos(signalInfo);
+    m_context->getComputeQueue().submit2(submitInfo);
+
+    m_computeSubmittedValue = signalValue;
+    m_computeFrameData[m_currentFrameIndex].timelineValue = signalValue;
 
+    // 本帧的图形提交只在真正消费计算结果的阶段等待，之前的阶段可以与计算重叠
+    this->addWaitSemaphore(m_computeTimeline, signalValue,
+        graphicsWaitStage ? graphicsWaitStage : vk::PipelineStageFlags2(vk::PipelineStageFlagBits2::eAllCommands));
+    return signalValue;
 }
+
 uint32_t CommandManager::beginFrame(const vk::SwapchainKHR &swapchain){
     auto device = m_context->getDevice();
-    // 等待 fence，但使用超时避免死锁
-    // 如果 fence 未被信号化（例如窗口调整大小期间），返回 eTimeout
-    vk::Result result = device.waitForFences(
-        m_perFrameData[m_currentFrameIndex].inFlightFence,VK_TRUE,1000000000ULL
-    );
-    if (result == vk::Result::eTimeout) {
+    // 等待该帧槽位上次提交的时间线值，但使用超时避免死锁
+    // 如果 GPU 迟迟未完成（例如窗口调整大小期间），返回 UINT32_MAX
+    const uint64_t frameValue = m_perFrameData[m_currentFrameIndex].timelineValue;
+    auto waitStart = std::chrono::steady_clock::now();
+    bool completed = this->waitForValue(frameValue, 1000000000ULL);
+    m_cpuWaitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    if (!completed) {
         return UINT32_MAX;
     }
-    if (result != vk::Result::eSuccess) {
-        throw std::runtime_error("Failed to wait for fence at frame " + std::to_string(m_currentFrameIndex) + "!");
-    }
-    result = device.acquireNextImageKHR(
+    // GPU 已经完成的部分可以安全回收
+    this->collectDeferredDeletions(this->gpuCompletedValue());
+
+    vk::Result result = device.acquireNextImageKHR(
         swapchain,
         UINT64_MAX,
         m_imageAvailableSemaphores[m_currentFrameIndex],
@@ -121,7 +293,6 @@ uint32_t CommandManager::beginFrame(const vk::SwapchainKHR &swapchain){
     if( result != vk::Result::eSuccess) {
         throw std::runtime_error("Failed to acquire swapchain image!");
     }
-    device.resetFences(m_perFrameData[m_currentFrameIndex].inFlightFence);
     return m_currentImageIndex;
 }
 
@@ -129,21 +300,36 @@ void CommandManager::endFrame(
     vk::CommandBuffer commandBuffer,
     const vk::SwapchainKHR& swapchain)
 {
-
-    auto device = m_context->getDevice();
     auto graphicsQueue = m_context->getGraphicsQueue();
     auto presentQueue = m_context->getPresentQueue();
 
-    // 1. 提交命令缓冲
-    vk::SubmitInfo submitInfo;
-    std::vector<vk::PipelineStageFlags> waitStages = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
-    submitInfo.setWaitSemaphores(m_imageAvailableSemaphores[m_currentFrameIndex])
-                .setWaitDstStageMask(waitStages)
-                .setCommandBuffers(commandBuffer)
-                .setSignalSemaphores(m_renderFinishedSemaphores[m_currentImageIndex]);
+    // 1. 提交命令缓冲：等待 acquire（二值）与其它子系统的时间线，signal present 用的二值信号量和帧时间线值
+    const uint64_t signalValue = m_submittedValue + 1;
+
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+    waitInfos.push_back(vk::SemaphoreSubmitInfo{
+        m_imageAvailableSemaphores[m_currentFrameIndex], 0, vk::PipelineStageFlagBits2::eColorAttachmentOutput
+    });
+    for (const auto& wait : m_pendingWaits) {
+        waitInfos.push_back(vk::SemaphoreSubmitInfo{wait.semaphore, wait.value, wait.stage});
+    }
+    m_pendingWaits.clear();
+
+    std::array<vk::SemaphoreSubmitInfo, 2> signalInfos = {
+        vk::SemaphoreSubmitInfo{m_renderFinishedSemaphores[m_currentImageIndex], 0, vk::PipelineStageFlagBits2::eAllCommands},
+        vk::SemaphoreSubmitInfo{m_timeline, signalValue, vk::PipelineStageFlagBits2::eAllCommands}
+    };
+
+    vk::CommandBufferSubmitInfo commandBufferInfo{commandBuffer};
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.setWaitSemaphoreInfos(waitInfos)
+              .setCommandBufferInfos(commandBufferInfo)
+              .setSignalSemaphoreInfos(signalInfos);
 
-    // 提交到图形队列（使用帧索引的fence）
-    graphicsQueue.submit(submitInfo, m_perFrameData[m_currentFrameIndex].inFlightFence);
+    graphicsQueue.submit2(submitInfo);
+    m_submittedValue = signalValue;
+    m_perFrameData[m_currentFrameIndex].timelineValue = signalValue;
 
     // 2. 呈现图像（使用图像索引的信号量）
     vk::PresentInfoKHR presentInfo;
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <print>
 #include <set>
+#include <algorithm>
 #include <GLFW/glfw3.h>
 
 bool Context::checkValidationLayerSupport() {
@@ -23,6 +24,14 @@ bool Context::checkValidationLayerSupport() {
     }
     return true;
 }
+bool Context::checkDeviceExtensionSupport(const char* extensionName) const {
+    for (const auto& extension : m_phyDevice.enumerateDeviceExtensionProperties()) {
+        if (strcmp(extensionName, extension.extensionName) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
 void Context::createInstance(){
     //1.检查是否开启Validation
     if(m_enableValidationLayers && !checkValidationLayerSupport()){
@@ -125,6 +134,8 @@ void Context::pickPhysicalDevice() {
         QueueFamilyIndices currentIndices;
         const auto queueFamilies = device.getQueueFamilyProperties();
         bool foundCombinedGraphicsPresent = false;
+        bool foundDedicatedCompute = false;
+        int transferRank = -1;
         // 遍历当前设备的所有队列族，寻找最佳组合
         for (uint32_t i = 0; i < queueFamilies.size(); ++i) {
             const auto& queueFamily = queueFamilies[i];
@@ -137,17 +148,27 @@ void Context::pickPhysicalDevice() {
                 currentIndices.presentFamily = i;
             }
             // 检查 Compute 队列
-            if (!currentIndices.computeFamily.has_value() && (queueFamily.queueFlags & vk::QueueFlagBits::eCompute)) {
-                currentIndices.computeFamily = i;
+            // 优先寻找专用的计算队列 (不包含Graphics能力)，用于异步计算与图形并行
+            if (queueFamily.queueFlags & vk::QueueFlagBits::eCompute) {
+                bool dedicated = !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics);
+                if (!currentIndices.computeFamily.has_value() || (dedicated && !foundDedicatedCompute)) {
+                    currentIndices.computeFamily = i;
+                    foundDedicatedCompute = dedicated;
+                }
             }
             
             // 检查 Transfer 队列
-            // 优先寻找专用的传输队列 (不包含Graphics能力)
-            if (!currentIndices.transferFamily.has_value() && (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer) && !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)) {
-                currentIndices.transferFamily = i;
-            } else if (!currentIndices.transferFamily.has_value() && (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer)) {
-                 // 如果没找到专用的，再考虑兼容的
-                currentIndices.transferFamily = i;
+            // 优先级：只有 Transfer 能力 (DMA 引擎) > 不包含 Graphics > 兼容的队列族，
+            // 先遇到的兼容队列族只作为后备，之后找到更专用的会替换它
+            if (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer) {
+                int rank = 0;
+                if (!(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)) {
+                    rank = (queueFamily.queueFlags & vk::QueueFlagBits::eCompute) ? 1 : 2;
+                }
+                if (!currentIndices.transferFamily.has_value() || rank > transferRank) {
+                    currentIndices.transferFamily = i;
+                    transferRank = rank;
+                }
             }
             // *** 核心优化：如果 Graphics 和 Present 是同一个队列族，给予巨大加分 ***
             if (currentIndices.graphicsFamily.has_value() && currentIndices.presentFamily.has_value() &&
@@ -201,7 +222,8 @@ void Context::pickPhysicalDevice() {
         std::println("  Graphics Queue Family: {}", m_queuefamily.graphicsFamily.value());
         std::println("  Present Queue Family:  {}", m_queuefamily.presentFamily.value());
         if (m_queuefamily.computeFamily.has_value()) {
-            std::println("  Compute Queue Family:  {}", m_queuefamily.computeFamily.value());
+            std::println("  Compute Queue Family:  {}{}", m_queuefamily.computeFamily.value(),
+                         m_queuefamily.computeFamily.value() != m_queuefamily.graphicsFamily.value() ? " (async)" : "");
         }
         if (m_queuefamily.transferFamily.has_value()) {
             std::println("  Transfer Queue Family: {}", m_queuefamily.transferFamily.value());
@@ -238,21 +260,73 @@ void Context::createLogicalDevice() {
         queueCreateInfo.setPQueuePriorities(&queuePriority);
         queueCreateInfos.push_back(queueCreateInfo);
     }
-    // 2. 启用设备特性
-    vk::PhysicalDeviceFeatures deviceFeatures = m_phyDevice.getFeatures();
-    
-    vk::PhysicalDeviceFeatures enabledFeatures{};
-    enabledFeatures.samplerAnisotropy = VK_TRUE;
+    // 2. 启用设备特性（通过 Features2 链启用 1.2 / 1.3 特性）
+    auto supported = m_phyDevice.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                               vk::PhysicalDeviceVulkan12Features,
+                                               vk::PhysicalDeviceVulkan13Features>();
+    const auto& supported12 = supported.get<vk::PhysicalDeviceVulkan12Features>();
+    const auto& supported13 = supported.get<vk::PhysicalDeviceVulkan13Features>();
+    // 帧图的屏障依赖 synchronization2，帧同步依赖时间线信号量
+    if (!supported13.synchronization2) {
+        throw std::runtime_error("synchronization2 is not supported by the selected device!");
+    }
+    if (!supported12.timelineSemaphore) {
+        throw std::runtime_error("timelineSemaphore is not supported by the selected device!");
+    }
+    m_features.synchronization2 = true;
+    m_features.timelineSemaphore = true;
+    // GPU 簇剔除的间接绘制：不支持时退化为逐网格 drawIndexed
+    m_features.multiDrawIndirect = supported.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect == VK_TRUE;
+    m_features.drawIndirectCount = supported12.drawIndirectCount == VK_TRUE;
+    // 块压缩纹理：桌面 GPU 基本都支持，不支持时导入器不编码，直接上传 RGBA8
+    m_features.textureCompressionBC = supported.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionBC == VK_TRUE;
+
+    // 网格着色器：扩展可用且 task / mesh 两个阶段都支持时启用，否则主通道只走顶点输入路径
+    vk::PhysicalDeviceMeshShaderFeaturesEXT enabledMesh{};
+    if (this->checkDeviceExtensionSupport(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+        auto supportedMesh = m_phyDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+        const auto& meshFeatures = supportedMesh.get<vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+        m_features.meshShader = meshFeatures.taskShader == VK_TRUE && meshFeatures.meshShader == VK_TRUE;
+    }
+    enabledMesh.taskShader = m_features.meshShader ? VK_TRUE : VK_FALSE;
+    enabledMesh.meshShader = m_features.meshShader ? VK_TRUE : VK_FALSE;
+
+    vk::PhysicalDeviceVulkan13Features enabled13{};
+    enabled13.synchronization2 = VK_TRUE;
+    enabled13.pNext = m_features.meshShader ? &enabledMesh : nullptr;
+
+    vk::PhysicalDeviceVulkan12Features enabled12{};
+    enabled12.timelineSemaphore = VK_TRUE;
+    enabled12.drawIndirectCount = m_features.drawIndirectCount ? VK_TRUE : VK_FALSE;
+    enabled12.pNext = &enabled13;
+
+    vk::PhysicalDeviceFeatures2 enabledFeatures{};
+    enabledFeatures.features.samplerAnisotropy = VK_TRUE;
+    enabledFeatures.features.multiDrawIndirect = m_features.multiDrawIndirect ? VK_TRUE : VK_FALSE;
+    enabledFeatures.features.textureCompressionBC = m_features.textureCompressionBC ? VK_TRUE : VK_FALSE;
+    enabledFeatures.pNext = &enabled12;
 
     // 4. 创建逻辑设备
     vk::DeviceCreateInfo createInfo{};
     createInfo.setQueueCreateInfoCount(static_cast<uint32_t>(queueCreateInfos.size()));
     createInfo.setPQueueCreateInfos(queueCreateInfos.data());
     
+    // 3. 可选扩展：VK_EXT_memory_budget 让 VMA 读取系统报告的显存预算
+    std::vector<const char*> enabledExtensions = m_deviceExtensions;
+    m_memoryBudgetSupported = this->checkDeviceExtensionSupport(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (m_memoryBudgetSupported) {
+        enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+    if (m_features.meshShader) {
+        enabledExtensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    }
+
     // 设置设备特性和扩展
-    createInfo.setPEnabledFeatures(&enabledFeatures);
-    createInfo.setEnabledExtensionCount(static_cast<uint32_t>(m_deviceExtensions.size()));
-    createInfo.setPpEnabledExtensionNames(m_deviceExtensions.data());
+    // 使用 Features2 链时 pEnabledFeatures 必须为空
+    createInfo.setPNext(&enabledFeatures);
+    createInfo.setPEnabledFeatures(nullptr);
+    createInfo.setEnabledExtensionCount(static_cast<uint32_t>(enabledExtensions.size()));
+    createInfo.setPpEnabledExtensionNames(enabledExtensions.data());
 
     try {
         m_logDevice = m_phyDevice.createDevice(createInfo);
@@ -260,6 +334,11 @@ void Context::createLogicalDevice() {
     } catch (vk::SystemError& err) {
         throw std::runtime_error("failed to create logical device! " + std::string(err.what()));
     }
+    if (m_features.meshShader) {
+        pfnCmdDrawMeshTasksEXT = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(m_logDevice.getProcAddr("vkCmdDrawMeshTasksEXT"));
+        m_features.meshShader = pfnCmdDrawMeshTasksEXT != nullptr;
+    }
+    std::println("Mesh shaders: {}", m_features.meshShader ? "VK_EXT_mesh_shader" : "unsupported");
     // 5. 获取队列句柄
     m_graphicsQueue = m_logDevice.getQueue(m_queuefamily.graphicsFamily.value(), 0);
     m_presentQueue = m_logDevice.getQueue(m_queuefamily.presentFamily.value(), 0);
@@ -285,12 +364,21 @@ void Context::createVmaAllocator() {
     vulkanFunctions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
     vulkanFunctions.vkGetDeviceProcAddr = &vkGetDeviceProcAddr;
     allocatorInfo.pVulkanFunctions = &vulkanFunctions;
-    // VMA 3.0+ 推荐的 flags
-    allocatorInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    // 告诉 VMA 设备实际支持的 API 版本（1.1+ 时预算查询走核心的 vkGetPhysicalDeviceMemoryProperties2）
+    const uint32_t deviceApiVersion = m_phyDevice.getProperties().apiVersion;
+    allocatorInfo.vulkanApiVersion = std::min(
+        VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(deviceApiVersion), VK_API_VERSION_MINOR(deviceApiVersion), 0),
+        VK_API_VERSION_1_4);
+    // 只有设备扩展启用时才能打开预算标志，否则 VMA 会退化为估算值
+    if (m_memoryBudgetSupported) {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     VkResult result = vmaCreateAllocator(&allocatorInfo, &m_vmaAllocator);
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to create VMA allocator!");
     }
+    m_memoryTracker = std::make_unique<MemoryTracker>(m_vmaAllocator);
+    std::println("VMA allocator created (memory budget: {})", m_memoryBudgetSupported ? "VK_EXT_memory_budget" : "estimated");
 }
 void Context::createCommandPool() {
     // 1. 创建图形命令池
@@ -338,4 +426,16 @@ Context::Context(std::unique_ptr<Window> &window){
     this->createVmaAllocator(); 
     // 7.创建命令池
     this->createCommandPool();
+    // 8.创建上传引擎（staging 环形缓冲 + 传输队列批量提交）
+    this->m_uploadEngine = std::make_unique<UploadEngine>(this);
+    // 9.创建工作线程池（文件读取 / 解析 / 解码）
+    this->m_jobSystem = std::make_unique<JobSystem>();
+    // 10.创建几何体竞技场（所有 Mesh 子分配到共享的顶点 / 索引缓冲）
+    this->m_geometryArena = std::make_unique<GeometryArena>(this);
+    // 11.创建采样器缓存（纹理按参数共享采样器）
+    this->m_samplerCache = std::make_unique<SamplerCache>(this);
+    // 12.创建纹理流式加载器（按使用反馈升降 mip 常驻级别）
+    this->m_textureStreamer = std::make_unique<TextureStreamer>(this);
+    // 13.创建计算 mip 生成器（使用采样器缓存；着色器缺失时退回 blit）
+    this->m_mipGenerator = std::make_unique<MipGenerator>(this);
 }
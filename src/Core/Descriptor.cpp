@@ -3,6 +3,7 @@
 #include "Assets/Material.h"
 #include "Scene/UniformBuffer.h"
 #include <print>
+#include <algorithm>
 #include <stdexcept>
 
 // ---------------------------------------------------------------------------
@@ -37,6 +38,12 @@ void DescriptorManager::createLayout(uint32_t setIndex, uint32_t bindStart) {
 
     std::vector<vk::DescriptorSetLayoutBinding> bindings;
     generateBindings<Types...>(bindStart, bindings);
+    // 未启用 VK_EXT_mesh_shader 时布局不能引用 task / mesh 阶段
+    if (!m_context->getFeatures().meshShader) {
+        for (auto& binding : bindings) {
+            binding.stageFlags &= ~(vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT);
+        }
+    }
 
     vk::DescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = vk::StructureType::eDescriptorSetLayoutCreateInfo;
@@ -86,11 +93,24 @@ DescriptorManager::~DescriptorManager() {
 // ---------------------------------------------------------------------------
 // 描述符池创建
 // ---------------------------------------------------------------------------
+void DescriptorManager::setCopiesPerInstance(uint32_t setIndex, uint32_t copies) {
+    if (m_descriptorPool) {
+        throw std::runtime_error("Copies for set " + std::to_string(setIndex) + " must be set before the pool is created.");
+    }
+    m_copies[setIndex] = std::max(copies, 1u);
+}
+
+uint32_t DescriptorManager::getCopies(uint32_t setIndex) const {
+    auto it = m_copies.find(setIndex);
+    return it == m_copies.end() ? 1u : it->second;
+}
+
 void DescriptorManager::createPool(const std::unordered_map<uint32_t, uint32_t>& setCapacity) {
     std::unordered_map<vk::DescriptorType, uint32_t> poolSizeCounts;
     uint32_t totalSets = 0;
-    // 遍历每个 set 的容量需求，计算池中每种描述符类型的总数
-    for (const auto& [setIndex, count] : setCapacity) {
+    // 遍历每个 set 的容量需求，计算池中每种描述符类型的总数（每个实例按副本数计）
+    for (const auto& [setIndex, instances] : setCapacity) {
+        const uint32_t count = instances * this->getCopies(setIndex);
         totalSets += count;
         // 检查该 set 的布局是否存在
         if (!m_layouts.count(setIndex)) {
@@ -99,9 +119,9 @@ void DescriptorManager::createPool(const std::unordered_map<uint32_t, uint32_t>&
         // --- 这里需要根据你的具体布局来手动计算 ---
         if (setIndex == 0) {        // Set 0: Camera
             poolSizeCounts[vk::DescriptorType::eUniformBuffer] += count;
-        } else if (setIndex == 1) { // Set 1: Object (Transform, Light, Material, 4 Textures)
+        } else if (setIndex == 1) { // Set 1: Object (Transform, Light, Material, 3 Textures: albedo / normal / ORM)
             poolSizeCounts[vk::DescriptorType::eUniformBuffer] += count * 3; // 3 UBOs
-            poolSizeCounts[vk::DescriptorType::eCombinedImageSampler] += count * 4; // 4 Samplers
+            poolSizeCounts[vk::DescriptorType::eCombinedImageSampler] += count * 3; // 3 Samplers
         }
     }
     // 填充 vk::DescriptorPoolSize 数组
@@ -140,8 +160,9 @@ void DescriptorManager::allocateAllSets(const std::unordered_map<uint32_t, uint3
     if (!m_descriptorPool) {
         throw std::runtime_error("Cannot allocate sets because the descriptor pool has not been created.");
     }
-    // 遍历每个需要分配的 set
-    for (const auto& [setIndex, count] : setCapacity) {
+    // 遍历每个需要分配的 set；实例 i 的副本 c 位于 i * copies + c
+    for (const auto& [setIndex, instances] : setCapacity) {
+        const uint32_t count = instances * this->getCopies(setIndex);
         auto layoutIt = m_layouts.find(setIndex);
         if (layoutIt == m_layouts.end()) {
             continue;
@@ -167,16 +188,18 @@ vk::DescriptorSetLayout DescriptorManager::getLayout(uint32_t setIndex) const {
     return it->second;
 }
 
-vk::DescriptorSet DescriptorManager::getSet(uint32_t setIndex, uint32_t instanceIndex) const {
-    auto setIt = m_sets.find(setIndex);
-    if (setIt == m_sets.end()) {
-        throw std::runtime_error("Sets for set " + std::to_string(setIndex) + " have not been allocated. Call allocateAllSets() first.");
-    }
-    const auto& instances = setIt->second;
-    if (instanceIndex >= instances.size()) {
-        throw std::runtime_error("Instance index " + std::to_string(instanceIndex) + " is out of bounds for set " + std::to_string(setIndex) + " (size: " + std::to_string(instances.size()) + ").");
+vk::DescriptorSet DescriptorManager::getSet(uint32_t setIndex, uint32_t instanceIndex, uint32_t copy) const {
+    return this->getDescriptorSet(setIndex, instanceIndex, copy);
+}
+
+vk::DescriptorSet& DescriptorManager::setAt(uint32_t setIndex, uint32_t instance, uint32_t copy) {
+    const uint32_t copies = this->getCopies(setIndex);
+    auto& instances = m_sets[setIndex];
+    const size_t index = static_cast<size_t>(instance) * copies + copy;
+    if (copy >= copies || index >= instances.size()) {
+        throw std::runtime_error("Instance " + std::to_string(instance) + " copy " + std::to_string(copy) + " is out of bounds for set " + std::to_string(setIndex) + ".");
     }
-    return instances[instanceIndex];
+    return instances[index];
 }
 
 void DescriptorManager::bindBufferToSet(uint32_t layoutIdx,
@@ -186,50 +209,64 @@ void DescriptorManager::bindBufferToSet(uint32_t layoutIdx,
                                         vk::DeviceSize size) {
     vk::DescriptorBufferInfo bufferInfo{buffer, 0, size};
 
-    vk::WriteDescriptorSet write{};
-    write.setDstSet(m_sets[layoutIdx][setInstance]);
-    write.setDstBinding(binding);
-    write.setDstArrayElement(0);
-    write.setDescriptorCount(1);
-    write.setDescriptorType(vk::DescriptorType::eUniformBuffer);
-    write.setPImageInfo(nullptr);
-    write.setPBufferInfo(&bufferInfo);
+    std::vector<vk::WriteDescriptorSet> writes;
+    for (uint32_t copy = 0; copy < this->getCopies(layoutIdx); copy++) {
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(this->setAt(layoutIdx, setInstance, copy));
+        write.setDstBinding(binding);
+        write.setDstArrayElement(0);
+        write.setDescriptorCount(1);
+        write.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+        write.setPImageInfo(nullptr);
+        write.setPBufferInfo(&bufferInfo);
+        writes.push_back(write);
+    }
 
-    m_context->getDevice().updateDescriptorSets(write, {});
+    m_context->getDevice().updateDescriptorSets(writes, {});
 }
 
 void DescriptorManager::bindImageToSet(uint32_t layoutIdx,
                                        uint32_t setInstance,
                                        uint32_t binding,
                                        vk::ImageView imageView,
-                                       vk::Sampler sampler) {
+                                       vk::Sampler sampler,
+                                       uint32_t copy) {
     vk::DescriptorImageInfo imageInfo{};
     imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
     imageInfo.imageView = imageView;
     imageInfo.sampler = sampler;
 
-    vk::WriteDescriptorSet write{};
-    write.setDstSet(m_sets[layoutIdx][setInstance]);
-    write.setDstBinding(binding);
-    write.setDstArrayElement(0);
-    write.setDescriptorCount(1);
-    write.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-    write.setPImageInfo(&imageInfo);
-    write.setPBufferInfo(nullptr);
+    // copy 为 kAllCopies 时写入所有副本（初次绑定），否则只写入指定的副本
+    const uint32_t first = copy == kAllCopies ? 0 : copy;
+    const uint32_t last = copy == kAllCopies ? this->getCopies(layoutIdx) : copy + 1;
+    std::vector<vk::WriteDescriptorSet> writes;
+    for (uint32_t c = first; c < last; c++) {
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(this->setAt(layoutIdx, setInstance, c));
+        write.setDstBinding(binding);
+        write.setDstArrayElement(0);
+        write.setDescriptorCount(1);
+        write.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+        write.setPImageInfo(&imageInfo);
+        write.setPBufferInfo(nullptr);
+        writes.push_back(write);
+    }
 
-    m_context->getDevice().updateDescriptorSets(write, {});
+    m_context->getDevice().updateDescriptorSets(writes, {});
 }
 
-vk::DescriptorSet DescriptorManager::getDescriptorSet(uint32_t setIndex, uint32_t index) const {
+vk::DescriptorSet DescriptorManager::getDescriptorSet(uint32_t setIndex, uint32_t index, uint32_t copy) const {
     auto setIt = m_sets.find(setIndex);
     if (setIt == m_sets.end()) {
         throw std::runtime_error("Sets for set " + std::to_string(setIndex) + " have not been allocated. Call allocateAllSets() first.");
     }
     const auto& instances = setIt->second;
-    if (index >= instances.size()) {
-        throw std::runtime_error("Instance index " + std::to_string(index) + " is out of bounds for set " + std::to_string(setIndex) + " (size: " + std::to_string(instances.size()) + ").");
+    const uint32_t copies = this->getCopies(setIndex);
+    const size_t slot = static_cast<size_t>(index) * copies + copy;
+    if (copy >= copies || slot >= instances.size()) {
+        throw std::runtime_error("Instance index " + std::to_string(index) + " (copy " + std::to_string(copy) + ") is out of bounds for set " + std::to_string(setIndex) + " (size: " + std::to_string(instances.size()) + ").");
     }
-    return instances[index];
+    return instances[slot];
 }
 
 std::vector<vk::DescriptorSetLayout> DescriptorManager::getAllDescriptorSetLayouts() const {
@@ -259,5 +296,5 @@ std::vector<vk::DescriptorSetLayout> DescriptorManager::getAllDescriptorSetLayou
 // 模板显式实例化
 // 注意：使用值类型而非指针类型，匹配 Renderer.cpp 中的调用
 template void DescriptorManager::createLayout<CameraUBO>(uint32_t, uint32_t);
-template void DescriptorManager::createLayout<TransformUBO, LightUBO, MaterialUBO, TextureSampler, TextureSampler, TextureSampler, TextureSampler>(uint32_t, uint32_t);
+template void DescriptorManager::createLayout<TransformUBO, LightUBO, MaterialUBO, TextureSampler, TextureSampler, TextureSampler>(uint32_t, uint32_t);
 
@@ -0,0 +1,355 @@
+#include "Core/GeometryArena.h"
+#include "Core/Context.h"
+#include "Core/Command.h"
+#include <print>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    vk::DeviceSize vertexByteOffset(const GeometryRange& range) {
+        return static_cast<vk::DeviceSize>(range.vertexOffset) * range.vertexStride;
+    }
+    vk::DeviceSize vertexByteSize(const GeometryRange& range) {
+        return static_cast<vk::DeviceSize>(range.vertexCount) * range.vertexStride;
+    }
+    uint32_t indexSize(vk::IndexType indexType) {
+        return indexType == vk::IndexType::eUint16 ? 2 : 4;
+    }
+    vk::DeviceSize indexByteOffset(const GeometryRange& range) {
+        return static_cast<vk::DeviceSize>(range.firstIndex) * indexSize(range.indexType);
+    }
+    vk::DeviceSize indexByteSize(const GeometryRange& range) {
+        return static_cast<vk::DeviceSize>(range.indexCount) * indexSize(range.indexType);
+    }
+
+    // 顶点缓冲除了作为顶点输入，在网格着色器路径中还由 task / mesh 阶段作为存储缓冲读取
+    vk::PipelineStageFlags2 vertexReadStage(const Context* context) {
+        vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eVertexAttributeInput;
+        if (context->getFeatures().meshShader) {
+            stage |= vk::PipelineStageFlagBits2::eTaskShaderEXT | vk::PipelineStageFlagBits2::eMeshShaderEXT;
+        }
+        return stage;
+    }
+    vk::AccessFlags2 vertexReadAccess(const Context* context) {
+        vk::AccessFlags2 access = vk::AccessFlagBits2::eVertexAttributeRead;
+        if (context->getFeatures().meshShader) {
+            access |= vk::AccessFlagBits2::eShaderStorageRead;
+        }
+        return access;
+    }
+}
+
+GeometryArena::GeometryArena(Context* context, uint32_t vertexCapacity, uint32_t indexCapacity)
+    : m_context(context) {
+    m_storage = this->createStorage(vertexCapacity, indexCapacity);
+    std::println("GeometryArena: {:.2f} MB vertex data + {:.2f} MB index data",
+                 static_cast<double>(vertexCapacity) * kVertexUnit / (1024.0 * 1024.0),
+                 static_cast<double>(indexCapacity) * kIndexUnit / (1024.0 * 1024.0));
+}
+
+GeometryArena::~GeometryArena() {
+    // 此时设备已空闲（Renderer 析构时 waitIdle），直接销毁
+    for (auto& storage : m_retired) {
+        this->destroyStorage(storage);
+    }
+    m_retired.clear();
+    this->destroyStorage(m_storage);
+}
+
+GeometryArena::Storage GeometryArena::createStorage(uint32_t vertexCapacity, uint32_t indexCapacity) const {
+    Storage storage;
+    storage.vertexCapacity = vertexCapacity;
+    storage.indexCapacity = indexCapacity;
+
+    // 传输队列与图形队列族不同时使用 CONCURRENT，上传与整理拷贝都不需要 release / acquire
+    UploadEngine* uploads = m_context->getUploadEngine();
+    const uint32_t queueFamilies[] = { m_context->getGraphicsQueueFamily(), uploads->getQueueFamily() };
+    const bool concurrent = uploads->usesOwnershipTransfer();
+
+    auto createBuffer = [&](VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VmaAllocation& allocation, const char* name) {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        bufferInfo.queueFamilyIndexCount = concurrent ? 2 : 0;
+        bufferInfo.pQueueFamilyIndices = concurrent ? queueFamilies : nullptr;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+        if (vmaCreateBuffer(m_context->getVmaAllocator(), &bufferInfo, &allocInfo, &buffer, &allocation, nullptr) != VK_SUCCESS) {
+            throw std::runtime_error(std::string("Failed to create geometry arena buffer: ") + name);
+        }
+        m_context->getMemoryTracker()->track(allocation, name, MemoryCategory::Mesh);
+    };
+
+    VkBuffer vertexBuffer;
+    VkBuffer indexBuffer;
+    // 网格着色器路径把顶点缓冲当作存储缓冲读取（自行解码顶点格式）
+    createBuffer(static_cast<VkDeviceSize>(vertexCapacity) * kVertexUnit, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                 vertexBuffer, storage.vertexAllocation, "GeometryArena [vertex]");
+    createBuffer(static_cast<VkDeviceSize>(indexCapacity) * kIndexUnit, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                 indexBuffer, storage.indexAllocation, "GeometryArena [index]");
+    storage.vertexBuffer = vertexBuffer;
+    storage.indexBuffer = indexBuffer;
+
+    // virtual block 以 kVertexUnit / kIndexUnit 为单位，分配得到的 offset 可以直接换算成 vertexOffset / firstIndex
+    VmaVirtualBlockCreateInfo blockInfo{};
+    blockInfo.size = vertexCapacity;
+    if (vmaCreateVirtualBlock(&blockInfo, &storage.vertexBlock) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create geometry arena vertex block!");
+    }
+    blockInfo.size = indexCapacity;
+    if (vmaCreateVirtualBlock(&blockInfo, &storage.indexBlock) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create geometry arena index block!");
+    }
+    return storage;
+}
+
+void GeometryArena::destroyStorage(Storage& storage) const {
+    // virtual block 销毁前必须为空
+    if (storage.vertexBlock != VK_NULL_HANDLE) {
+        vmaClearVirtualBlock(storage.vertexBlock);
+        vmaDestroyVirtualBlock(storage.vertexBlock);
+        storage.vertexBlock = VK_NULL_HANDLE;
+    }
+    if (storage.indexBlock != VK_NULL_HANDLE) {
+        vmaClearVirtualBlock(storage.indexBlock);
+        vmaDestroyVirtualBlock(storage.indexBlock);
+        storage.indexBlock = VK_NULL_HANDLE;
+    }
+    auto allocator = m_context->getVmaAllocator();
+    if (storage.vertexBuffer && storage.vertexAllocation != VK_NULL_HANDLE) {
+        m_context->getMemoryTracker()->untrack(storage.vertexAllocation);
+        vmaDestroyBuffer(allocator, static_cast<VkBuffer>(storage.vertexBuffer), storage.vertexAllocation);
+    }
+    if (storage.indexBuffer && storage.indexAllocation != VK_NULL_HANDLE) {
+        m_context->getMemoryTracker()->untrack(storage.indexAllocation);
+        vmaDestroyBuffer(allocator, static_cast<VkBuffer>(storage.indexBuffer), storage.indexAllocation);
+    }
+    storage = Storage{};
+}
+
+bool GeometryArena::tryAllocate(Storage& storage, uint32_t vertexCount, uint32_t vertexStride,
+                                uint32_t indexCount, vk::IndexType indexType, Slot& slot) const {
+    VmaVirtualAllocationCreateInfo allocInfo{};
+    VkDeviceSize offset = 0;
+
+    // 按步长对齐，起点总是整数个顶点
+    const uint32_t unitsPerVertex = vertexStride / kVertexUnit;
+    allocInfo.size = static_cast<VkDeviceSize>(vertexCount) * unitsPerVertex;
+    allocInfo.alignment = unitsPerVertex;
+    if (vmaVirtualAllocate(storage.vertexBlock, &allocInfo, &slot.vertexAllocation, &offset) != VK_SUCCESS) {
+        return false;
+    }
+    slot.range.vertexOffset = static_cast<int32_t>(offset / unitsPerVertex);
+    slot.range.vertexStride = vertexStride;
+
+    // 32 位索引按 4 字节对齐，firstIndex 以索引自身的类型计
+    const uint32_t unitsPerIndex = indexSize(indexType) / kIndexUnit;
+    allocInfo.size = static_cast<VkDeviceSize>(indexCount) * unitsPerIndex;
+    allocInfo.alignment = unitsPerIndex;
+    if (vmaVirtualAllocate(storage.indexBlock, &allocInfo, &slot.indexAllocation, &offset) != VK_SUCCESS) {
+        vmaVirtualFree(storage.vertexBlock, slot.vertexAllocation);
+        slot.vertexAllocation = VK_NULL_HANDLE;
+        return false;
+    }
+    slot.range.firstIndex = static_cast<uint32_t>(offset / unitsPerIndex);
+    slot.range.indexType = indexType;
+    slot.range.vertexCount = vertexCount;
+    slot.range.indexCount = indexCount;
+    return true;
+}
+
+GeometryArena::Handle GeometryArena::allocate(const void* vertices, uint32_t vertexCount, uint32_t vertexStride,
+                                              const void* indices, uint32_t indexCount, vk::IndexType indexType) {
+    if (vertexCount == 0 || indexCount == 0) {
+        throw std::runtime_error("GeometryArena: cannot allocate an empty mesh!");
+    }
+    const uint32_t unitsPerVertex = vertexStride / kVertexUnit;
+    if (vertexStride % kVertexUnit != 0 || (unitsPerVertex & (unitsPerVertex - 1)) != 0) {
+        throw std::runtime_error("GeometryArena: vertex stride must be a power-of-two multiple of 16 bytes!");
+    }
+    if (indexType != vk::IndexType::eUint16 && indexType != vk::IndexType::eUint32) {
+        throw std::runtime_error("GeometryArena: only 16/32-bit indices are supported!");
+    }
+    const uint32_t unitsPerIndex = indexSize(indexType) / kIndexUnit;
+
+    Slot slot;
+    if (!this->tryAllocate(m_storage, vertexCount, vertexStride, indexCount, indexType, slot)) {
+        // 先尝试按当前容量整理；仍放不下时按两倍扩容直到容纳全部存活数据
+        VmaStatistics vertexStats{};
+        VmaStatistics indexStats{};
+        vmaGetVirtualBlockStatistics(m_storage.vertexBlock, &vertexStats);
+        vmaGetVirtualBlockStatistics(m_storage.indexBlock, &indexStats);
+        const uint64_t vertexNeeded = vertexStats.allocationBytes + static_cast<uint64_t>(vertexCount + 1) * unitsPerVertex;
+        const uint64_t indexNeeded = indexStats.allocationBytes + static_cast<uint64_t>(indexCount + 1) * unitsPerIndex;
+
+        uint64_t vertexCapacity = m_storage.vertexCapacity;
+        uint64_t indexCapacity = m_storage.indexCapacity;
+        while (vertexCapacity < vertexNeeded) vertexCapacity *= 2;
+        while (indexCapacity < indexNeeded) indexCapacity *= 2;
+        for (int attempt = 0; ; attempt++) {
+            if (vertexCapacity > UINT32_MAX || indexCapacity > UINT32_MAX) {
+                throw std::runtime_error("GeometryArena: capacity exceeds 32-bit range!");
+            }
+            this->relocate(static_cast<uint32_t>(vertexCapacity), static_cast<uint32_t>(indexCapacity));
+            if (this->tryAllocate(m_storage, vertexCount, vertexStride, indexCount, indexType, slot)) break;
+            if (attempt > 0) {
+                throw std::runtime_error("GeometryArena: allocation failed after growing!");
+            }
+            vertexCapacity *= 2;
+            indexCapacity *= 2;
+        }
+    }
+    slot.live = true;
+
+    Handle handle;
+    if (!m_freeSlots.empty()) {
+        handle = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slots[handle] = slot;
+    } else {
+        handle = static_cast<Handle>(m_slots.size());
+        m_slots.push_back(slot);
+    }
+
+    // 数据通过 staging 环形缓冲写入各自的区间
+    UploadEngine* uploads = m_context->getUploadEngine();
+    uploads->uploadBuffer(
+        m_storage.vertexBuffer, vertices, vertexByteSize(slot.range), vertexByteOffset(slot.range),
+        vertexReadStage(m_context),
+        vertexReadAccess(m_context),
+        true
+    );
+    uploads->uploadBuffer(
+        m_storage.indexBuffer, indices, indexByteSize(slot.range), indexByteOffset(slot.range),
+        vk::PipelineStageFlagBits2::eIndexInput,
+        vk::AccessFlagBits2::eIndexRead,
+        true
+    );
+    return handle;
+}
+
+void GeometryArena::free(Handle handle) {
+    if (handle >= m_slots.size() || !m_slots[handle].live) {
+        return;
+    }
+    Slot& slot = m_slots[handle];
+    vmaVirtualFree(m_storage.vertexBlock, slot.vertexAllocation);
+    vmaVirtualFree(m_storage.indexBlock, slot.indexAllocation);
+    slot = Slot{};
+    m_freeSlots.push_back(handle);
+    m_fragmentationDirty = true;
+}
+
+void GeometryArena::relocate(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    Storage next = this->createStorage(vertexCapacity, indexCapacity);
+
+    // 按原字节偏移顺序重新分配，存活区间在新缓冲中紧凑排列
+    std::vector<Handle> order;
+    for (Handle handle = 0; handle < m_slots.size(); handle++) {
+        if (m_slots[handle].live) order.push_back(handle);
+    }
+    std::sort(order.begin(), order.end(), [this](Handle a, Handle b) {
+        return vertexByteOffset(m_slots[a].range) < vertexByteOffset(m_slots[b].range);
+    });
+
+    std::vector<vk::BufferCopy> vertexCopies;
+    std::vector<vk::BufferCopy> indexCopies;
+    vertexCopies.reserve(order.size());
+    indexCopies.reserve(order.size());
+    for (Handle handle : order) {
+        Slot& slot = m_slots[handle];
+        Slot moved;
+        if (!this->tryAllocate(next, slot.range.vertexCount, slot.range.vertexStride,
+                               slot.range.indexCount, slot.range.indexType, moved)) {
+            this->destroyStorage(next);
+            throw std::runtime_error("GeometryArena: relocation target is too small!");
+        }
+        vertexCopies.push_back(vk::BufferCopy{
+            vertexByteOffset(slot.range),
+            vertexByteOffset(moved.range),
+            vertexByteSize(slot.range)
+        });
+        indexCopies.push_back(vk::BufferCopy{
+            indexByteOffset(slot.range),
+            indexByteOffset(moved.range),
+            indexByteSize(slot.range)
+        });
+        moved.live = true;
+        slot = moved;
+    }
+
+    // 索引是相对 vertexOffset 的，移动时不需要改写
+    UploadEngine* uploads = m_context->getUploadEngine();
+    uploads->copyBuffer(m_storage.vertexBuffer, next.vertexBuffer, vertexCopies, vertexReadStage(m_context));
+    uploads->copyBuffer(m_storage.indexBuffer, next.indexBuffer, indexCopies, vk::PipelineStageFlagBits2::eIndexInput);
+
+    // 在途帧仍绑定着旧缓冲，等到 update 交给时间线延迟销毁
+    m_retired.push_back(m_storage);
+    m_storage = next;
+    m_relocations++;
+    std::println("GeometryArena: relocated {} mesh(es) into {:.2f} MB vertex data / {:.2f} MB index data",
+                 order.size(), static_cast<double>(vertexCapacity) * kVertexUnit / (1024.0 * 1024.0),
+                 static_cast<double>(indexCapacity) * kIndexUnit / (1024.0 * 1024.0));
+}
+
+float GeometryArena::calculateFragmentation() const {
+    auto fragmentation = [](VmaVirtualBlock block) {
+        VmaDetailedStatistics stats{};
+        vmaCalculateVirtualBlockStatistics(block, &stats);
+        const VkDeviceSize freeBytes = stats.statistics.blockBytes - stats.statistics.allocationBytes;
+        if (freeBytes == 0 || stats.unusedRangeCount <= 1) {
+            return 0.0f;
+        }
+        return 1.0f - static_cast<float>(stats.unusedRangeSizeMax) / static_cast<float>(freeBytes);
+    };
+    return std::max(fragmentation(m_storage.vertexBlock), fragmentation(m_storage.indexBlock));
+}
+
+void GeometryArena::update(CommandManager* commands) {
+    if (m_fragmentationDirty) {
+        m_fragmentationDirty = false;
+        if (this->calculateFragmentation() > m_defragThreshold) {
+            this->relocate(m_storage.vertexCapacity, m_storage.indexCapacity);
+        }
+    }
+    // 当前帧等待传输时间线（整理拷贝）后才会完成，此前的帧都只读旧缓冲
+    for (auto& storage : m_retired) {
+        commands->deferDestroy([this, storage]() mutable { this->destroyStorage(storage); });
+    }
+    m_retired.clear();
+}
+
+void GeometryArena::bind(vk::CommandBuffer commandBuffer, vk::IndexType indexType) const {
+    const vk::DeviceSize offset = 0;
+    commandBuffer.bindVertexBuffers(0, 1, &m_storage.vertexBuffer, &offset);
+    this->bindIndices(commandBuffer, indexType);
+}
+
+void GeometryArena::bindIndices(vk::CommandBuffer commandBuffer, vk::IndexType indexType) const {
+    commandBuffer.bindIndexBuffer(m_storage.indexBuffer, 0, indexType);
+}
+
+GeometryArenaStats GeometryArena::getStats() const {
+    VmaStatistics vertexStats{};
+    VmaStatistics indexStats{};
+    vmaGetVirtualBlockStatistics(m_storage.vertexBlock, &vertexStats);
+    vmaGetVirtualBlockStatistics(m_storage.indexBlock, &indexStats);
+
+    GeometryArenaStats stats;
+    stats.meshCount = static_cast<uint32_t>(m_slots.size() - m_freeSlots.size());
+    stats.vertexBytesCapacity = static_cast<uint64_t>(m_storage.vertexCapacity) * kVertexUnit;
+    stats.vertexBytesUsed = vertexStats.allocationBytes * kVertexUnit;
+    stats.indexBytesCapacity = static_cast<uint64_t>(m_storage.indexCapacity) * kIndexUnit;
+    stats.indexBytesUsed = indexStats.allocationBytes * kIndexUnit;
+    for (const auto& slot : m_slots) {
+        if (slot.live && slot.range.indexType == vk::IndexType::eUint16) stats.meshes16BitIndices++;
+    }
+    stats.fragmentation = this->calculateFragmentation();
+    stats.relocations = m_relocations;
+    return stats;
+}
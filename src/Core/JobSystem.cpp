@@ -0,0 +1,99 @@
+#include "Core/JobSystem.h"
+#include <print>
+#include <atomic>
+#include <algorithm>
+
+JobSystem::JobSystem(uint32_t threadCount) {
+    if (threadCount == 0) {
+        const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::max(1u, hardware - 1);
+    }
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        m_workers.emplace_back([this](std::stop_token stopToken) { this->workerLoop(stopToken); });
+    }
+    std::println("JobSystem: {} worker thread(s)", threadCount);
+}
+
+JobSystem::~JobSystem() {
+    for (auto& worker : m_workers) {
+        worker.request_stop();
+    }
+    m_condition.notify_all();
+    // jthread 析构时 join；工作线程会先处理完队列中剩余的任务
+    m_workers.clear();
+}
+
+void JobSystem::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void JobSystem::workerLoop(std::stop_token stopToken) {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_condition.wait(lock, stopToken, [this]() { return !m_queue.empty(); })) {
+                return; // 请求停止且队列已清空
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        job();
+    }
+}
+
+void JobSystem::parallelFor(size_t count, std::function<void(size_t)> body) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || m_workers.empty()) {
+        for (size_t i = 0; i < count; i++) body(i);
+        return;
+    }
+
+    // 排队中的辅助任务可能在 parallelFor 返回后才被执行，共享状态由它们共同持有
+    struct State {
+        std::function<void(size_t)> body;
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->body = std::move(body);
+    state->count = count;
+
+    auto drain = [](State& s) {
+        for (size_t i = s.next.fetch_add(1); i < s.count; i = s.next.fetch_add(1)) {
+            try {
+                s.body(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.error) s.error = std::current_exception();
+            }
+            if (s.done.fetch_add(1) + 1 == s.count) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.finished.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(count - 1, m_workers.size());
+    for (size_t i = 0; i < helpers; i++) {
+        this->enqueue([state, drain]() { drain(*state); });
+    }
+    drain(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->done.load() == state->count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
@@ -0,0 +1,208 @@
+#include "Core/MemoryTracker.h"
+#include <imgui.h>
+#include <algorithm>
+#include <fstream>
+#include <format>
+#include <print>
+#include <stdexcept>
+
+namespace {
+    std::string formatBytes(VkDeviceSize bytes) {
+        constexpr double KB = 1024.0;
+        constexpr double MB = KB * 1024.0;
+        constexpr double GB = MB * 1024.0;
+        double value = static_cast<double>(bytes);
+        if (value >= GB) return std::format("{:.2f} GB", value / GB);
+        if (value >= MB) return std::format("{:.2f} MB", value / MB);
+        if (value >= KB) return std::format("{:.1f} KB", value / KB);
+        return std::format("{} B", bytes);
+    }
+}
+
+const char* toString(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Mesh:          return "Mesh";
+        case MemoryCategory::Texture:       return "Texture";
+        case MemoryCategory::UniformBuffer: return "UniformBuffer";
+        case MemoryCategory::RenderTarget:  return "RenderTarget";
+        case MemoryCategory::Staging:       return "Staging";
+        case MemoryCategory::Other:         return "Other";
+        default:                            return "Unknown";
+    }
+}
+
+MemoryTracker::MemoryTracker(VmaAllocator allocator)
+    : m_allocator(allocator) {
+}
+
+void MemoryTracker::track(VmaAllocation allocation, const std::string& name, MemoryCategory category) {
+    if (allocation == VK_NULL_HANDLE) return;
+
+    // VMA 会复制名字，vmaBuildStatsString 的 JSON 中会带上 "Name" 字段
+    vmaSetAllocationName(m_allocator, allocation, name.c_str());
+
+    VmaAllocationInfo info{};
+    vmaGetAllocationInfo(m_allocator, allocation, &info);
+
+    std::lock_guard lock(m_mutex);
+    m_allocations[allocation] = TrackedAllocation{
+        .name = name,
+        .category = category,
+        .size = info.size,
+        .memoryType = info.memoryType
+    };
+}
+
+void MemoryTracker::untrack(VmaAllocation allocation) {
+    if (allocation == VK_NULL_HANDLE) return;
+    std::lock_guard lock(m_mutex);
+    m_allocations.erase(allocation);
+}
+
+std::vector<HeapBudget> MemoryTracker::getHeapBudgets() const {
+    const VkPhysicalDeviceMemoryProperties* memProps = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memProps);
+
+    std::vector<VmaBudget> budgets(memProps->memoryHeapCount);
+    vmaGetHeapBudgets(m_allocator, budgets.data());
+
+    std::vector<HeapBudget> result;
+    result.reserve(memProps->memoryHeapCount);
+    for (uint32_t i = 0; i < memProps->memoryHeapCount; ++i) {
+        result.push_back(HeapBudget{
+            .heapIndex = i,
+            .deviceLocal = (memProps->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+            .heapSize = memProps->memoryHeaps[i].size,
+            .usage = budgets[i].usage,
+            .budget = budgets[i].budget,
+            .blockBytes = budgets[i].statistics.blockBytes,
+            .allocationBytes = budgets[i].statistics.allocationBytes
+        });
+    }
+    return result;
+}
+
+CategoryTotals MemoryTracker::getCategoryTotals() const {
+    CategoryTotals totals{};
+    std::lock_guard lock(m_mutex);
+    for (const auto& [allocation, tracked] : m_allocations) {
+        totals[static_cast<size_t>(tracked.category)] += tracked.size;
+    }
+    return totals;
+}
+
+std::vector<TrackedAllocation> MemoryTracker::getLargestAllocations(size_t count) const {
+    std::vector<TrackedAllocation> all;
+    {
+        std::lock_guard lock(m_mutex);
+        all.reserve(m_allocations.size());
+        for (const auto& [allocation, tracked] : m_allocations) {
+            all.push_back(tracked);
+        }
+    }
+    count = std::min(count, all.size());
+    std::partial_sort(all.begin(), all.begin() + count, all.end(),
+        [](const TrackedAllocation& a, const TrackedAllocation& b) { return a.size > b.size; });
+    all.resize(count);
+    return all;
+}
+
+size_t MemoryTracker::getTrackedCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_allocations.size();
+}
+
+std::string MemoryTracker::buildStatsJson(bool detailed) const {
+    char* statsString = nullptr;
+    vmaBuildStatsString(m_allocator, &statsString, detailed ? VK_TRUE : VK_FALSE);
+    std::string json = statsString ? statsString : "";
+    vmaFreeStatsString(m_allocator, statsString);
+    return json;
+}
+
+void MemoryTracker::dumpStatsJson(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for VMA stats dump: " + path);
+    }
+    file << this->buildStatsJson(true);
+    std::println("VMA stats written to {}", path);
+}
+
+void MemoryTracker::drawImGuiPanel() {
+    ImGui::Begin("GPU Memory");
+
+    // 1. 各内存堆：用量 / 预算
+    if (ImGui::CollapsingHeader("Heaps", ImGuiTreeNodeFlags_DefaultOpen)) {
+        for (const auto& heap : this->getHeapBudgets()) {
+            float fraction = heap.budget > 0 ? static_cast<float>(static_cast<double>(heap.usage) / static_cast<double>(heap.budget)) : 0.0f;
+            std::string overlay = std::format("{} / {}", formatBytes(heap.usage), formatBytes(heap.budget));
+            ImGui::Text("Heap %u (%s, %s)", heap.heapIndex, heap.deviceLocal ? "device local" : "host", formatBytes(heap.heapSize).c_str());
+            if (fraction > 0.9f) {
+                ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
+                ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay.c_str());
+                ImGui::PopStyleColor();
+            } else {
+                ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay.c_str());
+            }
+            ImGui::Text("  VMA blocks: %s, allocations: %s",
+                        formatBytes(heap.blockBytes).c_str(), formatBytes(heap.allocationBytes).c_str());
+        }
+    }
+
+    // 2. 按分类统计
+    if (ImGui::CollapsingHeader("Categories", ImGuiTreeNodeFlags_DefaultOpen)) {
+        auto totals = this->getCategoryTotals();
+        if (ImGui::BeginTable("categories", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("Size");
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < totals.size(); ++i) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(toString(static_cast<MemoryCategory>(i)));
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(formatBytes(totals[i]).c_str());
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    // 3. Top-N 最大分配
+    if (ImGui::CollapsingHeader("Largest allocations", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::SliderInt("Count", &m_topCount, 1, 50);
+        ImGui::Text("Tracked allocations: %zu", this->getTrackedCount());
+        if (ImGui::BeginTable("largest", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+            ImGui::TableSetupColumn("Name");
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("Size");
+            ImGui::TableHeadersRow();
+            for (const auto& tracked : this->getLargestAllocations(static_cast<size_t>(m_topCount))) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(tracked.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(toString(tracked.category));
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(formatBytes(tracked.size).c_str());
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    // 4. 按需导出 vmaBuildStatsString JSON
+    if (ImGui::Button("Dump VMA stats (JSON)")) {
+        m_lastDumpPath = "vma_stats.json";
+        try {
+            this->dumpStatsJson(m_lastDumpPath);
+        } catch (const std::exception& e) {
+            m_lastDumpPath = e.what();
+        }
+    }
+    if (!m_lastDumpPath.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(m_lastDumpPath.c_str());
+    }
+
+    ImGui::End();
+}
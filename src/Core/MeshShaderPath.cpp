@@ -0,0 +1,265 @@
+#include "Core/MeshShaderPath.h"
+#include "Core/Pipeline.h"
+#include "Scene/Scene.h"
+#include <print>
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t kCullFrustum = 1u << 0;
+    constexpr uint32_t kCullCone = 1u << 1;
+    constexpr uint32_t kCompactVertices = 1u << 2;
+    constexpr uint32_t kTaskGroupSize = 32;     // meshlet.task 的 local_size_x
+    constexpr uint32_t kBindingCount = 3;
+}
+
+MeshShaderPath::MeshShaderPath(Context* context, uint32_t framesInFlight,
+                               const std::vector<vk::DescriptorSetLayout>& sceneLayouts, vk::RenderPass renderPass,
+                               const std::string& taskPath, const std::string& meshPath, const std::string& fragmentPath)
+    : m_context(context)
+    , m_frames(framesInFlight) {
+    if (!m_context->getFeatures().meshShader) {
+        std::println("Mesh shader path unavailable: VK_EXT_mesh_shader is not supported");
+        return;
+    }
+    auto device = m_context->getDevice();
+    const auto limits = m_context->getPhysicalDevice().getProperties().limits;
+    m_storageAlignment = std::max<vk::DeviceSize>(limits.minStorageBufferOffsetAlignment, 1);
+    m_maxStorageRange = limits.maxStorageBufferRange;
+
+    // set 2: meshlet 数组 / 同一缓冲的 32 位字视图 / 顶点缓冲
+    std::array<vk::DescriptorSetLayoutBinding, kBindingCount> bindings;
+    for (uint32_t i = 0; i < kBindingCount; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding{}
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(i == 0 ? vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT
+                                  : vk::ShaderStageFlagBits::eMeshEXT);
+    }
+    m_setLayout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{}.setBindings(bindings));
+
+    std::vector<vk::DescriptorSetLayout> setLayouts = sceneLayouts;
+    setLayouts.push_back(m_setLayout);
+    vk::PushConstantRange pushRange{vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT, 0, sizeof(MeshParams)};
+    m_pipelineLayout = device.createPipelineLayout(
+        vk::PipelineLayoutCreateInfo{}.setSetLayouts(setLayouts).setPushConstantRanges(pushRange));
+
+    // 着色器未编译（没有 glslc）时只禁用该路径
+    try {
+        this->createPipeline(sceneLayouts, renderPass, taskPath, meshPath, fragmentPath);
+        std::println("Mesh shader path ready");
+    } catch (const std::exception& e) {
+        std::println("Warning: mesh shader path unavailable: {}", e.what());
+    }
+}
+
+MeshShaderPath::~MeshShaderPath() {
+    // 此时设备已空闲（Renderer 析构时 waitIdle）
+    auto device = m_context->getDevice();
+    for (auto& frame : m_frames) {
+        if (frame.pool) device.destroyDescriptorPool(frame.pool);
+    }
+    if (m_pipeline) device.destroyPipeline(m_pipeline);
+    if (m_pipelineLayout) device.destroyPipelineLayout(m_pipelineLayout);
+    if (m_setLayout) device.destroyDescriptorSetLayout(m_setLayout);
+}
+
+void MeshShaderPath::createPipeline(const std::vector<vk::DescriptorSetLayout>& sceneLayouts, vk::RenderPass renderPass,
+                                    const std::string& taskPath, const std::string& meshPath, const std::string& fragmentPath) {
+    static_assert(sizeof(MeshParams) <= 128, "push constants must fit the guaranteed 128 bytes");
+    auto device = m_context->getDevice();
+    std::array<vk::ShaderModule, 3> modules{};
+    try {
+        modules[0] = PipelineManager::createShaderModule(m_context, taskPath);
+        modules[1] = PipelineManager::createShaderModule(m_context, meshPath);
+        modules[2] = PipelineManager::createShaderModule(m_context, fragmentPath);
+    } catch (...) {
+        for (auto module : modules) {
+            if (module) device.destroyShaderModule(module);
+        }
+        throw;
+    }
+
+    std::array<vk::PipelineShaderStageCreateInfo, 3> shaderStages{
+        vk::PipelineShaderStageCreateInfo{}.setStage(vk::ShaderStageFlagBits::eTaskEXT).setModule(modules[0]).setPName("main"),
+        vk::PipelineShaderStageCreateInfo{}.setStage(vk::ShaderStageFlagBits::eMeshEXT).setModule(modules[1]).setPName("main"),
+        vk::PipelineShaderStageCreateInfo{}.setStage(vk::ShaderStageFlagBits::eFragment).setModule(modules[2]).setPName("main")
+    };
+
+    // 视口与裁剪为动态状态（主通道每帧设置），swapchain 重建时不需要重建管线
+    vk::PipelineViewportStateCreateInfo viewportState{};
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+    const std::array<vk::DynamicState, 2> dynamicStates{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+    vk::PipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.setDynamicStates(dynamicStates);
+
+    // 光栅化、深度与混合状态与主管线（PipelineManager）一致
+    vk::PipelineRasterizationStateCreateInfo rasterizer;
+    rasterizer.setDepthClampEnable(false)
+            .setRasterizerDiscardEnable(false)
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setLineWidth(1.0f)
+            .setCullMode(vk::CullModeFlagBits::eNone)
+            .setFrontFace(vk::FrontFace::eCounterClockwise)
+            .setDepthBiasEnable(false);
+
+    vk::PipelineMultisampleStateCreateInfo multisampling;
+    multisampling.setSampleShadingEnable(false)
+                .setRasterizationSamples(vk::SampleCountFlagBits::e1)
+                .setMinSampleShading(1.0f);
+
+    vk::PipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.setDepthTestEnable(VK_TRUE)
+            .setDepthWriteEnable(VK_TRUE)
+            .setDepthCompareOp(vk::CompareOp::eLess)
+            .setDepthBoundsTestEnable(VK_FALSE)
+            .setStencilTestEnable(VK_FALSE)
+            .setMinDepthBounds(0.0f)
+            .setMaxDepthBounds(1.0f);
+
+    vk::PipelineColorBlendAttachmentState colorBlendAttachment;
+    colorBlendAttachment.setColorWriteMask(
+        vk::ColorComponentFlagBits::eR |
+        vk::ColorComponentFlagBits::eG |
+        vk::ColorComponentFlagBits::eB |
+        vk::ColorComponentFlagBits::eA)
+        .setBlendEnable(false);
+
+    vk::PipelineColorBlendStateCreateInfo colorBlending;
+    colorBlending.setLogicOpEnable(false)
+                .setAttachments(colorBlendAttachment);
+
+    // 网格着色器管线没有顶点输入与输入装配状态
+    vk::GraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.setStages(shaderStages);
+    pipelineInfo.pVertexInputState = nullptr;
+    pipelineInfo.pInputAssemblyState = nullptr;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+
+    auto result = device.createGraphicsPipeline(nullptr, pipelineInfo);
+    for (auto module : modules) {
+        device.destroyShaderModule(module);
+    }
+    if (result.result != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to create mesh shader pipeline!");
+    }
+    m_pipeline = result.value;
+}
+
+void MeshShaderPath::prepare(const Scene& scene, uint32_t frameIndex, const glm::vec3& cameraPosition, const ClusterCullSettings& settings) {
+    m_draws.clear();
+    m_stats = MeshShaderStats{};
+    if (!this->isEnabled()) {
+        return;
+    }
+
+    std::vector<const Renderable*> candidates;
+    for (const auto& renderable : scene.getRenderables()) {
+        const Mesh& mesh = renderable->getMesh();
+        if (mesh.getLod(renderable->getLod()).meshletCount == 0 || !mesh.hasMeshletLocalData()) continue;
+        candidates.push_back(renderable.get());
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    // 该槽位上一次的提交已经完成，描述符池可以直接重置或重建
+    auto device = m_context->getDevice();
+    FrameResources& frame = m_frames.at(frameIndex);
+    const uint32_t setCount = static_cast<uint32_t>(candidates.size());
+    if (setCount > frame.poolCapacity) {
+        if (frame.pool) device.destroyDescriptorPool(frame.pool);
+        frame.poolCapacity = std::bit_ceil(std::max(setCount, 16u));
+        vk::DescriptorPoolSize size{vk::DescriptorType::eStorageBuffer, frame.poolCapacity * kBindingCount};
+        frame.pool = device.createDescriptorPool(
+            vk::DescriptorPoolCreateInfo{}.setMaxSets(frame.poolCapacity).setPoolSizes(size));
+    } else {
+        device.resetDescriptorPool(frame.pool);
+    }
+    std::vector<vk::DescriptorSetLayout> layouts(setCount, m_setLayout);
+    std::vector<vk::DescriptorSet> sets = device.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo{}.setDescriptorPool(frame.pool).setSetLayouts(layouts));
+
+    // 竞技场整理后顶点缓冲与区间都会变化，所以每帧重写（GeometryArena::update 已在本帧之前执行）
+    const vk::Buffer vertexBuffer = m_context->getGeometryArena()->getVertexBuffer();
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const Renderable& renderable = *candidates[i];
+        const Mesh& mesh = renderable.getMesh();
+        const GeometryRange& range = mesh.getRange();
+
+        // 顶点缓冲从网格区间所在的对齐位置绑定，整个竞技场超过 maxStorageBufferRange 时也能访问
+        const vk::DeviceSize first = static_cast<vk::DeviceSize>(range.vertexOffset) * range.vertexStride;
+        const vk::DeviceSize bindOffset = first / m_storageAlignment * m_storageAlignment;
+        const vk::DeviceSize bindRange = first - bindOffset + static_cast<vk::DeviceSize>(range.vertexCount) * range.vertexStride;
+        if (bindRange > m_maxStorageRange) continue;   // 单个网格超出存储缓冲范围时走顶点输入路径
+
+        std::array<vk::DescriptorBufferInfo, kBindingCount> infos{
+            vk::DescriptorBufferInfo{mesh.getMeshletBuffer(), 0, VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{mesh.getMeshletBuffer(), 0, VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{vertexBuffer, bindOffset, bindRange}
+        };
+        std::array<vk::WriteDescriptorSet, kBindingCount> writes;
+        for (uint32_t b = 0; b < kBindingCount; b++) {
+            writes[b] = vk::WriteDescriptorSet{}
+                .setDstSet(sets[i])
+                .setDstBinding(b)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&infos[b]);
+        }
+        device.updateDescriptorSets(writes, nullptr);
+
+        // 包围体在反量化之前的模型空间，用 Renderable 自身的模型矩阵（与 ClusterCuller 一致）
+        const glm::mat4& model = renderable.getTransform().model;
+        const glm::mat3 linear(model);
+        const float maxScale = std::max({glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2])});
+        const MeshLod& lod = mesh.getLod(renderable.getLod());
+
+        DrawData draw;
+        draw.set = sets[i];
+        draw.params.model = model;
+        draw.params.cameraPosition = glm::vec4(glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f)), maxScale);
+        draw.params.meshletCount = lod.meshletCount;
+        draw.params.firstMeshlet = lod.firstMeshlet;
+        draw.params.vertexBase = static_cast<uint32_t>((first - bindOffset) / sizeof(uint32_t));
+        draw.params.flags = (settings.frustum ? kCullFrustum : 0)
+                          | (mesh.getVertexFormat() == VertexFormat::Compact ? kCompactVertices : 0);
+        // 镜像变换翻转了环绕方向，模型空间的背面测试不再成立
+        if (settings.cone && glm::determinant(linear) > 0.0f) {
+            draw.params.flags |= kCullCone;
+        }
+        m_draws[renderable.getObjectIndex()] = draw;
+
+        m_stats.meshes++;
+        m_stats.meshletsSubmitted += lod.meshletCount;
+        m_stats.trianglesSubmitted += lod.indexCount / 3;
+    }
+}
+
+bool MeshShaderPath::draw(vk::CommandBuffer commandBuffer, vk::DescriptorSet frameSet, vk::DescriptorSet objectSet,
+                          const Renderable& renderable) const {
+    auto it = m_draws.find(renderable.getObjectIndex());
+    if (it == m_draws.end()) {
+        return false;
+    }
+    const DrawData& draw = it->second;
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
+    const std::array<vk::DescriptorSet, 3> sets{frameSet, objectSet, draw.set};
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, sets, nullptr);
+    commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT,
+                                0, sizeof(MeshParams), &draw.params);
+    m_context->drawMeshTasks(commandBuffer, (draw.params.meshletCount + kTaskGroupSize - 1) / kTaskGroupSize);
+    return true;
+}
@@ -0,0 +1,555 @@
+#include "Core/MipGenerator.h"
+#include "Core/Context.h"
+#include "Core/Pipeline.h"
+#include "Core/UploadEngine.h"
+#include "Core/SamplerCache.h"
+#include "Core/MemoryTracker.h"
+#include <print>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // 与 spd_downsample.comp 的 push constant 块一致
+    struct SpdParams {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipCount = 0;
+        uint32_t srgb = 0;
+        uint32_t counterIndex = 0;
+        uint32_t groupCount = 0;
+    };
+    static_assert(sizeof(SpdParams) == 24, "must match the shader's push constant block");
+
+    constexpr uint32_t kMaxStorageLevels = 12;  // mips[12]
+    constexpr uint32_t kTileSize = 64;          // 每个工作组处理的 mip 0 区域
+
+    vk::ImageSubresourceRange colorRange(uint32_t baseMip, uint32_t mipCount) {
+        return vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, baseMip, mipCount, 0, 1};
+    }
+
+    uint32_t getGroupCount(uint32_t size) {
+        return (size + kTileSize - 1) / kTileSize;
+    }
+}
+
+MipGenerator::MipGenerator(Context* context, const std::string& shaderPath)
+    : m_context(context) {
+    auto device = m_context->getDevice();
+    auto physicalDevice = m_context->getPhysicalDevice();
+
+    // 有独立计算队列族时在异步计算队列上生成，与图形帧并行
+    const uint32_t graphicsFamily = m_context->getGraphicsQueueFamily();
+    m_async = m_context->hasComputeQueue() && m_context->getComputeQueueFamily() != graphicsFamily;
+    m_queue = m_async ? m_context->getComputeQueue() : m_context->getGraphicsQueue();
+    m_queueFamily = m_async ? m_context->getComputeQueueFamily() : graphicsFamily;
+
+    try {
+        vk::SemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+        typeInfo.initialValue = 0;
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.pNext = &typeInfo;
+        m_timeline = device.createSemaphore(semaphoreInfo);
+    } catch (const vk::SystemError& err) {
+        throw std::runtime_error("Failed to create mip generation timeline semaphore: " + std::string(err.what()));
+    }
+
+    // set 0: 源（mip 0）/ 1 ~ 12 级存储视图 / 计数
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings{
+        vk::DescriptorSetLayoutBinding{0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute},
+        vk::DescriptorSetLayoutBinding{1, vk::DescriptorType::eStorageImage, kMaxStorageLevels, vk::ShaderStageFlagBits::eCompute},
+        vk::DescriptorSetLayoutBinding{2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute}
+    };
+    m_setLayout = device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{}.setBindings(bindings));
+
+    vk::PushConstantRange pushRange{vk::ShaderStageFlagBits::eCompute, 0, sizeof(SpdParams)};
+    m_pipelineLayout = device.createPipelineLayout(
+        vk::PipelineLayoutCreateInfo{}.setSetLayouts(m_setLayout).setPushConstantRanges(pushRange));
+
+    m_commandPool = device.createCommandPool(vk::CommandPoolCreateInfo{}
+        .setFlags(vk::CommandPoolCreateFlagBits::eTransient)
+        .setQueueFamilyIndex(m_queueFamily));
+
+    // 源只用 texelFetch 读取，采样器参数不影响结果
+    m_sampler = m_context->getSamplerCache()->getSampler(vk::SamplerCreateInfo{}
+        .setMagFilter(vk::Filter::eNearest)
+        .setMinFilter(vk::Filter::eNearest)
+        .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+        .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+        .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+        .setMaxLod(0.0f));
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = kMaxJobsPerBatch * sizeof(uint32_t);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    VkBuffer buffer;
+    if (vmaCreateBuffer(m_context->getVmaAllocator(), &bufferInfo, &allocInfo, &buffer, &m_counterAllocation, nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mip generation counter buffer!");
+    }
+    m_counterBuffer = buffer;
+    m_context->getMemoryTracker()->track(m_counterAllocation, "MipGenerator [counters]", MemoryCategory::Other);
+
+    // RGBA8 UNORM 必须支持存储图像；sRGB 图像需要以 MUTABLE_FORMAT | EXTENDED_USAGE 创建才能带 STORAGE 用途
+    const auto unormFeatures = physicalDevice.getFormatProperties(vk::Format::eR8G8B8A8Unorm).optimalTilingFeatures;
+    const bool unormStorage = static_cast<bool>(unormFeatures & vk::FormatFeatureFlagBits::eStorageImage);
+    try {
+        physicalDevice.getImageFormatProperties(vk::Format::eR8G8B8A8Srgb, vk::ImageType::e2D, vk::ImageTiling::eOptimal,
+            MipGenerator::getImageUsage() | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst,
+            MipGenerator::getImageCreateFlags(vk::Format::eR8G8B8A8Srgb));
+        m_srgbStorage = true;
+    } catch (const vk::SystemError&) {
+        m_srgbStorage = false;
+    }
+
+    // 着色器未编译（没有 glslc）时退回 blit
+    try {
+        this->createPipeline(shaderPath);
+        m_available = unormStorage;
+        if (!unormStorage) {
+            std::println("Warning: compute mip generation unavailable: R8G8B8A8_UNORM storage images are not supported");
+        }
+    } catch (const std::exception& e) {
+        std::println("Warning: compute mip generation unavailable: {}", e.what());
+    }
+    if (m_available) {
+        std::println("MipGenerator: single-pass compute mips on queue family {}{}{}", m_queueFamily,
+                     m_async ? " (async compute)" : "", m_srgbStorage ? "" : ", sRGB falls back to blit");
+    }
+}
+
+MipGenerator::~MipGenerator() {
+    auto device = m_context->getDevice();
+    if (m_submittedValue > 0) {
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.setSemaphores(m_timeline);
+        waitInfo.setValues(m_submittedValue);
+        (void)device.waitSemaphores(waitInfo, UINT64_MAX);
+    }
+    this->retireSubmissions(m_submittedValue);
+    if (m_counterBuffer) {
+        m_context->getMemoryTracker()->untrack(m_counterAllocation);
+        vmaDestroyBuffer(m_context->getVmaAllocator(), static_cast<VkBuffer>(m_counterBuffer), m_counterAllocation);
+    }
+    device.destroyCommandPool(m_commandPool);
+    if (m_pipeline) device.destroyPipeline(m_pipeline);
+    device.destroyPipelineLayout(m_pipelineLayout);
+    device.destroyDescriptorSetLayout(m_setLayout);
+    device.destroySemaphore(m_timeline);
+}
+
+void MipGenerator::createPipeline(const std::string& shaderPath) {
+    auto device = m_context->getDevice();
+    vk::ShaderModule module = PipelineManager::createShaderModule(m_context, shaderPath);
+    vk::ComputePipelineCreateInfo createInfo{};
+    createInfo.stage = vk::PipelineShaderStageCreateInfo{}
+        .setStage(vk::ShaderStageFlagBits::eCompute)
+        .setModule(module)
+        .setPName("main");
+    createInfo.layout = m_pipelineLayout;
+    auto result = device.createComputePipeline(nullptr, createInfo);
+    device.destroyShaderModule(module);
+    if (result.result != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to create mip generation pipeline!");
+    }
+    m_pipeline = result.value;
+}
+
+bool MipGenerator::supports(vk::Format format, uint32_t width, uint32_t height, uint32_t mipLevels) const {
+    if (!m_available || mipLevels < 2 || std::max(width, height) > kMaxSize) {
+        return false;
+    }
+    return format == vk::Format::eR8G8B8A8Unorm || (format == vk::Format::eR8G8B8A8Srgb && m_srgbStorage);
+}
+
+vk::ImageCreateFlags MipGenerator::getImageCreateFlags(vk::Format format) {
+    // 存储视图用 UNORM 格式；EXTENDED_USAGE 允许 sRGB 图像带上其格式本身不支持的 STORAGE 用途
+    if (format == vk::Format::eR8G8B8A8Srgb) {
+        return vk::ImageCreateFlagBits::eMutableFormat | vk::ImageCreateFlagBits::eExtendedUsage;
+    }
+    return {};
+}
+
+uint64_t MipGenerator::completedValue() const {
+    return m_context->getDevice().getSemaphoreCounterValue(m_timeline);
+}
+
+void MipGenerator::retireSubmissions(uint64_t completedValue) {
+    auto device = m_context->getDevice();
+    while (!m_inFlight.empty() && m_inFlight.front().value <= completedValue) {
+        Submission& submission = m_inFlight.front();
+        device.freeCommandBuffers(m_commandPool, submission.commandBuffer);
+        device.destroyDescriptorPool(submission.pool);
+        for (vk::ImageView view : submission.views) {
+            device.destroyImageView(view);
+        }
+        m_inFlight.pop_front();
+    }
+}
+
+vk::DescriptorPool MipGenerator::createDescriptorPool(uint32_t jobCount) const {
+    std::array<vk::DescriptorPoolSize, 3> sizes{
+        vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, jobCount},
+        vk::DescriptorPoolSize{vk::DescriptorType::eStorageImage, jobCount * kMaxStorageLevels},
+        vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, jobCount}
+    };
+    return m_context->getDevice().createDescriptorPool(
+        vk::DescriptorPoolCreateInfo{}.setMaxSets(jobCount).setPoolSizes(sizes));
+}
+
+void MipGenerator::resetCounters(vk::CommandBuffer commandBuffer) const {
+    // 之前的派发读写完计数后才能清零，清零完成后才能开始新的派发
+    vk::BufferMemoryBarrier2 barrier{};
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite;
+    barrier.dstStageMask = vk::PipelineStageFlagBits2::eTransfer;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = m_counterBuffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setBufferMemoryBarriers(barrier));
+
+    commandBuffer.fillBuffer(m_counterBuffer, 0, VK_WHOLE_SIZE, 0);
+
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    barrier.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite;
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setBufferMemoryBarriers(barrier));
+}
+
+void MipGenerator::recordDispatch(vk::CommandBuffer commandBuffer, const MipJob& job, vk::DescriptorPool pool,
+                                  uint32_t counterIndex, std::vector<vk::ImageView>& views) const {
+    auto device = m_context->getDevice();
+    const uint32_t mipCount = std::min(job.mipLevels - 1, kMaxStorageLevels);
+
+    // 视图只声明各自的用途：sRGB 源视图不支持 STORAGE，UNORM 存储视图不需要 SAMPLED
+    auto createView = [&](vk::Format format, uint32_t level, vk::ImageUsageFlags usage) {
+        vk::ImageViewUsageCreateInfo usageInfo{usage};
+        vk::ImageViewCreateInfo viewInfo{};
+        viewInfo.pNext = &usageInfo;
+        viewInfo.image = job.image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange = colorRange(level, 1);
+        vk::ImageView view = device.createImageView(viewInfo);
+        views.push_back(view);
+        return view;
+    };
+
+    vk::DescriptorImageInfo sourceInfo{m_sampler, createView(job.format, 0, vk::ImageUsageFlagBits::eSampled),
+                                       vk::ImageLayout::eGeneral};
+    // 未使用的数组元素也必须是有效描述符，重复最后一级（着色器不会访问）
+    std::array<vk::DescriptorImageInfo, kMaxStorageLevels> storageInfos;
+    for (uint32_t i = 0; i < kMaxStorageLevels; i++) {
+        if (i < mipCount) {
+            storageInfos[i] = vk::DescriptorImageInfo{nullptr,
+                createView(vk::Format::eR8G8B8A8Unorm, i + 1, vk::ImageUsageFlagBits::eStorage), vk::ImageLayout::eGeneral};
+        } else {
+            storageInfos[i] = storageInfos[mipCount - 1];
+        }
+    }
+    vk::DescriptorBufferInfo counterInfo{m_counterBuffer, 0, VK_WHOLE_SIZE};
+
+    vk::DescriptorSet set = device.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo{}.setDescriptorPool(pool).setSetLayouts(m_setLayout))[0];
+    std::array<vk::WriteDescriptorSet, 3> writes{
+        vk::WriteDescriptorSet{}.setDstSet(set).setDstBinding(0)
+            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler).setImageInfo(sourceInfo),
+        vk::WriteDescriptorSet{}.setDstSet(set).setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageImage).setImageInfo(storageInfos),
+        vk::WriteDescriptorSet{}.setDstSet(set).setDstBinding(2)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(counterInfo)
+    };
+    device.updateDescriptorSets(writes, {});
+
+    SpdParams params{};
+    params.width = job.extent.width;
+    params.height = job.extent.height;
+    params.mipCount = mipCount;
+    params.srgb = job.format == vk::Format::eR8G8B8A8Srgb ? 1u : 0u;
+    params.counterIndex = counterIndex;
+    params.groupCount = getGroupCount(job.extent.width) * getGroupCount(job.extent.height);
+
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, set, {});
+    commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(SpdParams), &params);
+    commandBuffer.dispatch(getGroupCount(job.extent.width), getGroupCount(job.extent.height), 1);
+}
+
+uint64_t MipGenerator::submit(const std::vector<MipJob>& jobs, vk::Semaphore waitSemaphore, uint64_t waitValue) {
+    if (jobs.empty()) {
+        return m_submittedValue;
+    }
+    if (!m_available) {
+        throw std::runtime_error("MipGenerator: compute mip generation is not available!");
+    }
+    this->retireSubmissions(this->completedValue());
+    auto device = m_context->getDevice();
+    const uint32_t graphicsFamily = m_context->getGraphicsQueueFamily();
+    const vk::PipelineStageFlags2 waitStage = vk::PipelineStageFlagBits2::eComputeShader;
+
+    Submission submission;
+    vk::CommandBufferAllocateInfo allocInfo{};
+    allocInfo.level = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.commandBufferCount = 1;
+    submission.commandBuffer = device.allocateCommandBuffers(allocInfo)[0];
+    submission.pool = this->createDescriptorPool(static_cast<uint32_t>(jobs.size()));
+    vk::CommandBuffer commandBuffer = submission.commandBuffer;
+    commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+
+    // 1. acquire：与上传侧的 release 一一对应（TransferDst -> General），同一队列族时上传侧已经转换好布局
+    std::vector<vk::ImageMemoryBarrier2> barriers;
+    for (const MipJob& job : jobs) {
+        if (job.srcQueueFamily == VK_QUEUE_FAMILY_IGNORED || job.srcQueueFamily == m_queueFamily) continue;
+        vk::ImageMemoryBarrier2 acquire{};
+        acquire.srcStageMask = waitStage;
+        acquire.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+        acquire.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eShaderStorageRead
+                              | vk::AccessFlagBits2::eShaderStorageWrite;
+        acquire.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        acquire.newLayout = vk::ImageLayout::eGeneral;
+        acquire.srcQueueFamilyIndex = job.srcQueueFamily;
+        acquire.dstQueueFamilyIndex = m_queueFamily;
+        acquire.image = job.image;
+        acquire.subresourceRange = colorRange(0, job.mipLevels);
+        barriers.push_back(acquire);
+    }
+    if (!barriers.empty()) {
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barriers));
+    }
+
+    // 2. 每张图像一次派发，彼此之间没有依赖；计数用完 kMaxJobsPerBatch 个后清零复用
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+    for (uint32_t i = 0; i < jobs.size(); i++) {
+        if (i % kMaxJobsPerBatch == 0) {
+            this->resetCounters(commandBuffer);
+        }
+        this->recordDispatch(commandBuffer, jobs[i], submission.pool, i % kMaxJobsPerBatch, submission.views);
+        m_stats.images++;
+        m_stats.levels += jobs[i].mipLevels - 1;
+    }
+
+    // 3. General -> 最终布局；在计算队列族上生成时同时 release 给图形队列族（目标阶段由图形侧的 acquire 给出）
+    barriers.clear();
+    for (const MipJob& job : jobs) {
+        vk::ImageMemoryBarrier2 barrier{};
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+        barrier.oldLayout = vk::ImageLayout::eGeneral;
+        barrier.newLayout = job.finalLayout;
+        barrier.image = job.image;
+        barrier.subresourceRange = colorRange(0, job.mipLevels);
+        if (m_queueFamily != graphicsFamily) {
+            barrier.srcQueueFamilyIndex = m_queueFamily;
+            barrier.dstQueueFamilyIndex = graphicsFamily;
+        } else {
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstStageMask = job.dstStage;
+            barrier.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+        }
+        barriers.push_back(barrier);
+    }
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barriers));
+    commandBuffer.end();
+
+    const uint64_t signalValue = m_submittedValue + 1;
+    vk::SemaphoreSubmitInfo waitInfo{waitSemaphore, waitValue, waitStage};
+    vk::SemaphoreSubmitInfo signalInfo{m_timeline, signalValue, vk::PipelineStageFlagBits2::eAllCommands};
+    vk::CommandBufferSubmitInfo commandBufferInfo{commandBuffer};
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.setCommandBufferInfos(commandBufferInfo)
+              .setSignalSemaphoreInfos(signalInfo);
+    if (waitSemaphore) {
+        submitInfo.setWaitSemaphoreInfos(waitInfo);
+    }
+    m_queue.submit2(submitInfo);
+
+    submission.value = signalValue;
+    m_inFlight.push_back(std::move(submission));
+    m_submittedValue = signalValue;
+    m_stats.submissions++;
+    return signalValue;
+}
+
+MipBenchmarkResult MipGenerator::benchmark(uint32_t size, uint32_t iterations) {
+    if (!m_available) {
+        throw std::runtime_error("MipGenerator: compute mip generation is not available!");
+    }
+    auto device = m_context->getDevice();
+    auto physicalDevice = m_context->getPhysicalDevice();
+    const uint32_t graphicsFamily = m_context->getGraphicsQueueFamily();
+    if (physicalDevice.getQueueFamilyProperties()[graphicsFamily].timestampValidBits == 0) {
+        throw std::runtime_error("MipGenerator: graphics queue does not support timestamps!");
+    }
+    // 两条路径在同一个图形队列上比较，排除异步队列的影响。计数缓冲每次使用前都会清零，
+    // 在计算队列族之外使用时不需要所有权转移；但它与（异步计算上的）生成批次共用，
+    // 先等已提交的批次全部完成，否则两个队列会互相清零对方的计数
+    if (m_submittedValue > 0) {
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.setSemaphores(m_timeline);
+        waitInfo.setValues(m_submittedValue);
+        if (device.waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess) {
+            throw std::runtime_error("MipGenerator: failed to wait for pending mip generation!");
+        }
+        this->retireSubmissions(m_submittedValue);
+    }
+
+    MipBenchmarkResult result{};
+    result.size = std::clamp(size, 2u, kMaxSize);
+    result.mipLevels = static_cast<uint32_t>(std::floor(std::log2(result.size))) + 1;
+    result.iterations = std::max(iterations, 1u);
+    const vk::Format format = m_srgbStorage ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+
+    // 1. 测试图像（内容不影响耗时，不上传）
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo.flags = MipGenerator::getImageCreateFlags(format);
+    imageInfo.imageType = vk::ImageType::e2D;
+    imageInfo.format = format;
+    imageInfo.extent = vk::Extent3D{result.size, result.size, 1};
+    imageInfo.mipLevels = result.mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = vk::SampleCountFlagBits::e1;
+    imageInfo.tiling = vk::ImageTiling::eOptimal;
+    imageInfo.usage = MipGenerator::getImageUsage() | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+    imageInfo.sharingMode = vk::SharingMode::eExclusive;
+    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    VkImage image;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    if (vmaCreateImage(m_context->getVmaAllocator(), reinterpret_cast<VkImageCreateInfo*>(&imageInfo),
+                       &allocInfo, &image, &allocation, nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mip benchmark image!");
+    }
+    m_context->getMemoryTracker()->track(allocation, "MipGenerator [benchmark]", MemoryCategory::Texture);
+
+    const uint32_t queryCount = result.iterations * 4;
+    vk::QueryPool queryPool = device.createQueryPool(vk::QueryPoolCreateInfo{}
+        .setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(queryCount));
+    vk::CommandPool commandPool = device.createCommandPool(vk::CommandPoolCreateInfo{}
+        .setFlags(vk::CommandPoolCreateFlagBits::eTransient)
+        .setQueueFamilyIndex(graphicsFamily));
+    vk::CommandBuffer commandBuffer = device.allocateCommandBuffers(vk::CommandBufferAllocateInfo{}
+        .setCommandPool(commandPool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(1))[0];
+    vk::DescriptorPool descriptorPool = this->createDescriptorPool(1);
+    std::vector<vk::ImageView> views;
+
+    ImageUploadDesc blitDesc{};
+    blitDesc.image = image;
+    blitDesc.format = format;
+    blitDesc.extent = imageInfo.extent;
+    blitDesc.mipLevels = result.mipLevels;
+    blitDesc.generateMips = true;
+    MipJob job{};
+    job.image = image;
+    job.format = format;
+    job.extent = vk::Extent2D{result.size, result.size};
+    job.mipLevels = result.mipLevels;
+
+    // 2. 每次迭代：blit 链与单次派发各计时一次，布局转换到 Undefined 的屏障不计入
+    commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    commandBuffer.resetQueryPool(queryPool, 0, queryCount);
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+    auto discard = [&](vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::PipelineStageFlags2 dstStage,
+                       vk::AccessFlags2 dstAccess) {
+        vk::ImageMemoryBarrier2 barrier{};
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eMemoryWrite;
+        barrier.dstStageMask = dstStage;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = colorRange(0, result.mipLevels);
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barrier));
+    };
+    for (uint32_t i = 0; i < result.iterations; i++) {
+        const uint32_t query = i * 4;
+        discard(vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+                vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite);
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, query);
+        UploadEngine::recordMipmaps(commandBuffer, blitDesc);
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, query + 1);
+
+        this->resetCounters(commandBuffer);
+        discard(vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral, vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, query + 2);
+        if (i == 0) {
+            this->recordDispatch(commandBuffer, job, descriptorPool, 0, views);
+        } else {
+            // 描述符集不变，只重新派发
+            commandBuffer.dispatch(getGroupCount(result.size), getGroupCount(result.size), 1);
+        }
+        vk::ImageMemoryBarrier2 toFinal{};
+        toFinal.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+        toFinal.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+        toFinal.dstStageMask = job.dstStage;
+        toFinal.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+        toFinal.oldLayout = vk::ImageLayout::eGeneral;
+        toFinal.newLayout = job.finalLayout;
+        toFinal.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toFinal.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toFinal.image = image;
+        toFinal.subresourceRange = colorRange(0, result.mipLevels);
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(toFinal));
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, query + 3);
+    }
+    commandBuffer.end();
+
+    vk::CommandBufferSubmitInfo commandBufferInfo{commandBuffer};
+    m_context->getGraphicsQueue().submit2(vk::SubmitInfo2{}.setCommandBufferInfos(commandBufferInfo));
+    m_context->getGraphicsQueue().waitIdle();
+
+    // 3. 读回时间戳：每次迭代 [blit 开始, blit 结束, 派发开始, 派发结束]
+    auto timestamps = device.getQueryPoolResults<uint64_t>(queryPool, 0, queryCount, queryCount * sizeof(uint64_t),
+                                                           sizeof(uint64_t), vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+    if (timestamps.result == vk::Result::eSuccess) {
+        const double period = physicalDevice.getProperties().limits.timestampPeriod;
+        double blitNs = 0.0;
+        double computeNs = 0.0;
+        for (uint32_t i = 0; i < result.iterations; i++) {
+            const uint64_t* t = timestamps.value.data() + i * 4;
+            blitNs += static_cast<double>(t[1] - t[0]) * period;
+            computeNs += static_cast<double>(t[3] - t[2]) * period;
+        }
+        result.blitMs = blitNs * 1e-6 / result.iterations;
+        result.computeMs = computeNs * 1e-6 / result.iterations;
+    }
+    // blit 链每级一次 blit + 两个屏障，末级再一个屏障；计算路径一次派发 + 一个屏障
+    result.blitCommands = (result.mipLevels - 1) * 3 + 1;
+    result.computeCommands = 2;
+
+    for (vk::ImageView view : views) {
+        device.destroyImageView(view);
+    }
+    device.destroyDescriptorPool(descriptorPool);
+    device.destroyCommandPool(commandPool);
+    device.destroyQueryPool(queryPool);
+    m_context->getMemoryTracker()->untrack(allocation);
+    vmaDestroyImage(m_context->getVmaAllocator(), image, allocation);
+    if (timestamps.result != vk::Result::eSuccess) {
+        throw std::runtime_error("MipGenerator: failed to read benchmark timestamps!");
+    }
+
+    std::println("MipGenerator benchmark: {}x{} {} levels, blit {:.3f} ms ({} commands), compute {:.3f} ms ({} commands)",
+                 result.size, result.size, result.mipLevels, result.blitMs, result.blitCommands,
+                 result.computeMs, result.computeCommands);
+    m_benchmark = result;
+    return result;
+}
@@ -28,9 +28,11 @@ PipelineManager::PipelineManager(Context* context)
 
 PipelineManager::~PipelineManager() {
     auto device = m_context->getDevice();
-    for (auto& [type, pipeline] : m_pipelines) {
-        if (pipeline) {
-            device.destroyPipeline(pipeline);
+    for (auto& [type, variants] : m_pipelines) {
+        for (auto pipeline : variants) {
+            if (pipeline) {
+                device.destroyPipeline(pipeline);
+            }
         }
     }
     m_pipelines.clear();
@@ -42,7 +44,7 @@ PipelineManager::~PipelineManager() {
     m_pipelinelayout.clear();
     std::println("PipelineManager destroyed");
 }
-vk::ShaderModule PipelineManager::createShaderModule(const std::string &filepath){
+vk::ShaderModule PipelineManager::createShaderModule(Context* context, const std::string &filepath){
     auto code = Utils::readFile(filepath);
     if (code.size() % 4 != 0) {
         throw std::runtime_error("Shader file size is not a multiple of 4: " + filepath);
@@ -51,7 +53,7 @@ vk::ShaderModule PipelineManager::createShaderModule(const std::string &filepath
     createInfo.codeSize = code.size();
     createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
     try {
-        auto shaderModule = m_context->getDevice().createShaderModule(createInfo);
+        auto shaderModule = context->getDevice().createShaderModule(createInfo);
         std::println("Shader module created: {}", filepath);
         return shaderModule;
     } catch (const vk::SystemError& err) {
@@ -65,22 +67,24 @@ void PipelineManager::createGraphicsPipeline(
     vk::Extent2D swapchainExtent,
     vk::Format swapchainFormat,
     vk::RenderPass renderPass,
-    std::vector<vk::DescriptorSetLayout> setLayouts) {
+    std::vector<vk::DescriptorSetLayout> setLayouts,
+    VertexFormat vertexFormat) {
 
-    std::println("Creating graphics pipeline for type {}", static_cast<int>(type));
+    std::println("Creating graphics pipeline for type {} (vertex format {})", static_cast<int>(type), static_cast<int>(vertexFormat));
 
     vk::ShaderModule vertShaderModule;
     vk::ShaderModule fragShaderModule;
 
     try {
-        vertShaderModule = this->createShaderModule(spvPath[0]);
-        fragShaderModule = this->createShaderModule(spvPath[1]);
-
-        // 创建 pipeline layout
-        vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.setSetLayouts(setLayouts);
-
-        m_pipelinelayout[type] = m_context->getDevice().createPipelineLayout(pipelineLayoutInfo);
+        vertShaderModule = PipelineManager::createShaderModule(m_context, spvPath[0]);
+        fragShaderModule = PipelineManager::createShaderModule(m_context, spvPath[1]);
+
+        // 创建 pipeline layout（同一类型的各顶点格式变体共用）
+        if (!m_pipelinelayout[type]) {
+            vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+            pipelineLayoutInfo.setSetLayouts(setLayouts);
+            m_pipelinelayout[type] = m_context->getDevice().createPipelineLayout(pipelineLayoutInfo);
+        }
 
         // 顶点着色器阶段
         vk::PipelineShaderStageCreateInfo vertexShaderStageInfo{};
@@ -99,30 +103,12 @@ void PipelineManager::createGraphicsPipeline(
             fragmentShaderStageInfo
         };
 
-        // 顶点输入
-        vk::VertexInputBindingDescription bindingDescription{};
-        bindingDescription.binding = 0;
-        bindingDescription.stride = sizeof(Vertex);
-        bindingDescription.inputRate = vk::VertexInputRate::eVertex;
-
-        std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions;
-        // 位置 (location = 0)
-        attributeDescriptions[0].binding = 0;
-        attributeDescriptions[0].location = 0;
-        attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
-        attributeDescriptions[0].offset = offsetof(Vertex, pos);
-
-        // 法线 (location = 1)
-        attributeDescriptions[1].binding = 0;
-        attributeDescriptions[1].location = 1;
-        attributeDescriptions[1].format = vk::Format::eR32G32B32Sfloat;
-        attributeDescriptions[1].offset = offsetof(Vertex, normal);
-
-        // 纹理 (location = 2)
-        attributeDescriptions[2].binding = 0;
-        attributeDescriptions[2].location = 2;
-        attributeDescriptions[2].format = vk::Format::eR32G32Sfloat;
-        attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
+        // 顶点输入（与 Mesh 上传的顶点格式一致）
+        const bool compact = vertexFormat == VertexFormat::Compact;
+        const vk::VertexInputBindingDescription bindingDescription = compact ? CompactVertex::getBindingDescription()
+                                                                             : Vertex::getBindingDescription();
+        const std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions = compact ? CompactVertex::getAttributeDescriptions()
+                                                                                                 : Vertex::getAttributeDescriptions();
 
         vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
         vertexInputInfo.setVertexBindingDescriptions(bindingDescription)
@@ -230,7 +216,7 @@ void PipelineManager::createGraphicsPipeline(
             throw std::runtime_error("Failed to create graphics pipeline!");
         }
 
-        m_pipelines[type] = result.value;
+        m_pipelines[type][static_cast<size_t>(vertexFormat)] = result.value;
 
         // ✅ 管线创建后立即销毁 shader modules
         m_context->getDevice().destroyShaderModule(vertShaderModule);
@@ -254,6 +240,6 @@ vk::PipelineLayout PipelineManager::getPipelineLayout(PipelineType type) {
     return m_pipelinelayout[type];
 }
 
-vk::Pipeline PipelineManager::getPipeline(PipelineType type) {
-    return m_pipelines[type];
+vk::Pipeline PipelineManager::getPipeline(PipelineType type, VertexFormat vertexFormat) {
+    return m_pipelines[type][static_cast<size_t>(vertexFormat)];
 }
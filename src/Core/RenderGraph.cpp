@@ -0,0 +1,803 @@
+#include "Core/RenderGraph.h"
+#include <queue>
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <print>
+#include <stdexcept>
+
+namespace {
+    struct AccessInfo {
+        vk::PipelineStageFlags2 stage;
+        vk::AccessFlags2 access;
+        vk::ImageLayout layout;
+        bool write;
+    };
+
+    AccessInfo getAccessInfo(RGAccess access) {
+        using Stage = vk::PipelineStageFlagBits2;
+        using Access = vk::AccessFlagBits2;
+        using Layout = vk::ImageLayout;
+        switch (access) {
+            case RGAccess::ColorAttachmentWrite:
+                return {Stage::eColorAttachmentOutput, Access::eColorAttachmentWrite | Access::eColorAttachmentRead, Layout::eColorAttachmentOptimal, true};
+            case RGAccess::DepthAttachmentWrite:
+                return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+                        Access::eDepthStencilAttachmentWrite | Access::eDepthStencilAttachmentRead, Layout::eDepthStencilAttachmentOptimal, true};
+            case RGAccess::DepthAttachmentRead:
+                return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead, Layout::eDepthStencilReadOnlyOptimal, false};
+            case RGAccess::SampledRead:
+                return {Stage::eFragmentShader, Access::eShaderSampledRead, Layout::eShaderReadOnlyOptimal, false};
+            case RGAccess::ComputeSampledRead:
+                return {Stage::eComputeShader, Access::eShaderSampledRead, Layout::eShaderReadOnlyOptimal, false};
+            case RGAccess::StorageImageRead:
+                return {Stage::eComputeShader, Access::eShaderStorageRead, Layout::eGeneral, false};
+            case RGAccess::StorageImageWrite:
+                return {Stage::eComputeShader, Access::eShaderStorageWrite, Layout::eGeneral, true};
+            case RGAccess::StorageBufferRead:
+                return {Stage::eComputeShader, Access::eShaderStorageRead, Layout::eUndefined, false};
+            case RGAccess::StorageBufferWrite:
+                return {Stage::eComputeShader, Access::eShaderStorageWrite, Layout::eUndefined, true};
+            case RGAccess::VertexBufferRead:
+                return {Stage::eVertexAttributeInput, Access::eVertexAttributeRead, Layout::eUndefined, false};
+            case RGAccess::IndexBufferRead:
+                return {Stage::eIndexInput, Access::eIndexRead, Layout::eUndefined, false};
+            case RGAccess::IndirectBufferRead:
+                return {Stage::eDrawIndirect, Access::eIndirectCommandRead, Layout::eUndefined, false};
+            case RGAccess::UniformBufferRead:
+                return {Stage::eVertexShader | Stage::eFragmentShader, Access::eUniformRead, Layout::eUndefined, false};
+            case RGAccess::TransferSrc:
+                return {Stage::eTransfer, Access::eTransferRead, Layout::eTransferSrcOptimal, false};
+            case RGAccess::TransferDst:
+                return {Stage::eTransfer, Access::eTransferWrite, Layout::eTransferDstOptimal, true};
+        }
+        throw std::runtime_error("Unknown render graph access type");
+    }
+
+    const char* toString(RGAccess access) {
+        switch (access) {
+            case RGAccess::ColorAttachmentWrite: return "ColorAttachmentWrite";
+            case RGAccess::DepthAttachmentWrite: return "DepthAttachmentWrite";
+            case RGAccess::DepthAttachmentRead:  return "DepthAttachmentRead";
+            case RGAccess::SampledRead:          return "SampledRead";
+            case RGAccess::ComputeSampledRead:   return "ComputeSampledRead";
+            case RGAccess::StorageImageRead:     return "StorageImageRead";
+            case RGAccess::StorageImageWrite:    return "StorageImageWrite";
+            case RGAccess::StorageBufferRead:    return "StorageBufferRead";
+            case RGAccess::StorageBufferWrite:   return "StorageBufferWrite";
+            case RGAccess::VertexBufferRead:     return "VertexBufferRead";
+            case RGAccess::IndexBufferRead:      return "IndexBufferRead";
+            case RGAccess::IndirectBufferRead:   return "IndirectBufferRead";
+            case RGAccess::UniformBufferRead:    return "UniformBufferRead";
+            case RGAccess::TransferSrc:          return "TransferSrc";
+            case RGAccess::TransferDst:          return "TransferDst";
+        }
+        return "Unknown";
+    }
+
+    bool isDepthFormat(vk::Format format) {
+        return format == vk::Format::eD32Sfloat || format == vk::Format::eD32SfloatS8Uint ||
+               format == vk::Format::eD24UnormS8Uint || format == vk::Format::eD16Unorm;
+    }
+
+    // 计算队列支持的管线阶段
+    constexpr vk::PipelineStageFlags2 kComputeQueueStages =
+        vk::PipelineStageFlagBits2::eNone | vk::PipelineStageFlagBits2::eTopOfPipe | vk::PipelineStageFlagBits2::eBottomOfPipe |
+        vk::PipelineStageFlagBits2::eAllCommands | vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect |
+        vk::PipelineStageFlagBits2::eTransfer | vk::PipelineStageFlagBits2::eCopy | vk::PipelineStageFlagBits2::eClear |
+        vk::PipelineStageFlagBits2::eHost;
+
+    bool isComputeQueueCompatible(vk::PipelineStageFlags2 stages) {
+        return !(stages & ~kComputeQueueStages);
+    }
+
+    // 导入资源的初始状态可能来自图形阶段，在计算队列上用 ALL_COMMANDS / MEMORY_WRITE 代替
+    RGState toComputeQueueState(RGState state) {
+        if (!isComputeQueueCompatible(state.stage)) {
+            state.stage = vk::PipelineStageFlagBits2::eAllCommands;
+            state.access = state.access ? vk::AccessFlags2(vk::AccessFlagBits2::eMemoryWrite) : vk::AccessFlags2{};
+        }
+        return state;
+    }
+
+    template<typename T>
+    void hashCombine(size_t& seed, const T& value) {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+}
+
+// ---------------- RenderGraphBuilder ----------------
+
+RGHandle RenderGraphBuilder::read(RGHandle resource, RGAccess access) {
+    if (resource >= m_graph.m_resources.size()) {
+        throw std::runtime_error("RenderGraph: invalid resource handle in read()");
+    }
+    if (getAccessInfo(access).write) {
+        throw std::runtime_error(std::format("RenderGraph: {} is a write access, use write()", toString(access)));
+    }
+    m_graph.m_passes[m_passIndex].accesses.push_back({resource, access, false, std::nullopt});
+    return resource;
+}
+
+RGHandle RenderGraphBuilder::write(RGHandle resource, RGAccess access, std::optional<vk::ImageLayout> endLayout) {
+    if (resource >= m_graph.m_resources.size()) {
+        throw std::runtime_error("RenderGraph: invalid resource handle in write()");
+    }
+    m_graph.m_passes[m_passIndex].accesses.push_back({resource, access, true, endLayout});
+    return resource;
+}
+
+void RenderGraphBuilder::setSideEffect() {
+    m_graph.m_passes[m_passIndex].sideEffect = true;
+}
+
+void RenderGraphBuilder::setAsyncCompute() {
+    m_graph.m_passes[m_passIndex].queue = RGQueue::AsyncCompute;
+}
+
+// ---------------- RenderGraph ----------------
+
+RenderGraph::RenderGraph(Context* context, RenderTargetPool* pool)
+    : m_context(context), m_pool(pool) {
+}
+
+RenderGraph::~RenderGraph() {
+    this->invalidate();
+}
+
+void RenderGraph::reset() {
+    m_resources.clear();
+    m_passes.clear();
+}
+
+void RenderGraph::invalidate() {
+    if (m_pool && !m_transientTargets.empty()) {
+        m_pool->releaseAliasedTargets();
+    }
+    m_transientTargets.clear();
+    m_schedule.clear();
+    m_finalBarriers.clear();
+    m_computeReleaseBarriers.clear();
+    m_graphicsWaitStage = {};
+    m_computeWaitsForGraphics = false;
+    m_edges.clear();
+    m_culledPasses.clear();
+    m_lifetimes.clear();
+    m_compiled = false;
+    m_compiledHash = 0;
+}
+
+RGHandle RenderGraph::importImage(const std::string& name, vk::Image image, vk::ImageView view, const RenderTargetDesc& desc,
+                                  const RGState& initialState, std::optional<vk::ImageLayout> finalLayout) {
+    Resource resource;
+    resource.name = name;
+    resource.type = RGResourceType::Image;
+    resource.imported = true;
+    resource.output = finalLayout.has_value();
+    resource.desc = desc;
+    resource.image = image;
+    resource.view = view;
+    resource.aspect = isDepthFormat(desc.format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+    resource.finalLayout = finalLayout;
+    resource.initialState = initialState;
+    m_resources.push_back(std::move(resource));
+    return static_cast<RGHandle>(m_resources.size() - 1);
+}
+
+RGHandle RenderGraph::importBuffer(const std::string& name, vk::Buffer buffer, vk::DeviceSize size, const RGState& initialState) {
+    Resource resource;
+    resource.name = name;
+    resource.type = RGResourceType::Buffer;
+    resource.imported = true;
+    resource.buffer = buffer;
+    resource.size = size;
+    resource.initialState = initialState;
+    m_resources.push_back(std::move(resource));
+    return static_cast<RGHandle>(m_resources.size() - 1);
+}
+
+RGHandle RenderGraph::createImage(const std::string& name, const RenderTargetDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.type = RGResourceType::Image;
+    resource.desc = desc;
+    resource.aspect = isDepthFormat(desc.format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+    // transient 图像每帧内容都被丢弃；它可能与别的资源共享内存，首次使用前需等待之前的所有工作
+    resource.initialState = RGState{
+        .stage = vk::PipelineStageFlagBits2::eAllCommands,
+        .access = vk::AccessFlagBits2::eNone,
+        .layout = vk::ImageLayout::eUndefined
+    };
+    m_resources.push_back(std::move(resource));
+    return static_cast<RGHandle>(m_resources.size() - 1);
+}
+
+void RenderGraph::addPass(const std::string& name,
+                          const std::function<void(RenderGraphBuilder&)>& setup,
+                          RGExecuteFn execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+
+    RenderGraphBuilder builder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+    setup(builder);
+}
+
+size_t RenderGraph::computeTopologyHash() const {
+    // 只包含结构信息（导入图像的句柄每帧都可能不同，例如 swapchain image）
+    size_t seed = 0;
+    hashCombine(seed, m_asyncComputeEnabled);
+    for (const auto& resource : m_resources) {
+        hashCombine(seed, resource.name);
+        hashCombine(seed, static_cast<uint32_t>(resource.type));
+        hashCombine(seed, resource.imported);
+        hashCombine(seed, resource.output);
+        hashCombine(seed, static_cast<uint32_t>(resource.desc.format));
+        hashCombine(seed, resource.desc.extent.width);
+        hashCombine(seed, resource.desc.extent.height);
+        hashCombine(seed, static_cast<uint32_t>(resource.desc.usage));
+        hashCombine(seed, static_cast<uint32_t>(resource.desc.samples));
+        hashCombine(seed, static_cast<uint64_t>(resource.initialState.stage));
+        hashCombine(seed, static_cast<uint64_t>(resource.initialState.access));
+        hashCombine(seed, static_cast<uint32_t>(resource.initialState.layout));
+        hashCombine(seed, resource.finalLayout ? static_cast<int64_t>(*resource.finalLayout) : -1);
+    }
+    for (const auto& pass : m_passes) {
+        hashCombine(seed, pass.name);
+        hashCombine(seed, pass.sideEffect);
+        hashCombine(seed, static_cast<uint32_t>(pass.queue));
+        for (const auto& record : pass.accesses) {
+            hashCombine(seed, record.resource);
+            hashCombine(seed, static_cast<uint32_t>(record.access));
+            hashCombine(seed, record.write);
+            hashCombine(seed, record.endLayout ? static_cast<int64_t>(*record.endLayout) : -1);
+        }
+    }
+    return seed;
+}
+
+void RenderGraph::cullPasses() {
+    // 逆序遍历：一个 pass 只有在有副作用、或写入了后续需要的资源时才保留
+    std::vector<bool> needed(m_resources.size(), false);
+    m_culledPasses.assign(m_passes.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        needed[i] = m_resources[i].output;
+    }
+    for (size_t p = m_passes.size(); p-- > 0;) {
+        Pass& pass = m_passes[p];
+        bool keep = pass.sideEffect;
+        for (const auto& record : pass.accesses) {
+            if (record.write && needed[record.resource]) {
+                keep = true;
+                break;
+            }
+        }
+        pass.culled = !keep;
+        m_culledPasses[p] = !keep;
+        if (!keep) continue;
+        for (const auto& record : pass.accesses) {
+            if (!record.write) needed[record.resource] = true;
+        }
+    }
+}
+
+std::vector<uint32_t> RenderGraph::sortPasses() {
+    // 1. 按声明顺序建立 RAW / WAR / WAW 依赖边
+    const uint32_t passCount = static_cast<uint32_t>(m_passes.size());
+    std::vector<std::vector<uint32_t>> successors(passCount);
+    std::vector<uint32_t> inDegree(passCount, 0);
+    std::vector<uint32_t> lastWriter(m_resources.size(), UINT32_MAX);
+    std::vector<std::vector<uint32_t>> readersSinceWrite(m_resources.size());
+
+    m_edges.clear();
+    auto addEdge = [&](uint32_t from, uint32_t to) {
+        if (from == to || from == UINT32_MAX) return;
+        for (uint32_t existing : successors[from]) {
+            if (existing == to) return;
+        }
+        successors[from].push_back(to);
+        inDegree[to]++;
+        m_edges.emplace_back(from, to);
+    };
+
+    for (uint32_t p = 0; p < passCount; ++p) {
+        if (m_passes[p].culled) continue;
+        for (const auto& record : m_passes[p].accesses) {
+            addEdge(lastWriter[record.resource], p);
+            if (record.write) {
+                for (uint32_t reader : readersSinceWrite[record.resource]) {
+                    addEdge(reader, p);
+                }
+            }
+        }
+        for (const auto& record : m_passes[p].accesses) {
+            if (record.write) {
+                lastWriter[record.resource] = p;
+                readersSinceWrite[record.resource].clear();
+            } else {
+                readersSinceWrite[record.resource].push_back(p);
+            }
+        }
+    }
+
+    // 2. Kahn 拓扑排序，同一层内优先声明顺序靠前的 pass，保证结果稳定
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> ready;
+    uint32_t aliveCount = 0;
+    for (uint32_t p = 0; p < passCount; ++p) {
+        if (m_passes[p].culled) continue;
+        aliveCount++;
+        if (inDegree[p] == 0) ready.push(p);
+    }
+    std::vector<uint32_t> order;
+    order.reserve(aliveCount);
+    while (!ready.empty()) {
+        uint32_t p = ready.top();
+        ready.pop();
+        order.push_back(p);
+        for (uint32_t next : successors[p]) {
+            if (--inDegree[next] == 0) ready.push(next);
+        }
+    }
+    if (order.size() != aliveCount) {
+        throw std::runtime_error("RenderGraph: dependency cycle detected");
+    }
+    return order;
+}
+
+std::vector<RGQueue> RenderGraph::assignQueues(const std::vector<uint32_t>& order) const {
+    std::vector<RGQueue> queues(m_passes.size(), RGQueue::Graphics);
+    const bool asyncAvailable = m_asyncComputeEnabled && m_context->hasComputeQueue() &&
+                                m_context->getComputeQueueFamily() != m_context->getGraphicsQueueFamily();
+    if (!asyncAvailable) return queues;
+
+    // 计算命令整体先于图形命令提交，因此只有不依赖本帧图形 pass 的计算 pass 才能放到计算队列
+    std::vector<std::vector<uint32_t>> predecessors(m_passes.size());
+    for (const auto& [from, to] : m_edges) {
+        predecessors[to].push_back(from);
+    }
+    for (uint32_t p : order) {
+        const Pass& pass = m_passes[p];
+        if (pass.queue != RGQueue::AsyncCompute) continue;
+
+        bool eligible = true;
+        for (const auto& record : pass.accesses) {
+            if (!isComputeQueueCompatible(getAccessInfo(record.access).stage)) {
+                std::println("RenderGraph: pass '{}' uses {} and stays on the graphics queue", pass.name, toString(record.access));
+                eligible = false;
+                break;
+            }
+        }
+        for (uint32_t pred : predecessors[p]) {
+            if (!eligible) break;
+            if (queues[pred] != RGQueue::AsyncCompute) {
+                std::println("RenderGraph: pass '{}' depends on graphics pass '{}' and stays on the graphics queue",
+                             pass.name, m_passes[pred].name);
+                eligible = false;
+            }
+        }
+        if (eligible) queues[p] = RGQueue::AsyncCompute;
+    }
+    return queues;
+}
+
+void RenderGraph::computeLifetimes(const std::vector<uint32_t>& order) {
+    for (auto& resource : m_resources) {
+        resource.firstUse = UINT32_MAX;
+        resource.lastUse = 0;
+    }
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        for (const auto& record : m_passes[order[i]].accesses) {
+            Resource& resource = m_resources[record.resource];
+            resource.firstUse = std::min(resource.firstUse, i);
+            resource.lastUse = std::max(resource.lastUse, i);
+        }
+    }
+    m_lifetimes.clear();
+    for (const auto& resource : m_resources) {
+        m_lifetimes.emplace_back(resource.firstUse, resource.lastUse);
+    }
+}
+
+void RenderGraph::allocateTransients() {
+    // 生命周期不重叠的 transient 图像由 RenderTargetPool 做内存别名
+    std::vector<AliasRequest> requests;
+    std::vector<RGHandle> handles;
+    for (RGHandle h = 0; h < m_resources.size(); ++h) {
+        const Resource& resource = m_resources[h];
+        if (resource.imported || resource.type != RGResourceType::Image || resource.firstUse == UINT32_MAX) continue;
+        requests.push_back(AliasRequest{
+            .desc = resource.desc,
+            .firstPass = resource.firstUse,
+            .lastPass = resource.lastUse,
+            .name = resource.name
+        });
+        handles.push_back(h);
+    }
+
+    m_transientTargets.assign(m_resources.size(), nullptr);
+    if (requests.empty()) return;
+
+    auto targets = m_pool->createAliasedTargets(requests);
+    for (size_t i = 0; i < handles.size(); ++i) {
+        m_transientTargets[handles[i]] = targets[i];
+    }
+}
+
+void RenderGraph::buildBarriers(const std::vector<uint32_t>& order, const std::vector<RGQueue>& queues) {
+    // 模拟执行顺序，跟踪每个资源的布局、未完成的写入以及已经可见的读阶段
+    struct Tracked {
+        vk::ImageLayout layout;
+        vk::PipelineStageFlags2 writeStage;
+        vk::AccessFlags2 writeAccess;
+        vk::PipelineStageFlags2 readStages;     // 上次写入之后的所有读阶段（后续写入需要等待它们）
+        vk::PipelineStageFlags2 visibleStages;  // 上次写入已对这些阶段可见
+        vk::AccessFlags2 visibleAccess;
+        bool touchedByCompute;                  // 本帧被计算队列访问过
+        bool ownedByCompute;                    // 计算队列写入过，图形队列使用前需要所有权转移
+    };
+    std::vector<Tracked> tracked(m_resources.size());
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        const RGState& init = m_resources[i].initialState;
+        tracked[i] = Tracked{init.layout, init.stage, init.access, {}, {}, {}, false, false};
+    }
+
+    const uint32_t graphicsFamily = m_context->getGraphicsQueueFamily();
+    const uint32_t computeFamily = m_context->hasComputeQueue() ? m_context->getComputeQueueFamily() : graphicsFamily;
+
+    // 计算 → 图形：计算队列末尾释放，图形队列在使用前获取；同步由时间线信号量完成
+    auto transferToGraphics = [&](RGHandle handle, const RGState& dst, std::vector<Barrier>& acquireList) {
+        Tracked& state = tracked[handle];
+        m_computeReleaseBarriers.push_back(Barrier{
+            handle,
+            toComputeQueueState(RGState{state.writeStage | state.readStages, state.writeAccess, state.layout}),
+            RGState{vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, dst.layout},
+            computeFamily, graphicsFamily
+        });
+        acquireList.push_back(Barrier{
+            handle,
+            RGState{vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, state.layout},
+            dst,
+            computeFamily, graphicsFamily
+        });
+        m_graphicsWaitStage |= dst.stage ? dst.stage : vk::PipelineStageFlags2(vk::PipelineStageFlagBits2::eAllCommands);
+        state.layout = dst.layout;
+        state.touchedByCompute = false;
+        state.ownedByCompute = false;
+    };
+
+    m_schedule.clear();
+    m_schedule.reserve(order.size());
+    for (uint32_t passIndex : order) {
+        const RGQueue queue = queues[passIndex];
+        const bool onCompute = queue == RGQueue::AsyncCompute;
+        CompiledPass compiled{passIndex, queue, {}};
+        auto pushBarrier = [&](Barrier barrier) {
+            if (onCompute) {
+                barrier.src = toComputeQueueState(barrier.src);
+            }
+            compiled.barriers.push_back(barrier);
+        };
+
+        for (const auto& record : m_passes[passIndex].accesses) {
+            const Resource& resource = m_resources[record.resource];
+            const bool isImage = resource.type == RGResourceType::Image;
+            AccessInfo info = getAccessInfo(record.access);
+            Tracked& state = tracked[record.resource];
+
+            const vk::ImageLayout newLayout = isImage ? info.layout : vk::ImageLayout::eUndefined;
+
+            if (onCompute) {
+                // transient 资源在帧间共享，计算提交需要等上一帧的图形工作
+                if (!resource.imported) m_computeWaitsForGraphics = true;
+            } else if (state.touchedByCompute) {
+                if (state.ownedByCompute) {
+                    transferToGraphics(record.resource, RGState{info.stage, info.access, newLayout}, compiled.barriers);
+                    if (record.write) {
+                        state.writeStage = info.stage;
+                        state.writeAccess = info.access;
+                        state.readStages = {};
+                    } else {
+                        state.writeStage = {};
+                        state.writeAccess = {};
+                        state.readStages = info.stage;
+                    }
+                    state.visibleStages = {};
+                    state.visibleAccess = {};
+                    if (isImage && record.endLayout) state.layout = *record.endLayout;
+                    continue;
+                }
+                // 计算队列只读过：执行依赖由信号量等待保证，图形侧不再需要等待计算阶段
+                m_graphicsWaitStage |= info.stage;
+                state.writeStage = {};
+                state.writeAccess = {};
+                state.readStages = {};
+                state.touchedByCompute = false;
+            }
+
+            const bool layoutChange = isImage && newLayout != state.layout;
+            if (record.write || layoutChange) {
+                // 写入或布局转换：等待之前所有的读写 (WAW / WAR)
+                vk::PipelineStageFlags2 srcStage = state.writeStage | state.readStages;
+                if (srcStage || layoutChange) {
+                    pushBarrier(Barrier{
+                        record.resource,
+                        RGState{srcStage, state.writeAccess, state.layout},
+                        RGState{info.stage, info.access, newLayout}
+                    });
+                }
+                state.layout = newLayout;
+                if (record.write) {
+                    state.writeStage = info.stage;
+                    state.writeAccess = info.access;
+                    state.readStages = {};
+                } else {
+                    // 布局转换已完成可见性操作，之后的读无需再等
+                    state.writeStage = {};
+                    state.writeAccess = {};
+                    state.readStages = info.stage;
+                }
+                state.visibleStages = {};
+                state.visibleAccess = {};
+            } else {
+                // 读：只有存在尚未对该阶段可见的写入时才需要屏障 (RAW)
+                const bool pendingWrite = static_cast<bool>(state.writeAccess);
+                const bool alreadyVisible = (state.visibleStages & info.stage) == info.stage &&
+                                            (state.visibleAccess & info.access) == info.access;
+                if (pendingWrite && !alreadyVisible) {
+                    pushBarrier(Barrier{
+                        record.resource,
+                        RGState{state.writeStage, state.writeAccess, state.layout},
+                        RGState{info.stage, info.access, state.layout}
+                    });
+                    state.visibleStages |= info.stage;
+                    state.visibleAccess |= info.access;
+                }
+                state.readStages |= info.stage;
+            }
+
+            if (onCompute) {
+                state.touchedByCompute = true;
+                if (record.write) state.ownedByCompute = true;
+            }
+
+            // pass 内部（VkRenderPass finalLayout）改变了布局
+            if (isImage && record.endLayout) {
+                state.layout = *record.endLayout;
+            }
+        }
+        m_schedule.push_back(std::move(compiled));
+    }
+
+    // 导出资源转换到帧外部需要的布局（帧末由图形队列持有）
+    m_finalBarriers.clear();
+    for (RGHandle h = 0; h < m_resources.size(); ++h) {
+        const Resource& resource = m_resources[h];
+        if (!resource.finalLayout) continue;
+        const Tracked& state = tracked[h];
+        if (state.ownedByCompute) {
+            transferToGraphics(h, RGState{vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, *resource.finalLayout}, m_finalBarriers);
+            continue;
+        }
+        if (state.layout == *resource.finalLayout) continue;
+        m_finalBarriers.push_back(Barrier{
+            h,
+            RGState{state.writeStage | state.readStages, state.writeAccess, state.layout},
+            RGState{vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, *resource.finalLayout}
+        });
+    }
+}
+
+void RenderGraph::restoreCompiledState() {
+    // 本帧重新声明的 pass / 资源还没有编译结果，从缓存中恢复
+    for (size_t p = 0; p < m_passes.size() && p < m_culledPasses.size(); ++p) {
+        m_passes[p].culled = m_culledPasses[p];
+    }
+    for (size_t r = 0; r < m_resources.size() && r < m_lifetimes.size(); ++r) {
+        m_resources[r].firstUse = m_lifetimes[r].first;
+        m_resources[r].lastUse = m_lifetimes[r].second;
+    }
+}
+
+void RenderGraph::bindTransients() {
+    for (RGHandle h = 0; h < m_resources.size() && h < m_transientTargets.size(); ++h) {
+        if (RenderTarget* target = m_transientTargets[h]) {
+            m_resources[h].image = target->image;
+            m_resources[h].view = target->view;
+            m_resources[h].target = target;
+        }
+    }
+}
+
+void RenderGraph::compile() {
+    const size_t hash = this->computeTopologyHash();
+    if (m_compiled && hash == m_compiledHash) {
+        // 拓扑未变：复用调度与屏障，只需为本帧的资源声明重新绑定 transient 图像
+        this->restoreCompiledState();
+        this->bindTransients();
+        return;
+    }
+
+    // 拓扑变化很少发生（分辨率变化、开关特性），旧的 transient 图像可能仍在使用中
+    if (!m_transientTargets.empty()) {
+        m_context->getDevice().waitIdle();
+    }
+    this->invalidate();
+
+    this->cullPasses();
+    std::vector<uint32_t> order = this->sortPasses();
+    std::vector<RGQueue> queues = this->assignQueues(order);
+    this->computeLifetimes(order);
+    this->allocateTransients();
+    this->buildBarriers(order, queues);
+    this->bindTransients();
+
+    m_compiledHash = hash;
+    m_compiled = true;
+    std::println("RenderGraph compiled: {} passes ({} culled, {} async compute), {} barriers, {} alias slots",
+                 m_passes.size(), this->getCulledPassCount(), this->getAsyncComputePassCount(),
+                 this->getBarrierCount(), m_pool->getAliasSlotCount());
+}
+
+void RenderGraph::recordBarriers(vk::CommandBuffer cmd, const std::vector<Barrier>& barriers) const {
+    if (barriers.empty()) return;
+
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+    for (const auto& barrier : barriers) {
+        const Resource& resource = m_resources[barrier.resource];
+        if (resource.type == RGResourceType::Image) {
+            vk::ImageMemoryBarrier2 imageBarrier{};
+            imageBarrier.srcStageMask = barrier.src.stage;
+            imageBarrier.srcAccessMask = barrier.src.access;
+            imageBarrier.dstStageMask = barrier.dst.stage;
+            imageBarrier.dstAccessMask = barrier.dst.access;
+            imageBarrier.oldLayout = barrier.src.layout;
+            imageBarrier.newLayout = barrier.dst.layout;
+            imageBarrier.srcQueueFamilyIndex = barrier.srcQueueFamily;
+            imageBarrier.dstQueueFamilyIndex = barrier.dstQueueFamily;
+            imageBarrier.image = resource.image;
+            imageBarrier.subresourceRange = vk::ImageSubresourceRange{
+                resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS
+            };
+            imageBarriers.push_back(imageBarrier);
+        } else {
+            vk::BufferMemoryBarrier2 bufferBarrier{};
+            bufferBarrier.srcStageMask = barrier.src.stage;
+            bufferBarrier.srcAccessMask = barrier.src.access;
+            bufferBarrier.dstStageMask = barrier.dst.stage;
+            bufferBarrier.dstAccessMask = barrier.dst.access;
+            bufferBarrier.srcQueueFamilyIndex = barrier.srcQueueFamily;
+            bufferBarrier.dstQueueFamilyIndex = barrier.dstQueueFamily;
+            bufferBarrier.buffer = resource.buffer;
+            bufferBarrier.offset = 0;
+            bufferBarrier.size = VK_WHOLE_SIZE;
+            bufferBarriers.push_back(bufferBarrier);
+        }
+    }
+
+    vk::DependencyInfo dependencyInfo{};
+    dependencyInfo.setImageMemoryBarriers(imageBarriers);
+    dependencyInfo.setBufferMemoryBarriers(bufferBarriers);
+    cmd.pipelineBarrier2(dependencyInfo);
+}
+
+void RenderGraph::execute(vk::CommandBuffer cmd, vk::CommandBuffer computeCmd) {
+    if (!m_compiled) {
+        throw std::runtime_error("RenderGraph: execute() called before compile()");
+    }
+    const bool hasAsync = this->hasAsyncComputeWork();
+    if (hasAsync && !computeCmd) {
+        throw std::runtime_error("RenderGraph: async compute passes scheduled but no compute command buffer given");
+    }
+    for (const auto& compiled : m_schedule) {
+        vk::CommandBuffer target = compiled.queue == RGQueue::AsyncCompute ? computeCmd : cmd;
+        this->recordBarriers(target, compiled.barriers);
+        const Pass& pass = m_passes[compiled.passIndex];
+        if (pass.execute) {
+            pass.execute(target, *this);
+        }
+    }
+    if (hasAsync) {
+        this->recordBarriers(computeCmd, m_computeReleaseBarriers);
+    }
+    this->recordBarriers(cmd, m_finalBarriers);
+}
+
+bool RenderGraph::hasAsyncComputeWork() const {
+    return this->getAsyncComputePassCount() > 0;
+}
+
+size_t RenderGraph::getAsyncComputePassCount() const {
+    size_t count = 0;
+    for (const auto& compiled : m_schedule) {
+        if (compiled.queue == RGQueue::AsyncCompute) count++;
+    }
+    return count;
+}
+
+size_t RenderGraph::getCulledPassCount() const {
+    size_t count = 0;
+    for (const auto& pass : m_passes) {
+        if (pass.culled) count++;
+    }
+    return count;
+}
+
+size_t RenderGraph::getBarrierCount() const {
+    size_t count = m_finalBarriers.size() + m_computeReleaseBarriers.size();
+    for (const auto& compiled : m_schedule) {
+        count += compiled.barriers.size();
+    }
+    return count;
+}
+
+void RenderGraph::exportGraphviz(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for render graph dump: " + path);
+    }
+
+    file << "digraph RenderGraph {\n";
+    file << "    rankdir=LR;\n";
+    file << "    node [fontname=\"Helvetica\", fontsize=10];\n";
+    file << "    edge [fontname=\"Helvetica\", fontsize=8];\n";
+
+    // pass 节点：编号为执行顺序，被裁剪的 pass 画成虚线
+    std::vector<int> executionIndex(m_passes.size(), -1);
+    std::vector<size_t> barrierCount(m_passes.size(), 0);
+    std::vector<bool> onCompute(m_passes.size(), false);
+    for (size_t i = 0; i < m_schedule.size(); ++i) {
+        executionIndex[m_schedule[i].passIndex] = static_cast<int>(i);
+        barrierCount[m_schedule[i].passIndex] = m_schedule[i].barriers.size();
+        onCompute[m_schedule[i].passIndex] = m_schedule[i].queue == RGQueue::AsyncCompute;
+    }
+    for (size_t p = 0; p < m_passes.size(); ++p) {
+        const Pass& pass = m_passes[p];
+        if (pass.culled) {
+            file << std::format("    pass{} [shape=box, style=dashed, color=gray, label=\"{}\\n(culled)\"];\n", p, pass.name);
+        } else {
+            file << std::format("    pass{} [shape=box, style=filled, fillcolor=\"{}\", label=\"#{} {}\\n{}, {} barrier(s)\"];\n",
+                                p, onCompute[p] ? "#c9a0dc" : "#f6c28b", executionIndex[p], pass.name,
+                                onCompute[p] ? "async compute" : "graphics", barrierCount[p]);
+        }
+    }
+
+    // 资源节点
+    for (size_t r = 0; r < m_resources.size(); ++r) {
+        const Resource& resource = m_resources[r];
+        std::string detail;
+        if (resource.type == RGResourceType::Image) {
+            detail = std::format("{} {}x{}", vk::to_string(resource.desc.format),
+                                 resource.desc.extent.width, resource.desc.extent.height);
+        } else {
+            detail = std::format("buffer {} bytes", resource.size);
+        }
+        const char* kind = resource.imported ? "imported" : "transient";
+        const char* fill = resource.imported ? "#a8d5ba" : "#b5c7f2";
+        std::string lifetime = resource.firstUse == UINT32_MAX
+            ? std::string("unused")
+            : std::format("passes {}..{}", resource.firstUse, resource.lastUse);
+        file << std::format("    res{} [shape=ellipse, style=filled, fillcolor=\"{}\", label=\"{}\\n{}\\n{}, {}\"];\n",
+                            r, fill, resource.name, detail, kind, lifetime);
+    }
+
+    // 读写边
+    for (size_t p = 0; p < m_passes.size(); ++p) {
+        for (const auto& record : m_passes[p].accesses) {
+            if (record.write) {
+                file << std::format("    pass{} -> res{} [color=red, label=\"{}\"];\n", p, record.resource, toString(record.access));
+            } else {
+                file << std::format("    res{} -> pass{} [color=blue, label=\"{}\"];\n", record.resource, p, toString(record.access));
+            }
+        }
+    }
+
+    // pass 之间的依赖边
+    for (const auto& [from, to] : m_edges) {
+        file << std::format("    pass{} -> pass{} [style=dotted, color=gray40];\n", from, to);
+    }
+
+    file << "}\n";
+    std::println("Render graph written to {}", path);
+}
@@ -0,0 +1,283 @@
+#include "Core/RenderTargetPool.h"
+#include <algorithm>
+#include <format>
+#include <print>
+#include <stdexcept>
+
+namespace {
+    bool isDepthFormat(vk::Format format) {
+        switch (format) {
+            case vk::Format::eD16Unorm:
+            case vk::Format::eD32Sfloat:
+            case vk::Format::eX8D24UnormPack32:
+            case vk::Format::eD16UnormS8Uint:
+            case vk::Format::eD24UnormS8Uint:
+            case vk::Format::eD32SfloatS8Uint:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+RenderTargetPool::RenderTargetPool(Context* context)
+    : m_context(context) {
+    // 检查设备是否提供 LAZILY_ALLOCATED 内存类型（主要是移动端 tile-based GPU）
+    auto memProperties = m_context->getPhysicalDevice().getMemoryProperties();
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if (memProperties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated) {
+            m_lazyMemorySupported = true;
+            break;
+        }
+    }
+    std::println("RenderTargetPool created (lazily allocated memory: {})", m_lazyMemorySupported ? "supported" : "not supported");
+}
+
+RenderTargetPool::~RenderTargetPool() {
+    this->releaseAliasedTargets();
+    for (auto& target : m_targets) {
+        this->destroyTarget(*target);
+    }
+    m_targets.clear();
+    std::println("RenderTargetPool destroyed");
+}
+
+vk::Image RenderTargetPool::createImage(const RenderTargetDesc& desc) const {
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo.imageType = vk::ImageType::e2D;
+    imageInfo.extent = vk::Extent3D{desc.extent.width, desc.extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = desc.format;
+    imageInfo.tiling = vk::ImageTiling::eOptimal;
+    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+    imageInfo.usage = desc.usage;
+    imageInfo.sharingMode = vk::SharingMode::eExclusive;
+    imageInfo.samples = desc.samples;
+    return m_context->getDevice().createImage(imageInfo);
+}
+
+vk::ImageView RenderTargetPool::createImageView(vk::Image image, const RenderTargetDesc& desc) const {
+    vk::ImageViewCreateInfo viewInfo{};
+    viewInfo.image = image;
+    viewInfo.viewType = vk::ImageViewType::e2D;
+    viewInfo.format = desc.format;
+    viewInfo.subresourceRange.aspectMask = isDepthFormat(desc.format)
+        ? vk::ImageAspectFlagBits::eDepth
+        : vk::ImageAspectFlagBits::eColor;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+    return m_context->getDevice().createImageView(viewInfo);
+}
+
+std::unique_ptr<RenderTarget> RenderTargetPool::createTarget(const RenderTargetDesc& desc, const std::string& name) {
+    auto target = std::make_unique<RenderTarget>();
+    target->desc = desc;
+    target->name = name;
+    target->image = this->createImage(desc);
+
+    // 不需要 store 的附件放进惰性分配内存：tile-based GPU 上完全不占显存
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    if (desc.isTransient() && m_lazyMemorySupported) {
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+        target->lazilyAllocated = true;
+    }
+    VkResult result = vmaAllocateMemoryForImage(m_context->getVmaAllocator(),
+                                                static_cast<VkImage>(target->image),
+                                                &allocInfo, &target->allocation, nullptr);
+    if (result != VK_SUCCESS) {
+        m_context->getDevice().destroyImage(target->image);
+        throw std::runtime_error("Failed to allocate memory for render target: " + name);
+    }
+    vmaBindImageMemory(m_context->getVmaAllocator(), target->allocation, static_cast<VkImage>(target->image));
+    m_context->getMemoryTracker()->track(target->allocation, name, MemoryCategory::RenderTarget);
+
+    target->view = this->createImageView(target->image, desc);
+    return target;
+}
+
+void RenderTargetPool::destroyTarget(RenderTarget& target) {
+    auto device = m_context->getDevice();
+    if (target.view) {
+        device.destroyImageView(target.view);
+        target.view = nullptr;
+    }
+    if (target.image) {
+        device.destroyImage(target.image);
+        target.image = nullptr;
+    }
+    if (target.allocation != VK_NULL_HANDLE) {
+        m_context->getMemoryTracker()->untrack(target.allocation);
+        vmaFreeMemory(m_context->getVmaAllocator(), target.allocation);
+        target.allocation = VK_NULL_HANDLE;
+    }
+}
+
+void RenderTargetPool::beginFrame() {
+    ++m_frame;
+    // 空闲太久的目标说明描述已不再被请求（例如分辨率变化），释放其显存
+    auto it = std::remove_if(m_targets.begin(), m_targets.end(), [this](std::unique_ptr<RenderTarget>& target) {
+        if (!target->inUse && m_frame - target->lastUsedFrame > kMaxIdleFrames) {
+            this->destroyTarget(*target);
+            return true;
+        }
+        return false;
+    });
+    m_targets.erase(it, m_targets.end());
+}
+
+RenderTarget* RenderTargetPool::acquire(const RenderTargetDesc& desc, const std::string& name) {
+    for (auto& target : m_targets) {
+        if (!target->inUse && target->desc == desc) {
+            target->inUse = true;
+            target->lastUsedFrame = m_frame;
+            return target.get();
+        }
+    }
+    auto target = this->createTarget(desc, name);
+    target->inUse = true;
+    target->lastUsedFrame = m_frame;
+    std::println("RenderTargetPool: created '{}' {}x{} ({}{})", name, desc.extent.width, desc.extent.height,
+                 vk::to_string(desc.format), target->lazilyAllocated ? ", lazily allocated" : "");
+    m_targets.push_back(std::move(target));
+    return m_targets.back().get();
+}
+
+void RenderTargetPool::release(RenderTarget* target) {
+    if (!target) return;
+    target->inUse = false;
+    target->lastUsedFrame = m_frame;
+}
+
+std::vector<RenderTarget*> RenderTargetPool::createAliasedTargets(const std::vector<AliasRequest>& requests) {
+    auto device = m_context->getDevice();
+    std::vector<RenderTarget*> result(requests.size(), nullptr);
+
+    // 1. 创建图像（暂不绑定内存）并查询内存需求
+    struct Pending {
+        size_t requestIndex;
+        std::unique_ptr<RenderTarget> target;
+        vk::MemoryRequirements requirements;
+        uint32_t slot = UINT32_MAX;
+    };
+    std::vector<Pending> pending;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        // 惰性分配内存不能别名（也不占实际显存），直接走独立分配
+        if (request.desc.isTransient() && m_lazyMemorySupported) {
+            result[i] = this->acquire(request.desc, request.name);
+            m_aliasPooledTargets.push_back(result[i]);
+            continue;
+        }
+        auto target = std::make_unique<RenderTarget>();
+        target->desc = request.desc;
+        target->name = request.name;
+        target->inUse = true;
+        target->image = this->createImage(request.desc);
+        auto requirements = device.getImageMemoryRequirements(target->image);
+        pending.push_back({i, std::move(target), requirements});
+    }
+
+    // 2. 按 firstPass 排序后做贪心区间着色：
+    //    slot 的上一个占用者在本请求开始前结束，且内存类型兼容，即可复用
+    std::sort(pending.begin(), pending.end(), [&](const Pending& a, const Pending& b) {
+        return requests[a.requestIndex].firstPass < requests[b.requestIndex].firstPass;
+    });
+    size_t firstNewSlot = m_aliasSlots.size();
+    for (auto& p : pending) {
+        const auto& request = requests[p.requestIndex];
+        uint32_t bestSlot = UINT32_MAX;
+        for (uint32_t s = static_cast<uint32_t>(firstNewSlot); s < m_aliasSlots.size(); ++s) {
+            const auto& slot = m_aliasSlots[s];
+            if (slot.lastPass >= request.firstPass) continue;
+            if ((slot.requirements.memoryTypeBits & p.requirements.memoryTypeBits) == 0) continue;
+            // 优先选已经足够大的 slot 中最小的那个，避免无谓地放大
+            if (bestSlot == UINT32_MAX) {
+                bestSlot = s;
+                continue;
+            }
+            const auto& best = m_aliasSlots[bestSlot];
+            bool fits = slot.requirements.size >= p.requirements.size;
+            bool bestFits = best.requirements.size >= p.requirements.size;
+            if ((fits && !bestFits) ||
+                (fits && bestFits && slot.requirements.size < best.requirements.size) ||
+                (!fits && !bestFits && slot.requirements.size > best.requirements.size)) {
+                bestSlot = s;
+            }
+        }
+        if (bestSlot == UINT32_MAX) {
+            m_aliasSlots.push_back(AliasSlot{VK_NULL_HANDLE, p.requirements, request.lastPass});
+            bestSlot = static_cast<uint32_t>(m_aliasSlots.size() - 1);
+        } else {
+            auto& slot = m_aliasSlots[bestSlot];
+            slot.requirements.size = std::max(slot.requirements.size, p.requirements.size);
+            slot.requirements.alignment = std::max(slot.requirements.alignment, p.requirements.alignment);
+            slot.requirements.memoryTypeBits &= p.requirements.memoryTypeBits;
+            slot.lastPass = request.lastPass;
+        }
+        p.slot = bestSlot;
+    }
+
+    // 3. 为每个新 slot 分配一次内存
+    VkDeviceSize aliasedBytes = 0;
+    VkDeviceSize requestedBytes = 0;
+    for (size_t s = firstNewSlot; s < m_aliasSlots.size(); ++s) {
+        auto& slot = m_aliasSlots[s];
+        VkMemoryRequirements requirements = slot.requirements;
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        if (vmaAllocateMemory(m_context->getVmaAllocator(), &requirements, &allocInfo, &slot.allocation, nullptr) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate aliased render target memory");
+        }
+        m_context->getMemoryTracker()->track(slot.allocation, std::format("RenderTarget alias slot {}", s), MemoryCategory::RenderTarget);
+        aliasedBytes += slot.requirements.size;
+    }
+
+    // 4. 绑定图像到各自 slot 并创建视图
+    for (auto& p : pending) {
+        requestedBytes += p.requirements.size;
+        vmaBindImageMemory(m_context->getVmaAllocator(), m_aliasSlots[p.slot].allocation, static_cast<VkImage>(p.target->image));
+        p.target->view = this->createImageView(p.target->image, p.target->desc);
+        p.target->lastUsedFrame = m_frame;
+        result[p.requestIndex] = p.target.get();
+        m_aliasedTargets.push_back(std::move(p.target));
+    }
+    if (!pending.empty()) {
+        std::println("RenderTargetPool: {} aliased targets in {} slots ({} KB instead of {} KB)",
+                     pending.size(), m_aliasSlots.size() - firstNewSlot, aliasedBytes / 1024, requestedBytes / 1024);
+    }
+    return result;
+}
+
+void RenderTargetPool::releaseAliasedTargets() {
+    for (auto* target : m_aliasPooledTargets) {
+        this->release(target);
+    }
+    m_aliasPooledTargets.clear();
+    // 别名目标的内存属于 slot，先销毁图像再释放 slot
+    for (auto& target : m_aliasedTargets) {
+        this->destroyTarget(*target);
+    }
+    m_aliasedTargets.clear();
+    for (auto& slot : m_aliasSlots) {
+        if (slot.allocation != VK_NULL_HANDLE) {
+            m_context->getMemoryTracker()->untrack(slot.allocation);
+            vmaFreeMemory(m_context->getVmaAllocator(), slot.allocation);
+        }
+    }
+    m_aliasSlots.clear();
+}
+
+void RenderTargetPool::trim() {
+    auto it = std::remove_if(m_targets.begin(), m_targets.end(), [this](std::unique_ptr<RenderTarget>& target) {
+        if (!target->inUse) {
+            this->destroyTarget(*target);
+            return true;
+        }
+        return false;
+    });
+    m_targets.erase(it, m_targets.end());
+}
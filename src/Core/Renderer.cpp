@@ -1,6 +1,21 @@
 #include "Core/Renderer.h"
 #include <imgui_impl_vulkan.h>
 #include <print>
+#include <format>
+#include <algorithm>
+
+namespace {
+    // 每个模型空间单位在屏幕上覆盖的像素数：按包围球离相机最近的点计算（投影比例 * 最大轴缩放 / 距离）
+    float getPixelsPerUnit(const Camera& camera, const Renderable& renderable) {
+        const glm::mat4& model = renderable.getTransform().model;
+        const glm::mat3 linear(model);
+        const float maxScale = std::max({glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2])});
+        const glm::vec4& sphere = renderable.getMesh().getBoundingSphere();
+        const glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+        const float distance = std::max(glm::length(center - camera.getPosition()) - sphere.w * maxScale, camera.getNearPlane());
+        return camera.getProjectionScale() * maxScale / distance;
+    }
+}
 
 Renderer::Renderer(std::unique_ptr<Window>& window) {
     // 1. 创建上下文 (实例、设备等)
@@ -8,28 +23,29 @@ Renderer::Renderer(std::unique_ptr<Window>& window) {
 
     // 2. 创建交换链
     this->m_swapchain = std::make_unique<SwapchainManager>(m_context.get(), window.get());
+    this->m_renderTargetPool = std::make_unique<RenderTargetPool>(m_context.get());
+    this->m_renderGraph = std::make_unique<RenderGraph>(m_context.get(), m_renderTargetPool.get());
 
     // 3. 创建渲染通道
     this->m_mainRenderPass = this->createMainRenderPass(m_swapchain->getImageFormat(),vk::Format::eD32Sfloat);
 
-    // 4. 创建深度资源
-    this->createDepthResources();
-
-    // 5. 创建帧缓冲
-    this->createFramebuffers();
+    // 4. 深度由帧图作为 transient 资源分配
+    // 5. 帧缓冲在第一次执行主通道时按深度视图创建
 
     // 6. 创建描述符管理器
-    const int objectCount = 10;
+    const uint32_t objectCount = MAX_OBJECTS;
     this->m_descriptorManager = std::make_unique<DescriptorManager>(m_context.get());
 
     // Set 0: CameraUBO (1 个 binding)
     this->m_descriptorManager->createLayout<CameraUBO>(0);
 
-    // Set 1: TransformUBO, LightUBO, MaterialUBO, 4 个纹理采样器 (7 个 bindings)
-    this->m_descriptorManager->createLayout<TransformUBO, LightUBO, MaterialUBO, TextureSampler, TextureSampler, TextureSampler, TextureSampler>(1);
+    // Set 1: TransformUBO, LightUBO, MaterialUBO, 3 个纹理采样器：反照率、法线、ORM (6 个 bindings)
+    // 每个对象按 frame in flight 各一份：流式纹理替换时只重写当前帧的副本
+    this->m_descriptorManager->createLayout<TransformUBO, LightUBO, MaterialUBO, TextureSampler, TextureSampler, TextureSampler>(1);
+    this->m_descriptorManager->setCopiesPerInstance(1, MAX_FRAMES_IN_FLIGHT);
     std::unordered_map<uint32_t, uint32_t> capacities = {
         {0, MAX_FRAMES_IN_FLIGHT},
-        {1, static_cast<uint32_t>(objectCount)}
+        {1, objectCount}
     };
     this->m_descriptorManager->createPool(capacities);
     this->m_descriptorManager->allocateAllSets(capacities);
@@ -44,22 +60,14 @@ Renderer::Renderer(std::unique_ptr<Window>& window) {
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
         m_descriptorManager->bindBufferToSet(0, i, 0, m_frameUBOs.camera[i], sizeof(CameraUBO));
     }
-    for (int i = 0; i < objectCount; i++) {
+    for (uint32_t i = 0; i < objectCount; i++) {
         m_descriptorManager->bindBufferToSet(1, i, 0, m_objectUBOs.transform[i], sizeof(TransformUBO));
         m_descriptorManager->bindBufferToSet(1, i, 1, m_objectUBOs.light[i], sizeof(LightUBO));
         m_descriptorManager->bindBufferToSet(1, i, 2, m_objectUBOs.material[i], sizeof(MaterialUBO));
     }
 
     // 9. 创建渲染管线(需要使用渲染通道和描述符布局)
-    this->m_pipelineManager = std::make_unique<PipelineManager>(m_context.get());
-    this->m_pipelineManager->createGraphicsPipeline(
-        PipelineType::Main,
-        {"shaders/pbr.vert.spv", "shaders/pbr.frag.spv"},  // 使用PBR着色器
-        m_swapchain->getExtent(),
-        m_swapchain->getImageFormat(),
-        m_mainRenderPass->getRenderPass(),
-        m_descriptorManager->getAllDescriptorSetLayouts()
-    );
+    this->createPipelines();
 
     // 10. 创建命令管理器（需要swapchain图像数量）
     this->m_commandManager = std::make_unique<CommandManager>(
@@ -68,6 +76,17 @@ Renderer::Renderer(std::unique_ptr<Window>& window) {
         static_cast<uint32_t>(m_swapchain->getImageCount()) // 3
     );
 
+    // 簇剔除的间接命令按 frame in flight 各一份
+    this->m_clusterCuller = std::make_unique<ClusterCuller>(m_context.get(), MAX_FRAMES_IN_FLIGHT);
+    // 网格着色器路径与主管线共用 set 0 / set 1 与主渲染通道，设备支持时默认启用
+    this->m_meshShaderPath = std::make_unique<MeshShaderPath>(m_context.get(), MAX_FRAMES_IN_FLIGHT,
+                                                              m_descriptorManager->getAllDescriptorSetLayouts(),
+                                                              m_mainRenderPass->getRenderPass());
+    this->createTimestampPool();
+
+    // 默认在有独立计算队列族时启用异步计算
+    this->setAsyncComputeEnabled(true);
+
     // 11. 初始化 ImGui
     m_imguiManager = std::make_unique<ImGuiManager>();
     m_imguiManager->init(
@@ -78,6 +97,108 @@ Renderer::Renderer(std::unique_ptr<Window>& window) {
         static_cast<uint32_t>(m_swapchain->getImageCount())
     );
 }
+void Renderer::createPipelines() {
+    this->m_pipelineManager = std::make_unique<PipelineManager>(m_context.get());
+    // 使用PBR着色器；Compact 顶点格式的变体只替换顶点着色器（八面体法线解码）
+    const std::pair<VertexFormat, const char*> variants[] = {
+        {VertexFormat::Standard, "shaders/pbr.vert.spv"},
+        {VertexFormat::Compact, "shaders/pbr_compact.vert.spv"}
+    };
+    // 两个变体都是必需的：Compact 网格只上传了 16 字节顶点，没有可以回退的标准顶点缓冲
+    for (const auto& [format, vertexShader] : variants) {
+        this->m_pipelineManager->createGraphicsPipeline(
+            PipelineType::Main,
+            {vertexShader, "shaders/pbr.frag.spv"},
+            m_swapchain->getExtent(),
+            m_swapchain->getImageFormat(),
+            m_mainRenderPass->getRenderPass(),
+            m_descriptorManager->getAllDescriptorSetLayouts(),
+            format
+        );
+    }
+}
+void Renderer::createTimestampPool() {
+    // 图形队列族不支持时间戳时不计时（getGeometryStats 的 gpuMs 保持 0）
+    const auto families = m_context->getPhysicalDevice().getQueueFamilyProperties();
+    if (families[m_context->getGraphicsQueueFamily()].timestampValidBits == 0) {
+        return;
+    }
+    m_timestampPeriod = m_context->getPhysicalDevice().getProperties().limits.timestampPeriod;
+    m_timestampPool = m_context->getDevice().createQueryPool(vk::QueryPoolCreateInfo{}
+        .setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(MAX_FRAMES_IN_FLIGHT * 2));
+}
+void Renderer::readGeometryTimestamps(uint32_t frame) {
+    // 该槽位上一次的提交在 beginFrame 返回时已经完成，结果可以直接读取
+    GeometryTiming& timing = m_geometryTimings[frame];
+    if (!m_timestampPool || !timing.written) {
+        return;
+    }
+    timing.written = false;
+    auto result = m_context->getDevice().getQueryPoolResults<uint64_t>(
+        m_timestampPool, frame * 2, 2, 2 * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result.result != vk::Result::eSuccess) {
+        return;
+    }
+    m_geometryStats.meshShaders = timing.meshShaders;
+    m_geometryStats.triangles = timing.triangles;
+    m_geometryStats.gpuMs = static_cast<double>(result.value[1] - result.value[0]) * m_timestampPeriod * 1e-6;
+}
+void Renderer::selectLods(const Scene& scene) {
+    // 误差按包围球离相机最近的点换算：模型空间误差 * 最大轴缩放 * 投影比例 / 距离
+    const Camera& camera = scene.getCamera();
+    m_lodStats = {};
+    for (const auto& renderable : scene.getRenderables()) {
+        const Mesh& mesh = renderable->getMesh();
+        const uint32_t levels = static_cast<uint32_t>(mesh.getLods().size());
+        uint32_t level = 0;
+        if (levels > 1 && m_lodSettings.enabled) {
+            m_lodStats.meshesWithLods++;
+            if (m_lodSettings.forcedLevel >= 0) {
+                level = std::min(static_cast<uint32_t>(m_lodSettings.forcedLevel), levels - 1);
+            } else {
+                level = mesh.selectLod(getPixelsPerUnit(camera, *renderable), renderable->getLod(),
+                                       m_lodSettings.maxPixelError, m_lodSettings.hysteresis);
+            }
+        }
+        if (level != renderable->getLod()) {
+            m_lodStats.switches++;
+            renderable->setLod(level);
+        }
+        m_lodStats.meshesReduced += level > 0 ? 1 : 0;
+        m_lodStats.trianglesFull += mesh.getIndexCount() / 3;
+        m_lodStats.trianglesSelected += mesh.getLod(level).indexCount / 3;
+    }
+}
+void Renderer::requestTextureMips(const Scene& scene) {
+    // 纹理流式加载的使用反馈：视锥内物体的材质纹理按一个屏幕像素覆盖的 UV 长度请求 mip 级，下一帧开头生效
+    TextureStreamer* streamer = m_context->getTextureStreamer();
+    if (!streamer->getSettings().enabled) {
+        return;
+    }
+    const Camera& camera = scene.getCamera();
+    glm::vec4 planes[6];
+    Camera::extractFrustumPlanes(camera.getProjectionMatrix() * camera.getViewMatrix(), planes);
+    for (const auto& renderable : scene.getRenderables()) {
+        const Mesh& mesh = renderable->getMesh();
+        const glm::mat4& model = renderable->getTransform().model;
+        const glm::mat3 linear(model);
+        const float maxScale = std::max({glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2])});
+        const glm::vec4& sphere = mesh.getBoundingSphere();
+        const glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+        bool visible = true;
+        for (const glm::vec4& plane : planes) {
+            visible = visible && glm::dot(glm::vec3(plane), center) + plane.w > -sphere.w * maxScale;
+        }
+        if (!visible) continue;
+
+        const float uvPerPixel = mesh.getUvDensity() / getPixelsPerUnit(camera, *renderable);
+        const Material& material = renderable->getMaterial();
+        streamer->requestTexture(material.getAlbedoMap(), uvPerPixel);
+        streamer->requestTexture(material.getNormalMap(), uvPerPixel);
+        streamer->requestTexture(material.getOrmMap(), uvPerPixel);
+    }
+}
 std::unique_ptr<RenderPassManager> Renderer::createMainRenderPass(vk::Format color, vk::Format depth) {
     RenderPassConfig forwardConfig;
 
@@ -88,18 +209,18 @@ std::unique_ptr<RenderPassManager> Renderer::createMainRenderPass(vk::Format col
         .samples = vk::SampleCountFlagBits::e1,
         .loadOp = vk::AttachmentLoadOp::eClear,
         .storeOp = vk::AttachmentStoreOp::eStore,
-        .initialLayout = vk::ImageLayout::eUndefined,
+        .initialLayout = vk::ImageLayout::eColorAttachmentOptimal,   // 由帧图的屏障转换
         .finalLayout = vk::ImageLayout::ePresentSrcKHR
     });
 
-    // 2. 深度附件
+    // 2. 深度附件（帧结束后不再读取，不需要写回内存）
     forwardConfig.attachments.push_back({
         .type = AttachmentType::Depth,
         .format = depth,
         .samples = vk::SampleCountFlagBits::e1,
         .loadOp = vk::AttachmentLoadOp::eClear,
-        .storeOp = vk::AttachmentStoreOp::eStore,
-        .initialLayout = vk::ImageLayout::eUndefined,
+        .storeOp = vk::AttachmentStoreOp::eDontCare,
+        .initialLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
         .finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal
     });
 
@@ -118,61 +239,7 @@ std::unique_ptr<RenderPassManager> Renderer::createMainRenderPass(vk::Format col
     return std::make_unique<RenderPassManager>(m_context.get(), forwardConfig);
 }
 
-void Renderer::createDepthResources() {
-    vk::ImageCreateInfo imageInfo{};
-    imageInfo.imageType = vk::ImageType::e2D;
-    imageInfo.extent.width = m_swapchain->getExtent().width;
-    imageInfo.extent.height = m_swapchain->getExtent().height;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = vk::Format::eD32Sfloat;
-    imageInfo.tiling = vk::ImageTiling::eOptimal;
-    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
-    imageInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
-    imageInfo.sharingMode = vk::SharingMode::eExclusive;
-    imageInfo.samples = vk::SampleCountFlagBits::e1;
-    imageInfo.flags = vk::ImageCreateFlagBits{};
-    m_depthImage = m_context->getDevice().createImage(imageInfo);
-    // 分配内存
-    vk::MemoryRequirements memRequirements = m_context->getDevice().getImageMemoryRequirements(m_depthImage);
-    vk::PhysicalDeviceMemoryProperties memProperties = m_context->getPhysicalDevice().getMemoryProperties();
-    uint32_t memoryTypeIndex = UINT32_MAX;
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((memRequirements.memoryTypeBits & (1 << i)) &&
-            (memProperties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eDeviceLocal)) {
-            memoryTypeIndex = i;
-            break;
-        }
-    }
-    if (memoryTypeIndex == UINT32_MAX) {
-        throw std::runtime_error("failed to find suitable memory type for depth image!");
-    }
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryTypeIndex; // 使用找到的索引
-
-    m_depthImageMemory = m_context->getDevice().allocateMemory(allocInfo);
-    m_context->getDevice().bindImageMemory(m_depthImage, m_depthImageMemory, 0);
-    // 创建深度图像视图
-    vk::ImageViewCreateInfo viewInfo{};
-    viewInfo.image = m_depthImage;
-    viewInfo.viewType = vk::ImageViewType::e2D;
-    viewInfo.format = vk::Format::eD32Sfloat;
-    viewInfo.components.r = vk::ComponentSwizzle::eIdentity;
-    viewInfo.components.g = vk::ComponentSwizzle::eIdentity;
-    viewInfo.components.b = vk::ComponentSwizzle::eIdentity;
-    viewInfo.components.a = vk::ComponentSwizzle::eIdentity;
-    viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
-    m_depthImageView = m_context->getDevice().createImageView(viewInfo);
-}
-
-
-void Renderer::createFramebuffers() {
+void Renderer::createFramebuffers(vk::ImageView depthView) {
     const auto& swapchainImageViews = m_swapchain->getImageViews();
     m_swapchainFramebuffers.resize(swapchainImageViews.size());
     auto device = m_context->getDevice();
@@ -180,7 +247,7 @@ void Renderer::createFramebuffers() {
     for (size_t i = 0; i < swapchainImageViews.size(); ++i) {
         std::array<vk::ImageView, 2> attachments = {
             swapchainImageViews[i],     // 附件 0: 颜色 (来自 Swapchain)
-            m_depthImageView            // 附件 1: 深度 (我们自己创建的)
+            depthView                   // 附件 1: 深度 (来自帧图的 transient 资源)
         };
 
         vk::FramebufferCreateInfo framebufferInfo{};
@@ -197,12 +264,30 @@ void Renderer::createFramebuffers() {
             throw std::runtime_error("Failed to create framebuffer!");
         }
     }
+    m_framebufferDepthView = depthView;
+}
+vk::Framebuffer Renderer::getFramebuffer(uint32_t imageIndex, vk::ImageView depthView) {
+    // 深度视图只在帧图重新分配 transient 资源时变化（分辨率变化等），此时旧帧缓冲可能仍在使用，
+    // 交给时间线延迟删除，不阻塞 CPU
+    if (depthView != m_framebufferDepthView) {
+        if (!m_swapchainFramebuffers.empty()) {
+            m_commandManager->deferDestroy([device = m_context->getDevice(), framebuffers = std::move(m_swapchainFramebuffers)]() {
+                for (auto framebuffer : framebuffers) {
+                    device.destroyFramebuffer(framebuffer);
+                }
+            });
+            m_swapchainFramebuffers.clear();
+        }
+        this->createFramebuffers(depthView);
+    }
+    return m_swapchainFramebuffers[imageIndex];
 }
 void Renderer::cleanupUBOs() {
     auto allocator = m_context->getVmaAllocator();
 
     // 清理帧级
     for (size_t i = 0; i < m_frameAllocations.size(); i++) {
+        m_context->getMemoryTracker()->untrack(m_frameAllocations[i]);
         vmaDestroyBuffer(allocator,
                         static_cast<VkBuffer>(m_frameUBOs.camera[i]),
                         m_frameAllocations[i]);
@@ -219,6 +304,7 @@ void Renderer::cleanupUBOs() {
             case 1: buf = m_objectUBOs.light[objIdx]; break;
             case 2: buf = m_objectUBOs.material[objIdx]; break;
         }
+        m_context->getMemoryTracker()->untrack(m_objectAllocations[i]);
         vmaDestroyBuffer(allocator, static_cast<VkBuffer>(buf), m_objectAllocations[i]);
     }
 }
@@ -256,7 +342,8 @@ void Renderer::createFrameUBOs() {
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
         this->createUniformBuffer<CameraUBO>(
             m_frameUBOs.camera[i], 
-            m_frameAllocations[i]
+            m_frameAllocations[i],
+            std::format("CameraUBO[frame {}]", i)
         );
     }
 }
@@ -270,15 +357,18 @@ void Renderer::createObjectUBOs(size_t objectCount) {
     for (size_t i = 0; i < objectCount; i++) {
         this->createUniformBuffer<TransformUBO>(
             m_objectUBOs.transform[i],
-            m_objectAllocations[i * 3]
+            m_objectAllocations[i * 3],
+            std::format("TransformUBO[object {}]", i)
         );
         this->createUniformBuffer<LightUBO>(
             m_objectUBOs.light[i],
-            m_objectAllocations[i * 3 + 1]
+            m_objectAllocations[i * 3 + 1],
+            std::format("LightUBO[object {}]", i)
         );
         this->createUniformBuffer<MaterialUBO>(
             m_objectUBOs.material[i],
-            m_objectAllocations[i * 3 + 2]
+            m_objectAllocations[i * 3 + 2],
+            std::format("MaterialUBO[object {}]", i)
         );
     }
 }
@@ -295,12 +385,19 @@ Renderer::~Renderer() {
     // 1. 清理 ImGui
     m_imguiManager.reset();
     m_pipelineManager.reset();
-    // 2. 清理 CommandManager (fences, semaphores, command pools)
+    m_clusterCuller.reset();
+    m_meshShaderPath.reset();
+    if (m_timestampPool) {
+        m_context->getDevice().destroyQueryPool(m_timestampPool);
+    }
+    // 2. 清理 CommandManager (timeline, semaphores, command pools，并执行剩余的延迟删除)
     m_commandManager.reset();
     // 3. 清理 Framebuffers (依赖 swapchain image views 和 depth image)
     cleanupFramebuffers();
-    // 4. 清理深度资源
-    cleanupDepthResources();
+    // 4. 清理帧图（归还 transient 资源到池，随后销毁池）
+    m_features.clear();
+    m_renderGraph.reset();
+    m_renderTargetPool.reset();
     // 5. 清理 Swapchain (images, image views)
     m_swapchain.reset();
     // 6. 清理 DescriptorManager (layouts, pool, sets)
@@ -322,6 +419,9 @@ void Renderer::render(const std::unique_ptr<Scene>& scene) {
     }
     uint32_t imageIndex;
     uint32_t currentFrame = m_commandManager->getCurrentFrameIndex();
+    // 推进 VMA 帧号，使其按帧刷新 VK_EXT_memory_budget 的预算数据
+    vmaSetCurrentFrameIndex(m_context->getVmaAllocator(), ++m_frameNumber);
+    m_renderTargetPool->beginFrame();
 
     try{
         imageIndex = m_commandManager->beginFrame(m_swapchain->getSwapchain());
@@ -343,89 +443,129 @@ void Renderer::render(const std::unique_ptr<Scene>& scene) {
     vk::CommandBuffer commandBuffer = m_commandManager->getCurrentCommandBuffer();
     commandBuffer.reset();
     commandBuffer.begin(vk::CommandBufferBeginInfo{});
-
-    // 4. 主渲染通道
-    vk::RenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.setRenderPass(m_mainRenderPass->getRenderPass());
+    // 上一次使用该槽位时的几何计时已完成：回读后重置本帧的两个时间戳（必须在渲染通道之外）
+    this->readGeometryTimestamps(currentFrame);
+    if (m_timestampPool) {
+        commandBuffer.resetQueryPool(m_timestampPool, currentFrame * 2, 2);
+    }
 
     // 边界检查：确保 imageIndex 在有效范围内
-    if (imageIndex >= m_swapchainFramebuffers.size()) {
-        std::println("Error: imageIndex {} out of bounds (framebuffer count: {})",imageIndex, m_swapchainFramebuffers.size());
+    if (imageIndex >= m_swapchain->getImageCount()) {
+        std::println("Error: imageIndex {} out of bounds (swapchain image count: {})",imageIndex, m_swapchain->getImageCount());
         this->recreateSwapchainAndDependencies();
         return;
     }
 
-    renderPassInfo.setFramebuffer(m_swapchainFramebuffers[imageIndex]);
-    renderPassInfo.setRenderArea({ {0, 0}, m_swapchain->getExtent() });
-    
-    std::array<vk::ClearValue, 2> clearValues{};
-    clearValues[0].setColor(std::array<float, 4>{0.02f, 0.02f, 0.02f, 1.0f});
-    clearValues[1].setDepthStencil({ 1.0f, 0 });
-    renderPassInfo.setClearValues(clearValues);
-    
-    commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
-
-    // 5. 设置动态状态
-    vk::Viewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(m_swapchain->getExtent().width);
-    viewport.height = static_cast<float>(m_swapchain->getExtent().height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    commandBuffer.setViewport(0, viewport);
-
-    vk::Rect2D scissor{};
-    scissor.offset = vk::Offset2D{0, 0};
-    scissor.extent = m_swapchain->getExtent();
-    commandBuffer.setScissor(0, scissor);
-
-    // 6. 遍历场景并录制绘制命令 (优化前)
-    // TODO: 在这里按材质/管线分组以优化性能
-    for (const auto& renderable : scene->getRenderables()) {
-        auto& mesh = renderable->getMesh();
-        auto& material = renderable->getMaterial();
-
-        // 更新物体级 UBO (Set 1)
-        // TransformUBO (binding 0) - 每个对象每帧更新
-        // LightUBO     (binding 1) - 每帧更新 (如果光源会移动)
-        // MaterialUBO  (binding 2) - 每帧更新 (材质参数可能动态变化)
-        this->updateObjectUBO(
-            renderable->getObjectIndex(),
-            renderable->getTransform(),
-            scene->getMainLight(),
-            material.getData()
-        );
+    // 几何体竞技场：碎片过多时整理（拷贝进入上传批次），被替换的旧缓冲在本帧完成后销毁
+    m_context->getGeometryArena()->update(m_commandManager.get());
+
+    // 纹理流式加载：按上一帧的请求升降常驻级别（新图像的拷贝进入上传批次），被替换的旧图像在本帧完成后销毁。
+    // 受影响对象的描述符集副本全部标记为过期
+    TextureStreamer* streamer = m_context->getTextureStreamer();
+    if (streamer->update(m_commandManager.get())) {
+        for (const auto& renderable : scene->getRenderables()) {
+            Material& material = renderable->getMaterial();
+            if (streamer->wasSwapped(material.getAlbedoMap()) || streamer->wasSwapped(material.getNormalMap()) ||
+                streamer->wasSwapped(material.getOrmMap())) {
+                for (auto& stale : m_staleObjectSets) {
+                    stale.insert(renderable->getObjectIndex());
+                }
+            }
+        }
+    }
+    // 只重写当前帧的副本：上一次使用它的帧已在 beginFrame 中等待完成，仍在执行的帧使用的是另一份副本。
+    // 其余副本轮到各自的槽位时再重写；它们引用的旧图像只被更早的帧使用，而旧图像在本帧完成后才销毁
+    if (!m_staleObjectSets[currentFrame].empty()) {
+        for (const auto& renderable : scene->getRenderables()) {
+            if (m_staleObjectSets[currentFrame].contains(renderable->getObjectIndex())) {
+                renderable->getMaterial().bindToDescriptorSet(m_descriptorManager.get(), 1, renderable->getObjectIndex(), currentFrame);
+            }
+        }
+        m_staleObjectSets[currentFrame].clear();
+    }
 
-        PipelineType type = material.getPipelineType();
-        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipelineManager->getPipeline(type));
+    // 上传：提交挂起的传输批次，在帧开头录制 acquire 与 mip 生成，图形提交等待传输时间线
+    UploadEngine* uploads = m_context->getUploadEngine();
+    if (uint64_t uploadValue = uploads->recordGraphicsWork(commandBuffer)) {
+        m_commandManager->addWaitSemaphore(uploads->getTimelineSemaphore(), uploadValue, uploads->getGraphicsWaitStage());
+    }
+    // 计算 mip 生成在传输之后提交到（异步）计算队列，首次使用前还要等待其时间线
+    if (uint64_t mipValue = uploads->getMipWaitValue()) {
+        m_commandManager->addWaitSemaphore(m_context->getMipGenerator()->getTimelineSemaphore(), mipValue,
+                                           uploads->getGraphicsWaitStage());
+    }
 
-        vk::Buffer vertexBuffers[] = { mesh.getVertexBuffer() };
-        vk::DeviceSize offsets[] = { 0 };
-        commandBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
-        commandBuffer.bindIndexBuffer(mesh.getIndexBuffer(), 0, vk::IndexType::eUint32);
+    // 4. 声明本帧的帧图：swapchain image 为导入资源，深度为 transient 资源
+    const vk::Extent2D extent = m_swapchain->getExtent();
+    m_renderGraph->reset();
+    RGHandle backbuffer = m_renderGraph->importImage(
+        "Swapchain",
+        m_swapchain->getImage(imageIndex),
+        m_swapchain->getImageView(imageIndex),
+        RenderTargetDesc{
+            .format = m_swapchain->getImageFormat(),
+            .extent = extent,
+            .usage = vk::ImageUsageFlagBits::eColorAttachment,
+            .samples = vk::SampleCountFlagBits::e1
+        },
+        // 与 imageAvailable 信号量的等待阶段一致
+        RGState{vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined},
+        vk::ImageLayout::ePresentSrcKHR
+    );
+    // 深度只在主通道内使用（storeOp = DontCare），标记为 transient 以便放入惰性分配内存
+    RGHandle depth = m_renderGraph->createImage("Depth", RenderTargetDesc{
+        .format = vk::Format::eD32Sfloat,
+        .extent = extent,
+        .usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransientAttachment,
+        .samples = vk::SampleCountFlagBits::e1
+    });
 
-        // 绑定描述符集
-        std::vector<vk::DescriptorSet> descriptorSetsToBind = {
-            m_descriptorManager->getDescriptorSet(0, currentFrame),                 // Set 0: 帧级 (Camera)
-            m_descriptorManager->getDescriptorSet(1, renderable->getObjectIndex())  // Set 1: 物体级
-        };
-        commandBuffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics,
-            m_pipelineManager->getPipelineLayout(type),
-            0,
-            static_cast<uint32_t>(descriptorSetsToBind.size()),
-            descriptorSetsToBind.data(),
-            0,
-            nullptr
-        );
-        commandBuffer.drawIndexed(mesh.getIndexCount(), 1, 0, 0, 0);
+    FrameGraphContext frame{
+        .graph = *m_renderGraph,
+        .scene = *scene,
+        .frameIndex = currentFrame,
+        .imageIndex = imageIndex,
+        .extent = extent,
+        .backbuffer = backbuffer,
+        .depth = depth
+    };
+    for (auto& feature : m_features) {
+        if (feature->getStage() == RenderFeature::Stage::BeforeMain) feature->setup(frame);
+    }
+    // LOD 选择在两条几何路径之前：簇剔除、网格着色器与顶点输入绘制都按所选级别的索引 / 簇区间
+    this->selectLods(*scene);
+    this->requestTextureMips(*scene);
+    // 几何路径：支持网格着色器时带 meshlet 的网格在 task 阶段剔除，不再需要单独的簇剔除 pass
+    const CameraUBO camera = scene->getCamera().getUBO();
+    m_meshShaderPath->prepare(*scene, currentFrame, camera.position, m_clusterCuller->getSettings());
+    if (m_meshShaderPath->isEnabled()) {
+        m_clusterCuller->skipFrame(currentFrame);
+    } else {
+        m_clusterCuller->addPass(*m_renderGraph, *scene, currentFrame, camera.projection * camera.view, camera.position);
+    }
+    this->addMainPass(frame);
+    for (auto& feature : m_features) {
+        if (feature->getStage() == RenderFeature::Stage::AfterMain) feature->setup(frame);
     }
 
-    // ImGui render (same render pass, draws on top of scene)
-    m_imguiManager->render(commandBuffer);
+    // 5. 编译（拓扑不变时复用缓存）并录制
+    m_renderGraph->compile();
+    if (!m_pendingGraphDump.empty()) {
+        m_renderGraph->exportGraphviz(m_pendingGraphDump);
+        m_pendingGraphDump.clear();
+    }
+    // 异步计算 pass 录制到计算队列的命令缓冲，先于图形提交；图形提交在消费阶段等待计算时间线
+    vk::CommandBuffer computeCommandBuffer = nullptr;
+    if (m_renderGraph->hasAsyncComputeWork()) {
+        computeCommandBuffer = m_commandManager->beginComputeCommands();
+    }
+    m_renderGraph->execute(commandBuffer, computeCommandBuffer);
+    if (computeCommandBuffer) {
+        m_commandManager->submitCompute(computeCommandBuffer,
+                                        m_renderGraph->getGraphicsWaitStage(),
+                                        m_renderGraph->computeWaitsForGraphics());
+    }
 
-    commandBuffer.endRenderPass();
     commandBuffer.end();
     try {
         m_commandManager->endFrame(commandBuffer, m_swapchain->getSwapchain());
@@ -434,57 +574,170 @@ void Renderer::render(const std::unique_ptr<Scene>& scene) {
     }
 }
 
+void Renderer::addMainPass(FrameGraphContext& frame) {
+    const RGHandle backbuffer = frame.backbuffer;
+    const RGHandle depth = frame.depth;
+    const Scene* scene = &frame.scene;
+    const uint32_t currentFrame = frame.frameIndex;
+    const uint32_t imageIndex = frame.imageIndex;
+    const vk::Extent2D extent = frame.extent;
+
+    frame.graph.addPass("Forward",
+        [&](RenderGraphBuilder& builder) {
+            // VkRenderPass 的 finalLayout 会把颜色附件转换为 PresentSrc
+            builder.write(backbuffer, RGAccess::ColorAttachmentWrite, vk::ImageLayout::ePresentSrcKHR);
+            builder.write(depth, RGAccess::DepthAttachmentWrite);
+            m_clusterCuller->declareReads(builder);
+        },
+        [this, depth, scene, currentFrame, imageIndex, extent](vk::CommandBuffer commandBuffer, const RenderGraph& graph) {
+            vk::RenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.setRenderPass(m_mainRenderPass->getRenderPass());
+            renderPassInfo.setFramebuffer(this->getFramebuffer(imageIndex, graph.getImageView(depth)));
+            renderPassInfo.setRenderArea({ {0, 0}, extent });
+
+            std::array<vk::ClearValue, 2> clearValues{};
+            clearValues[0].setColor(std::array<float, 4>{0.02f, 0.02f, 0.02f, 1.0f});
+            clearValues[1].setDepthStencil({ 1.0f, 0 });
+            renderPassInfo.setClearValues(clearValues);
+
+            commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+
+            // 设置动态状态
+            vk::Viewport viewport{};
+            viewport.x = 0.0f;
+            viewport.y = 0.0f;
+            viewport.width = static_cast<float>(extent.width);
+            viewport.height = static_cast<float>(extent.height);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+            commandBuffer.setViewport(0, viewport);
+
+            vk::Rect2D scissor{};
+            scissor.offset = vk::Offset2D{0, 0};
+            scissor.extent = extent;
+            commandBuffer.setScissor(0, scissor);
+
+            // 所有网格共享竞技场的顶点 / 索引缓冲，整个 pass 只绑定一次；
+            // 16 / 32 位索引的网格交替出现时才按新类型重新绑定索引缓冲
+            GeometryArena* arena = m_context->getGeometryArena();
+            vk::IndexType boundIndexType = vk::IndexType::eUint32;
+            arena->bind(commandBuffer, boundIndexType);
+
+            // 几何绘制的 GPU 计时（不含 ImGui），用于比较网格着色器与顶点输入两条路径
+            GeometryTiming& timing = m_geometryTimings[currentFrame];
+            timing.meshShaders = m_meshShaderPath->isEnabled();
+            timing.triangles = 0;
+            if (m_timestampPool) {
+                commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, m_timestampPool, currentFrame * 2);
+            }
+
+            // 遍历场景并录制绘制命令 (优化前)
+            // TODO: 在这里按材质/管线分组以优化性能
+            for (const auto& renderable : scene->getRenderables()) {
+                auto& mesh = renderable->getMesh();
+                auto& material = renderable->getMaterial();
+
+                // 更新物体级 UBO (Set 1)
+                // TransformUBO (binding 0) - 每个对象每帧更新
+                // LightUBO     (binding 1) - 每帧更新 (如果光源会移动)
+                // MaterialUBO  (binding 2) - 每帧更新 (材质参数可能动态变化)
+                // Compact 网格的位置是包围盒内的 unorm16，反量化并入模型矩阵（法线矩阵不变）
+                TransformUBO transform = renderable->getTransform();
+                if (mesh.getVertexFormat() == VertexFormat::Compact) {
+                    transform.model = transform.model * mesh.getDequantizeMatrix();
+                }
+                this->updateObjectUBO(
+                    renderable->getObjectIndex(),
+                    transform,
+                    scene->getMainLight(),
+                    material.getData()
+                );
+
+                vk::DescriptorSet frameSet = m_descriptorManager->getDescriptorSet(0, currentFrame);                 // Set 0: 帧级 (Camera)
+                vk::DescriptorSet objectSet = m_descriptorManager->getDescriptorSet(1, renderable->getObjectIndex(), currentFrame); // Set 1: 物体级
+
+                // 网格着色器路径：task 阶段剔除簇，mesh 阶段直接读取顶点缓冲，不经过顶点输入
+                const MeshLod& lod = mesh.getLod(renderable->getLod());
+                if (m_meshShaderPath->draw(commandBuffer, frameSet, objectSet, *renderable)) {
+                    timing.triangles += lod.indexCount / 3;
+                    continue;
+                }
+
+                PipelineType type = material.getPipelineType();
+                vk::Pipeline pipeline = m_pipelineManager->getPipeline(type, mesh.getVertexFormat());
+                commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+
+                // 绑定描述符集
+                std::vector<vk::DescriptorSet> descriptorSetsToBind = { frameSet, objectSet };
+                commandBuffer.bindDescriptorSets(
+                    vk::PipelineBindPoint::eGraphics,
+                    m_pipelineManager->getPipelineLayout(type),
+                    0,
+                    static_cast<uint32_t>(descriptorSetsToBind.size()),
+                    descriptorSetsToBind.data(),
+                    0,
+                    nullptr
+                );
+                const GeometryRange& range = mesh.getRange();
+                if (range.indexType != boundIndexType) {
+                    boundIndexType = range.indexType;
+                    arena->bindIndices(commandBuffer, boundIndexType);
+                }
+                // 有簇剔除结果时按可见簇间接绘制，否则绘制所选级别的整段索引
+                if (!m_clusterCuller->draw(commandBuffer, graph, *renderable)) {
+                    commandBuffer.drawIndexed(lod.indexCount, 1, range.firstIndex + lod.firstIndex, range.vertexOffset, 0);
+                }
+                timing.triangles += lod.indexCount / 3;
+            }
+            if (m_timestampPool) {
+                commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, m_timestampPool, currentFrame * 2 + 1);
+                timing.written = true;
+            }
+
+            // ImGui render (same render pass, draws on top of scene)
+            m_imguiManager->render(commandBuffer);
+
+            commandBuffer.endRenderPass();
+        });
+}
+
 void Renderer::cleanupFramebuffers(){
     for (auto framebuffer : m_swapchainFramebuffers) {
         m_context->getDevice().destroyFramebuffer(framebuffer,nullptr);
     }
     m_swapchainFramebuffers.clear();
 }
-void Renderer::cleanupDepthResources() {
-    auto device = m_context->getDevice();
-    if (m_depthImageView) {
-        device.destroyImageView(m_depthImageView);
-        m_depthImageView = nullptr;
-    }
-    if (m_depthImage) {
-        device.destroyImage(m_depthImage);
-        m_depthImage = nullptr;
-    }
-    if (m_depthImageMemory) {
-        device.freeMemory(m_depthImageMemory);
-        m_depthImageMemory = nullptr;
-    }
-}
 void Renderer::recreateSwapchainAndDependencies() {
     std::println("=== Starting swapchain recreation ===");
     // 防止递归调用
     auto device = m_context->getDevice();
     device.waitIdle();
     this->cleanupFramebuffers();
-    this->cleanupDepthResources();
-    this->m_commandManager.reset();
+    m_framebufferDepthView = nullptr;
+    // 帧图的 transient 资源依赖旧的 extent，设备空闲时直接释放
+    this->m_renderGraph->invalidate();
     this->m_pipelineManager.reset();
     this->m_swapchain->recreate();
     
-    // 2.2 重建深度资源（需要新的 swapchain extent）
-    this->createDepthResources();
-    this->createFramebuffers();
-    m_pipelineManager = std::make_unique<PipelineManager>(m_context.get());
-    m_pipelineManager->createGraphicsPipeline(
-        PipelineType::Main,
-        {"shaders/pbr.vert.spv", "shaders/pbr.frag.spv"},
-        m_swapchain->getExtent(),
-        m_swapchain->getImageFormat(),
-        m_mainRenderPass->getRenderPass(),
-        m_descriptorManager->getAllDescriptorSetLayouts()
-    );
-    this->m_commandManager = std::make_unique<CommandManager>(m_context.get(),MAX_FRAMES_IN_FLIGHT,static_cast<uint32_t>(m_swapchain->getImageCount()));
+    // 2.2 旧尺寸的渲染目标已空闲，设备空闲时直接回收；新的深度与帧缓冲在下一帧编译帧图时创建
+    this->m_renderTargetPool->trim();
+    this->createPipelines();
+    // 时间线需要跨重建保持单调，只重建与 swapchain 图像数量相关的二值信号量
+    this->m_commandManager->onSwapchainRecreated(static_cast<uint32_t>(m_swapchain->getImageCount()));
     ImGui_ImplVulkan_SetMinImageCount(static_cast<uint32_t>(m_swapchain->getImageCount()));
     this->m_framebufferResized = false;
     std::println("=== Stop swapchain recreation ===");
 }
 
 
+void Renderer::setAsyncComputeEnabled(bool enabled) {
+    m_renderGraph->setAsyncComputeEnabled(enabled && m_commandManager->isAsyncComputeAvailable());
+}
+
+bool Renderer::isAsyncComputeEnabled() const {
+    return m_renderGraph->isAsyncComputeEnabled();
+}
+
 void Renderer::waitForIdle() {
     if (m_context && m_context->getDevice()) {
         m_context->getDevice().waitIdle();
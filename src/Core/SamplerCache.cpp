@@ -0,0 +1,94 @@
+#include "Core/SamplerCache.h"
+#include "Core/Context.h"
+#include <bit>
+#include <string>
+#include <stdexcept>
+
+namespace {
+    void hashCombine(size_t& seed, uint64_t value) {
+        seed ^= std::hash<uint64_t>{}(value) + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2);
+    }
+
+    uint64_t floatBits(float value) {
+        return std::bit_cast<uint32_t>(value);
+    }
+}
+
+size_t SamplerCache::CreateInfoHash::operator()(const vk::SamplerCreateInfo& info) const {
+    size_t seed = 0;
+    hashCombine(seed, static_cast<uint32_t>(info.flags));
+    hashCombine(seed, static_cast<uint64_t>(info.magFilter) | static_cast<uint64_t>(info.minFilter) << 8
+                    | static_cast<uint64_t>(info.mipmapMode) << 16);
+    hashCombine(seed, static_cast<uint64_t>(info.addressModeU) | static_cast<uint64_t>(info.addressModeV) << 8
+                    | static_cast<uint64_t>(info.addressModeW) << 16);
+    hashCombine(seed, floatBits(info.mipLodBias));
+    hashCombine(seed, static_cast<uint64_t>(info.anisotropyEnable) << 32 | floatBits(info.maxAnisotropy));
+    hashCombine(seed, static_cast<uint64_t>(info.compareEnable) << 32 | static_cast<uint32_t>(info.compareOp));
+    hashCombine(seed, floatBits(info.minLod) << 32 | floatBits(info.maxLod));
+    hashCombine(seed, static_cast<uint64_t>(info.borderColor) << 32 | info.unnormalizedCoordinates);
+    return seed;
+}
+
+bool SamplerCache::CreateInfoEqual::operator()(const vk::SamplerCreateInfo& a, const vk::SamplerCreateInfo& b) const {
+    // 浮点字段按位比较，与哈希保持一致
+    return a.flags == b.flags &&
+           a.magFilter == b.magFilter && a.minFilter == b.minFilter && a.mipmapMode == b.mipmapMode &&
+           a.addressModeU == b.addressModeU && a.addressModeV == b.addressModeV && a.addressModeW == b.addressModeW &&
+           floatBits(a.mipLodBias) == floatBits(b.mipLodBias) &&
+           a.anisotropyEnable == b.anisotropyEnable && floatBits(a.maxAnisotropy) == floatBits(b.maxAnisotropy) &&
+           a.compareEnable == b.compareEnable && a.compareOp == b.compareOp &&
+           floatBits(a.minLod) == floatBits(b.minLod) && floatBits(a.maxLod) == floatBits(b.maxLod) &&
+           a.borderColor == b.borderColor && a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+}
+
+SamplerCache::SamplerCache(Context* context)
+    : m_context(context)
+    , m_maxSamplers(context->getPhysicalDevice().getProperties().limits.maxSamplerAllocationCount) {
+}
+
+SamplerCache::~SamplerCache() {
+    for (const auto& [info, sampler] : m_samplers) {
+        m_context->getDevice().destroySampler(sampler);
+    }
+}
+
+vk::Sampler SamplerCache::getSampler(const vk::SamplerCreateInfo& info) {
+    if (info.pNext) {
+        throw std::runtime_error("SamplerCache: sampler create info with a pNext chain cannot be cached");
+    }
+    m_requests++;
+    if (auto it = m_samplers.find(info); it != m_samplers.end()) {
+        return it->second;
+    }
+    if (m_samplers.size() >= m_maxSamplers) {
+        throw std::runtime_error("SamplerCache: device sampler limit reached (" + std::to_string(m_maxSamplers) + ")");
+    }
+    vk::Sampler sampler = m_context->getDevice().createSampler(info);
+    if (!sampler) {
+        throw std::runtime_error("Failed to create sampler");
+    }
+    m_samplers.emplace(info, sampler);
+    return sampler;
+}
+
+vk::SamplerCreateInfo SamplerCache::getDefaultCreateInfo() const {
+    vk::PhysicalDeviceProperties properties = m_context->getPhysicalDevice().getProperties();
+
+    vk::SamplerCreateInfo samplerInfo{};
+    samplerInfo.magFilter = vk::Filter::eLinear;
+    samplerInfo.minFilter = vk::Filter::eLinear;
+    samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
+    samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
+    samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
+    samplerInfo.anisotropyEnable = VK_TRUE;
+    samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = vk::CompareOp::eAlways;
+    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+    samplerInfo.mipLodBias = 0.0f;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    return samplerInfo;
+}
@@ -208,6 +208,9 @@ vk::Extent2D SwapchainManager::getExtent() const {
 size_t SwapchainManager::getImageCount() const {
     return m_swapchainImages.size();
 }
+const vk::Image& SwapchainManager::getImage(size_t index) const{
+    return m_swapchainImages.at(index);
+}
 const vk::ImageView& SwapchainManager::getImageView(size_t index) const{
     return m_swapchainImageViews.at(index);
 }
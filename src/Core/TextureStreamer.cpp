@@ -0,0 +1,204 @@
+#include "Core/TextureStreamer.h"
+#include "Core/Context.h"
+#include "Core/Command.h"
+#include "Assets/Texture.h"
+#include <print>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // 边长不超过 initialSize 的第一级，且不高于质量上限
+    uint32_t getSmallMip(uint32_t width, uint32_t height, uint32_t levelCount, const TextureStreamerSettings& settings) {
+        uint32_t mip = 0;
+        while (mip + 1 < levelCount && std::max(width >> mip, height >> mip) > settings.initialSize) {
+            mip++;
+        }
+        return std::min(std::max(mip, settings.qualityCap), levelCount - 1);
+    }
+}
+
+TextureStreamer::TextureStreamer(Context* context)
+    : m_context(context) {
+}
+
+bool TextureStreamer::canStream(const TextureView& view) const {
+    return m_settings.enabled && view.levelCount > 1;
+}
+
+uint32_t TextureStreamer::getInitialMip(const TextureView& view) const {
+    return getSmallMip(view.width, view.height, std::max(view.levelCount, 1u), m_settings);
+}
+
+uint32_t TextureStreamer::getBaselineMip(const Texture& texture) const {
+    return getSmallMip(texture.getWidth(), texture.getHeight(), texture.getMipLevels(), m_settings);
+}
+
+void TextureStreamer::registerTexture(Texture* texture) {
+    m_entries[texture] = Entry{texture, UINT32_MAX, m_frame};
+    m_stats.textureCount = static_cast<uint32_t>(m_entries.size());
+}
+
+void TextureStreamer::unregisterTexture(Texture* texture) {
+    m_entries.erase(texture);
+    m_swapped.erase(texture);
+    m_stats.textureCount = static_cast<uint32_t>(m_entries.size());
+}
+
+void TextureStreamer::requestTexture(Texture* texture, float uvPerPixel) {
+    if (!texture) {
+        return;
+    }
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end()) {
+        return;
+    }
+    // 硬件按 log2(每像素纹素数) 选择级别，三线性在相邻两级之间混合，所以需要向下取整的那一级；
+    // 没有 UV（密度为 0）时只需要最小一级
+    const uint32_t lastMip = texture->getMipLevels() - 1;
+    const float texelsPerPixel = static_cast<float>(std::max(texture->getWidth(), texture->getHeight())) * uvPerPixel;
+    uint32_t mip = lastMip;
+    if (texelsPerPixel > 0.0f) {
+        const float level = std::log2(texelsPerPixel) + m_settings.mipBias;
+        mip = level <= 0.0f ? 0 : static_cast<uint32_t>(std::min(level, static_cast<float>(lastMip)));
+    }
+    it->second.requestedMip = std::min(it->second.requestedMip, mip);
+    it->second.lastUsed = m_frame;
+}
+
+void TextureStreamer::setResidentMip(Entry& entry, uint32_t mip, CommandManager* commands) {
+    const uint32_t previous = entry.texture->getResidentMip();
+    std::function<void()> release;
+    try {
+        release = entry.texture->setResidentMip(mip, commands);
+    } catch (const std::exception& e) {
+        std::println("Warning: TextureStreamer: {} stays at mip {}: {}", entry.texture->getName(), previous, e.what());
+        return;
+    }
+    if (!release) {
+        return;
+    }
+    commands->deferDestroy(std::move(release));
+    m_swapped.insert(entry.texture);
+    if (mip < previous) {
+        m_stats.upgrades++;
+    } else {
+        m_stats.downgrades++;
+    }
+    const VkDeviceSize bytes = entry.texture->getLevelBytes(entry.texture->getResidentMip());
+    m_stats.frameUploadBytes += bytes;
+    m_stats.uploadedBytes += bytes;
+}
+
+bool TextureStreamer::update(CommandManager* commands) {
+    m_swapped.clear();
+    m_stats.frameUploadBytes = 0;
+    m_stats.visibleCount = 0;
+    m_stats.pendingCount = 0;
+    m_stats.requestedBytes = 0;
+    // requestTexture 以 m_frame 标记上一帧的请求，之后的请求属于下一次 update
+    const uint64_t visibleFrame = m_frame++;
+
+    std::vector<Entry*> entries;
+    entries.reserve(m_entries.size());
+    for (auto& [texture, entry] : m_entries) {
+        entries.push_back(&entry);
+    }
+    auto resetRequests = [&]() {
+        for (Entry* entry : entries) entry->requestedMip = UINT32_MAX;
+    };
+    if (!m_settings.enabled) {
+        resetRequests();
+        return false;
+    }
+
+    // 有请求时取请求的级别，没有请求时保持当前级别；都不高于质量上限
+    auto getTargetMip = [&](const Entry& entry) {
+        const Texture& texture = *entry.texture;
+        const uint32_t requested = entry.requestedMip == UINT32_MAX ? texture.getResidentMip() : entry.requestedMip;
+        return std::min(std::max(requested, m_settings.qualityCap), texture.getMipLevels() - 1);
+    };
+    VkDeviceSize resident = 0;
+    for (const Entry* entry : entries) {
+        resident += entry->texture->getLevelBytes(entry->texture->getResidentMip());
+    }
+    auto moveTo = [&](Entry& entry, uint32_t mip) {
+        resident -= entry.texture->getLevelBytes(entry.texture->getResidentMip());
+        this->setResidentMip(entry, mip, commands);
+        resident += entry.texture->getLevelBytes(entry.texture->getResidentMip());
+    };
+
+    // 1. 质量上限提高（数值变大）后，高于上限的级别直接释放
+    for (Entry* entry : entries) {
+        if (entry->texture->getResidentMip() < m_settings.qualityCap) {
+            moveTo(*entry, m_settings.qualityCap);
+        }
+    }
+
+    // 上一帧不可见的纹理按 LRU 退回初始级别，直到常驻数据量不超过 limit
+    std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) { return a->lastUsed < b->lastUsed; });
+    auto releaseStale = [&](VkDeviceSize limit) {
+        for (Entry* entry : entries) {
+            if (resident <= limit || entry->lastUsed >= visibleFrame) break;
+            const uint32_t baseline = this->getBaselineMip(*entry->texture);
+            if (entry->texture->getResidentMip() < baseline) {
+                moveTo(*entry, baseline);
+            }
+        }
+    };
+
+    // 2. 升级：缺的级别最多的先上传；预算不足时先释放不可见的纹理，仍放不下则留到以后
+    std::vector<Entry*> upgrades;
+    for (Entry* entry : entries) {
+        if (entry->lastUsed != visibleFrame) continue;
+        m_stats.visibleCount++;
+        if (getTargetMip(*entry) < entry->texture->getResidentMip()) upgrades.push_back(entry);
+    }
+    std::sort(upgrades.begin(), upgrades.end(), [&](const Entry* a, const Entry* b) {
+        return a->texture->getResidentMip() - getTargetMip(*a) > b->texture->getResidentMip() - getTargetMip(*b);
+    });
+    const VkDeviceSize budget = m_settings.budgetBytes;
+    for (Entry* entry : upgrades) {
+        const uint32_t mip = getTargetMip(*entry);
+        const VkDeviceSize bytes = entry->texture->getLevelBytes(mip);
+        const VkDeviceSize cost = bytes - entry->texture->getLevelBytes(entry->texture->getResidentMip());
+        if (m_stats.frameUploadBytes > 0 && m_stats.frameUploadBytes + bytes > m_settings.maxUploadBytesPerFrame) {
+            m_stats.pendingCount++;
+            continue;
+        }
+        if (resident + cost > budget) {
+            releaseStale(budget > cost ? budget - cost : 0);
+        }
+        if (resident + cost > budget) {
+            m_stats.pendingCount++;
+            continue;
+        }
+        moveTo(*entry, mip);
+    }
+
+    // 3. 仍超出预算（预算调低）：先释放不可见的纹理，再逐级降低最大的可见纹理
+    releaseStale(budget);
+    while (resident > budget) {
+        Entry* largest = nullptr;
+        VkDeviceSize largestBytes = 0;
+        for (Entry* entry : entries) {
+            const Texture& texture = *entry->texture;
+            const VkDeviceSize bytes = texture.getLevelBytes(texture.getResidentMip());
+            if (texture.getResidentMip() + 1 < texture.getMipLevels() && bytes > largestBytes) {
+                largest = entry;
+                largestBytes = bytes;
+            }
+        }
+        if (!largest) break;
+        const uint32_t previous = largest->texture->getResidentMip();
+        moveTo(*largest, previous + 1);
+        if (largest->texture->getResidentMip() == previous) break;     // 重建失败
+    }
+
+    for (const Entry* entry : entries) {
+        const Texture& texture = *entry->texture;
+        m_stats.requestedBytes += texture.getLevelBytes(entry->lastUsed == visibleFrame ? getTargetMip(*entry) : texture.getResidentMip());
+    }
+    m_stats.residentBytes = resident;
+    resetRequests();
+    return !m_swapped.empty();
+}
@@ -0,0 +1,533 @@
+#include "Core/UploadEngine.h"
+#include "Core/Context.h"
+#include <print>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    vk::ImageSubresourceRange colorRange(uint32_t baseMip, uint32_t mipCount) {
+        return vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, baseMip, mipCount, 0, 1};
+    }
+}
+
+UploadEngine::UploadEngine(Context* context, vk::DeviceSize ringSize)
+    : m_context(context) {
+    // 没有独立传输队列族时退化为图形队列，此时不需要所有权转移
+    const uint32_t graphicsFamily = m_context->getGraphicsQueueFamily();
+    if (m_context->hasTransferQueue()) {
+        m_queue = m_context->getTransferQueue();
+        m_queueFamily = m_context->getTransferQueueFamily();
+    } else {
+        m_queue = m_context->getGraphicsQueue();
+        m_queueFamily = graphicsFamily;
+    }
+    m_ownershipTransfer = m_queueFamily != graphicsFamily;
+
+    try {
+        vk::SemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+        typeInfo.initialValue = 0;
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.pNext = &typeInfo;
+        m_timeline = m_context->getDevice().createSemaphore(semaphoreInfo);
+    } catch (const vk::SystemError& err) {
+        throw std::runtime_error("Failed to create upload timeline semaphore: " + std::string(err.what()));
+    }
+
+    this->createRingBuffer(ringSize);
+    std::println("UploadEngine: {} MB staging ring on queue family {}{}",
+                 ringSize / (1024 * 1024), m_queueFamily,
+                 m_ownershipTransfer ? " (ownership transfer to graphics)" : "");
+}
+
+UploadEngine::~UploadEngine() {
+    this->waitIdle();
+    auto device = m_context->getDevice();
+    if (m_ringBuffer && m_ringAllocation != VK_NULL_HANDLE) {
+        m_context->getMemoryTracker()->untrack(m_ringAllocation);
+        vmaDestroyBuffer(m_context->getVmaAllocator(), static_cast<VkBuffer>(m_ringBuffer), m_ringAllocation);
+        m_ringBuffer = nullptr;
+        m_ringAllocation = VK_NULL_HANDLE;
+    }
+    if (m_timeline) {
+        device.destroySemaphore(m_timeline);
+        m_timeline = nullptr;
+    }
+}
+
+void UploadEngine::createRingBuffer(vk::DeviceSize capacity) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // 持久映射，CPU 只顺序写入
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VkBuffer buffer;
+    VmaAllocationInfo info{};
+    if (vmaCreateBuffer(m_context->getVmaAllocator(), &bufferInfo, &allocInfo, &buffer, &m_ringAllocation, &info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload staging ring!");
+    }
+    m_ringBuffer = buffer;
+    m_ringMapped = static_cast<uint8_t*>(info.pMappedData);
+    m_ringCapacity = capacity;
+    m_context->getMemoryTracker()->track(m_ringAllocation, "UploadEngine [staging ring]", MemoryCategory::Staging);
+}
+
+vk::CommandBuffer UploadEngine::getRecordingCommandBuffer() {
+    if (!m_recording) {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandPool = m_context->getTransientCommandPool();
+        allocInfo.commandBufferCount = 1;
+        m_recording = m_context->getDevice().allocateCommandBuffers(allocInfo)[0];
+        m_recording.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    }
+    return m_recording;
+}
+
+bool UploadEngine::tryAllocateRing(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset) {
+    if (m_used == 0) {
+        m_head = 0;
+    }
+    offset = alignUp(m_head, alignment);
+    vk::DeviceSize padding = offset - m_head;
+    // 尾部放不下时回绕到开头，尾部剩余空间计为填充，随该批次一起回收
+    if (offset + size > m_ringCapacity) {
+        padding = m_ringCapacity - m_head;
+        offset = 0;
+    }
+    if (m_used + padding + size > m_ringCapacity) {
+        return false;
+    }
+    m_head = offset + size;
+    if (m_head == m_ringCapacity) {
+        m_head = 0;
+    }
+    m_used += padding + size;
+    m_current.ringBytes += padding + size;
+    return true;
+}
+
+UploadEngine::StagingAllocation UploadEngine::allocateStaging(vk::DeviceSize size, vk::DeviceSize alignment) {
+    // 超过环形缓冲容量的上传（例如超大纹理）单独分配，批次完成后销毁
+    if (size > m_ringCapacity) {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        DedicatedStaging staging;
+        VmaAllocationInfo info{};
+        if (vmaCreateBuffer(m_context->getVmaAllocator(), &bufferInfo, &allocInfo, &staging.buffer, &staging.allocation, &info) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create dedicated staging buffer!");
+        }
+        m_context->getMemoryTracker()->track(staging.allocation, "UploadEngine [dedicated staging]", MemoryCategory::Staging);
+        m_current.dedicated.push_back(staging);
+        return StagingAllocation{staging.buffer, 0, info.pMappedData};
+    }
+
+    this->retireBatches(this->completedValue());
+    vk::DeviceSize offset = 0;
+    while (!this->tryAllocateRing(size, alignment, offset)) {
+        // 当前批次占用的空间只有提交后才能回收
+        if (m_recording) {
+            this->flush();
+        }
+        if (m_inFlight.empty()) {
+            throw std::runtime_error("UploadEngine: staging ring exhausted!");
+        }
+        this->waitForOldestBatch();
+    }
+    return StagingAllocation{m_ringBuffer, offset, m_ringMapped + offset};
+}
+
+uint64_t UploadEngine::uploadBuffer(vk::Buffer dst, const void* data, vk::DeviceSize size, vk::DeviceSize dstOffset,
+                                    vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess, bool concurrent) {
+    if (size == 0) {
+        return m_submittedValue;
+    }
+    // 先分配 staging（可能触发 flush），再取当前批次的命令缓冲
+    StagingAllocation staging = this->allocateStaging(size, 16);
+    std::memcpy(staging.mapped, data, static_cast<size_t>(size));
+    // 非 HOST_COHERENT 内存需要显式 flush，一致性内存上为空操作
+    if (staging.buffer == m_ringBuffer) {
+        vmaFlushAllocation(m_context->getVmaAllocator(), m_ringAllocation, staging.offset, size);
+    } else {
+        vmaFlushAllocation(m_context->getVmaAllocator(), m_current.dedicated.back().allocation, 0, size);
+    }
+
+    vk::CommandBuffer commandBuffer = this->getRecordingCommandBuffer();
+    commandBuffer.copyBuffer(staging.buffer, dst, vk::BufferCopy{staging.offset, dstOffset, size});
+
+    if (m_ownershipTransfer && !concurrent) {
+        // release：目标阶段/访问在 release 中被忽略，由图形侧的 acquire 给出
+        vk::BufferMemoryBarrier2 release{};
+        release.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+        release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        release.srcQueueFamilyIndex = m_queueFamily;
+        release.dstQueueFamilyIndex = m_context->getGraphicsQueueFamily();
+        release.buffer = dst;
+        release.offset = dstOffset;
+        release.size = size;
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setBufferMemoryBarriers(release));
+        m_graphicsBufferOps.push_back(GraphicsBufferOp{dst, dstOffset, size, dstStage, dstAccess});
+    }
+    m_pendingWaitStage |= dstStage;
+    m_uploadCount++;
+    m_uploadedBytes += size;
+    return m_submittedValue + 1;
+}
+
+uint64_t UploadEngine::copyBuffer(vk::Buffer src, vk::Buffer dst, const std::vector<vk::BufferCopy>& regions,
+                                  vk::PipelineStageFlags2 dstStage) {
+    if (regions.empty()) {
+        return m_submittedValue;
+    }
+    vk::CommandBuffer commandBuffer = this->getRecordingCommandBuffer();
+    // 源区间可能刚被同一队列上更早的上传写入
+    vk::MemoryBarrier2 barrier{};
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    barrier.dstStageMask = vk::PipelineStageFlagBits2::eCopy;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eTransferRead;
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(barrier));
+    commandBuffer.copyBuffer(src, dst, regions);
+
+    m_pendingWaitStage |= dstStage;
+    m_uploadCount++;
+    for (const auto& region : regions) {
+        m_uploadedBytes += region.size;
+    }
+    return m_submittedValue + 1;
+}
+
+uint64_t UploadEngine::uploadImage(const ImageUploadDesc& desc, const void* data, vk::DeviceSize size) {
+    return this->uploadImage(desc, size, [data, size](uint8_t* mapped) {
+        std::memcpy(mapped, data, static_cast<size_t>(size));
+    });
+}
+
+uint64_t UploadEngine::uploadImage(const ImageUploadDesc& desc, vk::DeviceSize size, const std::function<void(uint8_t* mapped)>& write) {
+    StagingAllocation staging = this->allocateStaging(size, 16);
+    write(static_cast<uint8_t*>(staging.mapped));
+    if (staging.buffer == m_ringBuffer) {
+        vmaFlushAllocation(m_context->getVmaAllocator(), m_ringAllocation, staging.offset, size);
+    } else {
+        vmaFlushAllocation(m_context->getVmaAllocator(), m_current.dedicated.back().allocation, 0, size);
+    }
+
+    vk::CommandBuffer commandBuffer = this->getRecordingCommandBuffer();
+
+    // 1. Undefined -> TransferDst（全部 mip）
+    vk::ImageMemoryBarrier2 toTransfer{};
+    toTransfer.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+    toTransfer.srcAccessMask = vk::AccessFlagBits2::eNone;
+    toTransfer.dstStageMask = vk::PipelineStageFlagBits2::eCopy;
+    toTransfer.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    toTransfer.oldLayout = vk::ImageLayout::eUndefined;
+    toTransfer.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = desc.image;
+    toTransfer.subresourceRange = colorRange(0, desc.mipLevels);
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(toTransfer));
+
+    // 2. 拷贝 mip 0，或预先生成的全部 mip 级（一次 copyBufferToImage，多个 region）
+    std::vector<vk::BufferImageCopy> regions;
+    const uint32_t copiedLevels = desc.levelOffsets.empty() ? 1 : static_cast<uint32_t>(desc.levelOffsets.size());
+    for (uint32_t level = 0; level < copiedLevels; level++) {
+        vk::BufferImageCopy region{};
+        region.bufferOffset = staging.offset + (desc.levelOffsets.empty() ? 0 : desc.levelOffsets[level]);
+        region.imageSubresource = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, level, 0, 1};
+        region.imageOffset = vk::Offset3D{0, 0, 0};
+        region.imageExtent = vk::Extent3D{std::max(desc.extent.width >> level, 1u), std::max(desc.extent.height >> level, 1u), 1};
+        regions.push_back(region);
+    }
+    commandBuffer.copyBufferToImage(staging.buffer, desc.image, vk::ImageLayout::eTransferDstOptimal, regions);
+
+    // 3. 需要生成 mip 时保持 TransferDst，交给图形队列 blit；计算生成时转换到 General；否则直接转换到最终布局
+    const bool needsMips = desc.needsMipGeneration();
+    MipGenerator* mips = m_context->getMipGenerator();
+    const bool computeMips = needsMips && desc.storageMips && mips
+        && mips->supports(desc.format, desc.extent.width, desc.extent.height, desc.mipLevels);
+    if (computeMips) {
+        this->recordMipJob(commandBuffer, desc);
+        m_uploadCount++;
+        m_uploadedBytes += size;
+        return m_submittedValue + 1;
+    }
+    const vk::ImageLayout releasedLayout = needsMips ? vk::ImageLayout::eTransferDstOptimal : desc.finalLayout;
+
+    vk::ImageMemoryBarrier2 release{};
+    release.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+    release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    release.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    release.newLayout = releasedLayout;
+    release.image = desc.image;
+    release.subresourceRange = colorRange(0, desc.mipLevels);
+    if (m_ownershipTransfer) {
+        release.srcQueueFamilyIndex = m_queueFamily;
+        release.dstQueueFamilyIndex = m_context->getGraphicsQueueFamily();
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(release));
+        m_graphicsImageOps.push_back(GraphicsImageOp{desc, releasedLayout});
+    } else {
+        // 同一队列族：图形提交对传输时间线的等待已经提供内存依赖
+        if (!needsMips) {
+            release.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            release.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            release.dstStageMask = desc.dstStage;
+            release.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(release));
+        } else {
+            m_graphicsImageOps.push_back(GraphicsImageOp{desc, releasedLayout});
+        }
+    }
+    m_pendingWaitStage |= needsMips ? vk::PipelineStageFlagBits2::eBlit : desc.dstStage;
+    m_uploadCount++;
+    m_uploadedBytes += size;
+    return m_submittedValue + 1;
+}
+
+void UploadEngine::recordMipJob(vk::CommandBuffer commandBuffer, const ImageUploadDesc& desc) {
+    // 生成所在的队列族不同时 release 给它（由 MipGenerator acquire），否则在这里转换布局，
+    // 生成提交对传输时间线的等待提供内存依赖
+    const uint32_t mipFamily = m_context->getMipGenerator()->getQueueFamily();
+    vk::ImageMemoryBarrier2 release{};
+    release.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+    release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    release.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    release.newLayout = vk::ImageLayout::eGeneral;
+    release.srcQueueFamilyIndex = mipFamily != m_queueFamily ? m_queueFamily : VK_QUEUE_FAMILY_IGNORED;
+    release.dstQueueFamilyIndex = mipFamily != m_queueFamily ? mipFamily : VK_QUEUE_FAMILY_IGNORED;
+    release.image = desc.image;
+    release.subresourceRange = colorRange(0, desc.mipLevels);
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(release));
+
+    MipJob job{};
+    job.image = desc.image;
+    job.format = desc.format;
+    job.extent = vk::Extent2D{desc.extent.width, desc.extent.height};
+    job.mipLevels = desc.mipLevels;
+    job.finalLayout = desc.finalLayout;
+    job.dstStage = desc.dstStage;
+    job.srcQueueFamily = release.srcQueueFamilyIndex;
+    m_mipJobs.push_back(job);
+    m_pendingWaitStage |= desc.dstStage;
+}
+
+uint64_t UploadEngine::flush() {
+    if (!m_recording) {
+        return m_submittedValue;
+    }
+    m_recording.end();
+
+    const uint64_t signalValue = m_submittedValue + 1;
+    vk::SemaphoreSubmitInfo signalInfo{m_timeline, signalValue, vk::PipelineStageFlagBits2::eAllCommands};
+    vk::CommandBufferSubmitInfo commandBufferInfo{m_recording};
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.setCommandBufferInfos(commandBufferInfo)
+              .setSignalSemaphoreInfos(signalInfo);
+    m_queue.submit2(submitInfo);
+
+    m_current.value = signalValue;
+    m_current.commandBuffer = m_recording;
+    m_inFlight.push_back(std::move(m_current));
+    m_current = Batch{};
+    m_recording = nullptr;
+    m_submittedValue = signalValue;
+    m_batchCount++;
+    return signalValue;
+}
+
+uint64_t UploadEngine::recordGraphicsWork(vk::CommandBuffer commandBuffer) {
+    this->flush();
+    this->retireBatches(this->completedValue());
+    m_mipWaitValue = 0;
+    if (m_submittedValue <= m_graphicsWaitedValue) {
+        return 0;
+    }
+    const vk::PipelineStageFlags2 waitStage = m_pendingWaitStage ? m_pendingWaitStage
+                                                                 : vk::PipelineStageFlags2(vk::PipelineStageFlagBits2::eAllCommands);
+
+    // 1. acquire：与传输侧的 release 一一对应（同一队列族时没有 acquire），源阶段与信号量等待阶段一致
+    const uint32_t graphicsFamily = m_context->getGraphicsQueueFamily();
+    std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+    bufferBarriers.reserve(m_graphicsBufferOps.size());
+    for (const auto& op : m_graphicsBufferOps) {
+        vk::BufferMemoryBarrier2 acquire{};
+        acquire.srcStageMask = waitStage;
+        acquire.dstStageMask = op.dstStage;
+        acquire.dstAccessMask = op.dstAccess;
+        acquire.srcQueueFamilyIndex = m_queueFamily;
+        acquire.dstQueueFamilyIndex = graphicsFamily;
+        acquire.buffer = op.buffer;
+        acquire.offset = op.offset;
+        acquire.size = op.size;
+        bufferBarriers.push_back(acquire);
+    }
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    for (const auto& op : m_graphicsImageOps) {
+        if (!m_ownershipTransfer) continue;
+        const bool needsMips = op.desc.needsMipGeneration();
+        vk::ImageMemoryBarrier2 acquire{};
+        acquire.srcStageMask = waitStage;
+        acquire.dstStageMask = needsMips ? vk::PipelineStageFlagBits2::eBlit : op.desc.dstStage;
+        acquire.dstAccessMask = needsMips ? (vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite)
+                                          : vk::AccessFlagBits2::eShaderSampledRead;
+        acquire.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        acquire.newLayout = op.releasedLayout;
+        acquire.srcQueueFamilyIndex = m_queueFamily;
+        acquire.dstQueueFamilyIndex = graphicsFamily;
+        acquire.image = op.desc.image;
+        acquire.subresourceRange = colorRange(0, op.desc.mipLevels);
+        imageBarriers.push_back(acquire);
+    }
+
+    // 计算 mip 生成：在传输批次之后提交，异步计算时 acquire 与生成侧的 release（General -> 最终布局）对应
+    MipGenerator* mips = m_context->getMipGenerator();
+    if (!m_mipJobs.empty()) {
+        m_mipWaitValue = mips->submit(m_mipJobs, m_timeline, m_submittedValue);
+        for (const auto& job : m_mipJobs) {
+            if (mips->getQueueFamily() == graphicsFamily) continue;
+            vk::ImageMemoryBarrier2 acquire{};
+            acquire.srcStageMask = waitStage;
+            acquire.dstStageMask = job.dstStage;
+            acquire.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+            acquire.oldLayout = vk::ImageLayout::eGeneral;
+            acquire.newLayout = job.finalLayout;
+            acquire.srcQueueFamilyIndex = mips->getQueueFamily();
+            acquire.dstQueueFamilyIndex = graphicsFamily;
+            acquire.image = job.image;
+            acquire.subresourceRange = colorRange(0, job.mipLevels);
+            imageBarriers.push_back(acquire);
+        }
+        m_mipJobs.clear();
+    }
+    if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}
+            .setBufferMemoryBarriers(bufferBarriers)
+            .setImageMemoryBarriers(imageBarriers));
+    }
+
+    // 2. blit 只能在图形队列上执行
+    for (const auto& op : m_graphicsImageOps) {
+        if (op.desc.needsMipGeneration()) {
+            this->recordMipmaps(commandBuffer, op.desc);
+        }
+    }
+
+    m_graphicsBufferOps.clear();
+    m_graphicsImageOps.clear();
+    m_graphicsWaitStage = waitStage;
+    m_pendingWaitStage = {};
+    m_graphicsWaitedValue = m_submittedValue;
+    return m_submittedValue;
+}
+
+void UploadEngine::recordMipmaps(vk::CommandBuffer commandBuffer, const ImageUploadDesc& desc) {
+    vk::ImageMemoryBarrier2 barrier{};
+    barrier.image = desc.image;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    int32_t mipWidth = static_cast<int32_t>(desc.extent.width);
+    int32_t mipHeight = static_cast<int32_t>(desc.extent.height);
+
+    for (uint32_t i = 1; i < desc.mipLevels; i++) {
+        // 上一级 TransferDst -> TransferSrc
+        barrier.subresourceRange = colorRange(i - 1, 1);
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eBlit | vk::PipelineStageFlagBits2::eCopy;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        barrier.dstStageMask = vk::PipelineStageFlagBits2::eBlit;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eTransferRead;
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barrier));
+
+        vk::ImageBlit blit{};
+        blit.srcOffsets[0] = vk::Offset3D{0, 0, 0};
+        blit.srcOffsets[1] = vk::Offset3D{mipWidth, mipHeight, 1};
+        blit.srcSubresource = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, i - 1, 0, 1};
+        blit.dstOffsets[0] = vk::Offset3D{0, 0, 0};
+        blit.dstOffsets[1] = vk::Offset3D{mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
+        blit.dstSubresource = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, i, 0, 1};
+        commandBuffer.blitImage(desc.image, vk::ImageLayout::eTransferSrcOptimal,
+                                desc.image, vk::ImageLayout::eTransferDstOptimal,
+                                blit, vk::Filter::eLinear);
+
+        // 上一级 TransferSrc -> 最终布局
+        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.newLayout = desc.finalLayout;
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eBlit;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eTransferRead;
+        barrier.dstStageMask = desc.dstStage;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barrier));
+
+        if (mipWidth > 1) mipWidth /= 2;
+        if (mipHeight > 1) mipHeight /= 2;
+    }
+
+    // 最后一级只被写过
+    barrier.subresourceRange = colorRange(desc.mipLevels - 1, 1);
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = desc.finalLayout;
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eBlit;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    barrier.dstStageMask = desc.dstStage;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{}.setImageMemoryBarriers(barrier));
+}
+
+uint64_t UploadEngine::completedValue() const {
+    return m_context->getDevice().getSemaphoreCounterValue(m_timeline);
+}
+
+void UploadEngine::retireBatches(uint64_t completedValue) {
+    auto device = m_context->getDevice();
+    // 批次按提交顺序入队，遇到第一个未完成的即可停止
+    while (!m_inFlight.empty() && m_inFlight.front().value <= completedValue) {
+        Batch& batch = m_inFlight.front();
+        device.freeCommandBuffers(m_context->getTransientCommandPool(), batch.commandBuffer);
+        for (auto& staging : batch.dedicated) {
+            m_context->getMemoryTracker()->untrack(staging.allocation);
+            vmaDestroyBuffer(m_context->getVmaAllocator(), staging.buffer, staging.allocation);
+        }
+        m_used -= batch.ringBytes;
+        m_inFlight.pop_front();
+    }
+}
+
+void UploadEngine::waitForOldestBatch() {
+    if (m_inFlight.empty()) return;
+    vk::SemaphoreWaitInfo waitInfo{};
+    waitInfo.setSemaphores(m_timeline);
+    waitInfo.setValues(m_inFlight.front().value);
+    if (m_context->getDevice().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to wait for upload timeline!");
+    }
+    this->retireBatches(this->completedValue());
+}
+
+void UploadEngine::waitIdle() {
+    this->flush();
+    while (!m_inFlight.empty()) {
+        this->waitForOldestBatch();
+    }
+}
@@ -0,0 +1,136 @@
+#include <print>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include "Assets/AssetRegistry.h"
+
+// AssetRegistry 键测试：在临时目录中建立 assets/ 与指向它的符号链接，检查
+//  - "./"、".."、重复的分隔符、绝对路径与经符号链接的路径都规范化为同一个键，不存在的文件按词法规范化
+//  - 不同文件的键不同
+//  - 影响导入结果的设置（sRGB、mip、用途、块压缩；顶点格式、优化、网格簇、LOD）各自产生不同的键，useCache 不影响键
+// 只调用键的构造函数，不需要 Vulkan 设备。
+// 用法：asset_registry_test
+
+namespace {
+    namespace fs = std::filesystem;
+
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    void touch(const fs::path& path) {
+        std::ofstream(path) << "x";
+    }
+
+    void checkPaths(const fs::path& root) {
+        const std::string expected = AssetRegistry::normalizePath("assets/a.jpg");
+        const std::vector<std::string> aliases = {
+            "assets/./a.jpg",
+            "./assets/a.jpg",
+            "assets/../assets/a.jpg",
+            "assets//a.jpg",
+            (root / "assets" / "a.jpg").string(),
+            (root / "assets" / "sub" / ".." / "a.jpg").string(),
+        };
+        for (const std::string& alias : aliases) {
+            const std::string key = AssetRegistry::normalizePath(alias);
+            require(key == expected, "\"" + alias + "\" normalizes to \"" + key + "\", expected \"" + expected + "\"");
+        }
+
+        std::error_code ec;
+        fs::create_directory_symlink(root / "assets", root / "linked", ec);
+        if (ec) {
+            std::println("symbolic links unavailable ({}), skipping the symlink alias", ec.message());
+        } else {
+            require(AssetRegistry::normalizePath("linked/a.jpg") == expected, "a path through a symbolic link is a different key");
+        }
+
+        require(AssetRegistry::normalizePath("assets/b.jpg") != expected, "different files share a key");
+        require(AssetRegistry::normalizePath("missing/./c.png") == AssetRegistry::normalizePath("missing/c.png"),
+                "paths to a missing file normalize differently");
+        require(AssetRegistry::normalizePath("missing/d/../c.png") == AssetRegistry::normalizePath("missing/c.png"),
+                "\"..\" in a path to a missing file is not collapsed");
+    }
+
+    void checkTextureKeys() {
+        const std::string path = AssetRegistry::normalizePath("assets/a.jpg");
+        const TextureImportSettings base{};
+        const std::string key = AssetRegistry::makeTextureKey(path, base);
+        require(AssetRegistry::makeTextureKey(path, TextureImportSettings{}) == key, "equal texture settings give different keys");
+
+        TextureImportSettings noCache = base;
+        noCache.useCache = false;
+        require(AssetRegistry::makeTextureKey(path, noCache) == key, "useCache changes the texture key");
+
+        std::vector<TextureImportSettings> variants(5, base);
+        variants[0].srgb = false;
+        variants[1].generateMips = false;
+        variants[2].usage = TextureUsage::Normal;
+        variants[3].usage = TextureUsage::Orm;
+        variants[4].compress = false;
+        std::vector<std::string> keys = {key};
+        for (const TextureImportSettings& settings : variants) {
+            keys.push_back(AssetRegistry::makeTextureKey(path, settings));
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            for (size_t j = i + 1; j < keys.size(); j++) {
+                require(keys[i] != keys[j], "texture keys collide: " + keys[i]);
+            }
+        }
+    }
+
+    void checkMeshKeys() {
+        const std::string path = AssetRegistry::normalizePath("assets/model.obj");
+        const MeshImportSettings base{};
+        const std::string key = AssetRegistry::makeMeshKey(path, base);
+
+        MeshImportSettings noCache = base;
+        noCache.useCache = false;
+        require(AssetRegistry::makeMeshKey(path, noCache) == key, "useCache changes the mesh key");
+
+        std::vector<MeshImportSettings> variants(4, base);
+        variants[0].vertexFormat = VertexFormat::Compact;
+        variants[1].optimize = false;
+        variants[2].meshlets = false;
+        variants[3].lods = false;
+        std::vector<std::string> keys = {key};
+        for (const MeshImportSettings& settings : variants) {
+            keys.push_back(AssetRegistry::makeMeshKey(path, settings));
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            for (size_t j = i + 1; j < keys.size(); j++) {
+                require(keys[i] != keys[j], "mesh keys collide: " + keys[i]);
+            }
+        }
+    }
+}
+
+int main() {
+    const fs::path previous = fs::current_path();
+    const fs::path root = fs::temp_directory_path() / "vortex_asset_registry_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "assets" / "sub");
+    touch(root / "assets" / "a.jpg");
+    touch(root / "assets" / "b.jpg");
+    fs::current_path(root);
+
+    int result = EXIT_SUCCESS;
+    try {
+        checkPaths(fs::current_path());
+        checkTextureKeys();
+        checkMeshKeys();
+        std::println("OK");
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        result = EXIT_FAILURE;
+    }
+    fs::current_path(previous);
+    fs::remove_all(root);
+    return result;
+}
@@ -0,0 +1,217 @@
+#include <print>
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include "Assets/BlockCompressor.h"
+#include "Core/JobSystem.h"
+
+// BlockCompressor 往返测试：按格式规范独立实现 BC1 / BC4 / BC5 / BC7（mode 6）解码，
+// 对生成的测试图像编码再解码，要求各格式的 PSNR 不低于下限；并检查多线程编码与单线程结果逐字节一致。
+// 测试图像含平滑渐变、高频纹理与硬边，默认宽高不是 4 的倍数（覆盖边缘块）；PSNR 下限按默认尺寸设定。
+// 用法：block_compressor_test [宽] [高]
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    using Texel = std::array<uint8_t, 4>;
+
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> rgba;
+    };
+
+    Image makeImage(uint32_t width, uint32_t height) {
+        Image image{width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4)};
+        uint32_t state = 12345;
+        auto noise = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<int>(state >> 29) - 4;      // -4 ~ 3
+        };
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                const float u = static_cast<float>(x) / width;
+                const float v = static_cast<float>(y) / height;
+                float values[4] = {
+                    255.0f * u,
+                    127.5f + 100.0f * std::sin(u * 9.0f + v * 4.0f),
+                    255.0f * v * (1.0f - u),
+                    x < width / 2 ? 255.0f : 96.0f + 64.0f * std::cos(v * 12.0f)
+                };
+                // 右下四分之一是高频棋盘格，与渐变之间形成硬边
+                if (x >= width / 2 && y >= height / 2) {
+                    values[0] = ((x / 3 + y / 3) & 1) ? 230.0f : 30.0f;
+                }
+                uint8_t* texel = image.rgba.data() + (static_cast<size_t>(y) * width + x) * 4;
+                for (int c = 0; c < 4; c++) {
+                    texel[c] = static_cast<uint8_t>(std::clamp(static_cast<int>(values[c]) + noise(), 0, 255));
+                }
+            }
+        }
+        return image;
+    }
+
+    uint64_t readBits(const uint8_t* bytes, uint32_t offset, uint32_t count) {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const uint32_t bit = offset + i;
+            value |= static_cast<uint64_t>((bytes[bit / 8] >> (bit % 8)) & 1u) << i;
+        }
+        return value;
+    }
+
+    // BC1：两个 RGB565 端点，c0 > c1 时四色，否则三色 + 黑
+    void decodeBc1(const uint8_t* block, Texel out[16]) {
+        const uint32_t c0 = block[0] | (block[1] << 8);
+        const uint32_t c1 = block[2] | (block[3] << 8);
+        auto expand = [](uint32_t c) {
+            const uint32_t r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            return std::array<int, 3>{static_cast<int>((r << 3) | (r >> 2)), static_cast<int>((g << 2) | (g >> 4)),
+                                      static_cast<int>((b << 3) | (b >> 2))};
+        };
+        const auto e0 = expand(c0), e1 = expand(c1);
+        std::array<std::array<int, 3>, 4> palette{e0, e1};
+        for (int c = 0; c < 3; c++) {
+            if (c0 > c1) {
+                palette[2][c] = (2 * e0[c] + e1[c] + 1) / 3;
+                palette[3][c] = (e0[c] + 2 * e1[c] + 1) / 3;
+            } else {
+                palette[2][c] = (e0[c] + e1[c] + 1) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        for (uint32_t i = 0; i < 16; i++) {
+            const auto& color = palette[readBits(block + 4, i * 2, 2)];
+            out[i] = Texel{static_cast<uint8_t>(color[0]), static_cast<uint8_t>(color[1]), static_cast<uint8_t>(color[2]), 255};
+        }
+    }
+
+    // BC4：两个 8 位端点，r0 > r1 时八插值，否则六插值 + 0 / 255
+    void decodeBc4(const uint8_t* block, Texel out[16], int channel) {
+        const int r0 = block[0], r1 = block[1];
+        int palette[8] = {r0, r1};
+        if (r0 > r1) {
+            for (int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * r0 + i * r1 + 3) / 7;
+        } else {
+            for (int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * r0 + i * r1 + 2) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+        for (uint32_t i = 0; i < 16; i++) {
+            out[i][channel] = static_cast<uint8_t>(palette[readBits(block + 2, i * 3, 3)]);
+        }
+    }
+
+    // BC7：编码器只输出 mode 6（RGBA 7777 + 每端点一个 p 位，4 位索引，首个索引省略最高位）
+    void decodeBc7(const uint8_t* block, Texel out[16]) {
+        require(readBits(block, 0, 7) == (1u << 6), "BC7: block is not mode 6");
+        static constexpr int kWeights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+        int endpoints[2][4];
+        for (int c = 0; c < 4; c++) {
+            endpoints[0][c] = static_cast<int>(readBits(block, 7 + c * 14, 7));
+            endpoints[1][c] = static_cast<int>(readBits(block, 14 + c * 14, 7));
+        }
+        const int pbits[2] = {static_cast<int>(readBits(block, 63, 1)), static_cast<int>(readBits(block, 64, 1))};
+        for (int e = 0; e < 2; e++) {
+            for (int c = 0; c < 4; c++) endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+        }
+        uint32_t offset = 65;
+        for (uint32_t i = 0; i < 16; i++) {
+            const uint32_t bits = i == 0 ? 3 : 4;
+            const int weight = kWeights[readBits(block, offset, bits)];
+            offset += bits;
+            for (int c = 0; c < 4; c++) {
+                out[i][c] = static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+            }
+        }
+    }
+
+    Image decode(BlockFormat format, const std::vector<uint8_t>& encoded, uint32_t width, uint32_t height) {
+        Image image{width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4, 0)};
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockBytes = BlockCompressor::getBlockBytes(format);
+        for (uint32_t by = 0; by < blocksY; by++) {
+            for (uint32_t bx = 0; bx < blocksX; bx++) {
+                const uint8_t* block = encoded.data() + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+                Texel texels[16] = {};
+                switch (format) {
+                case BlockFormat::BC1: decodeBc1(block, texels); break;
+                case BlockFormat::BC4: decodeBc4(block, texels, 0); break;
+                case BlockFormat::BC5: decodeBc4(block, texels, 0); decodeBc4(block + 8, texels, 1); break;
+                case BlockFormat::BC7: decodeBc7(block, texels); break;
+                default: throw Failure{"decode: unsupported format"};
+                }
+                for (uint32_t i = 0; i < 16; i++) {
+                    const uint32_t x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                    if (x < width && y < height) {
+                        std::memcpy(image.rgba.data() + (static_cast<size_t>(y) * width + x) * 4, texels[i].data(), 4);
+                    }
+                }
+            }
+        }
+        return image;
+    }
+
+    double psnr(const Image& a, const Image& b, uint32_t channels) {
+        double error = 0.0;
+        for (size_t i = 0; i < a.rgba.size(); i += 4) {
+            for (uint32_t c = 0; c < channels; c++) {
+                const double d = static_cast<double>(a.rgba[i + c]) - b.rgba[i + c];
+                error += d * d;
+            }
+        }
+        const double mse = error / (static_cast<double>(a.width) * a.height * channels);
+        return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+    }
+
+    struct Case {
+        BlockFormat format;
+        const char* name;
+        uint32_t channels;          // 参与 PSNR 的通道数（从 R 开始）
+        double minPsnr;
+    };
+}
+
+int main(int argc, char** argv) {
+    const uint32_t width = argc > 1 ? std::max(1u, static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10))) : 258u;
+    const uint32_t height = argc > 2 ? std::max(1u, static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10))) : 131u;
+    const Image source = makeImage(width, height);
+    const Case cases[] = {
+        {BlockFormat::BC1, "BC1", 3, 35.0},
+        {BlockFormat::BC4, "BC4", 1, 39.0},
+        {BlockFormat::BC5, "BC5", 2, 41.0},
+        {BlockFormat::BC7, "BC7", 4, 34.0},     // alpha 与颜色独立变化，mode 6 的单条端点线在 RGBA 上折中
+    };
+
+    JobSystem jobs;
+    try {
+        for (const Case& test : cases) {
+            const size_t size = BlockCompressor::getEncodedSize(test.format, width, height);
+            std::vector<uint8_t> serial(size), parallel(size);
+            BlockCompressor::encode(test.format, source.rgba.data(), width, height, serial.data());
+            BlockCompressor::encode(test.format, source.rgba.data(), width, height, parallel.data(), &jobs);
+            require(serial == parallel, std::string(test.name) + ": parallel encoding differs from the serial result");
+
+            const double value = psnr(source, decode(test.format, serial, width, height), test.channels);
+            std::println("{} {}x{}: PSNR {:.2f} dB (floor {:.1f})", test.name, width, height, value, test.minPsnr);
+            require(value >= test.minPsnr, std::string(test.name) + ": PSNR " + std::to_string(value) + " dB is below the floor");
+        }
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
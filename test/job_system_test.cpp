@@ -0,0 +1,108 @@
+#include <print>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include "Core/JobSystem.h"
+
+// JobSystem 测试：分别用 1、3 个与默认数量的工作线程检查
+//  - parallelFor 的每个下标恰好执行一次
+//  - 三层嵌套的 parallelFor（任务内部再调用）全部完成，不会死锁
+//  - 任务抛出的异常在调用线程重新抛出（含嵌套调用中内层的异常），其余下标仍然执行完，之后线程池可以继续使用
+//  - submit 的异常通过 future 传回
+// 用法：job_system_test
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    void checkCoverage(JobSystem& jobs) {
+        constexpr size_t kCount = 10000;
+        std::vector<std::atomic<uint32_t>> visits(kCount);
+        jobs.parallelFor(kCount, [&](size_t i) { visits[i].fetch_add(1); });
+        for (size_t i = 0; i < kCount; i++) {
+            require(visits[i].load() == 1, "index " + std::to_string(i) + " ran " + std::to_string(visits[i].load()) + " times");
+        }
+    }
+
+    void checkNesting(JobSystem& jobs) {
+        constexpr size_t kOuter = 8, kMiddle = 6, kInner = 50;
+        std::vector<std::atomic<uint32_t>> visits(kOuter * kMiddle * kInner);
+        jobs.parallelFor(kOuter, [&](size_t a) {
+            jobs.parallelFor(kMiddle, [&](size_t b) {
+                jobs.parallelFor(kInner, [&](size_t c) { visits[(a * kMiddle + b) * kInner + c].fetch_add(1); });
+            });
+        });
+        for (size_t i = 0; i < visits.size(); i++) {
+            require(visits[i].load() == 1, "nested: index " + std::to_string(i) + " ran " + std::to_string(visits[i].load()) + " times");
+        }
+    }
+
+    void checkExceptions(JobSystem& jobs) {
+        constexpr size_t kCount = 1000;
+        std::atomic<size_t> completed{0};
+        try {
+            jobs.parallelFor(kCount, [&](size_t i) {
+                if (i == 337) throw std::runtime_error("job 337 failed");
+                completed.fetch_add(1);
+            });
+            throw Failure{"parallelFor swallowed the exception"};
+        } catch (const std::runtime_error& e) {
+            require(std::string(e.what()) == "job 337 failed", std::string("unexpected exception: ") + e.what());
+        }
+        // 异常之后 parallelFor 仍等到所有已领取的下标结束才返回
+        require(completed.load() == kCount - 1, "only " + std::to_string(completed.load()) + " indices completed before rethrowing");
+
+        // 所有下标都抛出：只重新抛出一个
+        try {
+            jobs.parallelFor(64, [](size_t i) { throw std::out_of_range(std::to_string(i)); });
+            throw Failure{"parallelFor swallowed exceptions from every index"};
+        } catch (const std::out_of_range&) {
+        }
+
+        // 内层的异常穿过外层传回调用线程
+        try {
+            jobs.parallelFor(4, [&](size_t a) {
+                jobs.parallelFor(16, [a](size_t b) {
+                    if (a == 2 && b == 9) throw std::logic_error("inner");
+                });
+            });
+            throw Failure{"nested parallelFor swallowed the exception"};
+        } catch (const std::logic_error& e) {
+            require(std::string(e.what()) == "inner", std::string("nested: unexpected exception: ") + e.what());
+        }
+
+        std::future<int> failed = jobs.submit([]() -> int { throw std::runtime_error("submit failed"); });
+        try {
+            failed.get();
+            throw Failure{"submit swallowed the exception"};
+        } catch (const std::runtime_error& e) {
+            require(std::string(e.what()) == "submit failed", std::string("submit: unexpected exception: ") + e.what());
+        }
+        require(jobs.submit([]() { return 42; }).get() == 42, "the pool is unusable after exceptions");
+        checkCoverage(jobs);
+    }
+}
+
+int main() {
+    try {
+        for (uint32_t threads : {1u, 3u, 0u}) {
+            JobSystem jobs(threads);
+            checkCoverage(jobs);
+            checkNesting(jobs);
+            checkExceptions(jobs);
+        }
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
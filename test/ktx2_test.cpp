@@ -0,0 +1,218 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "3rd/stb_image.h"
+
+#include <print>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <functional>
+#include "Assets/Ktx2.h"
+
+// Ktx2::parse 测试：在内存中拼出最小的 KTX2 文件（无 DFD / KVD），检查合法文件的解析结果，
+// 以及各个拒绝路径（级别索引截断、数据越界、级别长度不符、级别数超过完整 mip 链、BasisLZ）都会抛出。
+// 用法：ktx2_test
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    constexpr uint8_t kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr size_t kLevelIndexOffset = 80;
+    constexpr size_t kLevelIndexEntrySize = 24;
+
+    struct Level {
+        std::vector<uint8_t> bytes;         // 文件中的数据（超压缩时为压缩后的数据）
+        uint64_t uncompressedLength = 0;    // 0 表示与 bytes 的长度相同
+    };
+
+    struct Blob {
+        vk::Format format = vk::Format::eR8G8B8A8Unorm;
+        uint32_t width = 4;
+        uint32_t height = 4;
+        uint32_t supercompression = 0;
+        std::vector<Level> levels;
+    };
+
+    void writeU32(std::vector<uint8_t>& bytes, size_t offset, uint32_t value) {
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    }
+
+    void writeU64(std::vector<uint8_t>& bytes, size_t offset, uint64_t value) {
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    }
+
+    // 文件头 + 级别索引 + 数据（与常见打包工具一样小 mip 在前）
+    std::vector<uint8_t> build(const Blob& blob) {
+        const uint32_t levelCount = static_cast<uint32_t>(blob.levels.size());
+        std::vector<uint8_t> bytes(kLevelIndexOffset + levelCount * kLevelIndexEntrySize, 0);
+        std::memcpy(bytes.data(), kIdentifier, sizeof(kIdentifier));
+        writeU32(bytes, 12, static_cast<uint32_t>(blob.format));
+        writeU32(bytes, 16, 1);                     // typeSize
+        writeU32(bytes, 20, blob.width);
+        writeU32(bytes, 24, blob.height);
+        writeU32(bytes, 28, 0);                     // pixelDepth
+        writeU32(bytes, 32, 0);                     // layerCount
+        writeU32(bytes, 36, 1);                     // faceCount
+        writeU32(bytes, 40, levelCount);
+        writeU32(bytes, 44, blob.supercompression);
+        for (uint32_t level = levelCount; level-- > 0;) {
+            const Level& data = blob.levels[level];
+            const size_t entry = kLevelIndexOffset + level * kLevelIndexEntrySize;
+            writeU64(bytes, entry, bytes.size());
+            writeU64(bytes, entry + 8, data.bytes.size());
+            writeU64(bytes, entry + 16, data.uncompressedLength ? data.uncompressedLength : data.bytes.size());
+            bytes.insert(bytes.end(), data.bytes.begin(), data.bytes.end());
+        }
+        return bytes;
+    }
+
+    std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; i++) {
+            bytes[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+        return bytes;
+    }
+
+    // 只含一个非压缩（stored）块的 zlib 流，stb 的 zlib 解码器可以直接解出
+    std::vector<uint8_t> zlibStored(const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> stream = {0x78, 0x01, 0x01};
+        const uint16_t length = static_cast<uint16_t>(data.size());
+        const uint16_t inverted = static_cast<uint16_t>(~length);
+        stream.push_back(static_cast<uint8_t>(length));
+        stream.push_back(static_cast<uint8_t>(length >> 8));
+        stream.push_back(static_cast<uint8_t>(inverted));
+        stream.push_back(static_cast<uint8_t>(inverted >> 8));
+        stream.insert(stream.end(), data.begin(), data.end());
+        uint32_t a = 1, b = 0;
+        for (uint8_t byte : data) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        const uint32_t adler = (b << 16) | a;
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            stream.push_back(static_cast<uint8_t>(adler >> shift));
+        }
+        return stream;
+    }
+
+    // 4x4 RGBA8 的完整 mip 链：64 / 16 / 4 字节
+    Blob makeRgbaChain() {
+        Blob blob;
+        blob.levels = {Level{pattern(64, 1)}, Level{pattern(16, 2)}, Level{pattern(4, 3)}};
+        return blob;
+    }
+
+    void expectThrow(const std::string& what, const std::vector<uint8_t>& bytes, const std::string& fragment) {
+        try {
+            Ktx2::parse(bytes.data(), bytes.size(), what);
+        } catch (const std::runtime_error& e) {
+            require(std::string(e.what()).find(fragment) != std::string::npos,
+                    what + ": unexpected error \"" + e.what() + "\", expected \"" + fragment + "\"");
+            return;
+        }
+        throw Failure{what + ": accepted an invalid file"};
+    }
+
+    void checkValid() {
+        const Blob blob = makeRgbaChain();
+        const std::vector<uint8_t> bytes = build(blob);
+        require(Ktx2::isKtx2(bytes.data(), bytes.size()), "valid: identifier not recognised");
+        const Ktx2Image image = Ktx2::parse(bytes.data(), bytes.size(), "valid");
+        require(image.width == 4 && image.height == 4 && image.format == vk::Format::eR8G8B8A8Unorm, "valid: header fields differ");
+        require(image.levels.size() == 3 && image.decompressed.empty(), "valid: wrong level count");
+        const TextureView view = image.getView();
+        for (uint32_t level = 0; level < 3; level++) {
+            const auto& expected = blob.levels[level].bytes;
+            require(view.levels[level].size == expected.size(), "valid: level " + std::to_string(level) + " size differs");
+            require(std::memcmp(view.data + view.levels[level].offset, expected.data(), expected.size()) == 0,
+                    "valid: level " + std::to_string(level) + " data differs");
+        }
+
+        // 块压缩格式按块数计算长度：8x8 的 BC1 每级至少一个 8 字节块
+        Blob bc1;
+        bc1.format = vk::Format::eBc1RgbUnormBlock;
+        bc1.width = 8;
+        bc1.height = 8;
+        bc1.levels = {Level{pattern(32, 4)}, Level{pattern(8, 5)}, Level{pattern(8, 6)}, Level{pattern(8, 7)}};
+        const std::vector<uint8_t> bc1Bytes = build(bc1);
+        require(Ktx2::parse(bc1Bytes.data(), bc1Bytes.size(), "bc1").levels.size() == 4, "bc1: wrong level count");
+
+        // ZLIB 超压缩：各级解压后按 16 字节对齐排列
+        Blob zlib = makeRgbaChain();
+        zlib.supercompression = 3;
+        for (auto& level : zlib.levels) {
+            level.uncompressedLength = level.bytes.size();
+            level.bytes = zlibStored(level.bytes);
+        }
+        const std::vector<uint8_t> zlibBytes = build(zlib);
+        const Ktx2Image inflated = Ktx2::parse(zlibBytes.data(), zlibBytes.size(), "zlib");
+        const TextureView inflatedView = inflated.getView();
+        for (uint32_t level = 0; level < 3; level++) {
+            const auto& expected = blob.levels[level].bytes;
+            require(inflatedView.levels[level].offset % 16 == 0, "zlib: level " + std::to_string(level) + " is not aligned");
+            require(inflatedView.levels[level].size == expected.size() &&
+                    std::memcmp(inflatedView.data + inflatedView.levels[level].offset, expected.data(), expected.size()) == 0,
+                    "zlib: level " + std::to_string(level) + " differs after inflating");
+        }
+    }
+
+    void checkRejected() {
+        const std::vector<uint8_t> valid = build(makeRgbaChain());
+
+        // 级别索引截断：文件在第三个索引项中间结束
+        expectThrow("truncated index", std::vector<uint8_t>(valid.begin(), valid.begin() + kLevelIndexOffset + 2 * kLevelIndexEntrySize + 8),
+                    "truncated level index");
+
+        // 数据越界：去掉最后几个字节（mip 0 的数据在文件末尾）
+        expectThrow("outside file", std::vector<uint8_t>(valid.begin(), valid.end() - 4), "outside the file");
+
+        // 级别长度与格式算出的字节数不一致
+        Blob shortLevel = makeRgbaChain();
+        shortLevel.levels[0].bytes.resize(60);
+        expectThrow("wrong size", build(shortLevel), "expected 64");
+
+        Blob wrongUncompressed = makeRgbaChain();
+        wrongUncompressed.supercompression = 3;
+        for (auto& level : wrongUncompressed.levels) {
+            level.uncompressedLength = level.bytes.size();
+            level.bytes = zlibStored(level.bytes);
+        }
+        wrongUncompressed.levels[1].uncompressedLength = 12;
+        expectThrow("wrong uncompressed size", build(wrongUncompressed), "expected 16");
+
+        // 4x4 的完整 mip 链只有 3 级
+        Blob tooMany = makeRgbaChain();
+        tooMany.levels.push_back(Level{pattern(4, 9)});
+        expectThrow("too many levels", build(tooMany), "exceed the full chain");
+
+        // BasisLZ：超压缩方案 1，以及需要转码的 UNDEFINED 格式
+        Blob basis = makeRgbaChain();
+        basis.supercompression = 1;
+        expectThrow("BasisLZ", build(basis), "BasisLZ");
+        basis.format = vk::Format::eUndefined;
+        expectThrow("Basis Universal", build(basis), "Basis Universal");
+
+        expectThrow("not KTX2", std::vector<uint8_t>(valid.begin() + 1, valid.end()), "Not a KTX2 file");
+    }
+}
+
+int main() {
+    try {
+        checkValid();
+        checkRejected();
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
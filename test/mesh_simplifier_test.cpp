@@ -0,0 +1,171 @@
+#include <print>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <set>
+#include "Assets/MeshSimplifier.h"
+
+// MeshSimplifier 的 LOD 链测试：按 Mesh::buildLods 的参数（每级减半、累计误差不超过包围盒对角线的 5%、
+// 进展不足 15% 或少于 64 个三角形时停止）逐级简化，每一级检查
+//  - 索引数是 3 的倍数且严格小于上一级，所有索引都在顶点范围内，没有两个角相同的三角形
+//  - 单步误差不超过给定的误差上限
+//  - 开放网格：边界顶点锁定，每一级仍然被引用
+//  - 带 UV 接缝（位置相同的重复顶点）的闭合网格：按位置焊接后每条边仍恰好被两个方向相反的三角形共用（不开裂）
+// 用法：mesh_simplifier_test [网格分段]
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    constexpr uint32_t kMaxLodLevels = 6;
+    constexpr float kLodReduction = 0.5f;
+    constexpr float kLodMaxRelativeError = 0.05f;
+    constexpr size_t kLodMinTriangles = 64;
+    constexpr float kLodMinProgress = 0.85f;
+
+    struct Mesh {
+        std::vector<float> positions;       // xyz
+        std::vector<uint32_t> indices;
+        std::vector<uint32_t> weld;         // 顶点 -> 同位置的第一个顶点
+        std::vector<uint32_t> boundary;     // 开放边界上的顶点
+    };
+
+    // 起伏的高度场，四周是开放边界
+    Mesh makeTerrain(uint32_t n) {
+        Mesh mesh;
+        for (uint32_t y = 0; y <= n; y++) {
+            for (uint32_t x = 0; x <= n; x++) {
+                const float u = static_cast<float>(x) / n, v = static_cast<float>(y) / n;
+                mesh.positions.insert(mesh.positions.end(), {u, v, 0.05f * std::sin(u * 7.0f) * std::cos(v * 5.0f)});
+                mesh.weld.push_back(y * (n + 1) + x);
+                if (x == 0 || y == 0 || x == n || y == n) mesh.boundary.push_back(y * (n + 1) + x);
+            }
+        }
+        for (uint32_t y = 0; y < n; y++) {
+            for (uint32_t x = 0; x < n; x++) {
+                const uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 2, d = a + n + 1;
+                mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d});
+            }
+        }
+        return mesh;
+    }
+
+    // 环面：环向第 0 列在末尾重复一次（UV 接缝），管向首尾相接，整体闭合
+    Mesh makeSeamedTorus(uint32_t segments, uint32_t sides) {
+        Mesh mesh;
+        for (uint32_t i = 0; i <= segments; i++) {
+            const float u = 6.2831853f * static_cast<float>(i % segments) / segments;
+            for (uint32_t j = 0; j < sides; j++) {
+                const float v = 6.2831853f * static_cast<float>(j) / sides;
+                const float r = 0.3f + 0.03f * std::sin(u * 5.0f) * std::cos(v * 3.0f);
+                mesh.positions.insert(mesh.positions.end(), {(1.0f + r * std::cos(v)) * std::cos(u),
+                                                             (1.0f + r * std::cos(v)) * std::sin(u), r * std::sin(v)});
+                mesh.weld.push_back((i % segments) * sides + j);
+            }
+        }
+        for (uint32_t i = 0; i < segments; i++) {
+            for (uint32_t j = 0; j < sides; j++) {
+                const uint32_t a = i * sides + j, b = (i + 1) * sides + j;
+                const uint32_t c = (i + 1) * sides + (j + 1) % sides, d = i * sides + (j + 1) % sides;
+                mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d});
+            }
+        }
+        return mesh;
+    }
+
+    float boundingDiameter(const Mesh& mesh) {
+        float lo[3] = {mesh.positions[0], mesh.positions[1], mesh.positions[2]};
+        float hi[3] = {lo[0], lo[1], lo[2]};
+        for (size_t i = 0; i < mesh.positions.size(); i++) {
+            lo[i % 3] = std::min(lo[i % 3], mesh.positions[i]);
+            hi[i % 3] = std::max(hi[i % 3], mesh.positions[i]);
+        }
+        return std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) + (hi[2] - lo[2]) * (hi[2] - lo[2]));
+    }
+
+    void checkLevel(const std::string& name, const Mesh& mesh, const std::vector<uint32_t>& indices, bool closed) {
+        const size_t vertexCount = mesh.positions.size() / 3;
+        require(indices.size() % 3 == 0, name + ": index count is not a multiple of 3");
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            require(indices[i] < vertexCount && indices[i + 1] < vertexCount && indices[i + 2] < vertexCount,
+                    name + ": index out of range");
+            require(indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i] != indices[i + 2],
+                    name + ": degenerate triangle");
+        }
+        if (closed) {
+            // 焊接后每条有向边只出现一次，且反向边也存在
+            std::map<std::pair<uint32_t, uint32_t>, int> edges;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (size_t corner = 0; corner < 3; corner++) {
+                    edges[{mesh.weld[indices[i + corner]], mesh.weld[indices[i + (corner + 1) % 3]]}]++;
+                }
+            }
+            for (const auto& [edge, count] : edges) {
+                const auto reverse = edges.find({edge.second, edge.first});
+                require(count == 1 && reverse != edges.end() && reverse->second == 1,
+                        name + ": edge " + std::to_string(edge.first) + "-" + std::to_string(edge.second) + " is open or non-manifold");
+            }
+        } else {
+            const std::set<uint32_t> used(indices.begin(), indices.end());
+            for (uint32_t vertex : mesh.boundary) {
+                require(used.contains(vertex), name + ": boundary vertex " + std::to_string(vertex) + " was collapsed");
+            }
+        }
+    }
+
+    // 与 Mesh::buildLods 相同：每级在上一级的结果上继续简化，误差按三角不等式累加
+    void checkChain(const std::string& name, const Mesh& mesh, bool closed) {
+        const size_t vertexCount = mesh.positions.size() / 3;
+        const float errorBudget = boundingDiameter(mesh) * kLodMaxRelativeError;
+        std::vector<uint32_t> current = mesh.indices;
+        checkLevel(name + " LOD 0", mesh, current, closed);
+        std::vector<size_t> counts = {current.size()};
+        float error = 0.0f;
+        for (uint32_t level = 1; level < kMaxLodLevels; level++) {
+            const size_t targetTriangles = static_cast<size_t>(static_cast<float>(current.size() / 3) * kLodReduction);
+            if (targetTriangles < kLodMinTriangles) break;
+            std::vector<uint32_t> next = current;
+            const float limit = std::max(errorBudget - error, 0.0f);
+            const float stepError = MeshSimplifier::simplify(next, mesh.positions.data(), sizeof(float) * 3, vertexCount,
+                                                             targetTriangles * 3, limit);
+            const std::string levelName = name + " LOD " + std::to_string(level);
+            require(next.size() <= current.size(), levelName + ": simplification added indices");
+            if (static_cast<float>(next.size()) > static_cast<float>(current.size()) * kLodMinProgress) break;
+
+            require(next.size() < current.size(), levelName + ": index count did not decrease");
+            require(stepError >= 0.0f && stepError <= limit * 1.0001f, levelName + ": error " + std::to_string(stepError)
+                    + " exceeds the limit " + std::to_string(limit));
+            checkLevel(levelName, mesh, next, closed);
+            error += stepError;
+            counts.push_back(next.size());
+            current.swap(next);
+        }
+        require(counts.size() >= 3, name + ": chain stopped after " + std::to_string(counts.size()) + " levels");
+
+        std::string summary;
+        for (size_t count : counts) summary += " " + std::to_string(count / 3);
+        std::println("{}: triangles per LOD{}, error {:.5f} (budget {:.5f})", name, summary, error, errorBudget);
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t segments = argc > 1 ? std::max(16u, static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10))) : 64u;
+    try {
+        checkChain("terrain", makeTerrain(segments), false);
+        checkChain("torus", makeSeamedTorus(segments * 2, segments / 2), true);
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
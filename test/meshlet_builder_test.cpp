@@ -0,0 +1,152 @@
+#include <print>
+#include <format>
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+#include "Assets/MeshletBuilder.h"
+
+// MeshletBuilder 不变量测试：在生成的环面网格（闭合，按两个子网格区间划分）上建簇，检查
+//  - 每个三角形恰好出现在一个簇中（重排前后各区间的三角形多重集合相同，顶点顺序不变）
+//  - 簇是区间内连续、首尾相接的索引段，不跨越区间
+//  - 每个簇的顶点数 / 三角形数不超过 kMaxVertices / kMaxTriangles，vertexCount 与实际不同顶点数一致
+//  - 包围球包含簇的所有顶点，buildLocalData 的局部数据还原出相同的三角形
+// 用法：meshlet_builder_test [环向分段] [管向分段]
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    struct Mesh {
+        std::vector<float> positions;       // xyz
+        std::vector<uint32_t> indices;
+    };
+
+    // 半径带扰动的环面，两个方向首尾相接，没有开放边界
+    Mesh makeTorus(uint32_t segments, uint32_t sides) {
+        Mesh mesh;
+        for (uint32_t i = 0; i < segments; i++) {
+            const float u = 6.2831853f * static_cast<float>(i) / segments;
+            for (uint32_t j = 0; j < sides; j++) {
+                const float v = 6.2831853f * static_cast<float>(j) / sides;
+                const float r = 0.3f + 0.03f * std::sin(u * 5.0f) * std::cos(v * 3.0f);
+                mesh.positions.push_back((1.0f + r * std::cos(v)) * std::cos(u));
+                mesh.positions.push_back((1.0f + r * std::cos(v)) * std::sin(u));
+                mesh.positions.push_back(r * std::sin(v));
+            }
+        }
+        for (uint32_t i = 0; i < segments; i++) {
+            for (uint32_t j = 0; j < sides; j++) {
+                const uint32_t a = i * sides + j;
+                const uint32_t b = ((i + 1) % segments) * sides + j;
+                const uint32_t c = ((i + 1) % segments) * sides + (j + 1) % sides;
+                const uint32_t d = i * sides + (j + 1) % sides;
+                mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d});
+            }
+        }
+        return mesh;
+    }
+
+    using Triangle = std::array<uint32_t, 3>;
+
+    std::vector<Triangle> sortedTriangles(const std::vector<uint32_t>& indices, uint32_t firstIndex, uint32_t indexCount) {
+        std::vector<Triangle> triangles;
+        for (uint32_t i = firstIndex; i < firstIndex + indexCount; i += 3) {
+            triangles.push_back(Triangle{indices[i], indices[i + 1], indices[i + 2]});
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    void check(const Mesh& source, const std::vector<std::pair<uint32_t, uint32_t>>& ranges, float coneWeight) {
+        const std::string label = std::format("coneWeight {:.1f}", coneWeight);
+        const size_t vertexCount = source.positions.size() / 3;
+        std::vector<uint32_t> indices = source.indices;
+        std::vector<Meshlet> meshlets = MeshletBuilder::build(indices, ranges, source.positions.data(), sizeof(float) * 3,
+                                                              vertexCount, coneWeight);
+        require(indices.size() == source.indices.size(), label + ": index count changed");
+
+        size_t next = 0;
+        for (const auto& [firstIndex, indexCount] : ranges) {
+            require(sortedTriangles(indices, firstIndex, indexCount) == sortedTriangles(source.indices, firstIndex, indexCount),
+                    label + ": triangles of range " + std::to_string(firstIndex) + " differ after reordering");
+
+            // 区间内的簇按顺序首尾相接，恰好覆盖整个区间：每个三角形只属于一个簇
+            uint32_t cursor = firstIndex;
+            while (next < meshlets.size() && meshlets[next].firstIndex < firstIndex + indexCount) {
+                const Meshlet& meshlet = meshlets[next];
+                const std::string name = label + ": meshlet " + std::to_string(next);
+                require(meshlet.firstIndex == cursor, name + " does not start where the previous one ended");
+                require(meshlet.triangleCount > 0 && meshlet.triangleCount <= MeshletBuilder::kMaxTriangles,
+                        name + " has " + std::to_string(meshlet.triangleCount) + " triangles");
+                cursor += meshlet.triangleCount * 3;
+                require(cursor <= firstIndex + indexCount, name + " crosses the end of its range");
+
+                std::vector<uint32_t> vertices(indices.begin() + meshlet.firstIndex, indices.begin() + cursor);
+                std::sort(vertices.begin(), vertices.end());
+                vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+                require(vertices.size() <= MeshletBuilder::kMaxVertices, name + " has " + std::to_string(vertices.size()) + " vertices");
+                require(meshlet.vertexCount == vertices.size(), name + " reports a wrong vertex count");
+
+                for (uint32_t vertex : vertices) {
+                    float distance = 0.0f;
+                    for (int c = 0; c < 3; c++) {
+                        const float d = source.positions[vertex * 3 + c] - meshlet.center[c];
+                        distance += d * d;
+                    }
+                    require(std::sqrt(distance) <= meshlet.radius * 1.0001f + 1e-6f, name + " bounding sphere misses a vertex");
+                }
+                next++;
+            }
+            require(cursor == firstIndex + indexCount, label + ": meshlets do not cover range " + std::to_string(firstIndex));
+        }
+        require(next == meshlets.size(), label + ": meshlets outside every range");
+
+        // 局部数据：vertexCount 个顶点索引 + triangleCount 个打包的局部三角形
+        const uint32_t wordBase = static_cast<uint32_t>(meshlets.size() * sizeof(Meshlet) / 4);
+        const std::vector<uint32_t> local = MeshletBuilder::buildLocalData(meshlets, indices.data(), vertexCount, wordBase);
+        for (size_t m = 0; m < meshlets.size(); m++) {
+            const Meshlet& meshlet = meshlets[m];
+            const uint32_t* words = local.data() + (meshlet.dataOffset - wordBase);
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                const uint32_t packed = words[meshlet.vertexCount + t];
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    const uint32_t slot = (packed >> (corner * 8)) & 0xFF;
+                    require(slot < meshlet.vertexCount && words[slot] == indices[meshlet.firstIndex + t * 3 + corner],
+                            label + ": local data of meshlet " + std::to_string(m) + " does not match its triangles");
+                }
+            }
+        }
+        std::println("{}: {} triangles, {} meshlets", label, indices.size() / 3, meshlets.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t segments = argc > 1 ? std::max(3u, static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10))) : 96u;
+    const uint32_t sides = argc > 2 ? std::max(3u, static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10))) : 40u;
+    const Mesh torus = makeTorus(segments, sides);
+
+    // 两个子网格，分界不落在簇大小的整数倍上
+    const uint32_t indexCount = static_cast<uint32_t>(torus.indices.size());
+    const uint32_t split = (indexCount / 3 * 2 / 5) * 3;
+    const std::vector<std::pair<uint32_t, uint32_t>> ranges = {{0, split}, {split, indexCount - split}};
+    try {
+        for (float coneWeight : {0.0f, 0.5f, 4.0f}) {
+            check(torus, ranges, coneWeight);
+        }
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
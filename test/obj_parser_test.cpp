@@ -0,0 +1,257 @@
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <print>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include "Assets/ObjParser.h"
+#include "Core/JobSystem.h"
+
+// ObjParser 对照测试：以内置的 tinyobjloader 为参考，比较属性数组、三角化后的角点与分组，
+// 并比较两者的解析吞吐。输入为生成的网格 OBJ（覆盖 v/vt/vn 各种写法、负数相对下标、注释、CRLF、
+// 分组），或命令行给出的 .obj 文件。
+// 用法：obj_parser_test [网格边长 | 文件.obj] [重复次数]
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    // tinyobj 用自己的十进制解析（先转 double），ObjParser 用 std::from_chars，允许末位误差
+    bool nearlyEqual(float a, float b) {
+        return std::abs(a - b) <= 1e-6f * std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+    }
+
+    void compareArrays(const std::vector<float>& expected, const std::vector<float>& actual, const char* what) {
+        require(expected.size() == actual.size(), std::string(what) + ": element count differs");
+        for (size_t i = 0; i < expected.size(); i++) {
+            require(nearlyEqual(expected[i], actual[i]), std::string(what) + ": value " + std::to_string(i) + " differs ("
+                    + std::to_string(expected[i]) + " vs " + std::to_string(actual[i]) + ")");
+        }
+    }
+
+    struct Reference {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+    };
+
+    Reference loadReference(const std::string& text) {
+        Reference reference;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        std::istringstream stream(text);
+        if (!tinyobj::LoadObj(&reference.attrib, &reference.shapes, &materials, &warn, &err, &stream)) {
+            throw Failure{"tinyobj failed to parse the input: " + err};
+        }
+        return reference;
+    }
+
+    // 生成边长 side 的网格：三角形面的各种写法轮流出现，每 16 行开一个新组
+    std::string makeGridObj(uint32_t side) {
+        std::string text = "# generated grid\no grid\n";
+        char line[160];
+        for (uint32_t y = 0; y < side; y++) {
+            for (uint32_t x = 0; x < side; x++) {
+                const float u = static_cast<float>(x) / static_cast<float>(side - 1);
+                const float v = static_cast<float>(y) / static_cast<float>(side - 1);
+                const float height = 0.125f * std::sin(u * 9.0f) * std::cos(v * 7.0f);
+                // 一部分坐标用科学计数法与显式正号
+                if ((x + y) % 7 == 0) {
+                    std::snprintf(line, sizeof(line), "v %.7e %+.6f %.7e\n", u * 10.0f - 5.0f, height, v * 10.0f - 5.0f);
+                } else {
+                    std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u * 10.0f - 5.0f, height, v * 10.0f - 5.0f);
+                }
+                text += line;
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", u, v);
+                text += line;
+                const float nx = -std::cos(u * 9.0f) * 0.1f, nz = std::sin(v * 7.0f) * 0.1f;
+                const float length = std::sqrt(nx * nx + 1.0f + nz * nz);
+                std::snprintf(line, sizeof(line), "vn %.6f %.6f %.6f%s\n", nx / length, 1.0f / length, nz / length,
+                              y % 5 == 0 ? "\r" : "");
+                text += line;
+            }
+        }
+        text += "\n# faces\n";
+        auto index = [side](uint32_t x, uint32_t y) { return y * side + x + 1; };
+        const int64_t total = static_cast<int64_t>(side) * side;
+        for (uint32_t y = 0; y + 1 < side; y++) {
+            if (y % 16 == 0) {
+                std::snprintf(line, sizeof(line), "g rows_%u\n", y);
+                text += line;
+            }
+            for (uint32_t x = 0; x + 1 < side; x++) {
+                const uint32_t quad[4] = {index(x, y), index(x + 1, y), index(x + 1, y + 1), index(x, y + 1)};
+                const uint32_t triangles[2][3] = {{quad[0], quad[1], quad[2]}, {quad[0], quad[2], quad[3]}};
+                for (const auto& triangle : triangles) {
+                    text += "f";
+                    for (uint32_t corner : triangle) {
+                        const int64_t relative = static_cast<int64_t>(corner) - 1 - total;   // 相对末尾的负数下标
+                        switch ((x + y + corner) % 5) {
+                            case 0: std::snprintf(line, sizeof(line), " %u/%u/%u", corner, corner, corner); break;
+                            case 1: std::snprintf(line, sizeof(line), " %u//%u", corner, corner); break;
+                            case 2: std::snprintf(line, sizeof(line), " %u/%u", corner, corner); break;
+                            case 3: std::snprintf(line, sizeof(line), " %u", corner); break;
+                            default:
+                                std::snprintf(line, sizeof(line), " %lld/%lld/%lld", static_cast<long long>(relative),
+                                              static_cast<long long>(relative), static_cast<long long>(relative));
+                                break;
+                        }
+                        text += line;
+                    }
+                    text += x % 3 == 0 ? "  # tri\n" : "\n";
+                }
+            }
+        }
+        return text;
+    }
+
+    // 逐角点比较下标与组划分（三角形输入时两者的角点顺序应完全一致）
+    void compareTriangles(const Reference& reference, const ObjData& data) {
+        std::vector<tinyobj::index_t> corners;
+        for (const auto& shape : reference.shapes) {
+            corners.insert(corners.end(), shape.mesh.indices.begin(), shape.mesh.indices.end());
+        }
+        require(corners.size() == data.corners.size(), "corner count differs (" + std::to_string(corners.size()) + " vs "
+                + std::to_string(data.corners.size()) + ")");
+        for (size_t i = 0; i < corners.size(); i++) {
+            const ObjIndex& index = data.corners[i];
+            require(corners[i].vertex_index == index.position && corners[i].texcoord_index == index.texCoord
+                    && corners[i].normal_index == index.normal, "corner " + std::to_string(i) + " differs");
+        }
+        require(reference.shapes.size() == data.shapes.size(), "shape count differs (" + std::to_string(reference.shapes.size())
+                + " vs " + std::to_string(data.shapes.size()) + ")");
+        for (size_t i = 0; i < data.shapes.size(); i++) {
+            require(reference.shapes[i].mesh.indices.size() == data.shapes[i].cornerCount,
+                    "shape " + std::to_string(i) + " corner count differs");
+        }
+    }
+
+    void compareAttributes(const Reference& reference, const ObjData& data) {
+        compareArrays(reference.attrib.vertices, data.positions, "positions");
+        compareArrays(reference.attrib.normals, data.normals, "normals");
+        compareArrays(reference.attrib.texcoords, data.texCoords, "texCoords");
+    }
+
+    // 多边形的三角化方式不同（ObjParser 扇形，tinyobj 四边形取短对角线、其余耳切），
+    // 只要求三角形数与覆盖面积一致
+    void checkPolygons(JobSystem& jobs) {
+        const std::string text =
+            "v 0 0 0\nv 2 0 0\nv 2 1 0\nv 0 1 0\nv 3 0 0\nv 4 1 0\nv 3 2 0\nv 2 2 0\n"
+            "f 1 2 3 4\n"
+            "f 2 5 6 7 8 3\n";
+        const Reference reference = loadReference(text);
+        const ObjData data = ObjParser::parse(text, "polygons", &jobs);
+        compareAttributes(reference, data);
+
+        auto area = [&](auto&& position, size_t cornerCount) {
+            double sum = 0.0;
+            for (size_t i = 0; i < cornerCount; i += 3) {
+                const float* a = position(i);
+                const float* b = position(i + 1);
+                const float* c = position(i + 2);
+                sum += 0.5 * std::abs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]));
+            }
+            return sum;
+        };
+        const auto& indices = reference.shapes.at(0).mesh.indices;
+        const double expected = area([&](size_t i) { return &reference.attrib.vertices[indices[i].vertex_index * 3]; }, indices.size());
+        const double actual = area([&](size_t i) { return &data.positions[data.corners[i].position * 3]; }, data.corners.size());
+        require(indices.size() == data.corners.size(), "polygon triangle count differs");
+        require(std::abs(expected - actual) < 1e-5, "polygon triangulation covers a different area");
+    }
+
+    // 格式错误与越界下标：tinyobj 只给出警告，ObjParser 应抛出异常
+    void checkMalformed() {
+        const char* inputs[] = {
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n",
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n",
+            "v 0 0\n",
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/x 2 3\n",
+        };
+        for (const char* input : inputs) {
+            bool threw = false;
+            try {
+                ObjParser::parse(input, "malformed");
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            require(threw, std::string("malformed input was accepted: ") + input);
+        }
+    }
+
+    template<typename F>
+    double bestOf(uint32_t iterations, F&& run) {
+        double best = 0.0;
+        for (uint32_t i = 0; i < iterations; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string text, name = "grid";
+    uint32_t side = 256;
+    if (argc > 1) {
+        const std::string argument = argv[1];
+        if (argument.ends_with(".obj")) {
+            std::ifstream file(argument, std::ios::binary);
+            if (!file) {
+                std::println("Cannot open {}", argument);
+                return EXIT_FAILURE;
+            }
+            text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            name = argument;
+        } else {
+            side = std::max(2u, static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)));
+        }
+    }
+    const uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::max(1ul, std::strtoul(argv[2], nullptr, 10))) : 3u;
+    if (text.empty()) {
+        text = makeGridObj(side);
+    }
+
+    JobSystem jobs;
+    try {
+        Reference reference;
+        ObjData sequential, parallel;
+        const double referenceMs = bestOf(iterations, [&]() { reference = loadReference(text); });
+        const double sequentialMs = bestOf(iterations, [&]() { sequential = ObjParser::parse(text, name); });
+        const double parallelMs = bestOf(iterations, [&]() { parallel = ObjParser::parse(text, name, &jobs); });
+
+        const double megabytes = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+        std::println("{}: {:.2f} MB, {} triangles, best of {}", name, megabytes, sequential.corners.size() / 3, iterations);
+        std::println("  tinyobj (reference):    {:9.2f} ms ({:.1f} MB/s)", referenceMs, megabytes / referenceMs * 1000.0);
+        std::println("  ObjParser, 1 thread:    {:9.2f} ms ({:.1f} MB/s)", sequentialMs, megabytes / sequentialMs * 1000.0);
+        std::println("  ObjParser, {} workers:  {:9.2f} ms ({:.1f} MB/s)", jobs.getThreadCount(), parallelMs, megabytes / parallelMs * 1000.0);
+
+        // 外部文件可能含多边形，只比较属性；生成的网格全是三角形，逐角点比较
+        compareAttributes(reference, sequential);
+        compareAttributes(reference, parallel);
+        if (argc < 2 || !std::string(argv[1]).ends_with(".obj")) {
+            compareTriangles(reference, sequential);
+            compareTriangles(reference, parallel);
+        }
+        checkPolygons(jobs);
+        checkMalformed();
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+#include <print>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include "Core/SamplerCache.h"
+
+// SamplerCache 键测试：用缓存自己的哈希 / 相等比较（与 SamplerCache 内部的 unordered_map 相同）检查
+//  - 参数相同的 vk::SamplerCreateInfo 落到同一个条目
+//  - 各向异性、寻址模式、LOD 偏移等任一字段不同都是不同的条目（浮点按位比较，-0.0 与 0.0 不同）
+// 只用到哈希与比较，不需要 Vulkan 设备。
+// 用法：sampler_cache_test
+
+namespace {
+    struct Failure {
+        std::string message;
+    };
+
+    void require(bool condition, const std::string& message) {
+        if (!condition) throw Failure{message};
+    }
+
+    using SamplerMap = std::unordered_map<vk::SamplerCreateInfo, uint32_t, SamplerCache::CreateInfoHash, SamplerCache::CreateInfoEqual>;
+
+    // 与 SamplerCache::getDefaultCreateInfo 相同（maxAnisotropy 取常见的设备上限 16）
+    vk::SamplerCreateInfo makeDefault() {
+        vk::SamplerCreateInfo info{};
+        info.magFilter = vk::Filter::eLinear;
+        info.minFilter = vk::Filter::eLinear;
+        info.addressModeU = vk::SamplerAddressMode::eRepeat;
+        info.addressModeV = vk::SamplerAddressMode::eRepeat;
+        info.addressModeW = vk::SamplerAddressMode::eRepeat;
+        info.anisotropyEnable = VK_TRUE;
+        info.maxAnisotropy = 16.0f;
+        info.borderColor = vk::BorderColor::eIntOpaqueBlack;
+        info.unnormalizedCoordinates = VK_FALSE;
+        info.compareEnable = VK_FALSE;
+        info.compareOp = vk::CompareOp::eAlways;
+        info.mipmapMode = vk::SamplerMipmapMode::eLinear;
+        info.mipLodBias = 0.0f;
+        info.minLod = 0.0f;
+        info.maxLod = VK_LOD_CLAMP_NONE;
+        return info;
+    }
+
+    struct Variant {
+        const char* name;
+        std::function<void(vk::SamplerCreateInfo&)> apply;
+    };
+
+    void checkEqual() {
+        const SamplerCache::CreateInfoHash hash;
+        const SamplerCache::CreateInfoEqual equal;
+        const vk::SamplerCreateInfo a = makeDefault();
+        const vk::SamplerCreateInfo b = makeDefault();
+        require(equal(a, b) && hash(a) == hash(b), "equal create infos compare or hash differently");
+
+        SamplerMap samplers;
+        for (uint32_t i = 0; i < 100; i++) {
+            samplers.emplace(makeDefault(), i);
+        }
+        require(samplers.size() == 1, "equal create infos map to " + std::to_string(samplers.size()) + " entries");
+        require(samplers.begin()->second == 0, "the first entry was replaced");
+    }
+
+    void checkDistinct() {
+        const std::vector<Variant> variants = {
+            {"anisotropy 8x", [](auto& info) { info.maxAnisotropy = 8.0f; }},
+            {"anisotropy 1x", [](auto& info) { info.maxAnisotropy = 1.0f; }},
+            {"anisotropy off", [](auto& info) { info.anisotropyEnable = VK_FALSE; }},
+            {"address U clamp", [](auto& info) { info.addressModeU = vk::SamplerAddressMode::eClampToEdge; }},
+            {"address V clamp", [](auto& info) { info.addressModeV = vk::SamplerAddressMode::eClampToEdge; }},
+            {"address W clamp", [](auto& info) { info.addressModeW = vk::SamplerAddressMode::eClampToEdge; }},
+            {"address U mirror", [](auto& info) { info.addressModeU = vk::SamplerAddressMode::eMirroredRepeat; }},
+            {"lod bias 0.5", [](auto& info) { info.mipLodBias = 0.5f; }},
+            {"lod bias -0.5", [](auto& info) { info.mipLodBias = -0.5f; }},
+            {"lod bias -0.0", [](auto& info) { info.mipLodBias = -0.0f; }},
+            {"nearest mag", [](auto& info) { info.magFilter = vk::Filter::eNearest; }},
+            {"nearest mip", [](auto& info) { info.mipmapMode = vk::SamplerMipmapMode::eNearest; }},
+            {"max lod 4", [](auto& info) { info.maxLod = 4.0f; }},
+            {"min lod 1", [](auto& info) { info.minLod = 1.0f; }},
+            {"compare less", [](auto& info) { info.compareEnable = VK_TRUE; info.compareOp = vk::CompareOp::eLess; }},
+            {"white border", [](auto& info) { info.borderColor = vk::BorderColor::eFloatOpaqueWhite; }},
+        };
+
+        const SamplerCache::CreateInfoEqual equal;
+        const vk::SamplerCreateInfo base = makeDefault();
+        SamplerMap samplers;
+        samplers.emplace(base, 0);
+        for (uint32_t i = 0; i < variants.size(); i++) {
+            vk::SamplerCreateInfo info = makeDefault();
+            variants[i].apply(info);
+            require(!equal(base, info), std::string(variants[i].name) + ": compares equal to the default");
+            require(samplers.emplace(info, i + 1).second, std::string(variants[i].name) + ": shares an entry with another variant");
+        }
+        // 再插入一遍：每个变体都命中自己的条目
+        for (uint32_t i = 0; i < variants.size(); i++) {
+            vk::SamplerCreateInfo info = makeDefault();
+            variants[i].apply(info);
+            const auto it = samplers.find(info);
+            require(it != samplers.end() && it->second == i + 1, std::string(variants[i].name) + ": lookup hits the wrong entry");
+        }
+        require(samplers.size() == variants.size() + 1, "distinct create infos collapsed");
+        std::println("{} distinct sampler keys", samplers.size());
+    }
+}
+
+int main() {
+    try {
+        checkEqual();
+        checkDistinct();
+    } catch (const Failure& failure) {
+        std::println("FAILED: {}", failure.message);
+        return EXIT_FAILURE;
+    }
+    std::println("OK");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+#include <print>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include "Assets/VertexDedup.h"
+#include "Core/JobSystem.h"
+
+// 顶点去重微基准：旧的 unordered_map 路径作为参考实现，对比 VertexDedup 的单线程与分区并行路径。
+// 输入是网格状数据（每个顶点被约 6 个角点引用），结果与参考实现逐项比较，不一致时返回非零。
+// 用法：vertex_dedup_bench [角点数] [重复次数]
+
+namespace {
+    // 与 Vertex 相同的 32 字节布局（pos / normal / texCoord），不依赖 glm
+    struct BenchVertex {
+        float pos[3];
+        float normal[3];
+        float texCoord[2];
+        bool operator==(const BenchVertex& other) const {
+            for (int i = 0; i < 3; i++) {
+                if (pos[i] != other.pos[i] || normal[i] != other.normal[i]) return false;
+            }
+            return texCoord[0] == other.texCoord[0] && texCoord[1] == other.texCoord[1];
+        }
+    };
+    static_assert(sizeof(BenchVertex) == 32, "BenchVertex must match the Vertex layout");
+
+    // 去重前 Mesh::parseObj 使用的哈希（逐分量 std::hash<float> 移位异或）
+    struct ReferenceHash {
+        size_t operator()(const BenchVertex& vertex) const noexcept {
+            size_t h1 = std::hash<float>()(vertex.pos[0]);
+            size_t h2 = std::hash<float>()(vertex.pos[1]);
+            size_t h3 = std::hash<float>()(vertex.pos[2]);
+            size_t h4 = std::hash<float>()(vertex.normal[0]);
+            size_t h5 = std::hash<float>()(vertex.normal[1]);
+            size_t h6 = std::hash<float>()(vertex.normal[2]);
+            size_t h7 = std::hash<float>()(vertex.texCoord[0]);
+            size_t h8 = std::hash<float>()(vertex.texCoord[1]);
+            return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3) ^ (h5 << 4) ^ (h6 << 5) ^ (h7 << 6) ^ (h8 << 7);
+        }
+    };
+
+    // 参考实现：每个角点先 count 再插入，编号按首次出现顺序递增
+    VertexDedup::Result<BenchVertex> referenceDeduplicate(const std::vector<BenchVertex>& corners) {
+        VertexDedup::Result<BenchVertex> result;
+        result.indices.reserve(corners.size());
+        std::unordered_map<BenchVertex, uint32_t, ReferenceHash> uniqueVertices{};
+        for (const BenchVertex& vertex : corners) {
+            if (uniqueVertices.count(vertex) == 0) {
+                uniqueVertices[vertex] = static_cast<uint32_t>(result.vertices.size());
+                result.vertices.push_back(vertex);
+            }
+            result.indices.push_back(uniqueVertices[vertex]);
+        }
+        return result;
+    }
+
+    // 边长 side 的顶点网格，每个四边形两个三角形；角点数向上取到能覆盖 cornerCount 的网格
+    std::vector<BenchVertex> makeGrid(size_t cornerCount) {
+        constexpr std::pair<size_t, size_t> kQuadCorners[] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+        size_t side = 2;
+        while ((side - 1) * (side - 1) * 6 < cornerCount) side++;
+        auto vertexAt = [side](size_t x, size_t y) {
+            const float u = static_cast<float>(x) / static_cast<float>(side - 1);
+            const float v = static_cast<float>(y) / static_cast<float>(side - 1);
+            return BenchVertex{{u * 10.0f, 0.25f * u * v, v * 10.0f}, {0.0f, 1.0f, 0.0f}, {u, v}};
+        };
+        std::vector<BenchVertex> corners;
+        corners.reserve((side - 1) * (side - 1) * 6);
+        for (size_t y = 0; y + 1 < side; y++) {
+            for (size_t x = 0; x + 1 < side; x++) {
+                for (const auto& [dx, dy] : kQuadCorners) {
+                    corners.push_back(vertexAt(x + dx, y + dy));
+                }
+            }
+        }
+        return corners;
+    }
+
+    template<typename F>
+    double bestOf(uint32_t iterations, F&& run) {
+        double best = 0.0;
+        for (uint32_t i = 0; i < iterations; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+
+    // 顺序路径的编号顺序与参考实现相同，结果必须逐项一致
+    bool sameAsReference(const VertexDedup::Result<BenchVertex>& result, const VertexDedup::Result<BenchVertex>& reference) {
+        return result.indices == reference.indices && result.vertices == reference.vertices;
+    }
+
+    // 分区路径的编号顺序不同：顶点数相同，且每个角点解析回原来的顶点
+    bool equivalentToReference(const VertexDedup::Result<BenchVertex>& result, const VertexDedup::Result<BenchVertex>& reference,
+                               const std::vector<BenchVertex>& corners) {
+        if (result.vertices.size() != reference.vertices.size() || result.indices.size() != corners.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < corners.size(); i++) {
+            if (result.indices[i] >= result.vertices.size() || !(result.vertices[result.indices[i]] == corners[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t requested = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{3} << 20;
+    const uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::max(1ul, std::strtoul(argv[2], nullptr, 10))) : 3u;
+
+    const std::vector<BenchVertex> corners = makeGrid(requested);
+    auto fetch = [&](size_t i) { return corners[i]; };
+    JobSystem jobs;
+
+    VertexDedup::Result<BenchVertex> reference, sequential, parallel;
+    const double referenceMs = bestOf(iterations, [&]() { reference = referenceDeduplicate(corners); });
+    const double sequentialMs = bestOf(iterations, [&]() { sequential = VertexDedup::deduplicate<BenchVertex>(corners.size(), fetch); });
+    const double parallelMs = bestOf(iterations, [&]() { parallel = VertexDedup::deduplicate<BenchVertex>(corners.size(), fetch, &jobs); });
+
+    std::println("{} corners, {} unique vertices, best of {}", corners.size(), reference.vertices.size(), iterations);
+    std::println("  unordered_map (reference): {:9.2f} ms", referenceMs);
+    std::println("  VertexDedup, 1 thread:     {:9.2f} ms ({:.2f}x)", sequentialMs, referenceMs / sequentialMs);
+    std::println("  VertexDedup, {} workers:   {:9.2f} ms ({:.2f}x)", jobs.getThreadCount(), parallelMs, referenceMs / parallelMs);
+
+    bool ok = true;
+    if (!sameAsReference(sequential, reference)) {
+        std::println("FAILED: sequential result differs from the unordered_map reference");
+        ok = false;
+    }
+    if (!equivalentToReference(parallel, reference, corners)) {
+        std::println("FAILED: partitioned result is not equivalent to the unordered_map reference");
+        ok = false;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}